@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <CL/sycl.hpp>
 
@@ -11,6 +12,39 @@
 #include "runtime.h"
 #include "sycl_wrappers.h"
 
+namespace celerity::experimental {
+
+/**
+ * Buffer property requesting that the host-side backing memory of a buffer is placed in a memory-mapped scratch file instead of a heap allocation.
+ *
+ * Since the OS can write back and evict pages of file mappings under memory pressure, this allows the host working set of a node to exceed its
+ * physical memory, trading an out-of-memory failure for disk bandwidth. Host tasks reading such a buffer will ask the OS to page in their
+ * requirements while they wait for their dependencies. Device memory is unaffected.
+ *
+ * ```c++
+ * celerity::buffer<float, 2> buf(range, celerity::experimental::out_of_core_host_memory{"/scratch/tmp"});
+ * ```
+ */
+struct out_of_core_host_memory {
+	/// Directory in which scratch files are created. Should reside on a fast local disk. Empty selects the system's temporary directory.
+	std::string scratch_directory;
+};
+
+/**
+ * Buffer property requesting that the runtime keeps referring to the host data a buffer is initialized from instead of copying it on construction.
+ *
+ * Each node then only copies the parts of the buffer that it actually reads, when it first reads them, so the full initial data is no longer
+ * allocated and copied on every node. In exchange, the data behind the host pointer must remain valid and unmodified until the buffer has been
+ * destroyed and all command groups accessing it have completed (e.g. after `distr_queue::slow_full_sync()`).
+ *
+ * ```c++
+ * celerity::buffer<float, 2> buf(input.data(), range, celerity::experimental::host_init_by_reference{});
+ * ```
+ */
+struct host_init_by_reference {};
+
+} // namespace celerity::experimental
+
 namespace celerity {
 
 template <typename DataT, int Dims = 1>
@@ -47,6 +81,14 @@ class buffer final : public detail::lifetime_extending_state_wrapper {
 
 	explicit buffer(range<Dims> range) : buffer(nullptr, range) {}
 
+	explicit buffer(const DataT* host_ptr, range<Dims> range, const experimental::out_of_core_host_memory& property)
+	    : m_impl(std::make_shared<impl>(range, host_ptr, detail::host_storage_config{detail::host_memory_kind::mapped_file, property.scratch_directory})) {}
+
+	explicit buffer(range<Dims> range, const experimental::out_of_core_host_memory& property) : buffer(nullptr, range, property) {}
+
+	explicit buffer(const DataT* host_ptr, range<Dims> range, const experimental::host_init_by_reference& /* property */)
+	    : m_impl(std::make_shared<impl>(range, host_ptr, detail::host_storage_config{}, detail::host_init_policy::reference)) {}
+
 	template <int D = Dims, typename = std::enable_if_t<D == 0>>
 	buffer(const DataT& value) : buffer(&value, {}) {}
 
@@ -96,9 +138,12 @@ class buffer final : public detail::lifetime_extending_state_wrapper {
 
   private:
 	struct impl final : public detail::lifetime_extending_state {
-		impl(range<Dims> rng, const DataT* host_init_ptr) : range(rng) {
+		impl(range<Dims> rng, const DataT* host_init_ptr, detail::host_storage_config host_config = {},
+		    const detail::host_init_policy init_policy = detail::host_init_policy::copy_on_register)
+		    : range(rng) {
 			if(!detail::runtime::is_initialized()) { detail::runtime::init(nullptr, nullptr); }
-			id = detail::runtime::get_instance().get_buffer_manager().register_buffer<DataT, Dims>(detail::range_cast<3>(range), host_init_ptr);
+			id = detail::runtime::get_instance().get_buffer_manager().register_buffer<DataT, Dims>(
+			    detail::range_cast<3>(range), host_init_ptr, std::move(host_config), init_policy);
 		}
 		impl(const impl&) = delete;
 		impl(impl&&) = delete;
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <cstring>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -15,6 +22,7 @@
 #include "buffer_storage.h"
 #include "device_queue.h"
 #include "mpi_support.h"
+#include "numa.h"
 #include "payload.h"
 #include "ranges.h"
 #include "region_map.h"
@@ -24,6 +32,53 @@
 namespace celerity {
 namespace detail {
 
+	/**
+	 * Memory footprint of a single buffer on one side, in bytes.
+	 */
+	struct buffer_memory_usage {
+		size_t current_bytes = 0;
+		size_t peak_bytes = 0;
+
+		/// Number of times a backing buffer was replaced by a larger one.
+		size_t num_resizes = 0;
+
+		/// Bytes copied from a previous backing buffer into its replacement to retain data on resize.
+		size_t resize_copy_bytes = 0;
+
+		void allocate(const size_t bytes) {
+			current_bytes += bytes;
+			peak_bytes = std::max(peak_bytes, current_bytes);
+		}
+
+		void free(const size_t bytes) {
+			assert(bytes <= current_bytes);
+			current_bytes -= bytes;
+		}
+	};
+
+	struct buffer_memory_statistics {
+		buffer_memory_usage device;
+		buffer_memory_usage host;
+
+		/// Temporary host allocations for copies between host and device or for partially applied transfers. These are released immediately,
+		/// so current_bytes is zero outside of an ongoing buffer access.
+		buffer_memory_usage staging;
+
+		/// Incoming data that has been received but not yet applied to a backing buffer, see buffer_manager::set_buffer_data.
+		buffer_memory_usage scheduled_transfers;
+	};
+
+	/**
+	 * How the data of a host-initialized buffer enters the runtime.
+	 */
+	enum class host_init_policy {
+		/// The full range is copied into a host backing buffer on registration, the user pointer is not used afterwards.
+		copy_on_register,
+		/// Only a reference to the user pointer is kept. Each part of the buffer is copied from it once it is first read locally, parts that are
+		/// overwritten before being read are never copied. The user data must remain valid and unmodified until the buffer is unregistered.
+		reference,
+	};
+
 	/**
 	 * The buffer_manager keeps track of all Celerity buffers currently existing within the runtime.
 	 *
@@ -78,6 +133,11 @@ namespace detail {
 	 * Currently, these issues are handled through the buffer locking mechanism.
 	 * See buffer_manager::try_lock, buffer_manager::unlock and buffer_manager::is_locked.
 	 *
+	 * The buffer_manager is thread safe. Each buffer is protected by its own mutex, so accesses to different buffers from
+	 * multiple threads do not contend with each other. Buffers are looked up without locking, so callers must keep a buffer registered
+	 * while accessing it, i.e. not unregister it concurrently. Only has_buffer, get_memory_statistics and print_memory_report may be called
+	 * for buffers that are being unregistered.
+	 *
 	 * FIXME: The current buffer locking mechanism limits task parallelism. Come up with a better solution.
 	 */
 	class buffer_manager {
@@ -89,7 +149,7 @@ namespace detail {
 		using buffer_lifecycle_callback = std::function<void(buffer_lifecycle_event, buffer_id)>;
 
 		using device_buffer_factory = std::function<std::unique_ptr<buffer_storage>(const range<3>&, device_queue&)>;
-		using host_buffer_factory = std::function<std::unique_ptr<buffer_storage>(const range<3>&)>;
+		using host_buffer_factory = std::function<std::unique_ptr<buffer_storage>(const range<3>&, numa_node_id)>;
 
 		struct buffer_info {
 			int dimensions = -1;
@@ -129,30 +189,40 @@ namespace detail {
 		buffer_manager(device_queue& queue, buffer_lifecycle_callback lifecycle_cb);
 
 		template <typename DataT, int Dims>
-		buffer_id register_buffer(range<3> range, const DataT* host_init_ptr = nullptr) {
+		buffer_id register_buffer(range<3> range, const DataT* host_init_ptr = nullptr, host_storage_config host_config = {},
+		    const host_init_policy init_policy = host_init_policy::copy_on_register) {
 			assert(Dims > 0 || range[0] == 1);
 			assert(Dims > 1 || range[1] == 1);
 			assert(Dims > 2 || range[2] == 1);
 
-			buffer_id bid;
 			const bool is_host_initialized = host_init_ptr != nullptr;
-			{
-				std::unique_lock lock(m_mutex);
-				bid = m_buffer_count++;
-				m_buffers.emplace(std::piecewise_construct, std::tuple{bid}, std::tuple{});
-				auto device_factory = [](const celerity::range<3>& r, device_queue& q) {
-					return std::make_unique<device_buffer_storage<DataT, Dims>>(range_cast<Dims>(r), q);
-				};
-				auto host_factory = [](const celerity::range<3>& r) { return std::make_unique<host_buffer_storage<DataT, Dims>>(range_cast<Dims>(r)); };
-				m_buffer_infos.emplace(
-				    bid, buffer_info{Dims, range, sizeof(DataT), is_host_initialized, {}, std::move(device_factory), std::move(host_factory)});
-				m_newest_data_location.emplace(bid, region_map<data_location>(range, Dims, data_location::nowhere));
-
+			auto device_factory = [](const celerity::range<3>& r, device_queue& q) {
+				return std::make_unique<device_buffer_storage<DataT, Dims>>(range_cast<Dims>(r), q);
+			};
+			auto host_factory = [host_config = std::move(host_config)](const celerity::range<3>& r, const numa_node_id numa_node) {
+				auto placed_config = host_config;
+				placed_config.numa_node = numa_node;
+				return std::make_unique<host_buffer_storage<DataT, Dims>>(range_cast<Dims>(r), placed_config);
+			};
+			auto state = std::make_unique<buffer_state>(
+			    buffer_info{Dims, range, sizeof(DataT), is_host_initialized, {}, std::move(device_factory), std::move(host_factory)});
 #if defined(CELERITY_DETAIL_ENABLE_DEBUG)
-				m_buffer_types.emplace(bid, new buffer_type_guard<DataT, Dims>());
+			state->type_guard = std::make_unique<buffer_type_guard<DataT, Dims>>();
 #endif
+			if(is_host_initialized && init_policy == host_init_policy::reference) {
+				state->host_init_ptr = host_init_ptr;
+				state->pending_host_init_region = box(subrange<3>({}, range));
 			}
-			if(is_host_initialized) {
+
+			buffer_id bid;
+			{
+				std::lock_guard lock(m_registration_mutex);
+				bid = m_buffer_count++;
+				state->bid = bid;
+				m_buffer_states.insert(std::move(state));
+			}
+			m_num_active_buffers.fetch_add(1, std::memory_order_relaxed);
+			if(is_host_initialized && init_policy == host_init_policy::copy_on_register) {
 				// We need to access the full range for host-initialized buffers.
 				auto info = access_host_buffer(bid, access_mode::discard_write, {{}, range});
 				std::memcpy(info.ptr, host_init_ptr, range.size() * sizeof(DataT));
@@ -175,20 +245,27 @@ namespace detail {
 		 * This is useful in rare situations where worker nodes might receive data for buffers they haven't registered yet.
 		 */
 		bool has_buffer(buffer_id bid) const {
-			std::shared_lock lock(m_mutex);
-			return m_buffer_infos.count(bid) == 1;
+			std::shared_lock retirement_lock(m_retirement_mutex);
+			const auto* const state = m_buffer_states.find(bid);
+			return state != nullptr && state->is_registered.load(std::memory_order_acquire);
 		}
 
-		bool has_active_buffers() const {
-			std::shared_lock lock(m_mutex);
-			return !m_buffer_infos.empty();
+		bool has_active_buffers() const { return m_num_active_buffers.load(std::memory_order_relaxed) > 0; }
+
+		size_t get_element_size(buffer_id bid) const {
+			const auto& state = m_buffer_states.get(bid);
+			std::lock_guard lock(state.mutex);
+			assert(state.is_registered);
+			return state.info.element_size;
 		}
 
 		// returning copy of struct because FOR NOW it is not called in any performance critical section.
+		// The buffer must remain registered until this returns.
 		buffer_info get_buffer_info(buffer_id bid) const {
-			std::shared_lock lock(m_mutex);
-			assert(m_buffer_infos.find(bid) != m_buffer_infos.end());
-			return m_buffer_infos.at(bid);
+			const auto& state = m_buffer_states.get(bid);
+			std::lock_guard lock(state.mutex);
+			assert(state.is_registered);
+			return state.info;
 		}
 
 		/**
@@ -225,8 +302,9 @@ namespace detail {
 		access_info access_device_buffer(buffer_id bid, access_mode mode, const subrange<Dims>& sr) {
 #if defined(CELERITY_DETAIL_ENABLE_DEBUG)
 			{
-				std::unique_lock lock(m_mutex);
-				assert((m_buffer_types.at(bid)->has_type<DataT, Dims>()));
+				const auto& state = m_buffer_states.get(bid);
+				std::lock_guard lock(state.mutex);
+				assert((state.type_guard->has_type<DataT, Dims>()));
 			}
 #endif
 			return access_device_buffer(bid, mode, subrange_cast<3>(sr));
@@ -238,14 +316,32 @@ namespace detail {
 		access_info access_host_buffer(buffer_id bid, access_mode mode, const subrange<Dims>& sr) {
 #if defined(CELERITY_DETAIL_ENABLE_DEBUG)
 			{
-				std::unique_lock lock(m_mutex);
-				assert((m_buffer_types.at(bid)->has_type<DataT, Dims>()));
+				const auto& state = m_buffer_states.get(bid);
+				std::lock_guard lock(state.mutex);
+				assert((state.type_guard->has_type<DataT, Dims>()));
 			}
 #endif
 			return access_host_buffer(bid, mode, subrange_cast<3>(sr));
 		}
 
-		access_info access_host_buffer(buffer_id bid, cl::sycl::access::mode mode, const subrange<3>& sr);
+		/**
+		 * If the access requires a new host backing buffer, it is placed on NUMA node @p numa_node (if set), which should be the node of the thread
+		 * that is going to consume the data. Otherwise, new backing buffers are placed on the same node as the previous one.
+		 */
+		access_info access_host_buffer(buffer_id bid, cl::sycl::access::mode mode, const subrange<3>& sr, numa_node_id numa_node = no_numa_node);
+
+		/**
+		 * Returns the NUMA node the current host backing buffer of @p bid was placed on, or no_numa_node if there is none or placement was left to the OS.
+		 */
+		numa_node_id get_host_buffer_numa_node(buffer_id bid) const;
+
+		/**
+		 * Hints that the subrange @p sr of buffer @p bid will soon be accessed on the host, e.g. by a host task that is waiting for its dependencies.
+		 *
+		 * This never allocates or resizes memory and only affects the part of @p sr that is covered by the current host backing buffer.
+		 * It is a no-op unless the backing storage supports prefetching (see buffer_storage::prefetch).
+		 */
+		void prefetch_host_buffer(buffer_id bid, const subrange<3>& sr) const;
 
 		/**
 		 * @brief Tries to lock the given list of @p buffers using the given lock @p id.
@@ -274,15 +370,29 @@ namespace detail {
 		bool is_locked(buffer_id bid) const;
 
 		void set_debug_name(const buffer_id bid, const std::string& debug_name) {
-			std::lock_guard lock(m_mutex);
-			m_buffer_infos.at(bid).debug_name = debug_name;
+			auto& state = m_buffer_states.get(bid);
+			std::lock_guard lock(state.mutex);
+			state.info.debug_name = debug_name;
 		}
 
+		/**
+		 * Returns the memory footprint of buffer @p bid. Statistics are retained for the most recently unregistered buffers, so unlike most other
+		 * functions this may be called while @p bid is being unregistered.
+		 */
+		buffer_memory_statistics get_memory_statistics(buffer_id bid) const;
+
+		/**
+		 * Formats a table of the current and peak memory usage of every buffer registered during the lifetime of the buffer_manager. Buffers that were
+		 * unregistered long ago are summarized in a single line.
+		 */
+		std::string print_memory_report() const;
+
 		std::string get_debug_label(const buffer_id bid) const {
 			std::string name;
 			{
-				std::lock_guard lock(m_mutex);
-				name = m_buffer_infos.at(bid).debug_name;
+				const auto& state = m_buffer_states.get(bid);
+				std::lock_guard lock(state.mutex);
+				name = state.info.debug_name;
 			}
 			return !name.empty() ? fmt::format("B{} \"{}\"", bid, name) : fmt::format("B{}", bid);
 		}
@@ -343,27 +453,174 @@ namespace detail {
 			std::optional<cl::sycl::access::mode> earlier_access_mode = std::nullopt;
 		};
 
+		/**
+		 * Everything the buffer_manager knows about a single buffer, protected by its own mutex so that accesses to different buffers do not contend.
+		 *
+		 * States are destroyed when their buffer is unregistered; only the memory statistics of recently unregistered buffers are kept around (see
+		 * m_unregistered_buffers).
+		 */
+		struct buffer_state {
+			mutable std::mutex mutex;
+			buffer_id bid = 0; // assigned before the state is published
+			std::atomic<bool> is_registered = true;
+			buffer_info info;
+			virtual_buffer buffers;
+			std::vector<transfer> scheduled_transfers;
+			region_map<data_location> newest_data_location;
+			buffer_memory_statistics memory;
+			buffer_lock_info lock_info;
+			numa_node_id host_numa_node = no_numa_node; // of buffers.host_buf
+
+			// With host_init_policy::reference, the user data and the parts of it that have neither been read nor overwritten locally yet.
+			const void* host_init_ptr = nullptr;
+			region<3> pending_host_init_region;
+
+			// Mirrors the size of the device backing buffer, so out-of-memory diagnostics can list all allocations without locking other buffers.
+			std::atomic<size_t> device_allocation_bytes = 0;
+
+#if defined(CELERITY_DETAIL_ENABLE_DEBUG)
+			// Since we store buffers without type information (i.e., its data type and dimensionality),
+			// it is the user's responsibility to only request access to a buffer using the correct type.
+			// In debug builds we can help out a bit by remembering the type and asserting it on every access.
+			std::unique_ptr<buffer_type_guard_base> type_guard;
+#endif
+
+			explicit buffer_state(buffer_info buf_info)
+			    : info(std::move(buf_info)), newest_data_location(info.range, info.dimensions, data_location::nowhere) {}
+		};
+
+		/**
+		 * Maps the ids of registered buffers to their state without requiring a lock for lookups.
+		 *
+		 * Buffer ids are assigned sequentially, so states are stored in a ring of fixed-size segments that are allocated on demand and never move.
+		 * Each slot is shared by all ids that are a multiple of the capacity apart, which limits the number of simultaneously registered buffers but
+		 * not the number of registrations over the lifetime of the table. Insertions and removals must be serialized externally (see
+		 * m_registration_mutex) and are published with release semantics. Removal leaves the destruction of the state to the caller, which must
+		 * ensure that no lookup still refers to it (see m_retirement_mutex).
+		 */
+		class buffer_state_table {
+		  public:
+			static constexpr size_t segment_size = 256;
+			static constexpr size_t max_segments = 4096;
+			static constexpr size_t capacity = segment_size * max_segments;
+
+			buffer_state_table() = default;
+			buffer_state_table(const buffer_state_table&) = delete;
+			buffer_state_table& operator=(const buffer_state_table&) = delete;
+
+			~buffer_state_table() {
+				for(auto& seg : m_segments) {
+					auto* const entries = seg.load(std::memory_order_relaxed);
+					if(entries == nullptr) break;
+					for(auto& entry : *entries) {
+						delete entry.load(std::memory_order_relaxed);
+					}
+					delete entries;
+				}
+			}
+
+			buffer_state* find(const buffer_id bid) const {
+				const auto slot = bid % capacity;
+				const auto* const entries = m_segments[slot / segment_size].load(std::memory_order_acquire);
+				if(entries == nullptr) return nullptr;
+				auto* const state = (*entries)[slot % segment_size].load(std::memory_order_acquire);
+				return state != nullptr && state->bid == bid ? state : nullptr;
+			}
+
+			buffer_state& get(const buffer_id bid) const {
+				auto* const state = find(bid);
+				assert(state != nullptr);
+				return *state;
+			}
+
+			void insert(std::unique_ptr<buffer_state> state) {
+				const auto slot = state->bid % capacity;
+				auto& seg = m_segments[slot / segment_size];
+				auto* entries = seg.load(std::memory_order_relaxed);
+				if(entries == nullptr) {
+					entries = new segment{};
+					seg.store(entries, std::memory_order_release);
+				}
+				auto& entry = (*entries)[slot % segment_size];
+				if(entry.load(std::memory_order_relaxed) != nullptr) {
+					throw std::runtime_error(fmt::format("Exceeded the maximum of {} simultaneously registered buffers", capacity));
+				}
+				entry.store(state.release(), std::memory_order_release);
+			}
+
+			// Removes the state of @p bid from the table, leaving its destruction to the caller.
+			std::unique_ptr<buffer_state> erase(const buffer_id bid) {
+				const auto slot = bid % capacity;
+				auto* const entries = m_segments[slot / segment_size].load(std::memory_order_relaxed);
+				assert(entries != nullptr);
+				auto* const state = (*entries)[slot % segment_size].exchange(nullptr, std::memory_order_acq_rel);
+				assert(state != nullptr && state->bid == bid);
+				return std::unique_ptr<buffer_state>(state);
+			}
+
+			template <typename Fn>
+			void for_each(const Fn& fn) const {
+				for(const auto& seg : m_segments) {
+					const auto* const entries = seg.load(std::memory_order_acquire);
+					if(entries == nullptr) break;
+					for(const auto& entry : *entries) {
+						if(auto* const state = entry.load(std::memory_order_acquire)) { fn(*state); }
+					}
+				}
+			}
+
+		  private:
+			using segment = std::array<std::atomic<buffer_state*>, segment_size>;
+
+			std::array<std::atomic<segment*>, max_segments> m_segments{};
+		};
+
 	  private:
 		// Leave some memory for other processes.
 		double m_max_device_global_mem_usage = 0.95;
 		device_queue& m_queue;
 		buffer_lifecycle_callback m_lifecycle_cb;
+		// Serializes modifications of m_buffer_states and m_unregistered_buffers. May be acquired while holding a buffer state mutex, but not vice versa.
+		mutable std::mutex m_registration_mutex;
 		size_t m_buffer_count = 0;
-		mutable std::shared_mutex m_mutex;
-		std::unordered_map<buffer_id, buffer_info> m_buffer_infos;
-		std::unordered_map<buffer_id, virtual_buffer> m_buffers;
-		std::unordered_map<buffer_id, std::vector<transfer>> m_scheduled_transfers;
-		std::unordered_map<buffer_id, region_map<data_location>> m_newest_data_location;
+		buffer_state_table m_buffer_states;
+		std::atomic<size_t> m_num_active_buffers = 0;
+		// Held shared by functions that look up buffers which may be unregistered concurrently, for as long as they refer to a buffer state.
+		// unregister_buffer acquires it exclusively after erasing a state, so that no such function can refer to the state once it is destroyed.
+		// Acquire before any other mutex.
+		mutable std::shared_mutex m_retirement_mutex;
+
+		struct unregistered_buffer {
+			std::string debug_name;
+			buffer_memory_statistics memory;
+		};
 
-		std::unordered_map<buffer_id, buffer_lock_info> m_buffer_lock_infos;
+		// Unregistered buffers whose statistics are still reported individually. Beyond that, statistics are only accumulated, so that a program
+		// creating buffers in a loop does not grow the buffer_manager without bound.
+		static constexpr size_t max_retained_unregistered_buffers = 1024;
+		std::map<buffer_id, unregistered_buffer> m_unregistered_buffers;
+		size_t m_num_forgotten_buffers = 0;
+		buffer_memory_statistics m_forgotten_buffer_memory;
+
+		// Guards the set of locked buffers, all of which must be registered. Lock information is mirrored into the per-buffer state so that
+		// audit_buffer_access does not need to acquire this mutex. Acquire before any buffer state mutex.
+		mutable std::mutex m_buffer_locks_mutex;
+		std::unordered_set<buffer_id> m_locked_buffers;
 		std::unordered_map<buffer_lock_id, std::vector<buffer_id>> m_buffer_locks_by_id;
 
-#if defined(CELERITY_DETAIL_ENABLE_DEBUG)
-		// Since we store buffers without type information (i.e., its data type and dimensionality),
-		// it is the user's responsibility to only request access to a buffer using the correct type.
-		// In debug builds we can help out a bit by remembering the type and asserting it on every access.
-		std::unordered_map<buffer_id, std::unique_ptr<buffer_type_guard_base>> m_buffer_types;
-#endif
+		static buffer_memory_usage& get_memory_usage(buffer_state& state, const buffer_type type) {
+			return type == buffer_type::device_buffer ? state.memory.device : state.memory.host;
+		}
+
+		static void accumulate_memory_statistics(buffer_memory_statistics& sum, const buffer_memory_statistics& stats) {
+			for(const auto [sum_usage, usage] : {std::pair{&sum.device, &stats.device}, std::pair{&sum.host, &stats.host},
+			        std::pair{&sum.staging, &stats.staging}, std::pair{&sum.scheduled_transfers, &stats.scheduled_transfers}}) {
+				sum_usage->current_bytes += usage->current_bytes;
+				sum_usage->peak_bytes += usage->peak_bytes;
+				sum_usage->num_resizes += usage->num_resizes;
+				sum_usage->resize_copy_bytes += usage->resize_copy_bytes;
+			}
+		}
 
 		static resize_info is_resize_required(const backing_buffer& buffer, range<3> request_range, id<3> request_offset) {
 			assert(buffer.is_allocated());
@@ -385,8 +642,19 @@ namespace detail {
 			return result;
 		}
 
-		// Implementation of access_host_buffer, does not lock mutex (called by access_device_buffer).
-		access_info access_host_buffer_impl(const buffer_id bid, const access_mode mode, const subrange<3>& sr);
+		// Implementation of access_host_buffer, expects the buffer's state mutex to be held (called by access_device_buffer).
+		access_info access_host_buffer_impl(const buffer_id bid, const access_mode mode, const subrange<3>& sr, numa_node_id numa_node = no_numa_node);
+
+		// Makes host initialization data for all pending parts of sr available in the host buffer, so that the caller can read them. Expects the buffer's
+		// state mutex to be held.
+		void load_pending_host_init(buffer_id bid, const subrange<3>& sr);
+
+		/**
+		 * Resolves the pending host initialization data inside @p sr after an access with mode @p mode: For consumer modes the data is copied from
+		 * the user pointer into the (already coherent) host buffer, for producer modes it is superseded. Either way it is no longer pending afterwards.
+		 * Expects the buffer's state mutex to be held.
+		 */
+		static void resolve_pending_host_init(buffer_state& state, access_mode mode, const subrange<3>& sr);
 
 		/**
 		 * Returns whether an allocation of size bytes can be made without exceeding m_max_device_global_mem_usage,
@@ -435,6 +703,9 @@ namespace detail {
 		 */
 		void audit_buffer_access(buffer_id bid, bool requires_allocation, cl::sycl::access::mode mode);
 
+		// Mirrors lock information into the state of buffer bid, if it has been registered. Expects m_buffer_locks_mutex to be held.
+		void set_lock_info(buffer_id bid, const buffer_lock_info& lock_info);
+
 	  public:
 		static constexpr unsigned char test_mode_pattern = 0b10101010;
 
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include <CL/sycl.hpp>
 
 #include "backend/backend.h"
 #include "device_queue.h"
+#include "mapped_memory.h"
+#include "numa.h"
 #include "payload.h"
 #include "ranges.h"
 #include "workaround.h"
@@ -55,25 +60,78 @@ namespace detail {
 		device_allocation m_device_allocation;
 	};
 
+	enum class host_memory_kind {
+		heap,        ///< regular heap allocation
+		mapped_file, ///< memory-mapped scratch file, see scratch_file_mapping
+	};
+
+	/**
+	 * Selects how the host-side backing memory of a buffer is allocated.
+	 */
+	struct host_storage_config {
+		host_memory_kind kind = host_memory_kind::heap;
+
+		/// Directory for scratch files if kind == mapped_file. Empty selects the system's temporary directory.
+		std::string scratch_directory;
+
+		/// NUMA node to place heap allocations on, see get_numa_topology(). Ignored for mapped files.
+		numa_node_id numa_node = no_numa_node;
+	};
+
 	template <typename DataT, int Dims>
 	class host_buffer {
 	  public:
-		explicit host_buffer(range<Dims> range) : m_range(range) {
+		explicit host_buffer(range<Dims> range, const host_storage_config& config = {}) : m_range(range) {
 			auto r3 = range_cast<3>(range);
-			m_data = std::make_unique<DataT[]>(r3[0] * r3[1] * r3[2]);
+			const size_t num_elements = r3[0] * r3[1] * r3[2];
+			if(config.kind == host_memory_kind::mapped_file) {
+				// Freshly mapped scratch files are zero-filled, which matches the value-initialization of the heap case
+				m_mapping.emplace(config.scratch_directory, num_elements * sizeof(DataT));
+				m_ptr = static_cast<DataT*>(m_mapping->get_pointer());
+			} else if(const auto& topology = get_numa_topology(); config.numa_node != no_numa_node && topology.get_num_nodes() > 1) {
+				// Bind the (untouched) pages before value-initializing them, otherwise they would end up on the node of the allocating thread
+				m_data = std::unique_ptr<DataT[]>(new DataT[num_elements]);
+				m_ptr = m_data.get();
+				bind_memory_to_numa_node(m_ptr, num_elements * sizeof(DataT), topology, config.numa_node);
+				std::fill_n(m_ptr, num_elements, DataT{});
+				m_numa_node = config.numa_node;
+			} else {
+				m_data = std::make_unique<DataT[]>(num_elements);
+				m_ptr = m_data.get();
+			}
 		}
 
 		range<Dims> get_range() const { return m_range; };
 
-		DataT* get_pointer() { return m_data.get(); }
+		DataT* get_pointer() { return m_ptr; }
+
+		const DataT* get_pointer() const { return m_ptr; }
 
-		const DataT* get_pointer() const { return m_data.get(); }
+		bool is_mapped() const { return m_mapping.has_value(); }
 
-		bool operator==(const host_buffer& rhs) const { return m_data.get() == rhs.m_data.get(); }
+		/// The NUMA node this buffer was placed on, or no_numa_node if placement was left to the OS.
+		numa_node_id get_numa_node() const { return m_numa_node; }
+
+		/**
+		 * Passes an access pattern hint for the subrange @p sr to the OS. Since the hint is applied to the linear address range spanned by
+		 * @p sr, it may cover additional elements for multi-dimensional subranges. This is a no-op for heap-allocated buffers.
+		 */
+		void advise(const subrange<3>& sr, const mapped_access_advice advice) const {
+			if(!m_mapping.has_value() || sr.range.size() == 0) return;
+			const auto r3 = range_cast<3>(m_range);
+			const auto first = get_linear_index(r3, sr.offset);
+			const auto last = get_linear_index(r3, id_cast<3>(sr.offset + sr.range) - id<3>(1, 1, 1));
+			m_mapping->advise(first * sizeof(DataT), (last - first + 1) * sizeof(DataT), advice);
+		}
+
+		bool operator==(const host_buffer& rhs) const { return m_ptr == rhs.m_ptr; }
 
 	  private:
 		range<Dims> m_range;
 		std::unique_ptr<DataT[]> m_data;
+		std::optional<scratch_file_mapping> m_mapping;
+		DataT* m_ptr = nullptr;
+		numa_node_id m_numa_node = no_numa_node;
 	};
 
 	enum class buffer_type { device_buffer, host_buffer };
@@ -100,6 +158,12 @@ namespace detail {
 
 		virtual void set_data(const subrange<3>& sr, const void* in_linearized) = 0;
 
+		/**
+		 * Hints that the subrange @p sr (relative to this storage) is about to be accessed. Storage types that can page data in
+		 * asynchronously (such as out-of-core host buffers) use this to prefetch, all others ignore it.
+		 */
+		virtual void prefetch(const subrange<3>& /* sr */) const {}
+
 		/**
 		 * Copy data from the given source buffer into this buffer.
 		 *
@@ -167,7 +231,11 @@ namespace detail {
 	template <typename DataT, int Dims>
 	class host_buffer_storage : public buffer_storage {
 	  public:
-		explicit host_buffer_storage(range<Dims> range) : buffer_storage(range_cast<3>(range), buffer_type::host_buffer), m_host_buf(range) {}
+		explicit host_buffer_storage(range<Dims> range, const host_storage_config& config = {})
+		    : buffer_storage(range_cast<3>(range), buffer_type::host_buffer), m_host_buf(range, config) {
+			// Coherence updates and transfers mostly touch contiguous runs of memory in ascending order
+			if(m_host_buf.is_mapped()) { m_host_buf.advise(subrange<3>({}, get_range()), mapped_access_advice::sequential); }
+		}
 
 		size_t get_size() const override { return get_range().size() * sizeof(DataT); };
 
@@ -191,6 +259,8 @@ namespace detail {
 			    range_cast<Dims>(m_host_buf.get_range()), id_cast<Dims>(sr.offset), range_cast<Dims>(sr.range));
 		}
 
+		void prefetch(const subrange<3>& sr) const override { m_host_buf.advise(sr, mapped_access_advice::will_need); }
+
 		void copy(const buffer_storage& source, id<3> source_offset, id<3> target_offset, range<3> copy_range) override;
 
 		host_buffer<DataT, Dims>& get_host_buffer() { return m_host_buf; }
@@ -44,6 +44,14 @@ namespace detail {
 		int get_dry_run_nodes() const { return m_dry_run_nodes; }
 		std::optional<int> get_horizon_step() const { return m_horizon_step; }
 		std::optional<int> get_horizon_max_parallelism() const { return m_horizon_max_parallelism; }
+		std::optional<size_t> get_task_queue_soft_cap() const { return m_task_queue_soft_cap; }
+		bool get_numa_placement() const { return m_numa_placement; }
+		bool get_async_submission() const { return m_async_submission; }
+		std::optional<size_t> get_oversubscription() const { return m_oversubscription; }
+		bool get_locality_aware_assignment() const { return m_locality_aware_assignment; }
+		bool get_broadcast_trees() const { return m_broadcast_trees; }
+		bool get_load_balancing() const { return m_load_balancing; }
+		size_t get_load_balancing_slowdown() const { return m_load_balancing_slowdown; }
 
 	  private:
 		host_config m_host_cfg;
@@ -53,6 +61,14 @@ namespace detail {
 		bool m_recording = false;
 		std::optional<int> m_horizon_step;
 		std::optional<int> m_horizon_max_parallelism;
+		std::optional<size_t> m_task_queue_soft_cap;
+		bool m_numa_placement = true;
+		bool m_async_submission = false;
+		std::optional<size_t> m_oversubscription;
+		bool m_locality_aware_assignment = false;
+		bool m_broadcast_trees = false;
+		bool m_load_balancing = false;
+		size_t m_load_balancing_slowdown = 1;
 	};
 
 } // namespace detail
@@ -15,6 +15,17 @@ namespace debug {
 		return detail::get_buffer_name(buff);
 	}
 
+	using buffer_memory_statistics = detail::buffer_memory_statistics;
+
+	/**
+	 * Returns the current and peak memory footprint of the local backing allocations of @p buff on host and device, as well as of staging memory and
+	 * incoming data transfers.
+	 */
+	template <typename DataT, int Dims>
+	buffer_memory_statistics get_buffer_memory_statistics(const celerity::buffer<DataT, Dims>& buff) {
+		return detail::runtime::get_instance().get_buffer_manager().get_memory_statistics(detail::get_buffer_id(buff));
+	}
+
 	inline void set_task_name(celerity::handler& cgh, const std::string& debug_name) { detail::set_task_name(cgh, debug_name); }
 } // namespace debug
 } // namespace celerity
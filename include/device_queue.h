@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <type_traits>
 #include <variant>
@@ -74,7 +75,7 @@ namespace detail {
 			}
 			if(ptr == nullptr) {
 				throw allocation_error(fmt::format("Allocation of {} bytes failed; likely out of memory. Currently allocated: {} out of {} bytes.",
-				    count * sizeof(T), m_global_mem_allocated_bytes, m_global_mem_total_size_bytes));
+				    count * sizeof(T), m_global_mem_allocated_bytes.load(), m_global_mem_total_size_bytes));
 			}
 			m_global_mem_allocated_bytes += size_bytes;
 			return device_allocation{ptr, size_bytes};
@@ -110,7 +111,7 @@ namespace detail {
 
 	  private:
 		size_t m_global_mem_total_size_bytes = 0;
-		size_t m_global_mem_allocated_bytes = 0;
+		std::atomic<size_t> m_global_mem_allocated_bytes = 0; // buffers may be allocated concurrently (see buffer_manager)
 		std::unique_ptr<cl::sycl::queue> m_sycl_queue;
 		bool m_device_profiling_enabled = false;
 
@@ -130,3 +130,29 @@ class distr_queue {
 };
 
 } // namespace celerity
+
+namespace celerity::experimental {
+
+/**
+ * Starts recording the command groups submitted to the queue until `end_capture` is called, typically one iteration of a time-stepping loop.
+ * Fences and `slow_full_sync` are not recorded. Command groups must be copyable to be captured.
+ */
+inline void begin_capture(distr_queue& /* q */) { detail::runtime::get_instance().get_task_manager().begin_capture(); }
+
+/**
+ * Finishes the capture started by `begin_capture`, replacing any previously captured command groups.
+ */
+inline void end_capture(distr_queue& /* q */) { detail::runtime::get_instance().get_task_manager().end_capture(); }
+
+/**
+ * Submits copies of the captured command groups again, `num_iterations` times in a row. This is equivalent to submitting them manually, but allows the
+ * runtime to re-use the range mapper results of earlier iterations when generating commands. Results are only re-used for tasks whose accesses all use
+ * built-in range mappers (`one_to_one`, `neighborhood`, `fixed`, `slice` and `all`) with the same parameters as before, so changes to parameters captured
+ * by reference are always observed. Custom range mappers are evaluated again for every replayed task.
+ *
+ * Replayed tasks still go through dependency analysis and command generation like any other task, and all buffer state is updated as usual. Captured
+ * command groups must not refer to state that is expected to change between iterations, such as loop variables captured by value.
+ */
+inline void replay(distr_queue& /* q */, const size_t num_iterations) { detail::runtime::get_instance().get_task_manager().replay_capture(num_iterations); }
+
+} // namespace celerity::experimental
@@ -1,10 +1,12 @@
 #pragma once
 
-#include <bitset>
+#include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include "command_graph.h"
+#include "node_set.h"
 #include "ranges.h"
 #include "region_map.h"
 #include "types.h"
@@ -17,10 +19,6 @@ class abstract_command;
 class task_recorder;
 class command_recorder;
 
-// TODO: Make compile-time configurable
-constexpr size_t max_num_nodes = 256;
-using node_bitset = std::bitset<max_num_nodes>;
-
 /**
  * write_command_state is a command_id with two bits of additional information:
  *   - Whether the data written by this command is globally still the newest version ("fresh" or "stale")
@@ -62,11 +60,17 @@ class distributed_graph_generator {
 	inline static const write_command_state no_command = write_command_state(static_cast<command_id>(-1));
 
 	struct buffer_state {
-		buffer_state(region_map<write_command_state> lw, region_map<std::bitset<max_num_nodes>> rr)
-		    : local_last_writer(std::move(lw)), replicated_regions(std::move(rr)), pending_reduction(std::nullopt) {}
+		buffer_state(region_map<write_command_state> lw, region_map<node_set> rr, region_map<node_set> rn, const size_t elem_size)
+		    : local_last_writer(std::move(lw)), replicated_regions(std::move(rr)), resident_nodes(std::move(rn)), elem_size(elem_size),
+		      pending_reduction(std::nullopt) {}
 
 		region_map<write_command_state> local_last_writer;
-		region_map<node_bitset> replicated_regions;
+		region_map<node_set> replicated_regions;
+
+		// The nodes holding the newest version of each buffer region, as derived from the chunk assignments of previous tasks. Unlike the local last
+		// writers and replicated regions, this is identical on all nodes. Only maintained for locality-aware chunk assignment and broadcast trees.
+		region_map<node_set> resident_nodes;
+		size_t elem_size;
 
 		// When a buffer is used as the output of a reduction, we do not insert reduction_commands right away,
 		// but mark it as having a pending reduction. The final reduction will then be generated when the buffer
@@ -74,11 +78,58 @@ class distributed_graph_generator {
 		std::optional<reduction_info> pending_reduction;
 	};
 
+	using buffer_requirements_map = std::unordered_map<buffer_id, std::unordered_map<access_mode, region<3>>>;
+
+	struct mapped_requirements {
+		task_geometry geometry;
+		std::vector<std::pair<buffer_id, access_mode>> accesses;
+		std::vector<chunk<3>> chunks;
+		// Chunk requirements are evaluated on demand, since remote chunks that cannot read local data are skipped entirely
+		std::vector<buffer_requirements_map> chunk_requirements;
+		std::vector<bool> is_chunk_evaluated;
+		buffer_requirements_map global_requirements;
+		// The signature of the range mapper for each access, in order. Arbitrary range mappers can capture state by reference, so their results
+		// are only reused if all accesses use built-in range mappers with unchanged parameters.
+		std::vector<std::optional<range_mapper_signature>> signatures;
+	};
+
+	// A box read by every chunk of a task, which is forwarded along a binomial tree over the participating nodes instead of being pushed to all readers
+	// by a single node. The first node holds the data, all others receive it.
+	struct broadcast_tree {
+		buffer_id bid;
+		box<3> transferred_box;
+		std::vector<node_id> nodes;
+	};
+
+	// With fewer receivers, the node holding the data pushes to each of them directly, since a tree would only add latency.
+	constexpr static size_t min_broadcast_tree_receivers = 3;
+
   public:
 	distributed_graph_generator(
 	    const size_t num_nodes, const node_id local_nid, command_graph& cdag, const task_manager& tm, detail::command_recorder* recorder);
 
-	void add_buffer(const buffer_id bid, const int dims, const range<3>& range);
+	void add_buffer(const buffer_id bid, const int dims, const range<3>& range, const size_t elem_size);
+
+	// Sets the number of chunks per node for tasks that don't request an oversubscription factor themselves.
+	void set_oversubscription_factor(const size_t factor) {
+		assert(factor > 0);
+		m_oversubscription_factor = factor;
+	}
+
+	// Places the chunks of splittable tasks on the nodes that already hold most of their inputs, if that moves fewer bytes than the default contiguous
+	// assignment. Must be enabled before the first task is built.
+	void set_locality_aware_assignment(const bool enabled) { m_locality_aware_assignment = enabled; }
+
+	// Distributes data read by every chunk of a task along a tree of push commands, in which receivers forward what they received, instead of pushing it
+	// from a single node to all others. Must be enabled before the first task is built.
+	void set_broadcast_trees(const bool enabled) { m_broadcast_trees = enabled; }
+
+	// Splits subsequent tasks of the given kernel (identified by its debug name, see is_load_balanced_kernel) into slabs proportional to the per-node
+	// weights. Must be called identically on all nodes.
+	void set_split_weights(const std::string& kernel_name, std::vector<double> node_weights) {
+		assert(node_weights.size() == m_num_nodes);
+		m_split_weights.insert_or_assign(kernel_name, std::move(node_weights));
+	}
 
 	std::unordered_set<abstract_command*> build_task(const task& tsk);
 
@@ -99,6 +150,37 @@ class distributed_graph_generator {
 	 */
 	void generate_distributed_commands(const task& tsk);
 
+	// Evaluates the range mappers of a task for its entire global range and prepares the per-chunk evaluation. Results for tasks created from a captured
+	// command group are kept and re-used by later tasks from the same capture slot, as long as their geometry and buffer accesses are unchanged and
+	// their range mappers still map the entire task and its first chunk to the same regions.
+	mapped_requirements& get_mapped_requirements(const task& tsk, const std::vector<chunk<3>>& chunks);
+
+	const buffer_requirements_map& get_chunk_requirements(mapped_requirements& mapped, const task& tsk, const chunk<3>& chnk, size_t chunk_index);
+
+	// Bounds the kernel indices of all remote chunks that might read data this node has to push to them. Returns std::nullopt if every remote chunk
+	// needs to be inspected, e.g. because a range mapper cannot be inverted or the task participates in a reduction.
+	std::optional<box_vector<3>> get_push_candidate_bounds(const task& tsk);
+
+	// Returns the per-node split weights to use for a task, or nullptr if it is split evenly
+	const std::vector<double>* get_split_weights(const task& tsk) const;
+
+	// Returns the node each chunk is assigned to. The result only depends on state that is identical on all nodes.
+	std::vector<node_id> assign_chunks_to_nodes(const task& tsk, const std::vector<chunk<3>>& chunks, mapped_requirements& mapped);
+
+	void update_resident_nodes(const task& tsk, const std::vector<chunk<3>>& chunks, const std::vector<node_id>& chunk_nodes, mapped_requirements& mapped);
+
+	bool is_tracking_resident_nodes() const { return m_locality_aware_assignment || m_broadcast_trees; }
+
+	// Determines the broadcast trees for a task and marks their boxes as replicated, so that the nodes holding them do not push them directly. The result
+	// only depends on state that is identical on all nodes.
+	std::vector<broadcast_tree> plan_broadcast_trees(
+	    const task& tsk, const std::vector<chunk<3>>& chunks, const std::vector<node_id>& chunk_nodes, mapped_requirements& mapped);
+
+	// Generates the push commands of the local node within a broadcast tree. Must be called after the await pushes of the task have been generated,
+	// because intermediate nodes forward the data once their own await push has completed.
+	void generate_broadcast_pushes(
+	    const task& tsk, const broadcast_tree& tree, const std::vector<node_id>& chunk_nodes, std::vector<push_command*>& generated_pushes);
+
 	void generate_anti_dependencies(
 	    task_id tid, buffer_id bid, const region_map<write_command_state>& last_writers_map, const region<3>& write_req, abstract_command* write_cmd);
 
@@ -117,11 +199,15 @@ class distributed_graph_generator {
 	void prune_commands_before(const command_id epoch);
 
   private:
-	using buffer_read_map = std::unordered_map<buffer_id, region<3>>;
+	using buffer_read_map = std::unordered_map<buffer_id, shared_region<3>>;
 	using side_effect_map = std::unordered_map<host_object_id, command_id>;
 
 	size_t m_num_nodes;
 	node_id m_local_nid;
+	size_t m_oversubscription_factor = 1;
+	bool m_locality_aware_assignment = false;
+	bool m_broadcast_trees = false;
+	std::unordered_map<std::string, std::vector<double>> m_split_weights;
 	command_graph& m_cdag;
 	const task_manager& m_task_mngr;
 	std::unordered_map<buffer_id, buffer_state> m_buffer_states;
@@ -144,6 +230,10 @@ class distributed_graph_generator {
 	// Side effects on the same host object create true dependencies between task commands, so we track the last effect per host object.
 	side_effect_map m_host_object_last_effects;
 
+	// Range mapper results per capture slot, and a scratch instance for all other tasks to avoid re-allocating the maps.
+	std::unordered_map<capture_slot_id, mapped_requirements> m_captured_requirements;
+	mapped_requirements m_uncaptured_requirements;
+
 	// Generated commands will be recorded to this recorder if it is set
 	detail::command_recorder* m_recorder = nullptr;
 };
@@ -15,6 +15,7 @@ namespace detail {
 	class device_queue;
 	class task_manager;
 	class buffer_manager;
+	class load_balancer;
 
 	class duration_metric {
 	  public:
@@ -47,6 +48,9 @@ namespace detail {
 		executor(const size_t num_nodes, const node_id local_nid, host_queue& h_queue, device_queue& d_queue, task_manager& tm, buffer_manager& buffer_mngr,
 		    reduction_manager& reduction_mngr);
 
+		// Execution jobs report their execution times to the load balancer, if set. Must be called before startup().
+		void set_load_balancer(load_balancer* lb) { m_load_balancer = lb; }
+
 		void startup();
 
 		void enqueue(command_pkg&& pkg) {
@@ -67,6 +71,7 @@ namespace detail {
 		// FIXME: We currently need this for buffer locking in some jobs, which is a bit of a band-aid fix. Get rid of this at some point.
 		buffer_manager& m_buffer_mngr;
 		reduction_manager& m_reduction_mngr;
+		load_balancer* m_load_balancer = nullptr;
 		std::unique_ptr<buffer_transfer_manager> m_btm;
 		std::thread m_exec_thrd;
 		size_t m_running_device_compute_jobs = 0;
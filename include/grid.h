@@ -1,9 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
+#include <vector>
 
 #include <gch/small_vector.hpp>
 
@@ -259,6 +263,65 @@ class region {
 
 namespace celerity::detail::grid_detail {
 
+template <int Dims>
+struct shared_region_node {
+	region<Dims> value;
+	size_t hash;
+};
+
+} // namespace celerity::detail::grid_detail
+
+namespace celerity::detail {
+
+/// An immutable region that is cheap to copy and compare. Identical regions share a single allocation (hash-consing), so copying a shared_region only
+/// increments a reference count, and two shared_regions are equal iff they refer to the same allocation. Construction hashes the region and looks it up
+/// in a process-wide table, so this is meant for regions that are stored for later inspection (e.g. in commands or records) rather than computed with.
+template <int Dims>
+class shared_region {
+  public:
+	constexpr static int dimensions = Dims;
+
+	shared_region() = default;
+	shared_region(const region<Dims>& other) : shared_region(region<Dims>(other)) {}
+	shared_region(region<Dims>&& other);
+
+	const region<Dims>& get() const { return m_node != nullptr ? m_node->value : empty_region; }
+	operator const region<Dims>&() const { return get(); }
+
+	const box_vector<Dims>& get_boxes() const { return get().get_boxes(); }
+
+	bool empty() const { return m_node == nullptr; }
+
+	size_t get_hash() const { return m_node != nullptr ? m_node->hash : 0; }
+
+	friend bool operator==(const shared_region& lhs, const shared_region& rhs) { return lhs.m_node == rhs.m_node; }
+	friend bool operator!=(const shared_region& lhs, const shared_region& rhs) { return !(lhs == rhs); }
+
+	// Comparing against a plain region does not intern it
+	friend bool operator==(const shared_region& lhs, const region<Dims>& rhs) { return lhs.get() == rhs; }
+	friend bool operator==(const region<Dims>& lhs, const shared_region& rhs) { return lhs == rhs.get(); }
+	friend bool operator!=(const shared_region& lhs, const region<Dims>& rhs) { return !(lhs == rhs); }
+	friend bool operator!=(const region<Dims>& lhs, const shared_region& rhs) { return !(lhs == rhs); }
+
+  private:
+	inline static const region<Dims> empty_region;
+
+	std::shared_ptr<const grid_detail::shared_region_node<Dims>> m_node; // nullptr iff empty
+};
+
+/// Process-wide counters of all shared_region constructions, for benchmarking how many region copies are avoided.
+struct shared_region_statistics {
+	size_t num_constructions = 0;   ///< Number of shared_regions constructed from (non-empty and empty) regions
+	size_t num_allocations = 0;     ///< Number of distinct regions that were stored because no identical region was alive
+	size_t num_allocated_boxes = 0; ///< Total number of boxes in all regions that were stored
+};
+
+shared_region_statistics get_shared_region_statistics();
+
+} // namespace celerity::detail
+
+namespace celerity::detail::grid_detail {
+
 // forward-declaration for tests (explicitly instantiated)
 template <int StorageDims>
 void dissect_box(const box<StorageDims>& in_box, const std::vector<std::vector<size_t>>& cuts, box_vector<StorageDims>& out_dissected, int dim);
@@ -278,6 +341,42 @@ box_vector<Dims>&& normalize(box_vector<Dims>&& boxes) {
 	return std::move(boxes);
 }
 
+enum class region_operation { unite, intersect, subtract };
+
+// forward-declaration for tests (explicitly instantiated). region_union, region_intersection and region_difference switch to this algorithm for large operands.
+template <int Dims>
+region<Dims> sweep_region_operation(const region<Dims>& lhs, const region<Dims>& rhs, region_operation op);
+
+/// Number of boxes a box_soa compares per instruction on this CPU: 4 with AVX2, 2 with SSE4.2, or 1 on CPUs (or compilers) without vector support, in
+/// which case the region algorithms do not use box_soa at all.
+int get_box_soa_vector_width();
+
+/// A sequence of boxes in structure-of-arrays layout, i.e. with each coordinate of all boxes stored contiguously. This allows testing one box against
+/// all boxes of the sequence with vector compares (see get_box_soa_vector_width), which is the inner loop of the O(N * M) region intersection and
+/// difference algorithms. Member functions only consider the first EffectiveDims dimensions (see normalize).
+template <int Dims>
+class box_soa {
+  public:
+	box_soa() = default;
+	explicit box_soa(const box_vector<Dims>& boxes);
+
+	size_t size() const { return m_size; }
+
+	/// Appends the indices of all boxes that intersect `query` to `out_indices`, in ascending order.
+	template <int EffectiveDims>
+	void find_intersecting(const box<Dims>& query, std::vector<uint32_t>& out_indices) const;
+
+	/// Returns true if at least one of the boxes covers `query`.
+	template <int EffectiveDims>
+	bool any_covers(const box<Dims>& query) const;
+
+  private:
+	size_t m_size = 0;
+	// Boxes are asserted to not exceed size_t::max / 2 in any coordinate, so signed integers (which x86 can compare in vector registers) suffice.
+	std::array<std::vector<int64_t>, Dims> m_min;
+	std::array<std::vector<int64_t>, Dims> m_max;
+};
+
 } // namespace celerity::detail::grid_detail
 
 namespace celerity::detail {
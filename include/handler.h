@@ -53,6 +53,23 @@ namespace celerity::experimental {
 template <int Dims>
 void constrain_split(handler& cgh, const range<Dims>& constraint);
 
+/**
+ * Splits a task into `factor` chunks per node instead of one, so that the transfers required by one chunk can overlap with the execution of another.
+ * Chunks assigned to the same node are contiguous. Overrides the default factor set through `CELERITY_OVERSUBSCRIPTION`.
+ *
+ * Tasks with reductions are never oversubscribed. Split constraints take precedence, so a task might be split into fewer chunks than requested.
+ */
+void oversubscribe(handler& cgh, size_t factor);
+
+/**
+ * Selects how a task's global range is split into chunks. By default, tasks are split along their slowest dimension only, so each chunk borders at
+ * most two others. For stencils on many nodes, `split_strategy::block` splits along all dimensions instead, which reduces the size of the halo each
+ * chunk needs to exchange with its neighbors.
+ *
+ * Both strategies respect split constraints and the task granularity.
+ */
+void set_split_strategy(handler& cgh, split_strategy strategy);
+
 } // namespace celerity::experimental
 
 namespace celerity {
@@ -403,6 +420,8 @@ class handler {
 	friend void detail::add_reduction(handler& cgh, const detail::reduction_info& rinfo);
 	template <int Dims>
 	friend void experimental::constrain_split(handler& cgh, const range<Dims>& constraint);
+	friend void experimental::oversubscribe(handler& cgh, size_t factor);
+	friend void experimental::set_split_strategy(handler& cgh, experimental::split_strategy strategy);
 	friend void detail::extend_lifetime(handler& cgh, std::shared_ptr<detail::lifetime_extending_state> state);
 
 	friend void detail::set_task_name(handler& cgh, const std::string& debug_name);
@@ -418,6 +437,8 @@ class handler {
 	std::vector<std::shared_ptr<detail::lifetime_extending_state>> m_attached_state;
 	std::optional<std::string> m_usr_def_task_name;
 	range<3> m_split_constraint = detail::ones;
+	std::optional<size_t> m_oversubscription_factor;
+	experimental::split_strategy m_split_strategy = experimental::split_strategy::slab;
 
 	handler(detail::task_id tid, size_t num_collective_nodes) : m_tid(tid), m_num_collective_nodes(num_collective_nodes) {}
 
@@ -476,6 +497,17 @@ class handler {
 		m_split_constraint = detail::range_cast<3>(constraint);
 	}
 
+	void experimental_oversubscribe(const size_t factor) {
+		assert(m_task == nullptr);
+		if(factor == 0) { throw std::runtime_error("Oversubscription factor cannot be 0"); }
+		m_oversubscription_factor = factor;
+	}
+
+	void experimental_set_split_strategy(const experimental::split_strategy strategy) {
+		assert(m_task == nullptr);
+		m_split_strategy = strategy;
+	}
+
 	template <int Dims>
 	range<3> get_constrained_granularity(const range<Dims>& global_size, const range<Dims>& granularity) const {
 		range<3> result = detail::range_cast<3>(granularity);
@@ -584,9 +616,9 @@ class handler {
 			detail::cgf_diagnostics::get_instance().check<target::host_task>(kernel, m_access_map, m_non_void_side_effects_count);
 		}
 
-		auto fn = [kernel, cgid, global_range](detail::host_queue& q, const subrange<3>& execution_sr) {
+		auto fn = [kernel, cgid, global_range](detail::host_queue& q, const subrange<3>& execution_sr, const detail::numa_node_id numa_node) {
 			auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::host_task>(kernel);
-			return q.submit(cgid, [hydrated_kernel, global_range, execution_sr](MPI_Comm comm) {
+			return q.submit(cgid, numa_node, [hydrated_kernel, global_range, execution_sr](MPI_Comm comm) {
 				(void)global_range;
 				if constexpr(Dims > 0) {
 					if constexpr(Collective) {
@@ -616,6 +648,8 @@ class handler {
 		for(auto state : m_attached_state) {
 			m_task->extend_lifetime(std::move(state));
 		}
+		if(m_oversubscription_factor.has_value()) { m_task->set_oversubscription_factor(*m_oversubscription_factor); }
+		m_task->set_split_strategy(m_split_strategy);
 		return std::move(m_task);
 	}
 };
@@ -695,4 +729,8 @@ template <int Dims>
 void constrain_split(handler& cgh, const range<Dims>& constraint) {
 	cgh.experimental_constrain_split(constraint);
 }
+
+inline void oversubscribe(handler& cgh, const size_t factor) { cgh.experimental_oversubscribe(factor); }
+
+inline void set_split_strategy(handler& cgh, const split_strategy strategy) { cgh.experimental_set_split_strategy(strategy); }
 } // namespace celerity::experimental
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <CL/sycl.hpp>
 
@@ -12,6 +13,7 @@
 #include "config.h"
 #include "log.h"
 #include "named_threads.h"
+#include "numa.h"
 #include "types.h"
 
 namespace celerity {
@@ -113,9 +115,36 @@ namespace detail {
 			time_point end_time{};
 		};
 
-		host_queue() {
+		/**
+		 * @param numa_placement If the process spans multiple NUMA nodes, create a separate non-collective thread pool pinned to each node
+		 *                       (see submit(collective_group_id, numa_node_id, Fn&&)).
+		 */
+		explicit host_queue(const bool numa_placement = false) {
 			// TODO what is a good thread count for the non-collective thread pool?
 			m_threads.emplace(std::piecewise_construct, std::tuple{0}, std::tuple{MPI_COMM_NULL, 4, m_id++});
+
+			const auto& topology = get_numa_topology();
+			if(numa_placement && topology.get_num_nodes() > 1) {
+				for(numa_node_id node = 0; node < topology.get_num_nodes(); ++node) {
+					m_numa_threads.push_back(std::make_unique<comm_thread>(MPI_COMM_NULL, 4, m_id++));
+					for(int i = 0; i < m_numa_threads.back()->pool.size(); ++i) {
+						pin_thread_to_numa_node(m_numa_threads.back()->pool.get_thread(i).native_handle(), topology, node);
+					}
+				}
+			}
+		}
+
+		/**
+		 * Returns the number of NUMA nodes host tasks can be placed on, or 0 if NUMA placement is disabled.
+		 */
+		size_t get_num_numa_nodes() const { return m_numa_threads.size(); }
+
+		/**
+		 * Returns the next NUMA node in round-robin order, for distributing host tasks that have no preference. Called by executor thread.
+		 */
+		numa_node_id get_next_numa_node() {
+			if(m_numa_threads.empty()) return no_numa_node;
+			return static_cast<numa_node_id>(m_next_numa_node++ % m_numa_threads.size());
 		}
 
 		void require_collective_group(collective_group_id cgid) {
@@ -135,8 +164,18 @@ namespace detail {
 
 		template <typename Fn>
 		std::future<execution_info> submit(collective_group_id cgid, Fn&& fn) {
+			return submit(cgid, no_numa_node, std::forward<Fn>(fn));
+		}
+
+		/**
+		 * Submits a host task, running it on a thread pinned to NUMA node @p numa_node if NUMA placement is enabled. Collective host tasks
+		 * always run on the thread of their collective group.
+		 */
+		template <typename Fn>
+		std::future<execution_info> submit(collective_group_id cgid, numa_node_id numa_node, Fn&& fn) {
 			const std::lock_guard lock(m_mutex); // called by executor thread
-			auto& [comm, pool] = m_threads.at(cgid);
+			const bool use_numa_pool = cgid == 0 && numa_node != no_numa_node && numa_node < m_numa_threads.size();
+			auto& [comm, pool] = use_numa_pool ? *m_numa_threads[numa_node] : m_threads.at(cgid);
 			return pool.push([fn = std::forward<Fn>(fn), submit_time = std::chrono::steady_clock::now(), comm = comm](int) {
 				auto start_time = std::chrono::steady_clock::now();
 				try {
@@ -157,6 +196,9 @@ namespace detail {
 			for(auto& [_, ct] : m_threads) {
 				ct.pool.stop(true /* isWait */);
 			}
+			for(auto& ct : m_numa_threads) {
+				ct->pool.stop(true /* isWait */);
+			}
 		}
 
 	  private:
@@ -174,6 +216,8 @@ namespace detail {
 
 		std::mutex m_mutex;
 		std::unordered_map<collective_group_id, comm_thread> m_threads;
+		std::vector<std::unique_ptr<comm_thread>> m_numa_threads; // indexed by numa_node_id, empty if NUMA placement is disabled
+		size_t m_next_numa_node = 0;
 		size_t m_id = 0;
 	};
 
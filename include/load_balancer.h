@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <mpi.h>
+
+namespace celerity::detail {
+
+// Total number of work items and execution time of all chunks of a kernel executed on one node
+struct kernel_throughput {
+	size_t work_items = 0;
+	std::chrono::nanoseconds duration{0};
+};
+
+using kernel_throughput_map = std::unordered_map<std::string, kernel_throughput>;
+
+/**
+ * Kernels are identified across nodes by the debug name of their task. Host tasks without a name set through `debug::set_task_name` and unnamed device
+ * kernels share their name with unrelated kernels, so they are neither measured nor balanced.
+ */
+bool is_load_balanced_kernel(const std::string& kernel_name);
+
+/**
+ * Computes per-node split weights proportional to the throughput each node achieved for a kernel. Kernels that have not been measured on all nodes
+ * are omitted, since we cannot tell how fast the remaining nodes would be.
+ */
+std::unordered_map<std::string, std::vector<double>> compute_split_weights(const std::vector<kernel_throughput_map>& throughput_per_node);
+
+/**
+ * Collects the execution times of kernels on the local node, which the scheduler exchanges with all other nodes at horizons. Since every node
+ * receives the same measurements, all nodes derive the same split weights for subsequent instances of each kernel.
+ *
+ * Exchanges do not block the scheduler thread: the measurements sent at one horizon are received and applied at the next one. This relies on horizons
+ * being placed identically on all nodes, which also holds with asynchronous dependency analysis (see task_manager::async_horizon_delay).
+ */
+class load_balancer {
+  public:
+	/**
+	 * With a @p slowdown factor greater than 1, kernels take that many times longer to complete than they actually would. This simulates a slower node
+	 * on homogeneous hardware.
+	 */
+	explicit load_balancer(const double slowdown = 1.0) : m_slowdown(slowdown) {}
+
+	load_balancer(const load_balancer&) = delete;
+	load_balancer& operator=(const load_balancer&) = delete;
+
+	~load_balancer();
+
+	double get_slowdown() const { return m_slowdown; }
+
+	/**
+	 * Called by executor thread.
+	 */
+	void record_execution(const std::string& kernel_name, size_t work_items, std::chrono::nanoseconds duration);
+
+	/**
+	 * Called by scheduler thread for every task in submission order. Only registered kernels are exchanged, and since all nodes register the same kernels
+	 * in the same order, they can be identified by their index instead of their name.
+	 */
+	void register_kernel(const std::string& kernel_name);
+
+	/**
+	 * Called by scheduler thread. This is a collective operation, so all nodes must call it at the same point in the task sequence.
+	 *
+	 * Starts exchanging the throughput measured since the previous call without waiting for the other nodes, and returns the split weights resulting from
+	 * the exchange started by the previous call.
+	 */
+	std::unordered_map<std::string, std::vector<double>> exchange();
+
+  private:
+	struct exchanged_throughput {
+		uint64_t work_items = 0;
+		int64_t duration_ns = 0;
+	};
+
+	double m_slowdown;
+	// Only created on the first exchange, since slowdowns are also supported without load balancing
+	std::optional<MPI_Comm> m_comm;
+
+	std::mutex m_mutex;
+	kernel_throughput_map m_local_throughput; // since the last exchange
+
+	std::vector<std::string> m_kernel_names; // in registration order
+	std::unordered_set<std::string> m_registered_kernels;
+
+	// The exchange in flight and its buffers, which must not be touched until it has completed
+	std::optional<MPI_Request> m_pending_exchange;
+	size_t m_num_exchanged_kernels = 0;
+	std::vector<exchanged_throughput> m_send_buf;
+	std::vector<exchanged_throughput> m_recv_buf;
+};
+
+} // namespace celerity::detail
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace celerity {
+namespace detail {
+
+	enum class mapped_access_advice {
+		normal,     ///< no particular access pattern
+		sequential, ///< pages will be accessed in ascending order, read-ahead aggressively
+		will_need,  ///< pages will be accessed in the near future, start paging them in
+		dont_need,  ///< pages will not be accessed in the near future and may be written back and evicted
+	};
+
+	/**
+	 * A read-write memory mapping of a temporary scratch file, used as backing memory for out-of-core host buffers.
+	 *
+	 * The scratch file is removed from the file system as early as possible, so its storage is reclaimed by the OS once the mapping is released,
+	 * even if the process terminates abnormally. Since the mapping is backed by a file and not by swap space, the OS can write back and evict
+	 * pages under memory pressure, which allows the mapping to exceed the physical memory of a node (at the cost of disk bandwidth).
+	 */
+	class scratch_file_mapping {
+	  public:
+		/**
+		 * Creates and maps a zero-initialized scratch file of @p size_bytes bytes in @p directory, or the system's temporary directory if
+		 * @p directory is empty. Throws a std::runtime_error if the file cannot be created or mapped.
+		 */
+		scratch_file_mapping(const std::string& directory, size_t size_bytes);
+
+		scratch_file_mapping(const scratch_file_mapping&) = delete;
+		scratch_file_mapping(scratch_file_mapping&& other) noexcept
+		    : m_ptr(std::exchange(other.m_ptr, nullptr)), m_size_bytes(std::exchange(other.m_size_bytes, 0)) {}
+		scratch_file_mapping& operator=(const scratch_file_mapping&) = delete;
+		scratch_file_mapping& operator=(scratch_file_mapping&& other) noexcept {
+			if(this != &other) {
+				release();
+				m_ptr = std::exchange(other.m_ptr, nullptr);
+				m_size_bytes = std::exchange(other.m_size_bytes, 0);
+			}
+			return *this;
+		}
+
+		~scratch_file_mapping() { release(); }
+
+		void* get_pointer() const { return m_ptr; }
+
+		size_t get_size() const { return m_size_bytes; }
+
+		/**
+		 * Informs the OS about the expected access pattern for the byte range [offset, offset + size_bytes) of the mapping.
+		 * Advice is best-effort and is silently ignored where the platform does not support it.
+		 */
+		void advise(size_t offset, size_t size_bytes, mapped_access_advice advice) const;
+
+	  private:
+		void* m_ptr = nullptr;
+		size_t m_size_bytes = 0;
+
+		void release() noexcept;
+	};
+
+} // namespace detail
+} // namespace celerity
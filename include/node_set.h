@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "types.h"
+
+namespace celerity::detail {
+
+namespace node_set_detail {
+	struct shared_words;
+}
+
+/**
+ * A set of node ids that is cheap to copy and compare, for use as a region_map value. Sets containing only nodes below inline_capacity are stored in
+ * place within a single machine word. Larger sets refer to an immutable, reference-counted bit vector, of which identical ones share a single allocation
+ * (hash-consing), so the number of nodes is only bounded by memory. Either way, two node_sets are equal iff their representations are.
+ */
+class node_set {
+  public:
+	constexpr static size_t inline_capacity = sizeof(uintptr_t) * 8 - 1;
+
+	node_set() = default;
+	explicit node_set(const std::vector<node_id>& nodes);
+
+	node_set(const node_set& other);
+	node_set(node_set&& other) noexcept : m_repr(other.m_repr) { other.m_repr = inline_tag; }
+	node_set& operator=(const node_set& other);
+	node_set& operator=(node_set&& other) noexcept;
+	~node_set();
+
+	// The set of nodes 0 to num_nodes - 1
+	static node_set all(size_t num_nodes);
+
+	bool test(node_id nid) const;
+
+	bool none() const { return m_repr == inline_tag; }
+
+	size_t count() const;
+
+	node_set& set(node_id nid);
+
+	friend node_set operator|(const node_set& lhs, const node_set& rhs);
+
+	friend bool operator==(const node_set& lhs, const node_set& rhs) { return lhs.m_repr == rhs.m_repr; }
+	friend bool operator!=(const node_set& lhs, const node_set& rhs) { return !(lhs == rhs); }
+
+  private:
+	// The lowest bit is set for inline sets, which store node i in bit i + 1. Pointers to shared words are aligned, so their lowest bit is clear.
+	constexpr static uintptr_t inline_tag = 1;
+
+	uintptr_t m_repr = inline_tag;
+
+	bool is_inline() const { return (m_repr & inline_tag) != 0; }
+	const node_set_detail::shared_words& get_shared() const { return *reinterpret_cast<const node_set_detail::shared_words*>(m_repr); }
+
+	// Bit i of word w is node w * 64 + i, regardless of the representation
+	std::vector<uint64_t> get_words() const;
+	static node_set from_words(std::vector<uint64_t>&& words);
+};
+
+/// Process-wide counters of the shared bit vectors of large node_sets, for benchmarking their memory footprint.
+struct node_set_statistics {
+	size_t num_allocations = 0;   ///< Number of distinct bit vectors that were allocated because no identical one was alive
+	size_t num_live_sets = 0;     ///< Number of bit vectors currently alive
+	size_t num_live_bytes = 0;    ///< Total size of all bit vectors currently alive
+};
+
+node_set_statistics get_node_set_statistics();
+
+} // namespace celerity::detail
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace celerity {
+namespace detail {
+
+	/// Dense index into numa_topology::nodes (not necessarily the OS node number).
+	using numa_node_id = uint32_t;
+
+	constexpr numa_node_id no_numa_node = std::numeric_limits<numa_node_id>::max();
+
+	struct numa_node {
+		uint32_t os_index;           ///< node number as used by the operating system
+		std::vector<uint32_t> cores; ///< logical cores of this node that are available to the process
+	};
+
+	/**
+	 * The NUMA nodes of the system that have cores available to this process. Memory-only nodes and nodes whose cores are all excluded by the
+	 * process affinity mask are omitted, so a process that has been bound to a single socket (e.g. by the MPI launcher) sees a single node.
+	 */
+	struct numa_topology {
+		std::vector<numa_node> nodes;
+
+		size_t get_num_nodes() const { return nodes.size(); }
+	};
+
+	/**
+	 * Queries the NUMA topology from the operating system. Falls back to a single node containing all available cores if the topology cannot be
+	 * determined.
+	 */
+	numa_topology discover_numa_topology();
+
+	/**
+	 * Returns the topology discovered on first use.
+	 */
+	inline const numa_topology& get_numa_topology() {
+		static const numa_topology topology = discover_numa_topology();
+		return topology;
+	}
+
+	/**
+	 * Restricts the thread to the cores of NUMA node @p node. Best-effort, failures are logged but not reported.
+	 */
+	void pin_thread_to_numa_node(const std::thread::native_handle_type thread_handle, const numa_topology& topology, numa_node_id node);
+
+	/**
+	 * Asks the OS to place pages of [ptr, ptr + size_bytes) that have not yet been touched on NUMA node @p node. Only whole pages inside the
+	 * range are affected. Best-effort, this is a no-op where the platform does not support it.
+	 */
+	void bind_memory_to_numa_node(void* ptr, size_t size_bytes, const numa_topology& topology, numa_node_id node);
+
+} // namespace detail
+} // namespace celerity
@@ -50,6 +50,13 @@ struct fmt::formatter<celerity::detail::region<Dims>> : fmt::formatter<celerity:
 	}
 };
 
+template <int Dims>
+struct fmt::formatter<celerity::detail::shared_region<Dims>> : fmt::formatter<celerity::detail::region<Dims>> {
+	format_context::iterator format(const celerity::detail::shared_region<Dims>& region, format_context& ctx) const {
+		return formatter<celerity::detail::region<Dims>>::format(region.get(), ctx);
+	}
+};
+
 template <int Dims>
 struct fmt::formatter<celerity::subrange<Dims>> : fmt::formatter<celerity::id<Dims>> {
 	format_context::iterator format(const celerity::subrange<Dims>& sr, format_context& ctx) const {
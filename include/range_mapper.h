@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
+#include <optional>
 #include <stdexcept>
 #include <type_traits>
+#include <typeindex>
 
 #include <CL/sycl.hpp>
 #include <spdlog/fmt/fmt.h>
 
+#include "grid.h"
 #include "ranges.h"
 
 namespace celerity {
@@ -75,6 +79,39 @@ namespace detail {
 		return clamp_subrange_to_buffer_size(sr, buffer_size);
 	}
 
+	/**
+	 * Bounds the preimage of a range mapper, i.e. the set of kernel indices whose requirement can intersect a given buffer box. Only built-in range
+	 * mappers whose requirements are monotonic in the chunk have a preimage, arbitrary functors need to be evaluated for every chunk.
+	 */
+	template <typename Functor>
+	struct range_mapper_preimage {
+		static std::optional<box<3>> get_bounds(const Functor& /* rmfn */, const box<3>& /* buffer_box */, const box<3>& /* kernel_box */) {
+			return std::nullopt;
+		}
+	};
+
+	/**
+	 * Identifies a built-in range mapper by its type and parameters, so that the range mappers of two tasks can be compared by value.
+	 */
+	struct range_mapper_signature {
+		std::type_index functor;
+		std::array<size_t, 6> parameters{};
+
+		friend bool operator==(const range_mapper_signature& lhs, const range_mapper_signature& rhs) {
+			return lhs.functor == rhs.functor && lhs.parameters == rhs.parameters;
+		}
+		friend bool operator!=(const range_mapper_signature& lhs, const range_mapper_signature& rhs) { return !(lhs == rhs); }
+	};
+
+	/**
+	 * Built-in range mappers are pure functions of their parameters. Arbitrary functors have no signature, since they can capture state by reference
+	 * and map the same chunk differently every time they are invoked.
+	 */
+	template <typename Functor>
+	struct range_mapper_parameters {
+		static std::optional<range_mapper_signature> get_signature(const Functor& /* rmfn */) { return std::nullopt; }
+	};
+
 	class range_mapper_base {
 	  public:
 		explicit range_mapper_base(cl::sycl::access::mode am) : m_access_mode(am) {}
@@ -98,6 +135,12 @@ namespace detail {
 		virtual subrange<3> map_3(const chunk<2>& chnk) const = 0;
 		virtual subrange<3> map_3(const chunk<3>& chnk) const = 0;
 
+		// Returns a box within kernel_box that contains all kernel indices whose requirement can intersect buffer_box, or std::nullopt if unknown.
+		virtual std::optional<box<3>> get_preimage_bounds(const box<3>& buffer_box, const box<3>& kernel_box) const = 0;
+
+		// Returns the signature of a built-in range mapper, or std::nullopt if the range mapper cannot be compared by value.
+		virtual std::optional<range_mapper_signature> get_signature() const = 0;
+
 		virtual ~range_mapper_base() = default;
 
 	  private:
@@ -125,6 +168,12 @@ namespace detail {
 		subrange<3> map_3(const chunk<2>& chnk) const override { return map<3>(chnk); }
 		subrange<3> map_3(const chunk<3>& chnk) const override { return map<3>(chnk); }
 
+		std::optional<box<3>> get_preimage_bounds(const box<3>& buffer_box, const box<3>& kernel_box) const override {
+			return range_mapper_preimage<Functor>::get_bounds(m_rmfn, buffer_box, kernel_box);
+		}
+
+		std::optional<range_mapper_signature> get_signature() const override { return range_mapper_parameters<Functor>::get_signature(m_rmfn); }
+
 	  private:
 		Functor m_rmfn;
 		range<BufferDims> m_buffer_size;
@@ -164,6 +213,11 @@ namespace access {
 		}
 
 	  private:
+		template <typename>
+		friend struct detail::range_mapper_preimage;
+		template <typename>
+		friend struct detail::range_mapper_parameters;
+
 		subrange<BufferDims> m_sr;
 	};
 
@@ -179,6 +233,11 @@ namespace access {
 		}
 
 	  private:
+		template <typename>
+		friend struct detail::range_mapper_preimage;
+		template <typename>
+		friend struct detail::range_mapper_parameters;
+
 		size_t m_dim_idx;
 	};
 
@@ -209,6 +268,11 @@ namespace access {
 		}
 
 	  private:
+		template <typename>
+		friend struct detail::range_mapper_preimage;
+		template <typename>
+		friend struct detail::range_mapper_parameters;
+
 		size_t m_dim0, m_dim1, m_dim2;
 	};
 
@@ -218,6 +282,97 @@ namespace access {
 
 } // namespace access
 
+namespace detail {
+
+	template <>
+	struct range_mapper_preimage<celerity::access::one_to_one> {
+		static std::optional<box<3>> get_bounds(const celerity::access::one_to_one& /* rmfn */, const box<3>& buffer_box, const box<3>& kernel_box) {
+			return box_intersection(buffer_box, kernel_box);
+		}
+	};
+
+	template <int BufferDims>
+	struct range_mapper_preimage<celerity::access::fixed<BufferDims>> {
+		static std::optional<box<3>> get_bounds(const celerity::access::fixed<BufferDims>& rmfn, const box<3>& buffer_box, const box<3>& kernel_box) {
+			if(box_intersection(box<3>(subrange_cast<3>(rmfn.m_sr)), buffer_box).empty()) return box<3>();
+			return kernel_box;
+		}
+	};
+
+	template <int Dims>
+	struct range_mapper_preimage<celerity::access::slice<Dims>> {
+		static std::optional<box<3>> get_bounds(const celerity::access::slice<Dims>& rmfn, const box<3>& buffer_box, const box<3>& kernel_box) {
+			if(buffer_box.empty()) return box<3>();
+			// Every index along the sliced dimension requires the entire buffer extent in that dimension
+			auto min = buffer_box.get_min();
+			auto max = buffer_box.get_max();
+			min[rmfn.m_dim_idx] = kernel_box.get_min()[rmfn.m_dim_idx];
+			max[rmfn.m_dim_idx] = kernel_box.get_max()[rmfn.m_dim_idx];
+			return box_intersection(box<3>(min, max), kernel_box);
+		}
+	};
+
+	template <>
+	struct range_mapper_preimage<celerity::access::all> {
+		static std::optional<box<3>> get_bounds(const celerity::access::all& /* rmfn */, const box<3>& buffer_box, const box<3>& kernel_box) {
+			return buffer_box.empty() ? box<3>() : kernel_box;
+		}
+	};
+
+	template <int Dims>
+	struct range_mapper_preimage<celerity::access::neighborhood<Dims>> {
+		static std::optional<box<3>> get_bounds(const celerity::access::neighborhood<Dims>& rmfn, const box<3>& buffer_box, const box<3>& kernel_box) {
+			if(buffer_box.empty()) return box<3>();
+			// An index requires its neighbors, so it is required by its neighbors in turn
+			const id<3> border{rmfn.m_dim0, rmfn.m_dim1, rmfn.m_dim2};
+			auto min = buffer_box.get_min();
+			auto max = buffer_box.get_max();
+			for(int d = 0; d < 3; ++d) {
+				min[d] = min[d] > border[d] ? min[d] - border[d] : 0;
+				max[d] += border[d];
+			}
+			return box_intersection(box<3>(min, max), kernel_box);
+		}
+	};
+
+	template <>
+	struct range_mapper_parameters<celerity::access::one_to_one> {
+		static std::optional<range_mapper_signature> get_signature(const celerity::access::one_to_one& /* rmfn */) {
+			return range_mapper_signature{typeid(celerity::access::one_to_one)};
+		}
+	};
+
+	template <int BufferDims>
+	struct range_mapper_parameters<celerity::access::fixed<BufferDims>> {
+		static std::optional<range_mapper_signature> get_signature(const celerity::access::fixed<BufferDims>& rmfn) {
+			const auto sr = subrange_cast<3>(rmfn.m_sr);
+			return range_mapper_signature{typeid(rmfn), {sr.offset[0], sr.offset[1], sr.offset[2], sr.range[0], sr.range[1], sr.range[2]}};
+		}
+	};
+
+	template <int Dims>
+	struct range_mapper_parameters<celerity::access::slice<Dims>> {
+		static std::optional<range_mapper_signature> get_signature(const celerity::access::slice<Dims>& rmfn) {
+			return range_mapper_signature{typeid(rmfn), {rmfn.m_dim_idx}};
+		}
+	};
+
+	template <>
+	struct range_mapper_parameters<celerity::access::all> {
+		static std::optional<range_mapper_signature> get_signature(const celerity::access::all& /* rmfn */) {
+			return range_mapper_signature{typeid(celerity::access::all)};
+		}
+	};
+
+	template <int Dims>
+	struct range_mapper_parameters<celerity::access::neighborhood<Dims>> {
+		static std::optional<range_mapper_signature> get_signature(const celerity::access::neighborhood<Dims>& rmfn) {
+			return range_mapper_signature{typeid(rmfn), {rmfn.m_dim0, rmfn.m_dim1, rmfn.m_dim2}};
+		}
+	};
+
+} // namespace detail
+
 namespace experimental::access {
 
 	/**
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <numeric>
@@ -9,32 +15,81 @@
 #include <variant>
 #include <vector>
 
+#include <gch/small_vector.hpp>
 #include <spdlog/fmt/fmt.h>
 
 #include "grid.h"
 #include "utils.h"
 
-// Some toggles that affect performance (but also change the behavior!)
-// TODO: Consider making these template arguments instead (inside some config object), and add these:
-// - Preferred merge dimension
-// - In-place updates
-// - Localized updates
-// - Min/max children
-// - Linear vs quadratic split
-#define CELERITY_DETAIL_REGION_MAP_MERGE_ON_UPDATE 1
-#define CELERITY_DETAIL_REGION_MAP_CLAMP_RESULTS_TO_REQUEST_BOUNDARY 1
-#define CELERITY_DETAIL_REGION_MAP_MERGE_RESULTS 1
-#define CELERITY_DETAIL_REGION_MAP_USE_QUADRATIC_ASSIGNMENT_ON_INSERT 1
-
 namespace celerity::detail {
 
 struct region_map_testspy;
 
-namespace region_map_detail {
+/**
+ * How the children of an overfull region_map node are distributed between the two nodes that replace it.
+ */
+enum class region_map_split_algorithm {
+	/// Pick the two children that would waste the most area together as seeds, then assign all others in order to the node that grows least.
+	linear,
+	/// Pick seeds like `linear`, then repeatedly assign the child that grows either node least [Guttman 1984].
+	quadratic,
+	/// Sort children along the axis with the smallest sum of margins and split where the two nodes overlap least [Beckmann 1990].
+	rstar,
+};
+
+/**
+ * Tuning parameters of a region_map. A policy is a struct with the static members below; derive from this one to override individual parameters.
+ * See test/region_map_benchmarks.cc for how policies compare on the access patterns of the runtime.
+ */
+struct region_map_default_policy {
+	/// Maximum number of children (entries or subtrees) per node.
+	static constexpr size_t max_children = 8;
+
+	/// Nodes with fewer children are dissolved after an erase, and their children are reinserted.
+	static constexpr size_t min_children = 2;
+
+	/// How leaf nodes are split. Inner nodes are split linearly, unless this is `rstar`.
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::quadratic;
+
+	/// When an insertion overflows a non-root leaf, this many of its entries (those furthest from its center) are removed and reinserted from the root
+	/// instead of splitting it, which gives them a chance to end up in a better fitting leaf ("forced reinsertion" [Beckmann 1990]). 0 always splits.
+	static constexpr size_t forced_reinsert_count = 0;
+
+	/// Whether an insertion that grows several subtrees by the same area descends into the smallest one [Guttman 1984] rather than the first one.
+	static constexpr bool break_insertion_ties_by_area = false;
+
+	/// Whether updated entries are merged with equal-valued neighbors. Keeps the tree small at the cost of more expensive updates.
+	static constexpr bool merge_on_update = true;
+
+	/// Whether query results are clamped to the requested box.
+	static constexpr bool clamp_results_to_request_boundary = true;
+
+	/// Whether equal-valued query results are merged where possible.
+	static constexpr bool merge_results = true;
+
+	/// Whether 1-dimensional maps are stored as a sorted vector of intervals instead of an R-tree. None of the tree parameters above apply to it.
+	static constexpr bool use_interval_map_for_1d = true;
+};
+
+/**
+ * Counters for the node storage of a single region map.
+ */
+struct region_map_allocation_statistics {
+	size_t num_slab_allocations = 0; ///< heap allocations made for node storage
+	size_t num_node_allocations = 0; ///< nodes created over the lifetime of the map, including those that reused freed storage
+	size_t peak_live_nodes = 0;
+};
+
+/**
+ * Counters for the query cache of a single region map, see region_map::enable_query_cache.
+ */
+struct region_map_query_cache_statistics {
+	size_t num_hits = 0;          ///< queries answered from the cache as-is
+	size_t num_revalidations = 0; ///< queries answered from the cache after re-reading values that were updated in place
+	size_t num_misses = 0;        ///< queries that had to traverse the tree
+};
 
-	// TODO PERF: Do some experiments with these
-	constexpr size_t max_children = 8;
-	constexpr size_t min_children = 2;
+namespace region_map_detail {
 
 	template <int D, int Dims>
 	bool is_lo_inside(const box<Dims>& a, const box<Dims>& b) {
@@ -56,22 +111,62 @@ namespace region_map_detail {
 
 	template <int Dims>
 	box<Dims> compute_bounding_box(const box<Dims>& a, const box<Dims>& b) {
-		const auto min_a = a.get_min();
-		const auto min_b = b.get_min();
-		const auto max_a = a.get_max();
-		const auto max_b = b.get_max();
-		auto new_min = min_a;
-		auto new_max = max_a;
+		return {id_min(a.get_min(), b.get_min()), id_max(a.get_max(), b.get_max())};
+	}
+
+	/**
+	 * Calculates whether two boxes can be merged. In order to be mergeable, the two boxes
+	 * have to touch in one dimension and match exactly in all remaining dimensions.
+	 */
+	template <int Dims>
+	bool can_merge(const box<Dims>& box_a, const box<Dims>& box_b) {
+		bool adjacent = false;
 		for(size_t d = 0; d < Dims; ++d) {
-			new_min[d] = std::min(min_a[d], min_b[d]);
-			new_max[d] = std::max(max_a[d], max_b[d]);
+			if(box_a.get_min()[d] != box_b.get_min()[d] || box_a.get_max()[d] != box_b.get_max()[d]) {
+				// Dimension does not match exactly, but could still be adjacent.
+				// If we already are adjacent in another dimension, we cannot merge.
+				if(!adjacent && (box_a.get_max()[d] == box_b.get_min()[d] || box_b.get_max()[d] == box_a.get_min()[d])) {
+					adjacent = true;
+				} else {
+					return false;
+				}
+			}
+		}
+
+		assert(adjacent);
+		return true;
+	}
+
+	// Invokes cb for each of the up to 2 * Dims disjoint boxes that make up the part of outer outside of hole, which must overlap outer.
+	// Splits are made in the same order as in inner_node::update_box.
+	template <int Dims, typename Callback>
+	void for_each_box_difference(const box<Dims>& outer, const box<Dims>& hole, const Callback& cb) {
+		auto min = outer.get_min();
+		auto max = outer.get_max();
+		for(int d = Dims - 1; d >= 0; --d) {
+			if(hole.get_min()[d] > min[d]) {
+				auto piece_max = max;
+				piece_max[d] = hole.get_min()[d];
+				cb(box<Dims>(min, piece_max));
+				min[d] = hole.get_min()[d];
+			}
+			if(hole.get_max()[d] < max[d]) {
+				auto piece_min = min;
+				piece_min[d] = hole.get_max()[d];
+				cb(box<Dims>(piece_min, max));
+				max[d] = hole.get_max()[d];
+			}
 		}
-		return {new_min, new_max};
 	}
 
+	// Equivalent to !box_intersection(a, b).empty(), but evaluates all dimensions without branches and without constructing the intersection.
 	template <int Dims>
 	bool do_overlap(const box<Dims>& a, const box<Dims>& b) {
-		return !box_intersection(a, b).empty();
+		bool overlap = true;
+		for(int d = 0; d < Dims; ++d) {
+			overlap &= (a.get_min()[d] < b.get_max()[d]) & (b.get_min()[d] < a.get_max()[d]);
+		}
+		return overlap;
 	}
 
 	template <int Dims>
@@ -114,7 +209,7 @@ namespace region_map_detail {
 			assert(node->m_children.size() == node->m_child_boxes.size());
 			// TODO: This can actually fail for non-root nodes as well, as we currently do not try to balance assignments.
 			// assert(node->m_children.size() >= MIN_CHILDREN || node == m_root.get());
-			assert(node->m_children.size() <= max_children);
+			assert(node->m_children.size() <= RegionMap::policy::max_children);
 
 			for(size_t i = 0; i < node->m_children.size(); ++i) {
 				if(!node->contains_leaves()) {
@@ -127,19 +222,92 @@ namespace region_map_detail {
 #endif
 	}
 
-	template <typename ValueType, int Dims>
+	template <typename ValueType, int Dims, typename Policy>
 	class inner_node;
 
+	constexpr size_t nodes_per_arena_slab = 32;
+
+	/**
+	 * Slab allocator for the nodes of a single region map. Nodes are carved out of slabs of nodes_per_arena_slab and returned to a free list when
+	 * destroyed, so a map that does not grow beyond its previous peak size no longer touches the heap for nodes. Slabs are only released
+	 * together with the arena, which must therefore outlive all of its nodes.
+	 */
+	template <typename Node>
+	class node_arena {
+	  public:
+		node_arena() = default;
+		node_arena(const node_arena&) = delete;
+		node_arena(node_arena&&) = delete;
+		node_arena& operator=(const node_arena&) = delete;
+		node_arena& operator=(node_arena&&) = delete;
+		~node_arena() { assert(m_num_live_nodes == 0); }
+
+		template <typename... Args>
+		Node* create(Args&&... args) {
+			if(m_free_list == nullptr) { allocate_slab(); }
+			slot* const s = m_free_list;
+			m_free_list = s->next;
+			Node* const node = new(s->storage) Node(std::forward<Args>(args)...);
+			++m_statistics.num_node_allocations;
+			m_statistics.peak_live_nodes = std::max(m_statistics.peak_live_nodes, ++m_num_live_nodes);
+			return node;
+		}
+
+		void destroy(Node* const node) {
+			node->~Node();
+			slot* const s = reinterpret_cast<slot*>(node);
+			s->next = m_free_list;
+			m_free_list = s;
+			--m_num_live_nodes;
+		}
+
+		const region_map_allocation_statistics& get_statistics() const { return m_statistics; }
+
+		size_t get_num_live_nodes() const { return m_num_live_nodes; }
+
+	  private:
+		union slot {
+			slot* next;
+			alignas(Node) std::byte storage[sizeof(Node)];
+		};
+
+		std::vector<std::unique_ptr<slot[]>> m_slabs;
+		slot* m_free_list = nullptr;
+		size_t m_num_live_nodes = 0;
+		region_map_allocation_statistics m_statistics;
+
+		void allocate_slab() {
+			auto& slab = m_slabs.emplace_back(new slot[nodes_per_arena_slab]);
+			for(size_t i = 0; i < nodes_per_arena_slab; ++i) {
+				slab[i].next = i + 1 < nodes_per_arena_slab ? &slab[i + 1] : m_free_list;
+			}
+			m_free_list = &slab[0];
+			++m_statistics.num_slab_allocations;
+		}
+	};
+
+	/**
+	 * Returns a node to the arena it was created from.
+	 */
+	template <typename Node>
+	struct node_deleter {
+		node_arena<Node>* arena = nullptr;
+		void operator()(Node* const node) const { arena->destroy(node); }
+	};
+
 	/**
 	 * Convenience types shared by inner_node and region_map_impl.
 	 */
-	template <typename ValueType, int Dims>
+	template <typename ValueType, int Dims, typename Policy>
 	class region_map_types {
 	  public:
 		static_assert(Dims <= 3);
+		static_assert(Policy::min_children >= 1 && Policy::min_children <= Policy::max_children / 2);
+		static_assert(Policy::min_children + Policy::forced_reinsert_count <= Policy::max_children);
 
-		using inner_node_type = inner_node<ValueType, Dims>;
-		using unique_inner_node_ptr = std::unique_ptr<inner_node_type>;
+		using inner_node_type = inner_node<ValueType, Dims, Policy>;
+		using node_arena_type = node_arena<inner_node_type>;
+		using unique_inner_node_ptr = std::unique_ptr<inner_node_type, node_deleter<inner_node_type>>;
 		using inner_node_child_type = std::variant<unique_inner_node_ptr, ValueType>;
 		using entry = std::pair<box<Dims>, ValueType>;
 
@@ -164,16 +332,21 @@ namespace region_map_detail {
 		};
 	};
 
-	template <typename ValueType, int Dims>
+	template <typename ValueType, int Dims, typename Policy>
 	class inner_node {
 		friend struct celerity::detail::region_map_testspy;
 
-		using types = region_map_types<ValueType, Dims>;
+		using types = region_map_types<ValueType, Dims, Policy>;
 
 	  public:
-		inner_node(bool contains_leaves, size_t depth) : m_depth(depth), m_contains_leaves(contains_leaves) {
-			// During splits we temporarily need to store one additional child
-			m_children.reserve(max_children + 1);
+		inner_node(typename types::node_arena_type& arena, bool contains_leaves, size_t depth)
+		    : m_arena(&arena), m_depth(depth), m_contains_leaves(contains_leaves) {}
+
+		/**
+		 * Creates a node in @p arena that returns itself there once destroyed.
+		 */
+		static typename types::unique_inner_node_ptr create(typename types::node_arena_type& arena, bool contains_leaves, size_t depth) {
+			return typename types::unique_inner_node_ptr(arena.create(arena, contains_leaves, depth), {&arena});
 		}
 
 		~inner_node() = default;
@@ -192,6 +365,11 @@ namespace region_map_detail {
 
 		size_t get_depth() const { return m_depth; }
 
+		/**
+		 * Number of levels of inner nodes in this subtree, including this node. All leaves are on the same level.
+		 */
+		size_t get_height() const { return m_contains_leaves ? 1 : 1 + get_child_node(0).get_height(); }
+
 		/**
 		 * Recursively sets depth on this node and all of its children.
 		 */
@@ -297,40 +475,96 @@ namespace region_map_detail {
 			if(actions.size() == previous_action_count) return false;
 
 			// Otherwise check whether we can perform all actions locally.
-			const size_t insert_action_count = actions.size() - previous_action_count - erase_action_count;
-			const size_t new_num_children = m_children.size() + insert_action_count - erase_action_count;
-
-			// We can only process actions locally if we have enough space for all children.
-			const bool wont_overflow = new_num_children <= max_children;
-			// However, we also must ensure that we don't end up with too few children, as we otherwise degrade tree health over time.
-			const bool wont_underflow = new_num_children >= min_children;
+			return process_actions_locally(actions, previous_action_count, erase_action_count);
+		}
 
-			if(wont_overflow && wont_underflow) {
-				// First, process all erases.
-				for(size_t i = previous_action_count; i < actions.size(); ++i) {
-					if(auto* const erase_action = std::get_if<typename types::erase_node_action>(&actions[i])) {
-						erase_action->processed_locally = true;
-						std::vector<typename types::orphan> orphans(0);
-						[[maybe_unused]] const auto did_erase = erase(erase_action->box, orphans);
-						assert(did_erase);
-						assert(orphans.empty()); // This should never happen as we are in a leaf node.
+		/**
+		 * Batched version of update_box that updates all entries intersecting any of the boxes referenced by index_stack[first, last) in a
+		 * single traversal (see query). Instead of creating a hole for each box, every affected entry is replaced by its remainder and its
+		 * intersections with the boxes. These cover exactly the space of the erased entry, so the actions can be processed locally whenever
+		 * the leaf node has room for them. Entries that match a box exactly are updated in-place and added to updated_in_place.
+		 *
+		 * @returns True if a localized update operation was performed that may require a bounding box recomputation.
+		 */
+		bool update_region(const box<Dims>* boxes, std::vector<size_t>& index_stack, const size_t first, const size_t last, const ValueType& value,
+		    std::vector<typename types::update_action>& actions, std::vector<typename types::entry>& updated_in_place) {
+			if(!m_contains_leaves) {
+				bool any_child_did_local_update = false;
+				for(size_t i = 0; i < m_children.size(); ++i) {
+					const size_t child_first = push_overlapping_indices(m_child_boxes[i], boxes, index_stack, first, last);
+					const size_t child_last = index_stack.size();
+					if(child_first != child_last) {
+						if(get_child_node(i).update_region(boxes, index_stack, child_first, child_last, value, actions, updated_in_place)) {
+							m_child_boxes[i] = get_child_node(i).get_bounding_box();
+							any_child_did_local_update = true;
+						}
 					}
+					index_stack.resize(child_first);
 				}
+				return any_child_did_local_update;
+			}
 
-				// Now, process the inserts.
-				for(size_t i = previous_action_count; i < actions.size(); ++i) {
-					if(auto* const insert_action = std::get_if<typename types::insert_node_action>(&actions[i])) {
-						insert_action->processed_locally = true;
-						assert(m_children.size() < max_children);
-						insert_child_value(insert_action->box, insert_action->value);
+			size_t erase_action_count = 0;
+			const auto previous_action_count = actions.size();
+
+			for(size_t i = 0; i < m_children.size(); ++i) {
+				const auto& child_box = m_child_boxes[i];
+				const auto& child_value = get_child_value(i);
+				const size_t overlapping_first = push_overlapping_indices(child_box, boxes, index_stack, first, last);
+				const size_t* const overlapping = index_stack.data() + overlapping_first;
+				const size_t num_overlapping = index_stack.size() - overlapping_first;
+
+				if(num_overlapping == 0 || child_value == value) {
+					// Nothing to do
+				} else if(num_overlapping == 1 && boxes[overlapping[0]] == child_box) {
+					// Exact overlap. Simply update box in-place.
+					get_child_value(i) = value;
+					updated_in_place.push_back(std::make_pair(child_box, value));
+				} else {
+					actions.push_back(typename types::erase_node_action{child_box});
+					erase_action_count++;
+
+					// Cut the overlapping boxes out of the child one after another
+					gch::small_vector<detail::box<Dims>> remainders{child_box};
+					for(size_t j = 0; j < num_overlapping; ++j) {
+						const auto& hole = boxes[overlapping[j]];
+						for(size_t k = remainders.size(); k-- > 0;) {
+							if(!do_overlap<Dims>(remainders[k], hole)) continue;
+							const auto piece = remainders[k];
+							remainders[k] = remainders.back();
+							remainders.pop_back();
+							for_each_box_difference(piece, hole, [&](const detail::box<Dims>& b) { remainders.push_back(b); });
+						}
+					}
+					// Cutting one box after another can leave adjacent pieces behind, merge these before they become candidates for the whole tree
+					for(bool did_merge = true; did_merge;) {
+						did_merge = false;
+						for(size_t k = 0; k < remainders.size() && !did_merge; ++k) {
+							for(size_t l = k + 1; l < remainders.size(); ++l) {
+								if(can_merge(remainders[k], remainders[l])) {
+									remainders[k] = compute_bounding_box(remainders[k], remainders[l]);
+									remainders[l] = remainders.back();
+									remainders.pop_back();
+									did_merge = true;
+									break;
+								}
+							}
+						}
+					}
+					for(const auto& remainder : remainders) {
+						actions.push_back(typename types::insert_node_action{remainder, child_value});
+					}
+					for(size_t j = 0; j < num_overlapping; ++j) {
+						actions.push_back(typename types::insert_node_action{box_intersection(child_box, boxes[overlapping[j]]), value});
 					}
 				}
 
-				assert(m_children.size() == new_num_children);
-				return true;
+				index_stack.resize(overlapping_first);
 			}
 
-			return false;
+			if(actions.size() == previous_action_count) return false;
+
+			return process_actions_locally(actions, previous_action_count, erase_action_count);
 		}
 
 		template <typename Functor>
@@ -357,27 +591,16 @@ namespace region_map_detail {
 		 * into a currently existing hole and does not overlap with any other box in
 		 * the subtree.
 		 *
+		 * @param reinsertions If non-null and the policy asks for forced reinsertion, an overflowing leaf moves some of its entries here instead of
+		 *                     splitting. The caller must reinsert them (with a null @p reinsertions).
 		 * @returns If the insertion caused a node to be split, the spilled node is returned.
-		 *
-		 * TODO: Structurally very similar to insert_subtree - can we DRY up?
 		 */
-		std::optional<typename types::insert_result> insert(const box<Dims>& box, const ValueType& value) {
+		std::optional<typename types::insert_result> insert(
+		    const box<Dims>& box, const ValueType& value, std::vector<typename types::entry>* const reinsertions = nullptr) {
 			if(!m_contains_leaves) {
 				// Value belongs deeper into the tree. Find child that best fits it.
-				// TODO PERF: Resolve ties in area increase according to [Guttman 1984]
-				size_t best_i = std::numeric_limits<size_t>::max();
-				size_t smallest_area_delta = std::numeric_limits<size_t>::max();
-				for(size_t i = 0; i < m_child_boxes.size(); ++i) {
-					const auto area_delta = compute_bounding_box(m_child_boxes[i], box).get_area() - m_child_boxes[i].get_area();
-					if(area_delta < smallest_area_delta) {
-						smallest_area_delta = area_delta;
-						best_i = i;
-					}
-				}
-				assert(best_i < m_children.size());
-				assert(smallest_area_delta < std::numeric_limits<size_t>::max());
-
-				auto ret = get_child_node(best_i).insert(box, value);
+				const size_t best_i = choose_subtree(box);
+				auto ret = get_child_node(best_i).insert(box, value, reinsertions);
 
 				// Bounding box of child might have changed.
 				// TODO PERF: I think we can skip this if area_delta == 0 and child was not split
@@ -394,145 +617,39 @@ namespace region_map_detail {
 			}
 
 			// Try inserting value directly, or...
-			if(m_children.size() < max_children) {
+			if(m_children.size() < Policy::max_children) {
 				insert_child_value(box, value);
 				return std::nullopt;
 			}
 
-			// ...split if we are full (include new value in split decision).
 			insert_child_value(box, value);
 
-			auto [seed1, seed2] = pick_split_seeds();
-
-			auto node1 = std::make_unique<inner_node>(true, m_depth);
-			node1->insert_child_value(m_child_boxes[seed1], std::move(std::get<ValueType>(m_children[seed1])));
-			auto node2 = std::make_unique<inner_node>(true, m_depth);
-			node2->insert_child_value(m_child_boxes[seed2], std::move(std::get<ValueType>(m_children[seed2])));
-
-// TODO PERF: Quadratic does seem to perform better at least for some scenarios (e.g. walking full tree).
-#if !CELERITY_DETAIL_REGION_MAP_USE_QUADRATIC_ASSIGNMENT_ON_INSERT
-			auto bbox1 = m_child_boxes[seed1];
-			auto bbox2 = m_child_boxes[seed2];
-			for(size_t i = 0; i < m_child_boxes.size(); ++i) {
-				if(i == seed1 || i == seed2) continue;
-
-				const auto new_bbox1 = compute_bounding_box(bbox1, m_child_boxes[i]);
-				const auto new_bbox2 = compute_bounding_box(bbox2, m_child_boxes[i]);
-
-				// Assign value to node that results in smaller area increase.
-				if((new_bbox1.area() - bbox1.area()) < (new_bbox2.area() - bbox2.area())) {
-					node1->insert_child_value(m_child_boxes[i], std::move(std::get<ValueType>(m_children[i])));
-					bbox1 = new_bbox1;
-				} else {
-					node2->insert_child_value(m_child_boxes[i], std::move(std::get<ValueType>(m_children[i])));
-					bbox2 = new_bbox2;
-				}
-			}
-#else
-			// Greedily assign all values to groups, O(N^2)
-			auto bbox1 = m_child_boxes[seed1];
-			auto bbox2 = m_child_boxes[seed2];
-			auto area1 = bbox1.get_area();
-			auto area2 = bbox2.get_area();
-			std::vector<bool> assigned(m_children.size(), false);
-			assigned[seed1] = true;
-			assigned[seed2] = true;
-			size_t num_assigned = 2;
-			while(num_assigned < m_children.size()) {
-				size_t smallest_area_delta = std::numeric_limits<size_t>::max();
-				size_t smallest_i = std::numeric_limits<size_t>::max();
-				detail::box<Dims> smallest_bbox;
-				size_t smallest_area = 0;
-				size_t target_node = 0;
-
-				for(size_t i = 0; i < m_children.size(); ++i) {
-					if(assigned[i]) continue;
-
-					const auto new_bbox1 = compute_bounding_box(m_child_boxes[i], bbox1);
-					const auto new_bbox2 = compute_bounding_box(m_child_boxes[i], bbox2);
-					const auto new_area1 = new_bbox1.get_area();
-					const auto new_area2 = new_bbox2.get_area();
-
-					const auto ad1 = (new_area1 - area1);
-					const auto ad2 = (new_area2 - area2);
-
-					if(ad1 < smallest_area_delta) {
-						smallest_area_delta = ad1;
-						smallest_i = i;
-						smallest_bbox = new_bbox1;
-						smallest_area = new_area1;
-						target_node = 1;
-					}
-					if(ad2 < smallest_area_delta) {
-						smallest_area_delta = ad2;
-						smallest_i = i;
-						smallest_bbox = new_bbox2;
-						smallest_area = new_area2;
-						target_node = 2;
-					}
-				}
-
-				assert(target_node != 0);
-				if(target_node == 1) {
-					node1->insert_child_value(m_child_boxes[smallest_i], std::move(std::get<ValueType>(m_children[smallest_i])));
-					bbox1 = smallest_bbox;
-					area1 = smallest_area;
-				} else {
-					node2->insert_child_value(m_child_boxes[smallest_i], std::move(std::get<ValueType>(m_children[smallest_i])));
-					bbox2 = smallest_bbox;
-					area2 = smallest_area;
+			// ...evict the outermost entries for reinsertion (never from the root, where they would end up again), or...
+			if constexpr(Policy::forced_reinsert_count > 0) {
+				if(reinsertions != nullptr && m_depth > 0) {
+					evict_for_reinsertion(*reinsertions);
+					return std::nullopt;
 				}
-
-				assigned[smallest_i] = true;
-				num_assigned++;
 			}
-#endif
-
-			assert(!node1->m_children.empty());
-			assert(!node2->m_children.empty());
-			assert(node1->m_children.size() <= max_children);
-			assert(node2->m_children.size() <= max_children);
-			// TODO: This is currently not guaranteed; we may want to balance insertions if area increase is a tie.
-			// assert(!node1.is_underfull());
-			// assert(!node2.is_underfull());
-
-			typename types::insert_result result{std::move(node2), bbox2};
 
-			// Replace this with node 1, return node 2
-			*this = std::move(*node1);
-			sanity_check_bounding_boxes();
-			return result;
+			// ...split if we are full (include new value in split decision).
+			return split(Policy::split_algorithm);
 		}
 
-
 		/**
 		 * Inserts the given subtree as a child into this subtree, either directly
 		 * or further down (depending on its depth).
 		 *
 		 * @returns If the insertion caused a node to be split, the spilled node is returned.
-		 *
-		 * TODO: Structurally very similar to insert - can we DRY up?
 		 */
-		std::optional<typename types::insert_result> insert_subtree(const box<Dims>& box, std::unique_ptr<inner_node<ValueType, Dims>>&& subtree) {
+		std::optional<typename types::insert_result> insert_subtree(const box<Dims>& box, typename types::unique_inner_node_ptr&& subtree) {
 			assert(!m_contains_leaves);
 			assert(subtree->m_depth > m_depth);
 
 			// Check if subtree should be inserted as child of this node.
 			if(subtree->m_depth > m_depth + 1) {
 				// Subtree belongs deeper into the tree. Find child that best fits it.
-				// TODO PERF: Resolve ties in area increase according to [Guttman 1984]
-				size_t best_i = std::numeric_limits<size_t>::max();
-				size_t smallest_area_delta = std::numeric_limits<size_t>::max();
-				for(size_t i = 0; i < m_child_boxes.size(); ++i) {
-					const auto area_delta = compute_bounding_box(m_child_boxes[i], box).get_area() - m_child_boxes[i].get_area();
-					if(area_delta < smallest_area_delta) {
-						smallest_area_delta = area_delta;
-						best_i = i;
-					}
-				}
-				assert(best_i < m_children.size());
-				assert(smallest_area_delta < std::numeric_limits<size_t>::max());
-
+				const size_t best_i = choose_subtree(box);
 				auto ret = get_child_node(best_i).insert_subtree(box, std::move(subtree));
 
 				// Bounding box of child might have changed.
@@ -550,54 +667,14 @@ namespace region_map_detail {
 			}
 
 			// Try inserting value directly, or...
-			if(m_children.size() < max_children) {
+			if(m_children.size() < Policy::max_children) {
 				insert_child_node(box, std::move(subtree));
 				return std::nullopt;
 			}
 
 			// ...split if we are full (include new value in split decision).
 			insert_child_node(box, std::move(subtree));
-
-			auto [seed1, seed2] = pick_split_seeds();
-
-			auto node1 = std::make_unique<inner_node>(false, m_depth);
-			node1->insert_child_node(m_child_boxes[seed1], std::move(std::get<std::unique_ptr<inner_node>>(m_children[seed1])));
-			auto node2 = std::make_unique<inner_node>(false, m_depth);
-			node2->insert_child_node(m_child_boxes[seed2], std::move(std::get<std::unique_ptr<inner_node>>(m_children[seed2])));
-
-			auto bbox1 = m_child_boxes[seed1];
-			auto bbox2 = m_child_boxes[seed2];
-			for(size_t i = 0; i < m_children.size(); ++i) {
-				if(i == seed1 || i == seed2) continue;
-
-				assert(get_child_node(i).m_depth == m_depth + 1); // Sanity check
-				const auto new_bbox1 = compute_bounding_box(bbox1, m_child_boxes[i]);
-				const auto new_bbox2 = compute_bounding_box(bbox2, m_child_boxes[i]);
-
-				// Assign value to node that results in smaller area increase.
-				if((new_bbox1.get_area() - bbox1.get_area()) < (new_bbox2.get_area() - bbox2.get_area())) {
-					node1->insert_child_node(m_child_boxes[i], std::move(std::get<typename types::unique_inner_node_ptr>(m_children[i])));
-					bbox1 = new_bbox1;
-				} else {
-					node2->insert_child_node(m_child_boxes[i], std::move(std::get<typename types::unique_inner_node_ptr>(m_children[i])));
-					bbox2 = new_bbox2;
-				}
-			}
-
-			assert(!node1->m_children.empty());
-			assert(!node2->m_children.empty());
-			assert(node1->m_children.size() <= max_children);
-			assert(node2->m_children.size() <= max_children);
-			// TODO: This is currently not guaranteed; we may want to balance insertions if area increase is a tie.
-			// assert(!node1.is_underfull());
-			// assert(!node2.is_underfull());
-
-			typename types::insert_result result{std::move(node2), bbox2};
-
-			// Replace this with node 1, return node 2
-			*this = std::move(*node1);
-			sanity_check_bounding_boxes();
-			return result;
+			return split(Policy::split_algorithm == region_map_split_algorithm::rstar ? region_map_split_algorithm::rstar : region_map_split_algorithm::linear);
 		}
 
 		/**
@@ -660,6 +737,27 @@ namespace region_map_detail {
 			}
 		}
 
+		/**
+		 * Recursively invokes cb(entry_box, value, overlapping, num_overlapping) for every entry that intersects any of the boxes referenced by
+		 * index_stack[first, last), passing the indices of the boxes it intersects. Each level pushes the indices of the boxes that overlap a
+		 * child onto index_stack before descending, so deeper levels only test boxes that are still relevant to their subtree.
+		 */
+		template <typename Callback>
+		void query(const box<Dims>* boxes, std::vector<size_t>& index_stack, const size_t first, const size_t last, const Callback& cb) const {
+			for(size_t i = 0; i < m_children.size(); ++i) {
+				const size_t child_first = push_overlapping_indices(m_child_boxes[i], boxes, index_stack, first, last);
+				const size_t child_last = index_stack.size();
+				if(child_first != child_last) {
+					if(m_contains_leaves) {
+						cb(m_child_boxes[i], get_child_value(i), index_stack.data() + child_first, child_last - child_first);
+					} else {
+						get_child_node(i).query(boxes, index_stack, child_first, child_last, cb);
+					}
+				}
+				index_stack.resize(child_first);
+			}
+		}
+
 		/**
 		 * Returns the entry containing a given point, if such an entry exists.
 		 */
@@ -677,9 +775,47 @@ namespace region_map_detail {
 			return std::nullopt;
 		}
 
-		typename types::unique_inner_node_ptr eject_only_child() {
-			assert(!m_contains_leaves);
-			assert(m_children.size() == 1);
+		/**
+		 * Builds a tree over a set of non-overlapping entries bottom-up with Sort-Tile-Recursive packing [Leutenegger 1997]: Each level is
+		 * sorted into slabs along the first dimension, each slab along the second dimension and so on, and consecutive runs of children are
+		 * grouped into nodes. This yields fully packed nodes with little overlap in O(N log N), instead of inserting entries one by one.
+		 */
+		static typename types::unique_inner_node_ptr bulk_load(typename types::node_arena_type& arena, std::vector<typename types::entry>&& entries) {
+			assert(!entries.empty());
+
+			std::vector<std::pair<detail::box<Dims>, typename types::unique_inner_node_ptr>> level;
+			const auto get_entry_box = [](const typename types::entry& e) -> const detail::box<Dims>& { return e.first; };
+			str_pack(entries, 0, entries.size(), 0, get_entry_box, [&](const size_t begin, const size_t end) {
+				auto leaf = create(arena, true /* contains_leaves */, 0);
+				for(size_t i = begin; i < end; ++i) {
+					leaf->insert_child_value(entries[i].first, entries[i].second);
+				}
+				const auto bbox = leaf->get_bounding_box();
+				level.emplace_back(bbox, std::move(leaf));
+			});
+
+			while(level.size() > 1) {
+				std::vector<std::pair<detail::box<Dims>, typename types::unique_inner_node_ptr>> parents;
+				const auto get_child_box = [](const auto& child) -> const detail::box<Dims>& { return child.first; };
+				str_pack(level, 0, level.size(), 0, get_child_box, [&](const size_t begin, const size_t end) {
+					auto parent = create(arena, false /* contains_leaves */, 0);
+					for(size_t i = begin; i < end; ++i) {
+						parent->insert_child_node(level[i].first, std::move(level[i].second));
+					}
+					const auto bbox = parent->get_bounding_box();
+					parents.emplace_back(bbox, std::move(parent));
+				});
+				level = std::move(parents);
+			}
+
+			auto root = std::move(level.front().second);
+			root->set_depth(0);
+			return root;
+		}
+
+		typename types::unique_inner_node_ptr eject_only_child() {
+			assert(!m_contains_leaves);
+			assert(m_children.size() == 1);
 			auto child = std::move(std::get<typename types::unique_inner_node_ptr>(m_children[0]));
 			m_children.clear();
 			m_child_boxes.clear();
@@ -696,8 +832,8 @@ namespace region_map_detail {
 			return bbox;
 		}
 
-		void insert_child_node(const box<Dims>& box, std::unique_ptr<inner_node>&& node) {
-			assert(m_children.size() < max_children + 1); // During splits we temporarily go one above the max
+		void insert_child_node(const box<Dims>& box, typename types::unique_inner_node_ptr&& node) {
+			assert(m_children.size() < Policy::max_children + 1); // During splits we temporarily go one above the max
 			m_child_boxes.push_back(box);
 			m_children.emplace_back(std::move(node));
 		}
@@ -741,12 +877,70 @@ namespace region_map_detail {
 		template <typename RegionMap>
 		friend void sanity_check_region_map(const RegionMap& rm);
 
+		typename types::node_arena_type* m_arena;
+
 		size_t m_depth;
 
 		bool m_contains_leaves;
-		// TODO PERF: Consider storing these in small vectors
-		std::vector<box<Dims>> m_child_boxes;
-		std::vector<typename types::inner_node_child_type> m_children;
+		// During splits we temporarily need to store one additional child
+		gch::small_vector<box<Dims>, Policy::max_children + 1> m_child_boxes;
+		gch::small_vector<typename types::inner_node_child_type, Policy::max_children + 1> m_children;
+
+		/**
+		 * Checks whether the actions starting at previous_action_count, which were created for children of this leaf node, can be performed
+		 * without overflowing or underflowing it, and if so processes them right away.
+		 *
+		 * @returns True if the actions were processed locally.
+		 */
+		bool process_actions_locally(std::vector<typename types::update_action>& actions, const size_t previous_action_count, const size_t erase_action_count) {
+			const size_t insert_action_count = actions.size() - previous_action_count - erase_action_count;
+			const size_t new_num_children = m_children.size() + insert_action_count - erase_action_count;
+
+			// We can only process actions locally if we have enough space for all children.
+			const bool wont_overflow = new_num_children <= Policy::max_children;
+			// However, we also must ensure that we don't end up with too few children, as we otherwise degrade tree health over time.
+			const bool wont_underflow = new_num_children >= Policy::min_children;
+
+			if(wont_overflow && wont_underflow) {
+				// First, process all erases.
+				for(size_t i = previous_action_count; i < actions.size(); ++i) {
+					if(auto* const erase_action = std::get_if<typename types::erase_node_action>(&actions[i])) {
+						erase_action->processed_locally = true;
+						std::vector<typename types::orphan> orphans(0);
+						[[maybe_unused]] const auto did_erase = erase(erase_action->box, orphans);
+						assert(did_erase);
+						assert(orphans.empty()); // This should never happen as we are in a leaf node.
+					}
+				}
+
+				// Now, process the inserts.
+				for(size_t i = previous_action_count; i < actions.size(); ++i) {
+					if(auto* const insert_action = std::get_if<typename types::insert_node_action>(&actions[i])) {
+						insert_action->processed_locally = true;
+						assert(m_children.size() < Policy::max_children);
+						insert_child_value(insert_action->box, insert_action->value);
+					}
+				}
+
+				assert(m_children.size() == new_num_children);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Pushes the indices in index_stack[first, last) of all boxes overlapping box onto index_stack and returns where they start.
+		static size_t push_overlapping_indices(
+		    const box<Dims>& box, const detail::box<Dims>* boxes, std::vector<size_t>& index_stack, const size_t first, const size_t last) {
+			const size_t overlapping_first = index_stack.size();
+			for(size_t j = first; j < last; ++j) {
+				if(do_overlap<Dims>(box, boxes[index_stack[j]])) {
+					const auto index = index_stack[j]; // push_back may reallocate
+					index_stack.push_back(index);
+				}
+			}
+			return overlapping_first;
+		}
 
 		inner_node& get_child_node(size_t index) { return *std::get<typename types::unique_inner_node_ptr>(m_children[index]); }
 		const inner_node& get_child_node(size_t index) const { return *std::get<typename types::unique_inner_node_ptr>(m_children[index]); }
@@ -755,7 +949,7 @@ namespace region_map_detail {
 		const ValueType& get_child_value(size_t index) const { return std::get<ValueType>(m_children[index]); }
 
 		void insert_child_value(const box<Dims>& box, const ValueType& value) {
-			assert(m_children.size() < max_children + 1); // During splits we temporarily go one above the max
+			assert(m_children.size() < Policy::max_children + 1); // During splits we temporarily go one above the max
 #if !defined(NDEBUG)
 			for(auto& b : m_child_boxes) {
 				// New box must not overlap with any other
@@ -766,13 +960,323 @@ namespace region_map_detail {
 			m_children.emplace_back(value);
 		}
 
+		// Moves a child (entry or subtree) out of a node that is being split.
+		void adopt_child(const box<Dims>& box, typename types::inner_node_child_type&& child) {
+			assert(m_children.size() < Policy::max_children);
+			assert(m_contains_leaves == std::holds_alternative<ValueType>(child));
+			assert(m_contains_leaves || std::get<typename types::unique_inner_node_ptr>(child)->m_depth == m_depth + 1);
+			m_child_boxes.push_back(box);
+			m_children.push_back(std::move(child));
+		}
+
 		void erase_child(const size_t index) {
 			m_child_boxes.erase(m_child_boxes.begin() + index);
 			m_children.erase(m_children.begin() + index);
 		}
 
-		// TODO PERF: We're doing a quadratic split for now - revisit.
-		std::pair<size_t, size_t> pick_split_seeds() {
+		// Children indices assigned to each of the two nodes resulting from a split, in insertion order.
+		struct split_plan {
+			gch::small_vector<size_t, Policy::max_children + 1> first;
+			gch::small_vector<size_t, Policy::max_children + 1> second;
+		};
+
+		// Returns the index of the child whose bounding box grows least when extended to include box.
+		size_t choose_subtree(const box<Dims>& box) const {
+			size_t best_i = std::numeric_limits<size_t>::max();
+			size_t smallest_area_delta = std::numeric_limits<size_t>::max();
+			for(size_t i = 0; i < m_child_boxes.size(); ++i) {
+				const auto area_delta = compute_bounding_box(m_child_boxes[i], box).get_area() - m_child_boxes[i].get_area();
+				if(area_delta < smallest_area_delta
+				    || (Policy::break_insertion_ties_by_area && area_delta == smallest_area_delta
+				        && m_child_boxes[i].get_area() < m_child_boxes[best_i].get_area())) {
+					smallest_area_delta = area_delta;
+					best_i = i;
+				}
+			}
+			assert(best_i < m_children.size());
+			assert(smallest_area_delta < std::numeric_limits<size_t>::max());
+			return best_i;
+		}
+
+		/**
+		 * Splits this overfull node in two: This node is replaced by the first one, and the second one is returned.
+		 */
+		typename types::insert_result split(const region_map_split_algorithm algorithm) {
+			assert(m_children.size() == Policy::max_children + 1);
+
+			split_plan plan;
+			switch(algorithm) {
+			case region_map_split_algorithm::linear: plan = plan_linear_split(); break;
+			case region_map_split_algorithm::quadratic: plan = plan_quadratic_split(); break;
+			case region_map_split_algorithm::rstar: plan = plan_rstar_split(); break;
+			}
+
+			inner_node node1(*m_arena, m_contains_leaves, m_depth);
+			for(const auto i : plan.first) {
+				node1.adopt_child(m_child_boxes[i], std::move(m_children[i]));
+			}
+			auto node2 = create(*m_arena, m_contains_leaves, m_depth);
+			for(const auto i : plan.second) {
+				node2->adopt_child(m_child_boxes[i], std::move(m_children[i]));
+			}
+
+			assert(!node1.m_children.empty());
+			assert(!node2->m_children.empty());
+			assert(node1.m_children.size() <= Policy::max_children);
+			assert(node2->m_children.size() <= Policy::max_children);
+			// TODO: This is currently not guaranteed for linear and quadratic splits; we may want to balance insertions if area increase is a tie.
+			// assert(!node1.is_underfull());
+			// assert(!node2.is_underfull());
+
+			const auto bbox2 = node2->get_bounding_box();
+			typename types::insert_result result{std::move(node2), bbox2};
+
+			// Replace this with node 1, return node 2
+			*this = std::move(node1);
+			sanity_check_bounding_boxes();
+			return result;
+		}
+
+		// Assigns all non-seed children in order to the node that results in the smaller area increase, O(N).
+		split_plan plan_linear_split() const {
+			const auto [seed1, seed2] = pick_split_seeds();
+			split_plan plan;
+			plan.first.push_back(seed1);
+			plan.second.push_back(seed2);
+			auto bbox1 = m_child_boxes[seed1];
+			auto bbox2 = m_child_boxes[seed2];
+			for(size_t i = 0; i < m_children.size(); ++i) {
+				if(i == seed1 || i == seed2) continue;
+
+				const auto new_bbox1 = compute_bounding_box(bbox1, m_child_boxes[i]);
+				const auto new_bbox2 = compute_bounding_box(bbox2, m_child_boxes[i]);
+
+				if((new_bbox1.get_area() - bbox1.get_area()) < (new_bbox2.get_area() - bbox2.get_area())) {
+					plan.first.push_back(i);
+					bbox1 = new_bbox1;
+				} else {
+					plan.second.push_back(i);
+					bbox2 = new_bbox2;
+				}
+			}
+			return plan;
+		}
+
+		// Greedily assigns the child with the smallest area increase across both nodes next, O(N^2).
+		split_plan plan_quadratic_split() const {
+			const auto [seed1, seed2] = pick_split_seeds();
+			split_plan plan;
+			plan.first.push_back(seed1);
+			plan.second.push_back(seed2);
+			auto bbox1 = m_child_boxes[seed1];
+			auto bbox2 = m_child_boxes[seed2];
+			auto area1 = bbox1.get_area();
+			auto area2 = bbox2.get_area();
+			gch::small_vector<bool, Policy::max_children + 1> assigned(m_children.size(), false);
+			assigned[seed1] = true;
+			assigned[seed2] = true;
+			size_t num_assigned = 2;
+			while(num_assigned < m_children.size()) {
+				size_t smallest_area_delta = std::numeric_limits<size_t>::max();
+				size_t smallest_i = std::numeric_limits<size_t>::max();
+				detail::box<Dims> smallest_bbox;
+				size_t smallest_area = 0;
+				size_t target_node = 0;
+
+				for(size_t i = 0; i < m_children.size(); ++i) {
+					if(assigned[i]) continue;
+
+					const auto new_bbox1 = compute_bounding_box(m_child_boxes[i], bbox1);
+					const auto new_bbox2 = compute_bounding_box(m_child_boxes[i], bbox2);
+					const auto new_area1 = new_bbox1.get_area();
+					const auto new_area2 = new_bbox2.get_area();
+
+					const auto ad1 = (new_area1 - area1);
+					const auto ad2 = (new_area2 - area2);
+
+					if(ad1 < smallest_area_delta) {
+						smallest_area_delta = ad1;
+						smallest_i = i;
+						smallest_bbox = new_bbox1;
+						smallest_area = new_area1;
+						target_node = 1;
+					}
+					if(ad2 < smallest_area_delta) {
+						smallest_area_delta = ad2;
+						smallest_i = i;
+						smallest_bbox = new_bbox2;
+						smallest_area = new_area2;
+						target_node = 2;
+					}
+				}
+
+				assert(target_node != 0);
+				if(target_node == 1) {
+					plan.first.push_back(smallest_i);
+					bbox1 = smallest_bbox;
+					area1 = smallest_area;
+				} else {
+					plan.second.push_back(smallest_i);
+					bbox2 = smallest_bbox;
+					area2 = smallest_area;
+				}
+
+				assigned[smallest_i] = true;
+				num_assigned++;
+			}
+			return plan;
+		}
+
+		/**
+		 * R*-tree split [Beckmann 1990]: Children are sorted by their lower and upper bounds along each axis, and the axis where the split candidates
+		 * have the smallest sum of margins (half perimeters) is chosen. Along that axis, the candidate with the smallest overlap between both nodes
+		 * wins, and ties are broken by total area. Both nodes receive at least 40% of the children.
+		 */
+		split_plan plan_rstar_split() const {
+			using index_order = gch::small_vector<size_t, Policy::max_children + 1>;
+
+			const size_t num_children = m_children.size();
+			const size_t min_fill = std::max<size_t>(1, std::max(Policy::min_children, Policy::max_children * 2 / 5));
+			assert(2 * min_fill <= num_children);
+
+			const auto sorted_along = [&](const int d, const bool by_max) {
+				index_order order(num_children);
+				std::iota(order.begin(), order.end(), size_t(0));
+				std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) {
+					const auto &lbox = m_child_boxes[lhs], &rbox = m_child_boxes[rhs];
+					const auto lkey = by_max ? std::pair(lbox.get_max()[d], lbox.get_min()[d]) : std::pair(lbox.get_min()[d], lbox.get_max()[d]);
+					const auto rkey = by_max ? std::pair(rbox.get_max()[d], rbox.get_min()[d]) : std::pair(rbox.get_min()[d], rbox.get_max()[d]);
+					return lkey < rkey;
+				});
+				return order;
+			};
+
+			// Bounding boxes of all prefixes [0, k] and suffixes [k, N) of an order
+			const auto accumulate_bounding_boxes = [&](const index_order& order, gch::small_vector<detail::box<Dims>, Policy::max_children + 1>& prefix,
+			                                           gch::small_vector<detail::box<Dims>, Policy::max_children + 1>& suffix) {
+				prefix.resize(num_children);
+				suffix.resize(num_children);
+				prefix[0] = m_child_boxes[order[0]];
+				for(size_t k = 1; k < num_children; ++k) {
+					prefix[k] = compute_bounding_box(prefix[k - 1], m_child_boxes[order[k]]);
+				}
+				suffix[num_children - 1] = m_child_boxes[order[num_children - 1]];
+				for(size_t k = num_children - 1; k > 0; --k) {
+					suffix[k - 1] = compute_bounding_box(suffix[k], m_child_boxes[order[k - 1]]);
+				}
+			};
+
+			const auto margin = [](const detail::box<Dims>& b) {
+				size_t m = 0;
+				for(int d = 0; d < Dims; ++d) {
+					m += b.get_range()[d];
+				}
+				return m;
+			};
+
+			gch::small_vector<detail::box<Dims>, Policy::max_children + 1> prefix;
+			gch::small_vector<detail::box<Dims>, Policy::max_children + 1> suffix;
+
+			int best_axis = 0;
+			size_t smallest_margin_sum = std::numeric_limits<size_t>::max();
+			for(int d = 0; d < Dims; ++d) {
+				size_t margin_sum = 0;
+				for(const bool by_max : {false, true}) {
+					accumulate_bounding_boxes(sorted_along(d, by_max), prefix, suffix);
+					for(size_t k = min_fill; k <= num_children - min_fill; ++k) {
+						margin_sum += margin(prefix[k - 1]) + margin(suffix[k]);
+					}
+				}
+				if(margin_sum < smallest_margin_sum) {
+					smallest_margin_sum = margin_sum;
+					best_axis = d;
+				}
+			}
+
+			index_order best_order;
+			size_t best_k = 0;
+			size_t smallest_overlap = std::numeric_limits<size_t>::max();
+			size_t smallest_area = std::numeric_limits<size_t>::max();
+			for(const bool by_max : {false, true}) {
+				auto order = sorted_along(best_axis, by_max);
+				accumulate_bounding_boxes(order, prefix, suffix);
+				bool improved = false;
+				for(size_t k = min_fill; k <= num_children - min_fill; ++k) {
+					const auto overlap = box_intersection(prefix[k - 1], suffix[k]).get_area();
+					const auto area = prefix[k - 1].get_area() + suffix[k].get_area();
+					if(overlap < smallest_overlap || (overlap == smallest_overlap && area < smallest_area)) {
+						smallest_overlap = overlap;
+						smallest_area = area;
+						best_k = k;
+						improved = true;
+					}
+				}
+				if(improved) { best_order = std::move(order); }
+			}
+
+			split_plan plan;
+			plan.first.assign(best_order.begin(), best_order.begin() + static_cast<ptrdiff_t>(best_k));
+			plan.second.assign(best_order.begin() + static_cast<ptrdiff_t>(best_k), best_order.end());
+			return plan;
+		}
+
+		// Moves the Policy::forced_reinsert_count entries whose centers lie furthest from the center of this leaf into evicted.
+		void evict_for_reinsertion(std::vector<typename types::entry>& evicted) {
+			assert(m_contains_leaves);
+			const auto bbox = get_bounding_box();
+			const auto distance_from_center = [&](const detail::box<Dims>& b) {
+				double distance = 0; // squared, in units of half cells
+				for(int d = 0; d < Dims; ++d) {
+					const auto delta = static_cast<double>(b.get_min()[d] + b.get_max()[d]) - static_cast<double>(bbox.get_min()[d] + bbox.get_max()[d]);
+					distance += delta * delta;
+				}
+				return distance;
+			};
+
+			for(size_t n = 0; n < Policy::forced_reinsert_count; ++n) {
+				size_t furthest_i = 0;
+				double furthest_distance = -1;
+				for(size_t i = 0; i < m_children.size(); ++i) {
+					const auto distance = distance_from_center(m_child_boxes[i]);
+					if(distance > furthest_distance) {
+						furthest_distance = distance;
+						furthest_i = i;
+					}
+				}
+				evicted.emplace_back(m_child_boxes[furthest_i], std::move(get_child_value(furthest_i)));
+				erase_child(furthest_i);
+			}
+		}
+
+		// Sorts items[begin, end) by the center of their boxes along dimension dim, then recursively sorts each slab of the result along the next
+		// dimension. Slabs are sized so that each dimension is cut into roughly the same number of slabs. Once all dimensions are sorted, the
+		// items of each slab are split into groups of at most max_children, and cb(group_begin, group_end) is invoked for each of them.
+		// Groups never straddle two slabs, and as slabs differ in size by at most one, none of the groups is underfull.
+		template <typename Items, typename GetBox, typename Callback>
+		static void str_pack(Items& items, const size_t begin, const size_t end, const int dim, const GetBox& get_box, const Callback& cb) {
+			std::sort(items.begin() + static_cast<ptrdiff_t>(begin), items.begin() + static_cast<ptrdiff_t>(end), [&](const auto& lhs, const auto& rhs) {
+				const auto& lbox = get_box(lhs);
+				const auto& rbox = get_box(rhs);
+				return lbox.get_min()[dim] + lbox.get_max()[dim] < rbox.get_min()[dim] + rbox.get_max()[dim];
+			});
+
+			const size_t num_items = end - begin;
+			const size_t num_nodes = (num_items + Policy::max_children - 1) / Policy::max_children;
+			if(dim + 1 == Dims || num_nodes <= 1) {
+				for(size_t g = 0; g < num_nodes; ++g) {
+					cb(begin + num_items * g / num_nodes, begin + num_items * (g + 1) / num_nodes);
+				}
+				return;
+			}
+
+			const auto num_slabs = static_cast<size_t>(std::ceil(std::pow(static_cast<double>(num_nodes), 1.0 / (Dims - dim))));
+			for(size_t s = 0; s < num_slabs; ++s) {
+				str_pack(items, begin + num_items * s / num_slabs, begin + num_items * (s + 1) / num_slabs, dim + 1, get_box, cb);
+			}
+		}
+
+		// Picks the two children that would waste the most area if they were placed in the same node, O(N^2).
+		std::pair<size_t, size_t> pick_split_seeds() const {
 			size_t worst_area = 0;
 			size_t worst_i = std::numeric_limits<size_t>::max();
 			size_t worst_j = std::numeric_limits<size_t>::max();
@@ -791,7 +1295,7 @@ namespace region_map_detail {
 			return std::make_pair(worst_i, worst_j);
 		}
 
-		bool is_underfull() const { return m_children.size() < min_children; }
+		bool is_underfull() const { return m_children.size() < Policy::min_children; }
 
 		box<Dims> sanity_check_bounding_boxes() const {
 #if !defined(NDEBUG)
@@ -836,17 +1340,19 @@ namespace region_map_detail {
 	 * TODO PERF: Try to minimize the number of value copies we do during intermediate steps (e.g. when merging)
 	 * TODO PERF: Look into bulk-loading algorithms for updating multiple boxes at once
 	 */
-	template <typename ValueType, int Dims>
+	template <typename ValueType, int Dims, typename Policy = region_map_default_policy>
 	class region_map_impl {
 		friend struct celerity::detail::region_map_testspy;
-		using types = region_map_types<ValueType, Dims>;
+		using types = region_map_types<ValueType, Dims, Policy>;
 
 	  public:
 		using value_type = ValueType;
+		using policy = Policy;
 		static constexpr size_t dimensions = Dims;
 
 		region_map_impl(const range<Dims>& extent, ValueType default_value = ValueType{})
-		    : m_extent(subrange<Dims>({}, extent)), m_root(std::make_unique<typename types::inner_node_type>(true, 0)) {
+		    : m_extent(subrange<Dims>({}, extent)), m_arena(std::make_unique<typename types::node_arena_type>()),
+		      m_root(types::inner_node_type::create(*m_arena, true, 0)) {
 			m_root->insert(this->m_extent, default_value);
 		}
 
@@ -855,7 +1361,17 @@ namespace region_map_detail {
 		region_map_impl(const region_map_impl&) = delete;
 		region_map_impl(region_map_impl&&) noexcept = default;
 		region_map_impl& operator=(const region_map_impl&) = delete;
-		region_map_impl& operator=(region_map_impl&&) noexcept = default;
+
+		region_map_impl& operator=(region_map_impl&& other) noexcept {
+			// Our nodes must be returned to our arena before it is replaced
+			m_erase_orphans.clear();
+			m_query_cache.clear();
+			m_root.reset();
+			m_extent = other.m_extent;
+			m_arena = std::move(other.m_arena);
+			m_root = std::move(other.m_root);
+			return *this;
+		}
 
 		/**
 		 * Updates the value for the provided box within the tree.
@@ -882,6 +1398,10 @@ namespace region_map_detail {
 			m_update_actions.clear();
 			m_root->update_box(clamped_box, value, m_update_actions);
 
+			// Actions processed locally have changed nodes without going through insert() and erase()
+			if(!m_update_actions.empty()) { ++m_structure_version; }
+			++m_value_version;
+
 			m_merge_candidates.clear();
 
 			// If there are any actions it means there was no in-place update.
@@ -893,43 +1413,11 @@ namespace region_map_detail {
 				m_merge_candidates.push_back(std::make_pair(clamped_box, value));
 			}
 
-#if !defined(NDEBUG)
-			// Sanity check: Erased and inserted boxes must cover the same space
-			region<Dims> erased;
-			region<Dims> inserted;
-			for(const auto& a : m_update_actions) {
-				utils::match(
-				    a,
-				    [&](const typename types::erase_node_action& erase_action) {
-					    assert(region_intersection(erased, erase_action.box).empty());
-					    erased = region_union(erased, erase_action.box);
-				    },
-				    [&](const typename types::insert_node_action& insert_action) {
-					    assert(region_intersection(inserted, insert_action.box).empty());
-					    inserted = region_union(inserted, insert_action.box);
-				    });
-			}
-			assert(erased == inserted);
-#endif
-
-			for(const auto& a : m_update_actions) {
-				utils::match(
-				    a,
-				    [&](const typename types::erase_node_action& erase_action) {
-					    if(!erase_action.processed_locally) { erase(erase_action.box); }
-				    },
-				    [&](const typename types::insert_node_action& insert_action) {
-					    if(!insert_action.processed_locally) { insert(insert_action.box, insert_action.value); }
-					    // Even if the action was processed locally already, we still have to try and merge the new box.
-					    m_merge_candidates.push_back(std::make_pair(insert_action.box, insert_action.value));
-				    });
-			}
+			apply_update_actions();
 
 			sanity_check_region_map(*this);
 
-#if CELERITY_DETAIL_REGION_MAP_MERGE_ON_UPDATE
-			try_merge(std::move(m_merge_candidates));
-#endif
+			if constexpr(Policy::merge_on_update) { try_merge(m_merge_candidates); }
 
 			sanity_check_region_map(*this);
 		}
@@ -945,11 +1433,10 @@ namespace region_map_detail {
 
 			m_updated_nodes.clear();
 			m_root->apply_to_values(f, m_updated_nodes);
+			++m_value_version;
 
-#if CELERITY_DETAIL_REGION_MAP_MERGE_ON_UPDATE
 			// Now attempt to merge boxes that had their value modified by the functor.
-			try_merge(std::move(m_updated_nodes));
-#endif
+			if constexpr(Policy::merge_on_update) { try_merge(m_updated_nodes); }
 
 			sanity_check_region_map(*this);
 		}
@@ -962,48 +1449,258 @@ namespace region_map_detail {
 		std::vector<typename types::entry> get_region_values(const box<Dims>& request) const {
 			assert(m_root != nullptr && "Moved from?");
 
+			if(m_query_cache_capacity > 0) { return query_through_cache(&request, 1, [this] { return merge_query_results(); }); }
+
 			m_query_results_raw.clear();
 			m_root->query(request, m_query_results_raw);
 
-#if !CELERITY_DETAIL_REGION_MAP_CLAMP_RESULTS_TO_REQUEST_BOUNDARY && !CELERITY_DETAIL_REGION_MAP_MERGE_RESULTS
-			return m_query_results_raw;
-#endif
+			if constexpr(!Policy::clamp_results_to_request_boundary && !Policy::merge_results) { return m_query_results_raw; }
 
-#if CELERITY_DETAIL_REGION_MAP_CLAMP_RESULTS_TO_REQUEST_BOUNDARY
-			// Clamp to query request box
-			m_query_results_clamped.clear();
-			for(auto& [b, v] : m_query_results_raw) {
-				const auto r_min = request.get_min();
-				const auto r_max = request.get_max();
-				const auto v_min = b.get_min();
-				const auto v_max = b.get_max();
-				auto clamped_min = v_min;
-				auto clamped_max = v_max;
-
-				for(size_t d = 0; d < Dims; ++d) {
-					clamped_min[d] = std::max(v_min[d], r_min[d]);
-					clamped_max[d] = std::min(v_max[d], r_max[d]);
+			if constexpr(Policy::clamp_results_to_request_boundary) {
+				// Clamp to query request box
+				m_query_results_clamped.clear();
+				for(auto& [b, v] : m_query_results_raw) {
+					const auto r_min = request.get_min();
+					const auto r_max = request.get_max();
+					const auto v_min = b.get_min();
+					const auto v_max = b.get_max();
+					auto clamped_min = v_min;
+					auto clamped_max = v_max;
+
+					for(size_t d = 0; d < Dims; ++d) {
+						clamped_min[d] = std::max(v_min[d], r_min[d]);
+						clamped_max[d] = std::min(v_max[d], r_max[d]);
+					}
+					m_query_results_clamped.push_back(std::make_pair(box<Dims>{clamped_min, clamped_max}, v));
 				}
-				m_query_results_clamped.push_back(std::make_pair(box<Dims>{clamped_min, clamped_max}, v));
+			} else {
+				std::swap(m_query_results_raw, m_query_results_clamped);
 			}
-#else
-			std::swap(m_query_results_raw, m_query_results_clamped);
+
+			return merge_query_results();
+		}
+
+		/**
+		 * Finds all entries intersecting with any box of request in a single traversal, clamps them to each of these boxes and merges the result.
+		 */
+		std::vector<typename types::entry> get_region_values(const region<Dims>& request) const {
+			assert(m_root != nullptr && "Moved from?");
+
+			if(request.empty()) return {};
+			if(request.get_boxes().size() == 1) return get_region_values(request.get_boxes().front());
+
+			const auto& request_boxes = request.get_boxes();
+			if(m_query_cache_capacity > 0) {
+				return query_through_cache(request_boxes.data(), request_boxes.size(), [this] { return sort_merge_query_results(); });
+			}
+
+			m_query_results_clamped.clear();
+			m_root->query(request_boxes.data(), init_query_index_stack(request_boxes.size()), 0, request_boxes.size(),
+			    [&](const box<Dims>& b, const ValueType& v, const size_t* overlapping, const size_t num_overlapping) {
+				    if constexpr(Policy::clamp_results_to_request_boundary) {
+					    for(size_t i = 0; i < num_overlapping; ++i) {
+						    m_query_results_clamped.push_back(std::make_pair(box_intersection(b, request_boxes[overlapping[i]]), v));
+					    }
+				    } else {
+					    m_query_results_clamped.push_back(std::make_pair(b, v));
+				    }
+			    });
+
+			return sort_merge_query_results();
+		}
+
+		/**
+		 * Updates the value for all boxes of a region. Unlike calling update_box for each box, all affected entries are found in a single
+		 * traversal, each of them is split once around the boxes it overlaps, and merging happens once for all new entries.
+		 */
+		void update_region(const region<Dims>& region, const ValueType& value) {
+			assert(m_root != nullptr && "Moved from?");
+
+			const auto clamped_region = region_intersection(region, m_extent);
+			if(clamped_region.empty()) return;
+			if(clamped_region.get_boxes().size() == 1) {
+				update_box(clamped_region.get_boxes().front(), value);
+				return;
+			}
+
+			const auto& boxes = clamped_region.get_boxes();
+			m_update_actions.clear();
+			m_merge_candidates.clear(); // Receives all in-place updates
+			m_root->update_region(boxes.data(), init_query_index_stack(boxes.size()), 0, boxes.size(), value, m_update_actions, m_merge_candidates);
+			if(!m_update_actions.empty()) { ++m_structure_version; }
+			++m_value_version;
+
+			// Every node has at least min_children children, so the tree holds on the order of live_nodes * min_children entries. If the update
+			// inserts at least as many, rebuilding the tree with bulk-loading is cheaper than inserting the new entries one by one.
+			const auto num_pending_inserts = std::count_if(m_update_actions.begin(), m_update_actions.end(), [](const auto& a) {
+				const auto* const insert_action = std::get_if<typename types::insert_node_action>(&a);
+				return insert_action != nullptr && !insert_action->processed_locally;
+			});
+			if(static_cast<size_t>(num_pending_inserts) >= m_arena->get_num_live_nodes() * Policy::min_children) {
+				rebuild_with_update_actions();
+			} else {
+				apply_update_actions();
+			}
+
+			sanity_check_region_map(*this);
+
+			if constexpr(Policy::merge_on_update) { try_merge(m_merge_candidates); }
+
+			sanity_check_region_map(*this);
+		}
+
+		/**
+		 * Replaces all entries with a partition of the extent (disjoint boxes that cover it exactly), bulk-loading the tree instead of
+		 * inserting the boxes one by one.
+		 */
+		void reset(std::vector<typename types::entry> partition) {
+			assert(m_root != nullptr && "Moved from?");
+
+#if !defined(NDEBUG)
+			region<Dims> covered;
+			for(const auto& [box, value] : partition) {
+				assert(m_extent.covers(box));
+				assert(region_intersection(covered, box).empty());
+				covered = region_union(covered, box);
+			}
+			assert(covered == region(m_extent));
 #endif
 
+			m_root.reset(); // Return nodes to the arena before building the new tree
+			++m_structure_version;
+			std::vector<typename types::entry> merge_candidates;
+			if constexpr(Policy::merge_on_update) { merge_candidates = partition; }
+			m_root = types::inner_node_type::bulk_load(*m_arena, std::move(partition));
+
+			sanity_check_region_map(*this);
+
+			if constexpr(Policy::merge_on_update) { try_merge(merge_candidates); }
+
+			sanity_check_region_map(*this);
+		}
+
+		auto format_to(fmt::format_context::iterator out) const {
+			out = fmt::format_to(out, "Region Map\n");
+			return m_root->format_to(out, 0);
+		}
+
+		range<Dims> get_extent() const { return m_extent.get_range(); }
+
+		const region_map_allocation_statistics& get_allocation_statistics() const { return m_arena->get_statistics(); }
+
+		/**
+		 * Remembers which entries the most recent `capacity` distinct requests decomposed into, so that repeating one of them skips the tree
+		 * traversal. A cached decomposition stays valid until the tree changes structurally; values updated in place are simply re-read.
+		 * A capacity of 0 disables the cache.
+		 */
+		void enable_query_cache(const size_t capacity) {
+			m_query_cache_capacity = capacity;
+			m_query_cache.clear();
+			m_query_cache.reserve(capacity);
+		}
+
+		const region_map_query_cache_statistics& get_query_cache_statistics() const { return m_query_cache_statistics; }
+
+	  private:
+		struct query_cache_entry {
+			box_vector<Dims> request;
+			size_t request_hash = 0;
+			uint64_t last_use = 0;
+			uint64_t structure_version = 0;
+			uint64_t value_version = 0;
+			std::vector<typename types::entry> pieces; // clamped to the request if the policy says so, but not merged
+			std::vector<const ValueType*> sources;     // where the value of each piece is stored, valid until the next structural change
+			std::vector<typename types::entry> results;
+		};
+
+		static size_t hash_request(const box<Dims>* const request_boxes, const size_t num_request_boxes) {
+			size_t seed = num_request_boxes;
+			for(size_t i = 0; i < num_request_boxes; ++i) {
+				for(int d = 0; d < Dims; ++d) {
+					utils::hash_combine(seed, request_boxes[i].get_min()[d]);
+					utils::hash_combine(seed, request_boxes[i].get_max()[d]);
+				}
+			}
+			return seed;
+		}
+
+		/**
+		 * Answers a query from the cache if the tree has not changed structurally since the request was last seen, re-reading the values of its
+		 * pieces if any were updated in place since. Otherwise the tree is traversed, replacing the least recently used cache entry.
+		 */
+		template <typename Merge>
+		std::vector<typename types::entry> query_through_cache(const box<Dims>* const request_boxes, const size_t num_request_boxes, const Merge& merge) const {
+			const auto request_hash = hash_request(request_boxes, num_request_boxes);
+			query_cache_entry* cached = nullptr;
+			query_cache_entry* least_recently_used = nullptr;
+			for(auto& e : m_query_cache) {
+				if(e.request_hash == request_hash && e.request.size() == num_request_boxes && std::equal(e.request.begin(), e.request.end(), request_boxes)) {
+					cached = &e;
+					break;
+				}
+				if(least_recently_used == nullptr || e.last_use < least_recently_used->last_use) { least_recently_used = &e; }
+			}
+
+			const bool is_structure_valid = cached != nullptr && cached->structure_version == m_structure_version;
+			const bool is_value_valid = is_structure_valid && cached->value_version == m_value_version;
+
+			if(cached == nullptr) {
+				cached = m_query_cache.size() < m_query_cache_capacity ? &m_query_cache.emplace_back() : least_recently_used;
+				cached->request.assign(request_boxes, request_boxes + num_request_boxes);
+				cached->request_hash = request_hash;
+			}
+			cached->last_use = ++m_query_cache_clock;
+
+			if(is_value_valid) {
+				m_query_cache_statistics.num_hits++;
+				return cached->results;
+			}
+
+			if(is_structure_valid) {
+				m_query_cache_statistics.num_revalidations++;
+				for(size_t i = 0; i < cached->pieces.size(); ++i) {
+					cached->pieces[i].second = *cached->sources[i];
+				}
+			} else {
+				m_query_cache_statistics.num_misses++;
+				cached->pieces.clear();
+				cached->sources.clear();
+				m_root->query(request_boxes, init_query_index_stack(num_request_boxes), 0, num_request_boxes,
+				    [&](const box<Dims>& b, const ValueType& v, const size_t* overlapping, const size_t num_overlapping) {
+					    if constexpr(Policy::clamp_results_to_request_boundary) {
+						    for(size_t i = 0; i < num_overlapping; ++i) {
+							    cached->pieces.push_back(std::make_pair(box_intersection(b, request_boxes[overlapping[i]]), v));
+							    cached->sources.push_back(&v);
+						    }
+					    } else {
+						    cached->pieces.push_back(std::make_pair(b, v));
+						    cached->sources.push_back(&v);
+					    }
+				    });
+				cached->structure_version = m_structure_version;
+			}
+
+			m_query_results_clamped = cached->pieces;
+			cached->results = merge();
+			cached->value_version = m_value_version;
+			return cached->results;
+		}
+
+		// Merges the entries in m_query_results_clamped where possible.
+		std::vector<typename types::entry> merge_query_results() const {
 #ifdef NDEBUG
 			// In 1D everything that can be merged will be merged on update.
 			// (Nevertheless, assert this in debug builds).
-			if(Dims == 1) return m_query_results_clamped;
+			if(Dims == 1 && Policy::merge_on_update) return m_query_results_clamped;
 #endif
 
-#if !CELERITY_DETAIL_REGION_MAP_MERGE_RESULTS
-			return m_query_results_clamped;
-#endif
+			if constexpr(!Policy::merge_results) { return m_query_results_clamped; }
 
 			// Do a greedy quadratic merge
 			// TODO PERF: Can we come up with a more efficient solution here? Maybe some sort of line-sweeping algorithm?
 			bool did_merge = true;
-			std::vector<bool> is_merged(m_query_results_clamped.size(), false);
+			auto& is_merged = m_query_results_merged;
+			is_merged.assign(m_query_results_clamped.size(), false);
 			while(did_merge) {
 				did_merge = false;
 				for(size_t i = 0; i < m_query_results_clamped.size(); ++i) {
@@ -1012,7 +1709,7 @@ namespace region_map_detail {
 						if(is_merged[j]) continue;
 						if(m_query_results_clamped[i].second != m_query_results_clamped[j].second) continue;
 						if(can_merge(m_query_results_clamped[i].first, m_query_results_clamped[j].first)) {
-							assert(Dims > 1 || !CELERITY_DETAIL_REGION_MAP_MERGE_ON_UPDATE); // 1D should already have merged on update.
+							assert(Dims > 1 || !Policy::merge_on_update); // 1D should already have merged on update.
 							// TODO PERF: Computing the bbox from scratch isn't ideal, as we really only need to adjust one dimension.
 							m_query_results_clamped[i].first = compute_bounding_box(m_query_results_clamped[i].first, m_query_results_clamped[j].first);
 							is_merged[j] = true;
@@ -1029,14 +1726,84 @@ namespace region_map_detail {
 			return results_merged;
 		}
 
-		auto format_to(fmt::format_context::iterator out) const {
-			out = fmt::format_to(out, "Region Map\n");
-			return m_root->format_to(out, 0);
+		// Prepares the index stack for an inner_node::query over num_boxes boxes.
+		std::vector<size_t>& init_query_index_stack(const size_t num_boxes) const {
+			m_query_index_stack.resize(num_boxes);
+			std::iota(m_query_index_stack.begin(), m_query_index_stack.end(), size_t{0});
+			return m_query_index_stack;
 		}
 
-		range<Dims> get_extent() const { return m_extent.get_range(); }
+		// The cross-section of a box perpendicular to the merge dimension followed by its minimum along that dimension.
+		struct merge_key {
+			std::array<size_t, 2 * Dims - 1> coordinates;
+			size_t index;
+		};
+
+		// Merges the entries in m_query_results_clamped like merge_query_results, but instead of comparing all pairs, sorts the entries
+		// along each dimension in turn so that mergeable neighbors become adjacent. This is O(N log N) per pass, which matters for the large
+		// result sets of region queries.
+		std::vector<typename types::entry> sort_merge_query_results() const {
+			auto& results = m_query_results_clamped;
+
+#ifdef NDEBUG
+			// The boxes of a normalized 1D region are never adjacent, so pieces from different request boxes never merge either.
+			if(Dims == 1 && Policy::merge_on_update) return results;
+#endif
+
+			if constexpr(!Policy::merge_results) { return results; }
+
+			// A pass along d merges all runs of adjacent boxes in d at once, so we are done once no pass along any dimension has merged anything.
+			auto& keys = m_query_results_merge_keys;
+			auto& is_merged = m_query_results_merged;
+			int passes_without_merge = 0;
+			for(int d = 0; passes_without_merge < Dims && results.size() > 1; d = (d + 1) % Dims) {
+				// Order by cross-section first, so that boxes which can be merged along d end up next to each other
+				keys.resize(results.size());
+				for(size_t i = 0; i < results.size(); ++i) {
+					const auto& min = results[i].first.get_min();
+					const auto& max = results[i].first.get_max();
+					size_t k = 0;
+					for(int o = 0; o < Dims; ++o) {
+						if(o == d) continue;
+						keys[i].coordinates[k++] = min[o];
+						keys[i].coordinates[k++] = max[o];
+					}
+					keys[i].coordinates[k] = min[d];
+					keys[i].index = i;
+				}
+				std::sort(keys.begin(), keys.end(), [](const merge_key& lhs, const merge_key& rhs) { return lhs.coordinates < rhs.coordinates; });
+
+				bool did_merge = false;
+				is_merged.assign(results.size(), false);
+				for(size_t i = 0, head = 0; i < keys.size(); ++i) {
+					auto& [head_box, head_value] = results[keys[head].index];
+					const auto& [box, value] = results[keys[i].index];
+					if(i > head && head_value == value && head_box.get_max()[d] == box.get_min()[d]
+					    && std::equal(keys[head].coordinates.begin(), keys[head].coordinates.end() - 1, keys[i].coordinates.begin())) {
+						assert(Dims > 1 || !Policy::merge_on_update); // 1D should already have merged on update.
+						head_box = compute_bounding_box(head_box, box);
+						is_merged[keys[i].index] = true;
+						did_merge = true;
+					} else {
+						head = i;
+					}
+				}
+
+				if(did_merge) {
+					size_t num_kept = 0;
+					for(size_t i = 0; i < results.size(); ++i) {
+						if(is_merged[i]) continue;
+						if(num_kept != i) { results[num_kept] = std::move(results[i]); }
+						++num_kept;
+					}
+					results.erase(results.begin() + static_cast<std::ptrdiff_t>(num_kept), results.end());
+				}
+				passes_without_merge = did_merge ? 1 : passes_without_merge + 1;
+			}
+
+			return results;
+		}
 
-	  private:
 		template <typename RegionMap>
 		friend void sanity_check_region_map(const RegionMap& rm);
 
@@ -1044,7 +1811,9 @@ namespace region_map_detail {
 		// and which initially contains the default value. Currently always starts at [0,0,0].
 		box<Dims> m_extent;
 
-		std::unique_ptr<typename types::inner_node_type> m_root;
+		// Declared before the root so that it outlives all nodes.
+		std::unique_ptr<typename types::node_arena_type> m_arena;
+		typename types::unique_inner_node_ptr m_root;
 
 		// These vectors are frequently used during updates, queries etc.
 		// We keep them here as to not have to allocate them from scratch every time,
@@ -1055,14 +1824,38 @@ namespace region_map_detail {
 		std::vector<typename types::orphan> m_erase_orphans;
 		mutable std::vector<typename types::entry> m_query_results_raw;
 		mutable std::vector<typename types::entry> m_query_results_clamped;
+		mutable std::vector<bool> m_query_results_merged;
+		mutable std::vector<size_t> m_query_index_stack;
+		mutable std::vector<merge_key> m_query_results_merge_keys;
+		std::vector<box<Dims>> m_rebuild_erased_boxes;
+		// Every insert and erase changes the structure of the tree, every update changes values
+		uint64_t m_structure_version = 0;
+		uint64_t m_value_version = 0;
+		size_t m_query_cache_capacity = 0;
+		mutable std::vector<query_cache_entry> m_query_cache;
+		mutable uint64_t m_query_cache_clock = 0;
+		mutable region_map_query_cache_statistics m_query_cache_statistics;
+		std::vector<bool> m_merge_candidates_merged;
 
 		/**
 		 * Inserts a new entry into the tree.
 		 * Precondition: The insert location must be empty.
 		 */
 		void insert(const box<Dims>& box, const ValueType& value) {
-			auto ret = m_root->insert(box, value);
-			if(ret.has_value()) { reroot(std::move(*ret)); }
+			++m_structure_version;
+			if constexpr(Policy::forced_reinsert_count > 0) {
+				// Entries evicted from an overflowing leaf are reinserted once, after which leaves are split as usual.
+				std::vector<typename types::entry> reinsertions;
+				auto ret = m_root->insert(box, value, &reinsertions);
+				if(ret.has_value()) { reroot(std::move(*ret)); }
+				for(auto& [b, v] : reinsertions) {
+					auto reinsert_ret = m_root->insert(b, v);
+					if(reinsert_ret.has_value()) { reroot(std::move(*reinsert_ret)); }
+				}
+			} else {
+				auto ret = m_root->insert(box, value);
+				if(ret.has_value()) { reroot(std::move(*ret)); }
+			}
 		}
 
 		/**
@@ -1078,7 +1871,7 @@ namespace region_map_detail {
 		 * increasing the tree's height by 1.
 		 */
 		void reroot(typename types::insert_result new_sibling) {
-			auto new_root = std::make_unique<typename types::inner_node_type>(false, 0);
+			auto new_root = types::inner_node_type::create(*m_arena, false, 0);
 			const auto old_root_bbox = m_root->get_bounding_box();
 			new_root->insert_child_node(old_root_bbox, std::move(m_root));
 			new_root->insert_child_node(new_sibling.spilled_box, std::move(new_sibling.spilled_node));
@@ -1091,15 +1884,21 @@ namespace region_map_detail {
 		 * are reinserted.
 		 */
 		void erase(const box<Dims>& box) {
+			++m_structure_version;
 			m_erase_orphans.clear();
+			const auto height_before = m_root->get_height();
 			[[maybe_unused]] const auto did_erase = m_root->erase(box, m_erase_orphans);
 			assert(did_erase);
 
+			// Reinserting an orphan can split the root, after which the remaining orphaned subtrees belong one level further down than they were.
 			for(auto& o : m_erase_orphans) {
 				utils::match(
-				    o.second,                                                                                    //
-				    [&](ValueType& v) { insert(o.first, v); },                                                   //
-				    [&](typename types::unique_inner_node_ptr& in) { insert_subtree(o.first, std::move(in)); }); //
+				    o.second, //
+				    [&](ValueType& v) { insert(o.first, v); },
+				    [&](typename types::unique_inner_node_ptr& in) {
+					    in->set_depth(in->get_depth() + (m_root->get_height() - height_before));
+					    insert_subtree(o.first, std::move(in));
+				    });
 			}
 
 			if(!m_root->contains_leaves() && m_root->num_children() == 1) {
@@ -1110,31 +1909,84 @@ namespace region_map_detail {
 		}
 
 		/**
-		 * Calculates whether two boxes can be merged. In order to be mergeable, the two boxes
-		 * have to touch in one dimension and match exactly in all remaining dimensions.
+		 * Performs all update actions in m_update_actions that have not already been processed locally, and adds all inserted boxes
+		 * to m_merge_candidates.
 		 */
-		bool can_merge(const box<Dims>& box_a, const box<Dims>& box_b) const {
-			bool adjacent = false;
-			for(size_t d = 0; d < Dims; ++d) {
-				if(box_a.get_min()[d] != box_b.get_min()[d] || box_a.get_max()[d] != box_b.get_max()[d]) {
-					// Dimension does not match exactly, but could still be adjacent.
-					// If we already are adjacent in another dimension, we cannot merge.
-					if(!adjacent && (box_a.get_max()[d] == box_b.get_min()[d] || box_b.get_max()[d] == box_a.get_min()[d])) {
-						adjacent = true;
-					} else {
-						return false;
-					}
+		void apply_update_actions() {
+#if !defined(NDEBUG)
+			// Sanity check: Erased and inserted boxes must cover the same space
+			region<Dims> erased;
+			region<Dims> inserted;
+			for(const auto& a : m_update_actions) {
+				utils::match(
+				    a,
+				    [&](const typename types::erase_node_action& erase_action) {
+					    assert(region_intersection(erased, erase_action.box).empty());
+					    erased = region_union(erased, erase_action.box);
+				    },
+				    [&](const typename types::insert_node_action& insert_action) {
+					    assert(region_intersection(inserted, insert_action.box).empty());
+					    inserted = region_union(inserted, insert_action.box);
+				    });
+			}
+			assert(erased == inserted);
+#endif
+
+			for(const auto& a : m_update_actions) {
+				utils::match(
+				    a,
+				    [&](const typename types::erase_node_action& erase_action) {
+					    if(!erase_action.processed_locally) { erase(erase_action.box); }
+				    },
+				    [&](const typename types::insert_node_action& insert_action) {
+					    if(!insert_action.processed_locally) { insert(insert_action.box, insert_action.value); }
+					    // Even if the action was processed locally already, we still have to try and merge the new box.
+					    m_merge_candidates.push_back(std::make_pair(insert_action.box, insert_action.value));
+				    });
+			}
+		}
+
+		/**
+		 * Like apply_update_actions, but instead of erasing and inserting entries one by one, bulk-loads a new tree from all entries
+		 * that remain after the update.
+		 */
+		void rebuild_with_update_actions() {
+			const auto min_less = [](const box<Dims>& lhs, const box<Dims>& rhs) {
+				for(int d = 0; d < Dims; ++d) {
+					if(lhs.get_min()[d] != rhs.get_min()[d]) return lhs.get_min()[d] < rhs.get_min()[d];
+				}
+				return false;
+			};
+
+			// Entries don't overlap, so their minimum coordinates identify them uniquely.
+			auto& erased = m_rebuild_erased_boxes;
+			erased.clear();
+			for(const auto& a : m_update_actions) {
+				const auto* const erase_action = std::get_if<typename types::erase_node_action>(&a);
+				if(erase_action != nullptr && !erase_action->processed_locally) { erased.push_back(erase_action->box); }
+			}
+			std::sort(erased.begin(), erased.end(), min_less);
+
+			std::vector<typename types::entry> entries;
+			m_root->for_each([&](const box<Dims>& box, const ValueType& value) {
+				if(!std::binary_search(erased.begin(), erased.end(), box, min_less)) { entries.push_back(std::make_pair(box, value)); }
+			});
+			for(const auto& a : m_update_actions) {
+				if(const auto* const insert_action = std::get_if<typename types::insert_node_action>(&a)) {
+					if(!insert_action->processed_locally) { entries.push_back(std::make_pair(insert_action->box, insert_action->value)); }
+					m_merge_candidates.push_back(std::make_pair(insert_action->box, insert_action->value));
 				}
 			}
 
-			assert(adjacent);
-			return true;
+			m_root.reset(); // Return nodes to the arena before building the new tree
+			++m_structure_version;
+			m_root = types::inner_node_type::bulk_load(*m_arena, std::move(entries));
 		}
 
 		/**
 		 * Try to merge a list of candidate entries with their neighbors within the tree.
 		 */
-		void try_merge(std::vector<typename types::entry>&& merge_candidates) {
+		void try_merge(std::vector<typename types::entry>& merge_candidates) {
 #if !defined(NDEBUG)
 			// Sanity check: Merge candidates do not overlap
 			region<Dims> candidate_union;
@@ -1149,7 +2001,8 @@ namespace region_map_detail {
 			//     If yes, erase the two boxes, insert the new one and add it as a merge candidate.
 			// Repeat until no more merges are possible.
 			bool did_merge = true;
-			std::vector<bool> merged(merge_candidates.size(), false);
+			auto& merged = m_merge_candidates_merged;
+			merged.assign(merge_candidates.size(), false);
 			while(did_merge) {
 				did_merge = false;
 
@@ -1205,9 +2058,6 @@ namespace region_map_detail {
 					}
 				}
 			}
-
-			// Cache candidate allocation (yes, it's ugly)
-			m_merge_candidates = std::move(merge_candidates);
 		}
 
 		/**
@@ -1222,8 +2072,8 @@ namespace region_map_detail {
 
 	// Specialization for 0-dimensional buffers (= a single value of type ValueType).
 	// NOTE: AllScale boxes don't support 0 dimensions. We use 1 for now.
-	template <typename ValueType>
-	class region_map_impl<ValueType, 0> {
+	template <typename ValueType, typename Policy>
+	class region_map_impl<ValueType, 0, Policy> {
 	  public:
 		region_map_impl(const range<0>& /* extent */, ValueType default_value) : m_value(default_value) {}
 
@@ -1240,14 +2090,227 @@ namespace region_map_detail {
 		ValueType m_value;
 	};
 
+	/**
+	 * Region map backend for 1-dimensional buffers. The extent is partitioned into intervals, of which only the start points and values are stored,
+	 * in two sorted vectors. Updates and queries find the first affected interval by binary search and then only touch the intervals they overlap.
+	 * Neighboring intervals with the same value are coalesced upon update, so query results never need to be merged.
+	 */
+	template <typename ValueType, typename Policy>
+	class interval_map {
+		friend struct celerity::detail::region_map_testspy;
+
+	  public:
+		using value_type = ValueType;
+		using policy = Policy;
+		using entry = std::pair<box<1>, ValueType>;
+		static constexpr size_t dimensions = 1;
+
+		interval_map(const range<1>& extent, ValueType default_value = ValueType{}) : m_extent(extent[0]), m_starts{0}, m_values{std::move(default_value)} {}
+
+		void update_box(const box<1>& box, const ValueType& value) {
+			const size_t begin = box.get_min()[0];
+			const size_t end = std::min(box.get_max()[0], m_extent);
+			if(begin >= end) return;
+
+			const size_t first = find_interval(begin);
+			const size_t last = find_interval(end - 1);
+			if(first == last && m_values[first] == value) return;
+
+			// The intervals first..last are replaced by (the remaining head of first), [begin, end) and (the remaining tail of last)
+			const bool keep_head = m_starts[first] < begin;
+			const bool keep_tail = end < get_interval_end(last);
+			std::optional<ValueType> tail_value;
+			if(keep_tail) { tail_value = m_values[last]; }
+
+			const size_t num_old = last - first + 1;
+			const size_t num_new = 1 + keep_head + keep_tail;
+			if(num_new > num_old) {
+				m_starts.insert(m_starts.begin() + static_cast<ptrdiff_t>(last + 1), num_new - num_old, end);
+				m_values.insert(m_values.begin() + static_cast<ptrdiff_t>(last + 1), num_new - num_old, value);
+			} else if(num_new < num_old) {
+				erase_intervals(first + num_new, first + num_old);
+			}
+
+			const size_t updated = first + keep_head;
+			m_starts[updated] = begin;
+			m_values[updated] = value;
+			if(keep_tail) {
+				m_starts[updated + 1] = end;
+				m_values[updated + 1] = std::move(*tail_value);
+			}
+
+			if constexpr(Policy::merge_on_update) {
+				const bool merge_prev = updated > 0 && m_values[updated - 1] == value;
+				const bool merge_next = updated + 1 < m_starts.size() && m_values[updated + 1] == value;
+				if(merge_prev || merge_next) { erase_intervals(merge_prev ? updated : updated + 1, merge_next ? updated + 2 : updated + 1); }
+			}
+
+			sanity_check();
+		}
+
+		void update_region(const region<1>& region, const ValueType& value) {
+			for(const auto& box : region.get_boxes()) {
+				update_box(box, value);
+			}
+		}
+
+		/**
+		 * Replaces all values of the map. The boxes of the partition must be disjoint and cover the extent exactly.
+		 */
+		void reset(std::vector<entry> partition) {
+			std::sort(partition.begin(), partition.end(), [](const entry& lhs, const entry& rhs) { return lhs.first.get_min()[0] < rhs.first.get_min()[0]; });
+			m_starts.clear();
+			m_values.clear();
+			[[maybe_unused]] size_t covered_end = 0;
+			for(auto& [box, value] : partition) {
+				assert(box.get_min()[0] == covered_end && "partition must cover the extent without gaps");
+				covered_end = box.get_max()[0];
+				if(Policy::merge_on_update && !m_values.empty() && m_values.back() == value) continue;
+				m_starts.push_back(box.get_min()[0]);
+				m_values.push_back(std::move(value));
+			}
+			assert(covered_end == m_extent);
+			sanity_check();
+		}
+
+		std::vector<entry> get_region_values(const box<1>& request) const {
+			std::vector<entry> results;
+			query(request, results);
+			return results;
+		}
+
+		std::vector<entry> get_region_values(const region<1>& request) const {
+			// The boxes of a normalized 1D region are sorted and do not touch, so results for different boxes can never be merged
+			std::vector<entry> results;
+			for(const auto& box : request.get_boxes()) {
+				query(box, results);
+			}
+			return results;
+		}
+
+		template <typename Functor>
+		void apply_to_values(const Functor& f) {
+			static_assert(std::is_same_v<std::invoke_result_t<Functor, ValueType>, ValueType>, "Functor must return value of same type");
+
+			for(auto& value : m_values) {
+				value = f(value);
+			}
+			if constexpr(Policy::merge_on_update) {
+				size_t num_kept = 1;
+				for(size_t i = 1; i < m_starts.size(); ++i) {
+					if(m_values[i] == m_values[num_kept - 1]) continue;
+					m_starts[num_kept] = m_starts[i];
+					m_values[num_kept] = std::move(m_values[i]);
+					++num_kept;
+				}
+				m_starts.resize(num_kept);
+				m_values.erase(m_values.begin() + static_cast<ptrdiff_t>(num_kept), m_values.end());
+			}
+
+			sanity_check();
+		}
+
+		/**
+		 * Invokes the provided callback for every entry (box/value pair) within the region map,
+		 * for debugging / testing / instrumentation.
+		 */
+		template <typename Callback>
+		void for_each(const Callback& cb) const {
+			for(size_t i = 0; i < m_starts.size(); ++i) {
+				cb(box<1>(m_starts[i], get_interval_end(i)), m_values[i]);
+			}
+		}
+
+		auto format_to(fmt::format_context::iterator out) const {
+			out = fmt::format_to(out, "Region Map\n");
+			for(size_t i = 0; i < m_starts.size(); ++i) {
+				out = fmt::format_to(out, "  {} : ", box<1>(m_starts[i], get_interval_end(i)));
+				if constexpr(fmt::is_formattable<ValueType>::value) {
+					out = fmt::format_to(out, "{}\n", m_values[i]);
+				} else {
+					out = fmt::format_to(out, "(value not printable)\n");
+				}
+			}
+			return out;
+		}
+
+		range<1> get_extent() const { return range<1>(m_extent); }
+
+		/// The interval map owns no nodes, its two vectors grow like any other.
+		region_map_allocation_statistics get_allocation_statistics() const { return {}; }
+
+		/// Lookups are a binary search already, so there is nothing to gain from caching them.
+		void enable_query_cache(const size_t /* capacity */) {}
+
+		region_map_query_cache_statistics get_query_cache_statistics() const { return {}; }
+
+	  private:
+		size_t m_extent;
+		std::vector<size_t> m_starts; // m_starts[0] is always 0, the last interval ends at m_extent
+		std::vector<ValueType> m_values;
+
+		size_t find_interval(const size_t point) const {
+			return static_cast<size_t>(std::upper_bound(m_starts.begin(), m_starts.end(), point) - m_starts.begin()) - 1;
+		}
+
+		size_t get_interval_end(const size_t index) const { return index + 1 < m_starts.size() ? m_starts[index + 1] : m_extent; }
+
+		void erase_intervals(const size_t first, const size_t last) {
+			m_starts.erase(m_starts.begin() + static_cast<ptrdiff_t>(first), m_starts.begin() + static_cast<ptrdiff_t>(last));
+			m_values.erase(m_values.begin() + static_cast<ptrdiff_t>(first), m_values.begin() + static_cast<ptrdiff_t>(last));
+		}
+
+		// Appends the intervals overlapping request to results
+		void query(const box<1>& request, std::vector<entry>& results) const {
+			const size_t begin = request.get_min()[0];
+			const size_t end = std::min(request.get_max()[0], m_extent);
+			if(begin >= end) return;
+
+			for(size_t i = find_interval(begin); i < m_starts.size() && m_starts[i] < end; ++i) {
+				if constexpr(Policy::clamp_results_to_request_boundary) {
+					results.emplace_back(box<1>(std::max(m_starts[i], begin), std::min(get_interval_end(i), end)), m_values[i]);
+				} else {
+					// Without clamping, an interval spanning several request boxes must only be reported once
+					const box<1> interval(m_starts[i], get_interval_end(i));
+					if(!results.empty() && results.back().first == interval) continue;
+					results.emplace_back(interval, m_values[i]);
+				}
+				if constexpr(Policy::merge_results && !Policy::merge_on_update) {
+					const auto n = results.size();
+					if(n >= 2 && results[n - 2].second == results[n - 1].second && results[n - 2].first.get_max()[0] == results[n - 1].first.get_min()[0]) {
+						results[n - 2].first = box<1>(results[n - 2].first.get_min()[0], results[n - 1].first.get_max()[0]);
+						results.pop_back();
+					}
+				}
+			}
+		}
+
+		void sanity_check() const {
+#if !defined(NDEBUG)
+			assert(m_starts.size() == m_values.size());
+			assert(!m_starts.empty() && m_starts.front() == 0);
+			for(size_t i = 1; i < m_starts.size(); ++i) {
+				assert(m_starts[i - 1] < m_starts[i]);
+				assert(m_starts[i] < m_extent);
+				if constexpr(Policy::merge_on_update) { assert(!(m_values[i - 1] == m_values[i])); }
+			}
+#endif
+		}
+	};
+
+	/// The implementation region_map uses for a given dimensionality.
+	template <typename ValueType, int Dims, typename Policy>
+	using region_map_backend =
+	    std::conditional_t<Dims == 1 && Policy::use_interval_map_for_1d, interval_map<ValueType, Policy>, region_map_impl<ValueType, Dims, Policy>>;
+
 } // namespace region_map_detail
 
 /**
  * The region_map is a spatial data structure for storing values within an n-dimensional extent.
  * Each point within the extent can hold a single value of type ValueType, and all points are initially
- * set to a provided default value.
+ * set to a provided default value. The tree layout can be tuned for an access pattern through a Policy (see region_map_default_policy).
  */
-template <typename ValueType>
+template <typename ValueType, typename Policy = region_map_default_policy>
 class region_map {
 	friend struct region_map_testspy;
 
@@ -1260,10 +2323,34 @@ class region_map {
 		using namespace region_map_detail;
 		assert_dimensionality(box<3>(subrange<3>{id<3>{}, extent}), dims);
 		switch(m_dims) {
-		case 0: m_region_map.template emplace<region_map_impl<ValueType, 0>>(range_cast<0>(extent), default_value); break;
-		case 1: m_region_map.template emplace<region_map_impl<ValueType, 1>>(range_cast<1>(extent), default_value); break;
-		case 2: m_region_map.template emplace<region_map_impl<ValueType, 2>>(range_cast<2>(extent), default_value); break;
-		case 3: m_region_map.template emplace<region_map_impl<ValueType, 3>>(range_cast<3>(extent), default_value); break;
+		case 0: m_region_map.template emplace<region_map_backend<ValueType, 0, Policy>>(range_cast<0>(extent), default_value); break;
+		case 1: m_region_map.template emplace<region_map_backend<ValueType, 1, Policy>>(range_cast<1>(extent), default_value); break;
+		case 2: m_region_map.template emplace<region_map_backend<ValueType, 2, Policy>>(range_cast<2>(extent), default_value); break;
+		case 3: m_region_map.template emplace<region_map_backend<ValueType, 3, Policy>>(range_cast<3>(extent), default_value); break;
+		default: assert(false);
+		}
+	}
+
+	/**
+	 * Constructs a region map from a known partition of its extent, see reset().
+	 */
+	region_map(range<3> extent, int dims, const std::vector<std::pair<box<3>, ValueType>>& partition)
+	    : region_map(extent, dims, partition.front().second) {
+		reset(partition);
+	}
+
+	/**
+	 * Replaces all values of the region map. The boxes of the partition must be disjoint and cover the extent exactly. The tree is bulk-loaded
+	 * from them, which is considerably faster than and results in a better balanced tree than updating the boxes one by one.
+	 */
+	void reset(const std::vector<std::pair<box<3>, ValueType>>& partition) {
+		using namespace region_map_detail;
+		assert(!partition.empty());
+		switch(m_dims) {
+		case 0: get_map<0>().update_box(box_cast<1>(partition.front().first), partition.front().second); break;
+		case 1: get_map<1>().reset(entries_cast<1>(partition)); break;
+		case 2: get_map<2>().reset(entries_cast<2>(partition)); break;
+		case 3: get_map<3>().reset(partition); break;
 		default: assert(false);
 		}
 	}
@@ -1272,9 +2359,16 @@ class region_map {
 	 * Sets a new value for the provided region within the region map.
 	 */
 	void update_region(const region<3>& region, const ValueType& value) {
-		region_map_detail::assert_dimensionality(region, m_dims);
-		for(const auto& box : region.get_boxes()) {
-			update_box(box, value);
+		using namespace region_map_detail;
+		assert_dimensionality(region, m_dims);
+		switch(m_dims) {
+		case 0:
+			if(!region.empty()) { get_map<0>().update_box(box_cast<1>(region.get_boxes().front()), value); }
+			break;
+		case 1: get_map<1>().update_region(region_cast<1>(region), value); break;
+		case 2: get_map<2>().update_region(region_cast<2>(region), value); break;
+		case 3: get_map<3>().update_region(region, value); break;
+		default: assert(false);
 		}
 	}
 
@@ -1298,13 +2392,15 @@ class region_map {
 	 * @returns A list of boxes clamped to the request region, and their associated values.
 	 */
 	std::vector<std::pair<box<3>, ValueType>> get_region_values(const region<3>& request) const {
-		region_map_detail::assert_dimensionality(request, m_dims);
-		std::vector<std::pair<box<3>, ValueType>> results;
-		for(const auto& box : request.get_boxes()) {
-			const auto r = get_region_values(box);
-			results.insert(results.begin(), r.cbegin(), r.cend());
+		using namespace region_map_detail;
+		assert_dimensionality(request, m_dims);
+		switch(m_dims) {
+		case 0: return request.empty() ? std::vector<std::pair<box<3>, ValueType>>{} : get_region_values(request.get_boxes().front());
+		case 1: return entries_cast<3>(get_map<1>().get_region_values(region_cast<1>(request)));
+		case 2: return entries_cast<3>(get_map<2>().get_region_values(region_cast<2>(request)));
+		case 3: return get_map<3>().get_region_values(request);
+		default: assert(false); return {};
 		}
-		return results;
 	}
 
 	/**
@@ -1359,6 +2455,41 @@ class region_map {
 		}
 	}
 
+	/**
+	 * Returns counters for the node storage of this map. 0-dimensional maps store a single value and report no allocations.
+	 */
+	region_map_allocation_statistics get_allocation_statistics() const {
+		switch(m_dims) {
+		case 1: return get_map<1>().get_allocation_statistics();
+		case 2: return get_map<2>().get_allocation_statistics();
+		case 3: return get_map<3>().get_allocation_statistics();
+		default: return {};
+		}
+	}
+
+	/**
+	 * Memoizes the decomposition of the most recent `capacity` distinct requests, see region_map_impl::enable_query_cache. Worthwhile for maps that
+	 * are queried with the same regions over and over while their geometry stays the same, such as the last writers of iteratively accessed buffers.
+	 * 0-dimensional maps have nothing to cache.
+	 */
+	void enable_query_cache(const size_t capacity) {
+		switch(m_dims) {
+		case 1: get_map<1>().enable_query_cache(capacity); break;
+		case 2: get_map<2>().enable_query_cache(capacity); break;
+		case 3: get_map<3>().enable_query_cache(capacity); break;
+		default: break;
+		}
+	}
+
+	region_map_query_cache_statistics get_query_cache_statistics() const {
+		switch(m_dims) {
+		case 1: return get_map<1>().get_query_cache_statistics();
+		case 2: return get_map<2>().get_query_cache_statistics();
+		case 3: return get_map<3>().get_query_cache_statistics();
+		default: return {};
+		}
+	}
+
 	auto format_to(fmt::format_context::iterator out) const {
 		switch(m_dims) {
 		case 1: return get_map<1>().format_to(out);
@@ -1369,18 +2500,27 @@ class region_map {
 
   private:
 	int m_dims;
-	std::variant<std::monostate, region_map_detail::region_map_impl<ValueType, 0>, region_map_detail::region_map_impl<ValueType, 1>,
-	    region_map_detail::region_map_impl<ValueType, 2>, region_map_detail::region_map_impl<ValueType, 3>>
+	std::variant<std::monostate, region_map_detail::region_map_backend<ValueType, 0, Policy>, region_map_detail::region_map_backend<ValueType, 1, Policy>,
+	    region_map_detail::region_map_backend<ValueType, 2, Policy>, region_map_detail::region_map_backend<ValueType, 3, Policy>>
 	    m_region_map;
 
+	template <int DimsOut, int DimsIn>
+	static std::vector<std::pair<box<DimsOut>, ValueType>> entries_cast(const std::vector<std::pair<box<DimsIn>, ValueType>>& entries) {
+		std::vector<std::pair<box<DimsOut>, ValueType>> result;
+		result.reserve(entries.size());
+		std::transform(
+		    entries.cbegin(), entries.cend(), std::back_inserter(result), [](const auto& p) { return std::make_pair(box_cast<DimsOut>(p.first), p.second); });
+		return result;
+	}
+
 	template <int Dims>
-	region_map_detail::region_map_impl<ValueType, Dims>& get_map() {
+	region_map_detail::region_map_backend<ValueType, Dims, Policy>& get_map() {
 		static_assert(Dims >= 0 && Dims <= 3);
 		return std::get<Dims + 1>(m_region_map);
 	}
 
 	template <int Dims>
-	const region_map_detail::region_map_impl<ValueType, Dims>& get_map() const {
+	const region_map_detail::region_map_backend<ValueType, Dims, Policy>& get_map() const {
 		static_assert(Dims >= 0 && Dims <= 3);
 		return std::get<Dims + 1>(m_region_map);
 	}
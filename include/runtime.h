@@ -28,6 +28,7 @@ namespace detail {
 	class executor;
 	class task_manager;
 	class host_object_manager;
+	class load_balancer;
 
 	class runtime_already_started_error : public std::runtime_error {
 	  public:
@@ -110,6 +111,7 @@ namespace detail {
 		std::unique_ptr<host_object_manager> m_host_object_mngr;
 		std::unique_ptr<task_manager> m_task_mngr;
 		std::unique_ptr<executor> m_exec;
+		std::unique_ptr<load_balancer> m_load_balancer;
 
 		std::unique_ptr<detail::task_recorder> m_task_recorder;
 		std::unique_ptr<detail::command_recorder> m_command_recorder;
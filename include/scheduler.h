@@ -14,6 +14,7 @@ namespace detail {
 
 	class distributed_graph_generator;
 	class executor;
+	class load_balancer;
 	class task;
 
 	// Abstract base class to allow different threading implementation in tests
@@ -27,12 +28,20 @@ namespace detail {
 
 		virtual void shutdown();
 
+		/**
+		 * Exchanges kernel throughputs between nodes at every horizon and splits subsequent tasks accordingly. Must be set on all nodes or none,
+		 * before startup().
+		 */
+		void set_load_balancer(load_balancer* lb) { m_load_balancer = lb; }
+
 		/**
 		 * @brief Notifies the scheduler that a new task has been created and is ready for scheduling.
 		 */
 		void notify_task_created(const task* const tsk) { notify(event_task_available{tsk}); }
 
-		void notify_buffer_registered(const buffer_id bid, const int dims, const range<3>& range) { notify(event_buffer_registered{bid, dims, range}); }
+		void notify_buffer_registered(const buffer_id bid, const int dims, const range<3>& range, const size_t elem_size) {
+			notify(event_buffer_registered{bid, dims, range, elem_size});
+		}
 
 	  protected:
 		/**
@@ -53,12 +62,14 @@ namespace detail {
 			buffer_id bid;
 			int dims;
 			celerity::range<3> range;
+			size_t elem_size;
 		};
 		using event = std::variant<event_shutdown, event_task_available, event_buffer_registered>;
 
 		bool m_is_dry_run;
 		std::unique_ptr<distributed_graph_generator> m_dggen;
 		executor* m_exec; // Pointer instead of reference so we can omit for tests / benchmarks
+		load_balancer* m_load_balancer = nullptr;
 
 		std::queue<event> m_available_events;
 		std::queue<event> m_in_flight_events;
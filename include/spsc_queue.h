@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace celerity::detail {
+
+// Unbounded single-producer single-consumer queue. push() and try_pop() are lock-free; pop() spins briefly before putting the consumer to sleep, in which
+// case the producer pays for a notification. This keeps the producer fast as long as the consumer is busy.
+template <typename T>
+class spsc_queue {
+  public:
+	spsc_queue() : m_head(new node()), m_tail(m_head) {}
+
+	spsc_queue(const spsc_queue&) = delete;
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	~spsc_queue() {
+		while(m_head != nullptr) {
+			const auto next = m_head->next.load(std::memory_order_relaxed);
+			delete m_head;
+			m_head = next;
+		}
+	}
+
+	// may only be called from the producer thread
+	void push(T value) {
+		const auto n = new node();
+		n->value.emplace(std::move(value));
+		// Both this store and the load of m_consumer_sleeping are sequentially consistent, pairing with pop(): either the consumer sees the new node, or
+		// we see that it is (about to go) asleep.
+		m_tail->next.store(n, std::memory_order_seq_cst);
+		m_tail = n;
+
+		if(m_consumer_sleeping.load(std::memory_order_seq_cst)) {
+			{
+				std::lock_guard lock(m_mutex);
+				m_consumer_sleeping.store(false, std::memory_order_relaxed);
+			}
+			m_wakeup.notify_one();
+		}
+	}
+
+	// may only be called from the consumer thread
+	std::optional<T> try_pop() {
+		const auto next = m_head->next.load(std::memory_order_seq_cst);
+		if(next == nullptr) return std::nullopt;
+		// next becomes the new sentinel
+		std::optional<T> value(std::move(next->value));
+		next->value.reset();
+		delete m_head;
+		m_head = next;
+		return value;
+	}
+
+	// may only be called from the consumer thread
+	T pop() {
+		for(;;) {
+			for(int i = 0; i < spin_count; ++i) {
+				if(auto value = try_pop()) return std::move(*value);
+				std::this_thread::yield();
+			}
+
+			std::unique_lock lock(m_mutex);
+			m_consumer_sleeping.store(true, std::memory_order_seq_cst);
+			if(auto value = try_pop()) {
+				m_consumer_sleeping.store(false, std::memory_order_relaxed);
+				return std::move(*value);
+			}
+			m_wakeup.wait(lock, [this] { return !m_consumer_sleeping.load(std::memory_order_relaxed); });
+		}
+	}
+
+  private:
+	constexpr static int spin_count = 64;
+
+	struct node {
+		std::optional<T> value;
+		std::atomic<node*> next = nullptr;
+	};
+
+	node* m_head; // owned by the consumer, always a sentinel without a value
+	node* m_tail; // owned by the producer
+
+	std::atomic<bool> m_consumer_sleeping = false;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeup;
+};
+
+} // namespace celerity::detail
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -53,7 +54,7 @@ namespace detail {
 
 		virtual sycl::event operator()(
 		    device_queue& q, const subrange<3> execution_sr, const std::vector<void*>& reduction_ptrs, const bool is_reduction_initializer) const = 0;
-		virtual std::future<host_queue::execution_info> operator()(host_queue& q, const subrange<3>& execution_sr) const = 0;
+		virtual std::future<host_queue::execution_info> operator()(host_queue& q, const subrange<3>& execution_sr, numa_node_id numa_node) const = 0;
 	};
 
 	template <typename Functor>
@@ -66,8 +67,8 @@ namespace detail {
 			return invoke<sycl::event>(q, execution_sr, reduction_ptrs, is_reduction_initializer);
 		}
 
-		std::future<host_queue::execution_info> operator()(host_queue& q, const subrange<3>& execution_sr) const override {
-			return invoke<std::future<host_queue::execution_info>>(q, execution_sr);
+		std::future<host_queue::execution_info> operator()(host_queue& q, const subrange<3>& execution_sr, const numa_node_id numa_node) const override {
+			return invoke<std::future<host_queue::execution_info>>(q, execution_sr, numa_node);
 		}
 
 	  private:
@@ -94,6 +95,10 @@ namespace detail {
 			const auto& [bid, rm] = m_accesses[n];
 			return {bid, rm->get_access_mode()};
 		}
+		std::optional<box<3>> get_nth_access_preimage_bounds(const size_t n, const box<3>& buffer_box, const box<3>& kernel_box) const {
+			return m_accesses[n].second->get_preimage_bounds(buffer_box, kernel_box);
+		}
+		std::optional<range_mapper_signature> get_nth_access_signature(const size_t n) const { return m_accesses[n].second->get_signature(); }
 
 		/**
 		 * @brief Computes the combined access-region for a given buffer, mode and subrange.
@@ -164,6 +169,13 @@ namespace detail {
 
 		const side_effect_map& get_side_effect_map() const { return m_side_effects; }
 
+		/**
+		 * Returns the union of all regions of @p bid that the task reads (or writes) over its entire global range, not including reductions.
+		 * These are computed once on task creation so that dependency analysis does not have to re-evaluate range mappers.
+		 */
+		const region<3>& get_consumed_region(buffer_id bid) const;
+		const region<3>& get_produced_region(buffer_id bid) const;
+
 		const task_geometry& get_geometry() const { return m_geometry; }
 
 		int get_dimensions() const { return m_geometry.dimensions; }
@@ -177,6 +189,22 @@ namespace detail {
 		void set_debug_name(const std::string& debug_name) { m_debug_name = debug_name; }
 		const std::string& get_debug_name() const { return m_debug_name; }
 
+		/**
+		 * Tasks created from a captured command group, either while capturing or replaying, share the slot of that command group. Graph generation uses
+		 * it to recognize tasks it has seen before.
+		 */
+		void set_capture_slot(const capture_slot_id slot) { m_capture_slot = slot; }
+		std::optional<capture_slot_id> get_capture_slot() const { return m_capture_slot; }
+
+		/**
+		 * The number of chunks per node requested through `experimental::oversubscribe`, or std::nullopt to use the default of the graph generator.
+		 */
+		void set_oversubscription_factor(const size_t factor) { m_oversubscription_factor = factor; }
+		std::optional<size_t> get_oversubscription_factor() const { return m_oversubscription_factor; }
+
+		void set_split_strategy(const experimental::split_strategy strategy) { m_split_strategy = strategy; }
+		experimental::split_strategy get_split_strategy() const { return m_split_strategy; }
+
 		bool has_variable_split() const { return m_type == task_type::host_compute || m_type == task_type::device_compute; }
 
 		execution_target get_execution_target() const {
@@ -245,6 +273,12 @@ namespace detail {
 		}
 
 	  private:
+		struct buffer_requirements {
+			buffer_id bid;
+			region<3> consumed;
+			region<3> produced;
+		};
+
 		task_id m_tid;
 		task_type m_type;
 		collective_group_id m_cgid;
@@ -254,9 +288,13 @@ namespace detail {
 		detail::side_effect_map m_side_effects;
 		reduction_set m_reductions;
 		std::string m_debug_name;
+		std::optional<capture_slot_id> m_capture_slot;
+		std::optional<size_t> m_oversubscription_factor;
+		experimental::split_strategy m_split_strategy = experimental::split_strategy::slab;
 		detail::epoch_action m_epoch_action;
 		std::unique_ptr<fence_promise> m_fence_promise;
 		std::vector<std::shared_ptr<lifetime_extending_state>> m_attached_state;
+		std::vector<buffer_requirements> m_buffer_requirements;
 
 		task(task_id tid, task_type type, collective_group_id cgid, task_geometry geometry, std::unique_ptr<command_launcher_storage_base> launcher,
 		    buffer_access_map access_map, detail::side_effect_map side_effects, reduction_set reductions, detail::epoch_action epoch_action,
@@ -268,7 +306,11 @@ namespace detail {
 			// Only host tasks can have side effects
 			assert(this->m_side_effects.empty() || type == task_type::host_compute || type == task_type::collective || type == task_type::master_node
 			       || type == task_type::fence);
+			compute_buffer_requirements();
 		}
+
+		void compute_buffer_requirements();
+		const buffer_requirements* find_buffer_requirements(buffer_id bid) const;
 	};
 
 } // namespace detail
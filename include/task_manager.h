@@ -1,15 +1,23 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <limits>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <variant>
 
 #include "handler.h"
 #include "host_queue.h"
 #include "region_map.h"
+#include "spsc_queue.h"
 #include "task.h"
 #include "task_ring_buffer.h"
 #include "types.h"
@@ -60,39 +68,52 @@ namespace detail {
 	  public:
 		constexpr inline static task_id initial_epoch_task = 0;
 
+		// Number of submissions between a horizon decision of the analysis thread and the insertion of the horizon, see enable_async_dependency_analysis.
+		constexpr inline static size_t async_horizon_delay = 16;
+
 		task_manager(size_t num_collective_nodes, host_queue* queue, detail::task_recorder* recorder);
 
-		virtual ~task_manager() = default;
+		virtual ~task_manager();
 
 		template <typename CGF, typename... Hints>
 		task_id submit_command_group(CGF cgf, Hints... hints) {
-			auto reservation = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
-			const auto tid = reservation.get_tid();
-
-			handler cgh = make_command_group_handler(tid, m_num_collective_nodes);
-			cgf(cgh);
-
-			auto unique_tsk = into_task(std::move(cgh));
-
-			// Require the collective group before inserting the task into the ring buffer, otherwise the executor will try to schedule the collective host
-			// task on a collective-group thread that does not yet exist.
-			// The queue pointer will be null in non-runtime tests.
-			if(m_queue) m_queue->require_collective_group(unique_tsk->get_collective_group_id());
+			std::optional<capture_slot_id> capture_slot;
+			if(m_capture.has_value()) { capture_slot = capture_command_group(cgf); }
+			return submit_command_group_internal(cgf, capture_slot);
+		}
 
-			auto& tsk = register_task_internal(std::move(reservation), std::move(unique_tsk));
-			compute_dependencies(tsk);
+		/**
+		 * Starts recording all command groups submitted from now on, until end_capture() is called. Fences and epochs are not recorded.
+		 */
+		void begin_capture();
 
-			// the following deletion is intentionally redundant with the one happening when waiting for free task slots
-			// we want to free tasks earlier than just when running out of slots,
-			// so that we can potentially reclaim additional resources such as buffers earlier
-			m_task_buffer.delete_up_to(m_latest_epoch_reached.get());
+		/**
+		 * Finishes the capture started by begin_capture(), replacing any previously captured command groups.
+		 */
+		void end_capture();
 
-			invoke_callbacks(&tsk);
+		/**
+		 * Submits the most recently captured command groups again, @p num_iterations times in a row. Graph generation recognizes the resulting tasks and
+		 * re-uses the range mapper results of earlier instances as long as the task geometry and buffer accesses stay the same.
+		 */
+		void replay_capture(size_t num_iterations);
 
-			if(need_new_horizon()) { generate_horizon_task(); }
+		/**
+		 * Moves dependency analysis, task deletion and the invocation of task callbacks onto a dedicated thread, so that submit_command_group only runs the
+		 * command group function on the calling thread. Operations that need the complete task graph (epochs, fences, shutdown) wait for the analysis
+		 * thread to catch up first. Task callbacks must be registered before calling this.
+		 *
+		 * Horizons are inserted async_horizon_delay submissions after the task that triggered them (or at the next epoch or fence), so that task ids only
+		 * depend on the sequence of submissions and match between nodes. The application thread waits for the analysis thread whenever it would
+		 * otherwise run further ahead.
+		 */
+		void enable_async_dependency_analysis();
 
-			return tid;
-		}
+		/**
+		 * Blocks until all command groups submitted so far have been analyzed, then rethrows the first error encountered by the analysis thread, if any.
+		 * Returns immediately when dependencies are analyzed synchronously.
+		 */
+		void await_async_analysis();
 
 		/**
 		 * Inserts an epoch task that depends on the entire execution front and that immediately becomes the current epoch_for_new_tasks and the last writer
@@ -139,18 +160,28 @@ namespace detail {
 		/**
 		 * @brief Shuts down the task_manager, freeing all stored tasks.
 		 */
-		void shutdown() { m_task_buffer.clear(); }
+		void shutdown();
 
 		void set_horizon_step(const int step) {
 			assert(step >= 0);
+			await_async_analysis();
 			m_task_horizon_step_size = step;
 		}
 
 		void set_horizon_max_parallelism(const int para) {
 			assert(para >= 1);
+			await_async_analysis();
 			m_task_horizon_max_parallelism = para;
 		}
 
+		/**
+		 * Sets the number of tasks that can be managed at once before submitting a new task waits for the executor to reach a horizon or epoch.
+		 */
+		void set_task_queue_soft_cap(const size_t cap) {
+			await_async_analysis();
+			m_task_buffer.set_soft_cap(cap);
+		}
+
 		/**
 		 * @brief Notifies the task manager that the given horizon has been executed (used for task deletion).
 		 *
@@ -179,6 +210,27 @@ namespace detail {
 		size_t get_current_task_count() const { return m_task_buffer.get_current_task_count(); }
 
 	  private:
+		struct analysis_job_task {
+			task_ring_buffer::reservation reserve;
+			std::unique_ptr<task> tsk;
+		};
+		struct analysis_job_horizon {
+			task_ring_buffer::reservation reserve;
+		};
+		struct analysis_job_add_buffer {
+			buffer_id bid;
+			int dims;
+			range<3> buffer_range;
+			bool host_initialized;
+		};
+		struct analysis_job_barrier {
+			std::promise<void>* done;
+		};
+		struct analysis_job_shutdown {};
+		using analysis_job = std::variant<analysis_job_task, analysis_job_horizon, analysis_job_add_buffer, analysis_job_barrier, analysis_job_shutdown>;
+
+		constexpr static size_t no_horizon_request = std::numeric_limits<size_t>::max();
+
 		const size_t m_num_collective_nodes;
 		host_queue* m_queue;
 
@@ -233,8 +285,102 @@ namespace detail {
 		// An optional task_recorder which records information about tasks for e.g. printing graphs.
 		mutable detail::task_recorder* m_task_recorder;
 
+		struct captured_command_group {
+			std::function<void(handler&)> cgf;
+			capture_slot_id slot;
+		};
+
+		// Command groups recorded since begin_capture(), if a capture is in progress
+		std::optional<std::vector<captured_command_group>> m_capture;
+		std::vector<captured_command_group> m_captured_command_groups;
+		capture_slot_id m_next_capture_slot = 0;
+
+		// Only modified by the application thread while the analysis thread is not running.
+		bool m_async_analysis = false;
+
+		// Jobs submitted by the application thread, processed in order by the analysis thread.
+		spsc_queue<analysis_job> m_analysis_queue;
+		std::thread m_analysis_thread;
+
+		// Number of command groups submitted since enabling async analysis. Only accessed by the application thread.
+		size_t m_num_async_submissions = 0;
+
+		// Number of submitted command groups the analysis thread has finished with. Modified under m_analysis_progress_mutex so that the application
+		// thread can wait on m_analysis_progress.
+		std::atomic<size_t> m_num_analyzed_submissions = 0;
+		std::mutex m_analysis_progress_mutex;
+		std::condition_variable m_analysis_progress;
+
+		// The analysis thread cannot reserve task ids itself, so it asks the application thread to insert a horizon by storing the index of the
+		// submission after which it decided that one is needed. Inserting the horizon on the next submission would make its task id depend on how far
+		// the application thread has run ahead, so the application thread inserts it exactly async_horizon_delay submissions later instead.
+		// m_horizon_request_pending is only accessed by the thread analyzing tasks and prevents repeated requests until the horizon has been created.
+		std::atomic<size_t> m_horizon_requested_after = no_horizon_request;
+		bool m_horizon_request_pending = false;
+
+		// The first exception thrown on the analysis thread, rethrown on the application thread.
+		std::atomic<bool> m_analysis_failed = false;
+		std::mutex m_analysis_error_mutex;
+		std::exception_ptr m_analysis_error;
+
+		template <typename CGF>
+		task_id submit_command_group_internal(CGF& cgf, const std::optional<capture_slot_id> capture_slot) {
+			if(m_async_analysis) { prepare_async_submission(); }
+
+			auto reservation = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
+			const auto tid = reservation.get_tid();
+
+			handler cgh = make_command_group_handler(tid, m_num_collective_nodes);
+			cgf(cgh);
+
+			auto unique_tsk = into_task(std::move(cgh));
+			if(capture_slot.has_value()) { unique_tsk->set_capture_slot(*capture_slot); }
+
+			// Require the collective group before inserting the task into the ring buffer, otherwise the executor will try to schedule the collective host
+			// task on a collective-group thread that does not yet exist.
+			// The queue pointer will be null in non-runtime tests.
+			if(m_queue) m_queue->require_collective_group(unique_tsk->get_collective_group_id());
+
+			if(m_async_analysis) {
+				m_analysis_queue.push(analysis_job_task{std::move(reservation), std::move(unique_tsk)});
+				++m_num_async_submissions;
+			} else {
+				process_task(std::move(reservation), std::move(unique_tsk));
+			}
+
+			return tid;
+		}
+
+		template <typename CGF>
+		capture_slot_id capture_command_group(const CGF& cgf) {
+			if constexpr(std::is_copy_constructible_v<CGF>) {
+				const capture_slot_id slot = m_next_capture_slot++;
+				m_capture->push_back(captured_command_group{std::function<void(handler&)>(cgf), slot});
+				return slot;
+			} else {
+				throw std::runtime_error("Command groups must be copy-constructible to be captured");
+			}
+		}
+
 		task& register_task_internal(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task);
 
+		// Registers a submitted task, computes its dependencies and creates a horizon if necessary.
+		void process_task(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task);
+
+		void add_buffer_internal(buffer_id bid, const int dims, const range<3>& range, bool host_initialized);
+
+		// Creates a horizon requested by the analysis thread once its position is due and rethrows analysis errors.
+		void prepare_async_submission();
+
+		// Waits until the analysis thread has processed everything submitted so far and rethrows analysis errors, without inserting pending horizons.
+		void drain_async_analysis();
+
+		void await_analyzed_submissions(size_t num_submissions);
+
+		void analysis_thread_main();
+
+		void stop_async_analysis();
+
 		void invoke_callbacks(const task* tsk) const;
 
 		void add_dependency(task& depender, task& dependee, dependency_kind kind, dependency_origin origin);
@@ -249,7 +395,7 @@ namespace detail {
 
 		const std::unordered_set<task*>& get_execution_front() { return m_execution_front; }
 
-		task_id generate_horizon_task();
+		task_id generate_horizon_task(task_ring_buffer::reservation&& reserve);
 
 		void compute_dependencies(task& tsk);
 
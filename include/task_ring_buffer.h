@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "log.h"
 #include "task.h"
@@ -10,7 +13,11 @@
 
 namespace celerity::detail {
 
-constexpr unsigned long task_ringbuffer_size = 1024;
+// Tasks are stored in fixed-size segments which are allocated as the application thread runs ahead and freed once all of their tasks are deleted.
+constexpr size_t task_ring_buffer_segment_size = 1024;
+
+// The number of live tasks beyond which reserving a new task waits for the executor to reach a horizon or epoch.
+constexpr size_t default_task_ring_buffer_soft_cap = 64 * 1024;
 
 class task_ring_buffer {
 	friend struct task_ring_buffer_testspy;
@@ -31,7 +38,9 @@ class task_ring_buffer {
 		}
 		reservation(const reservation&) = delete;            // non copyable
 		reservation& operator=(const reservation&) = delete; // non assignable
-		reservation(reservation&&) = default;                // movable
+		reservation(reservation&& other) noexcept : m_consumed(other.m_consumed), m_tid(other.m_tid), m_buffer(other.m_buffer) {
+			other.m_consumed = true; // the moved-from reservation must not revoke the task id
+		}
 
 		task_id get_tid() const { return m_tid; }
 
@@ -46,6 +55,13 @@ class task_ring_buffer {
 		task_ring_buffer& m_buffer;
 	};
 
+	explicit task_ring_buffer(const size_t soft_cap = default_task_ring_buffer_soft_cap) { set_soft_cap(soft_cap); }
+
+	task_ring_buffer(const task_ring_buffer&) = delete;
+	task_ring_buffer& operator=(const task_ring_buffer&) = delete;
+
+	~task_ring_buffer() { free_segments(); }
+
 	bool has_task(task_id tid) const {
 		return tid >= m_number_of_deleted_tasks.load(std::memory_order_relaxed) // best effort, only reliable from application thread
 		       && tid < m_next_active_tid.load(std::memory_order_acquire);      // synchronizes access to data with put(...)
@@ -53,19 +69,43 @@ class task_ring_buffer {
 
 	size_t get_total_task_count() const { return m_next_active_tid.load(std::memory_order_relaxed); }
 
-	task* find_task(task_id tid) const { return has_task(tid) ? m_data[tid % task_ringbuffer_size].get() : nullptr; }
+	task* find_task(task_id tid) const { return has_task(tid) ? get_slot(tid).get() : nullptr; }
 
 	task* get_task(task_id tid) const {
 		assert(has_task(tid));
-		return m_data[tid % task_ringbuffer_size].get();
+		return get_slot(tid).get();
 	}
 
-	// all member functions beyond this point may *only* be called by the main application thread
+	// all member functions beyond this point may *only* be called by the main application thread.
+	// With asynchronous dependency analysis, put and delete_up_to are called from the task manager's analysis thread instead, while the application thread
+	// keeps reserving task ids. The two sides touch disjoint state, everything else is only called while the analysis thread is idle.
 
 	size_t get_current_task_count() const { //
 		return m_next_active_tid.load(std::memory_order_relaxed) - m_number_of_deleted_tasks.load(std::memory_order_relaxed);
 	}
 
+	size_t get_soft_cap() const { return m_soft_cap; }
+
+	// Lowering the cap below the current task count only takes effect once enough tasks have been deleted.
+	void set_soft_cap(const size_t soft_cap) {
+		assert(soft_cap > 0);
+		m_soft_cap = soft_cap;
+		// live tasks generally do not start at a segment boundary, and reservations can exceed the cap by one
+		const size_t min_directory_size = (soft_cap + task_ring_buffer_segment_size - 1) / task_ring_buffer_segment_size + 2;
+		const auto old_directory = m_directory.load(std::memory_order_relaxed);
+		if(old_directory != nullptr && old_directory->size() >= min_directory_size) return;
+
+		auto new_directory = std::make_unique<segment_directory>(min_directory_size);
+		for(size_t sid = m_first_segment; sid < m_end_segment; ++sid) {
+			(*new_directory)[sid % new_directory->size()].store((*old_directory)[sid % old_directory->size()].load(std::memory_order_relaxed),
+			    std::memory_order_relaxed);
+		}
+		m_directory.store(new_directory.get(), std::memory_order_release);
+		// Other threads might still be looking up tasks through the previous directory, so we keep it alive for as long as the ring buffer exists.
+		// This only happens when the cap is raised, which is rare enough for the memory to not matter.
+		m_directories.push_back(std::move(new_directory));
+	}
+
 	// the task id passed to the wait callback identifies the lowest in-use TID that the ring buffer is aware of
 	using wait_callback = std::function<void(task_id)>;
 
@@ -85,22 +125,31 @@ class task_ring_buffer {
 	void put(reservation&& reserve, std::unique_ptr<task> task) {
 		reserve.consume();
 		assert(m_next_active_tid.load(std::memory_order_relaxed) == reserve.m_tid);
-		m_data[reserve.m_tid % task_ringbuffer_size] = std::move(task);
-		m_next_active_tid.store(reserve.m_tid + 1, std::memory_order_release);
+		while(m_end_segment <= reserve.m_tid / task_ring_buffer_segment_size) {
+			allocate_segment();
+		}
+		get_slot(reserve.m_tid) = std::move(task);
+		m_next_active_tid.store(reserve.m_tid + 1, std::memory_order_release); // also publishes the segment to other threads
 	}
 
 	void delete_up_to(task_id target_tid) {
 		assert(target_tid >= m_number_of_deleted_tasks.load(std::memory_order_relaxed));
-		for(task_id tid = m_number_of_deleted_tasks.load(std::memory_order_relaxed); tid < target_tid; ++tid) {
-			m_data[tid % task_ringbuffer_size].reset();
+		const auto end_tid = std::min<task_id>(target_tid, m_next_active_tid.load(std::memory_order_relaxed));
+		for(task_id tid = m_number_of_deleted_tasks.load(std::memory_order_relaxed); tid < end_tid; ++tid) {
+			get_slot(tid).reset();
 		}
 		m_number_of_deleted_tasks.store(target_tid, std::memory_order_relaxed);
+
+		// Tasks are only deleted once the executor has reached a later horizon or epoch, at which point no other thread will look them up anymore.
+		// The same holds for the segments containing them.
+		while(m_first_segment < m_end_segment && (m_first_segment + 1) * task_ring_buffer_segment_size <= target_tid) {
+			free_first_segment();
+		}
 	}
 
 	void clear() {
-		for(auto&& d : m_data) {
-			d.reset();
-		}
+		free_segments();
+		m_first_segment = m_end_segment = m_next_task_id / task_ring_buffer_segment_size;
 		m_number_of_deleted_tasks.store(m_next_task_id, std::memory_order_relaxed);
 	}
 
@@ -122,16 +171,61 @@ class task_ring_buffer {
 	task_buffer_iterator end() const { return task_buffer_iterator(m_next_task_id, *this); }
 
   private:
+	using segment = std::array<std::unique_ptr<task>, task_ring_buffer_segment_size>;
+	// maps segment i to index i % size(), sized such that all live segments fit without collisions
+	using segment_directory = std::vector<std::atomic<segment*>>;
+
 	// the id of the next task that will be reserved
 	task_id m_next_task_id = 0;
 	// the next task id that will actually be emplaced
 	std::atomic<task_id> m_next_active_tid = task_id(0);
 	// the number of deleted tasks (which is implicitly the start of the active range of the ringbuffer)
 	std::atomic<size_t> m_number_of_deleted_tasks = 0;
-	std::array<std::unique_ptr<task>, task_ringbuffer_size> m_data;
+	size_t m_soft_cap = 0;
+
+	std::atomic<segment_directory*> m_directory = nullptr;
+	// the current directory is the last element, all others might still be read by other threads
+	std::vector<std::unique_ptr<segment_directory>> m_directories;
+	// the range of segment indices (task id / segment size) that are currently allocated
+	size_t m_first_segment = 0;
+	size_t m_end_segment = 0;
+	// the most recently freed segment, kept around to avoid an allocation every time the buffer advances by a segment
+	std::unique_ptr<segment> m_spare_segment;
+
+	std::unique_ptr<task>& get_slot(const task_id tid) const {
+		auto& directory = *m_directory.load(std::memory_order_acquire);
+		const auto seg = directory[tid / task_ring_buffer_segment_size % directory.size()].load(std::memory_order_relaxed);
+		assert(seg != nullptr);
+		return (*seg)[tid % task_ring_buffer_segment_size];
+	}
+
+	void allocate_segment() {
+		auto seg = m_spare_segment != nullptr ? std::move(m_spare_segment) : std::make_unique<segment>();
+		auto& directory = *m_directory.load(std::memory_order_relaxed);
+		assert(m_end_segment - m_first_segment < directory.size());
+		directory[m_end_segment % directory.size()].store(seg.release(), std::memory_order_relaxed);
+		++m_end_segment;
+	}
+
+	void free_first_segment() {
+		auto& directory = *m_directory.load(std::memory_order_relaxed);
+		std::unique_ptr<segment> seg(directory[m_first_segment % directory.size()].exchange(nullptr, std::memory_order_relaxed));
+		++m_first_segment;
+		for(auto& slot : *seg) {
+			slot.reset(); // tasks skipped by delete_up_to
+		}
+		m_spare_segment = std::move(seg);
+	}
+
+	void free_segments() {
+		while(m_first_segment < m_end_segment) {
+			free_first_segment();
+		}
+		m_spare_segment.reset();
+	}
 
 	void wait_for_available_slot(const wait_callback& wc) const {
-		if(m_next_task_id - m_number_of_deleted_tasks.load(std::memory_order_relaxed) >= task_ringbuffer_size) {
+		if(m_next_task_id - m_number_of_deleted_tasks.load(std::memory_order_relaxed) >= m_soft_cap) {
 			wc(static_cast<task_id>(m_number_of_deleted_tasks.load(std::memory_order_relaxed)));
 		}
 	}
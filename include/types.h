@@ -57,6 +57,7 @@ MAKE_PHANTOM_TYPE(reduction_id, size_t)
 MAKE_PHANTOM_TYPE(host_object_id, size_t)
 MAKE_PHANTOM_TYPE(hydration_id, size_t);
 MAKE_PHANTOM_TYPE(transfer_id, size_t)
+MAKE_PHANTOM_TYPE(capture_slot_id, size_t)
 
 
 // declared in this header for include-dependency reasons
@@ -64,6 +65,11 @@ namespace celerity::experimental {
 
 enum class side_effect_order { sequential };
 
+enum class split_strategy {
+	slab,  ///< split along the slowest dimension only
+	block, ///< split along all dimensions into a grid of blocks with minimal surface between them
+};
+
 }
 
 namespace celerity::detail {
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <future>
 #include <limits>
+#include <optional>
 #include <utility>
 
 #include "buffer_transfer_manager.h"
@@ -19,6 +20,7 @@ namespace detail {
 	class task_manager;
 	class reduction_manager;
 	class buffer_manager;
+	class load_balancer;
 
 	class worker_job;
 
@@ -144,22 +146,36 @@ namespace detail {
 	// host-compute jobs, master-node tasks and collective host tasks
 	class host_execute_job : public worker_job {
 	  public:
-		host_execute_job(command_pkg pkg, host_queue& queue, task_manager& tm, buffer_manager& bm)
-		    : worker_job(pkg), m_queue(queue), m_task_mngr(tm), m_buffer_mngr(bm) {
+		host_execute_job(command_pkg pkg, host_queue& queue, task_manager& tm, buffer_manager& bm, load_balancer* lb)
+		    : worker_job(pkg), m_queue(queue), m_task_mngr(tm), m_buffer_mngr(bm), m_load_balancer(lb) {
 			assert(pkg.get_command_type() == command_type::execution);
+			map_accesses(pkg);
+			prefetch_buffers(pkg);
 		}
 
 	  private:
 		host_queue& m_queue;
 		task_manager& m_task_mngr;
 		buffer_manager& m_buffer_mngr;
+		load_balancer* m_load_balancer;
 		std::future<host_queue::execution_info> m_future;
 		bool m_submitted = false;
+		std::optional<std::chrono::steady_clock::time_point> m_release_time;
+		std::vector<subrange<3>> m_access_subranges; // of each buffer access of the task, in order
 
 #if CELERITY_ACCESSOR_BOUNDARY_CHECK
 		std::vector<std::vector<id<3>>> m_oob_indices_per_accessor;
 #endif
 
+		// Evaluates the range mappers of the task for the executed chunk, which the job needs for prefetching, NUMA placement and execution.
+		void map_accesses(const command_pkg& pkg);
+
+		// Jobs are created ahead of their execution, which gives out-of-core buffers a head start on paging in the required data.
+		void prefetch_buffers(const command_pkg& pkg);
+
+		// Picks the NUMA node to run the host task on, or no_numa_node if NUMA placement is disabled.
+		numa_node_id select_numa_node(const task& tsk) const;
+
 		bool execute(const command_pkg& pkg) override;
 		std::string get_description(const command_pkg& pkg) override;
 	};
@@ -170,8 +186,9 @@ namespace detail {
 	 */
 	class device_execute_job : public worker_job {
 	  public:
-		device_execute_job(command_pkg pkg, device_queue& queue, task_manager& tm, buffer_manager& bm, reduction_manager& rm, node_id local_nid)
-		    : worker_job(pkg), m_queue(queue), m_task_mngr(tm), m_buffer_mngr(bm), m_reduction_mngr(rm), m_local_nid(local_nid) {
+		device_execute_job(
+		    command_pkg pkg, device_queue& queue, task_manager& tm, buffer_manager& bm, reduction_manager& rm, node_id local_nid, load_balancer* lb)
+		    : worker_job(pkg), m_queue(queue), m_task_mngr(tm), m_buffer_mngr(bm), m_reduction_mngr(rm), m_local_nid(local_nid), m_load_balancer(lb) {
 			assert(pkg.get_command_type() == command_type::execution);
 		}
 
@@ -181,8 +198,11 @@ namespace detail {
 		buffer_manager& m_buffer_mngr;
 		reduction_manager& m_reduction_mngr;
 		node_id m_local_nid;
+		load_balancer* m_load_balancer;
 		cl::sycl::event m_event;
 		bool m_submitted = false;
+		std::chrono::steady_clock::time_point m_submit_time;
+		std::optional<std::chrono::steady_clock::time_point> m_release_time;
 
 #if CELERITY_ACCESSOR_BOUNDARY_CHECK
 		std::vector<id<3>*> m_oob_indices_per_accessor;
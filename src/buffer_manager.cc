@@ -10,34 +10,131 @@ namespace detail {
 	buffer_manager::buffer_manager(device_queue& queue, buffer_lifecycle_callback lifecycle_cb) : m_queue(queue), m_lifecycle_cb(std::move(lifecycle_cb)) {}
 
 	void buffer_manager::unregister_buffer(buffer_id bid) noexcept {
+		unregistered_buffer stats;
 		{
-			std::unique_lock lock(m_mutex);
-			assert(m_buffer_infos.find(bid) != m_buffer_infos.end());
+			auto& state = m_buffer_states.get(bid);
+			std::lock_guard lock(state.mutex);
+			assert(state.is_registered);
 
 			// Log the allocation size for host and device
-			const auto& buf = m_buffers[bid];
+			const auto& buf = state.buffers;
 			const size_t host_size = buf.host_buf.is_allocated() ? buf.host_buf.storage->get_size() : 0;
 			const size_t device_size = buf.device_buf.is_allocated() ? buf.device_buf.storage->get_size() : 0;
 
 			CELERITY_TRACE("Unregistering buffer {}. host size = {} B, device size = {} B", bid, host_size, device_size);
-			m_buffers.erase(bid);
-			m_buffer_infos.erase(bid);
 
-#if defined(CELERITY_DETAIL_ENABLE_DEBUG)
-			m_buffer_types.erase(bid);
-#endif
+			state.memory.host.free(host_size);
+			state.memory.device.free(device_size);
+			state.memory.scheduled_transfers.free(state.memory.scheduled_transfers.current_bytes);
+			state.is_registered.store(false, std::memory_order_release);
+			stats = {state.info.debug_name, state.memory};
+		}
+
+		std::unique_ptr<buffer_state> state;
+		{
+			std::lock_guard lock(m_registration_mutex);
+			state = m_buffer_states.erase(bid);
+			m_unregistered_buffers.emplace(bid, std::move(stats));
+			if(m_unregistered_buffers.size() > max_retained_unregistered_buffers) {
+				const auto oldest = m_unregistered_buffers.begin();
+				accumulate_memory_statistics(m_forgotten_buffer_memory, oldest->second.memory);
+				m_num_forgotten_buffers++;
+				m_unregistered_buffers.erase(oldest);
+			}
+		}
+		{
+			// Waits for functions that may have looked up the state before it was erased
+			std::unique_lock retirement_lock(m_retirement_mutex);
 		}
+		state.reset(); // releases all backing memory outside of the registration lock
+
+		m_num_active_buffers.fetch_sub(1, std::memory_order_relaxed);
 		m_lifecycle_cb(buffer_lifecycle_event::unregistered, bid);
 	}
 
+	buffer_memory_statistics buffer_manager::get_memory_statistics(const buffer_id bid) const {
+		std::shared_lock retirement_lock(m_retirement_mutex);
+		if(const auto* const state = m_buffer_states.find(bid)) {
+			std::lock_guard lock(state->mutex);
+			return state->memory;
+		}
+		std::lock_guard lock(m_registration_mutex);
+		const auto it = m_unregistered_buffers.find(bid);
+		assert(it != m_unregistered_buffers.end());
+		return it->second.memory;
+	}
+
+	std::string buffer_manager::print_memory_report() const {
+		struct buffer_report {
+			buffer_id bid;
+			std::string name;
+			buffer_memory_statistics stats;
+		};
+
+		// Keeps the states collected below from being destroyed if their buffers are unregistered in the meantime
+		std::shared_lock retirement_lock(m_retirement_mutex);
+
+		std::vector<buffer_report> buffers;
+		std::vector<const buffer_state*> registered_states;
+		size_t num_forgotten_buffers;
+		buffer_memory_statistics forgotten_buffer_memory;
+		{
+			std::lock_guard lock(m_registration_mutex);
+			m_buffer_states.for_each([&](const buffer_state& state) { registered_states.push_back(&state); });
+			for(const auto& [bid, unregistered] : m_unregistered_buffers) {
+				buffers.push_back({bid, unregistered.debug_name, unregistered.memory});
+			}
+			num_forgotten_buffers = m_num_forgotten_buffers;
+			forgotten_buffer_memory = m_forgotten_buffer_memory;
+		}
+		// Buffer state mutexes must not be acquired while holding m_registration_mutex
+		for(const auto* const state : registered_states) {
+			std::lock_guard lock(state->mutex);
+			buffers.push_back({state->bid, state->info.debug_name, state->memory});
+		}
+		std::sort(buffers.begin(), buffers.end(), [](const buffer_report& lhs, const buffer_report& rhs) { return lhs.bid < rhs.bid; });
+
+		const auto format_usage = [](std::string& out, const char* side, const buffer_memory_usage& usage) {
+			fmt::format_to(std::back_inserter(out), "  {} {} / {} B", side, usage.current_bytes, usage.peak_bytes);
+			if(usage.num_resizes > 0) { fmt::format_to(std::back_inserter(out), " ({} resizes, {} B copied)", usage.num_resizes, usage.resize_copy_bytes); }
+		};
+
+		const auto format_statistics = [&](std::string& out, const buffer_memory_statistics& stats) {
+			format_usage(out, "device", stats.device);
+			format_usage(out, "host", stats.host);
+			format_usage(out, "staging", stats.staging);
+			format_usage(out, "transfers", stats.scheduled_transfers);
+			out += '\n';
+		};
+
+		std::string report = "Buffer memory usage (current / peak):\n";
+		buffer_memory_statistics total;
+		if(num_forgotten_buffers > 0) {
+			fmt::format_to(std::back_inserter(report), "\t{} earlier unregistered buffers (sum of peaks):", num_forgotten_buffers);
+			format_statistics(report, forgotten_buffer_memory);
+			accumulate_memory_statistics(total, forgotten_buffer_memory);
+		}
+		for(const auto& [bid, name, stats] : buffers) {
+			fmt::format_to(std::back_inserter(report), "\t{}:", !name.empty() ? fmt::format("B{} \"{}\"", bid, name) : fmt::format("B{}", bid));
+			format_statistics(report, stats);
+			accumulate_memory_statistics(total, stats);
+		}
+		fmt::format_to(std::back_inserter(report), "\tTotal: device {} B, host {} B currently allocated, {} resizes copied {} B", total.device.current_bytes,
+		    total.host.current_bytes, total.device.num_resizes + total.host.num_resizes, total.device.resize_copy_bytes + total.host.resize_copy_bytes);
+		return report;
+	}
+
 	void buffer_manager::get_buffer_data(buffer_id bid, const subrange<3>& sr, void* out_linearized) {
-		std::unique_lock lock(m_mutex);
-		assert(m_buffers.count(bid) == 1 && (m_buffers.at(bid).device_buf.is_allocated() || m_buffers.at(bid).host_buf.is_allocated()));
-		auto data_locations = m_newest_data_location.at(bid).get_region_values(region(sr));
+		auto& state = m_buffer_states.get(bid);
+		std::lock_guard lock(state.mutex);
+		assert(state.is_registered);
+		load_pending_host_init(bid, sr);
+		assert(state.buffers.device_buf.is_allocated() || state.buffers.host_buf.is_allocated());
+		auto data_locations = state.newest_data_location.get_region_values(region(sr));
 
 		// Slow path: We need to obtain current data from both host and device.
 		if(data_locations.size() > 1) {
-			auto& existing_buf = m_buffers[bid].host_buf;
+			auto& existing_buf = state.buffers.host_buf;
 			assert(existing_buf.is_allocated());
 
 			// Make sure newest data resides on the host.
@@ -46,7 +143,7 @@ namespace detail {
 			backing_buffer replacement_buf;
 			if(info.resize_required) {
 				// TODO: Do we really want to allocate host memory for this..? We could also make the buffer storage "coherent" directly.
-				replacement_buf = backing_buffer{m_buffer_infos.at(bid).construct_host(info.new_range), info.new_offset};
+				replacement_buf = backing_buffer{state.info.construct_host(info.new_range, state.host_numa_node), info.new_offset};
 			}
 			existing_buf = make_buffer_subrange_coherent(bid, access_mode::read, std::move(existing_buf), sr, std::move(replacement_buf));
 
@@ -55,58 +152,77 @@ namespace detail {
 
 		// get_buffer_data will race with pending transfers for the same subrange. In case there are pending transfers and a host buffer does not exist yet,
 		// these transfers cannot easily be flushed here as creating a host buffer requires a templated context that knows about DataT.
-		assert(std::none_of(m_scheduled_transfers[bid].begin(), m_scheduled_transfers[bid].end(),
+		assert(std::none_of(state.scheduled_transfers.begin(), state.scheduled_transfers.end(),
 		    [&](const transfer& t) { return !box_intersection(box(sr), box(t.sr)).empty(); }));
 
 		if(data_locations[0].second == data_location::host || data_locations[0].second == data_location::host_and_device) {
-			return m_buffers.at(bid).host_buf.storage->get_data({m_buffers.at(bid).host_buf.get_local_offset(sr.offset), sr.range}, out_linearized);
+			return state.buffers.host_buf.storage->get_data({state.buffers.host_buf.get_local_offset(sr.offset), sr.range}, out_linearized);
 		}
 
-		return m_buffers.at(bid).device_buf.storage->get_data({m_buffers.at(bid).device_buf.get_local_offset(sr.offset), sr.range}, out_linearized);
+		return state.buffers.device_buf.storage->get_data({state.buffers.device_buf.get_local_offset(sr.offset), sr.range}, out_linearized);
 	}
 
 	void buffer_manager::set_buffer_data(buffer_id bid, const subrange<3>& sr, unique_payload_ptr in_linearized) {
-		std::unique_lock lock(m_mutex);
-		assert(m_buffer_infos.count(bid) == 1);
-		m_scheduled_transfers[bid].push_back({std::move(in_linearized), sr});
+		auto& state = m_buffer_states.get(bid);
+		std::lock_guard lock(state.mutex);
+		assert(state.is_registered);
+		// The received data is newer than anything the user initialized the buffer with
+		resolve_pending_host_init(state, access_mode::discard_write, sr);
+		state.memory.scheduled_transfers.allocate(sr.range.size() * state.info.element_size);
+		state.scheduled_transfers.push_back({std::move(in_linearized), sr});
 	}
 
 	buffer_manager::access_info buffer_manager::access_device_buffer(buffer_id bid, access_mode mode, const subrange<3>& sr) {
-		std::unique_lock lock(m_mutex);
-		assert(all_true(range_cast<3>(sr.offset + sr.range) <= m_buffer_infos.at(bid).range));
+		auto& state = m_buffer_states.get(bid);
+		std::lock_guard lock(state.mutex);
+		assert(all_true(range_cast<3>(sr.offset + sr.range) <= state.info.range));
 
-		auto& existing_buf = m_buffers[bid].device_buf;
+		// Host initialization data is staged in the host buffer and then made coherent on the device like any other host data.
+		if(access::mode_traits::is_consumer(mode)) {
+			load_pending_host_init(bid, sr);
+		} else {
+			resolve_pending_host_init(state, mode, sr);
+		}
+
+		auto& existing_buf = state.buffers.device_buf;
 		backing_buffer replacement_buf;
 
 		const auto die = [&](const size_t allocation_size_bytes) {
 			std::string msg = fmt::format("Unable to allocate buffer {} of size {}.\n", bid, allocation_size_bytes);
 			fmt::format_to(std::back_inserter(msg), "\nCurrent allocations:\n");
 			size_t total_bytes = 0;
-			for(const auto& [bid, b] : m_buffers) {
-				if(b.device_buf.is_allocated()) {
-					fmt::format_to(std::back_inserter(msg), "\tBuffer {}: {} bytes\n", bid, b.device_buf.storage->get_size());
-					total_bytes += b.device_buf.storage->get_size();
+			std::lock_guard registration_lock(m_registration_mutex); // keeps other buffers from being unregistered
+			m_buffer_states.for_each([&](const buffer_state& other) {
+				const size_t bytes = other.device_allocation_bytes.load(std::memory_order_relaxed);
+				if(bytes == 0) return;
+				fmt::format_to(std::back_inserter(msg), "\tBuffer {}: {} bytes", other.bid, bytes);
+				// Other buffers may be in use concurrently, only report their detailed statistics if this does not require waiting
+				std::unique_lock other_lock(other.mutex, std::defer_lock);
+				if(&other == &state || other_lock.try_lock()) {
+					fmt::format_to(std::back_inserter(msg), " (peak {} bytes, {} resizes)", other.memory.device.peak_bytes, other.memory.device.num_resizes);
 				}
-			}
+				msg += '\n';
+				total_bytes += bytes;
+			});
 			fmt::format_to(std::back_inserter(msg), "Total usage: {} / {} bytes ({:.1f}%).\n", total_bytes, m_queue.get_global_memory_total_size_bytes(),
 			    100 * static_cast<double>(total_bytes) / static_cast<double>(m_queue.get_global_memory_total_size_bytes()));
 			throw allocation_error(msg);
 		};
 
 		if(!existing_buf.is_allocated()) {
-			const auto allocation_size_bytes = sr.range.size() * m_buffer_infos.at(bid).element_size;
+			const auto allocation_size_bytes = sr.range.size() * state.info.element_size;
 			if(!can_allocate(allocation_size_bytes)) {
 				// TODO: Unless this single allocation exceeds the total available memory on the device we don't need to abort right away,
 				// could evict other buffers first.
 				die(allocation_size_bytes);
 			}
-			replacement_buf = backing_buffer{m_buffer_infos.at(bid).construct_device(sr.range, m_queue), sr.offset};
+			replacement_buf = backing_buffer{state.info.construct_device(sr.range, m_queue), sr.offset};
 		} else if(const auto info = is_resize_required(existing_buf, sr.range, sr.offset); info.resize_required) {
-			const auto element_size = m_buffer_infos.at(bid).element_size;
+			const auto element_size = state.info.element_size;
 			const auto allocation_size_bytes = info.new_range.size() * element_size;
 			if(can_allocate(allocation_size_bytes)) {
 				// Easy path: We can just do the resize on the device directly
-				replacement_buf = backing_buffer{m_buffer_infos.at(bid).construct_device(info.new_range, m_queue), info.new_offset};
+				replacement_buf = backing_buffer{state.info.construct_device(info.new_range, m_queue), info.new_offset};
 			} else {
 				bool spill_to_host = false;
 				// Check if we can do the resize by going through host first (see if we'll be able to fit just the added elements of the resized buffer).
@@ -137,17 +253,19 @@ namespace detail {
 				}
 
 				// We now have all data "backed up" on the host, so we may deallocate the device buffer (via destructor).
+				state.memory.device.free(existing_buf.storage->get_size());
 				existing_buf = backing_buffer{};
-				auto locations = m_newest_data_location.at(bid).get_region_values(retain_region);
+				state.device_allocation_bytes.store(0, std::memory_order_relaxed);
+				auto locations = state.newest_data_location.get_region_values(retain_region);
 				for(auto& [box, locs] : locations) {
 					assert(locs == data_location::host_and_device);
-					m_newest_data_location.at(bid).update_region(box, data_location::host);
+					state.newest_data_location.update_region(box, data_location::host);
 				}
 
 				// Finally create the new device buffer. It will be made coherent with data from the host below.
 				// If we have to spill to host, only allocate the currently requested subrange. Otherwise use bounding box of existing and new range.
 				replacement_buf = backing_buffer{
-				    m_buffer_infos.at(bid).construct_device(spill_to_host ? sr.range : info.new_range, m_queue), spill_to_host ? sr.offset : info.new_offset};
+				    state.info.construct_device(spill_to_host ? sr.range : info.new_range, m_queue), spill_to_host ? sr.offset : info.new_offset};
 			}
 		}
 
@@ -160,27 +278,40 @@ namespace detail {
 		}
 
 		existing_buf = make_buffer_subrange_coherent(bid, mode, std::move(existing_buf), {sr.offset, sr.range}, std::move(replacement_buf));
+		state.device_allocation_bytes.store(existing_buf.storage->get_size(), std::memory_order_relaxed);
 
 		return {existing_buf.storage->get_pointer(), existing_buf.storage->get_range(), existing_buf.offset};
 	}
 
-	buffer_manager::access_info buffer_manager::access_host_buffer(buffer_id bid, access_mode mode, const subrange<3>& sr) {
-		std::unique_lock lock(m_mutex);
-		return access_host_buffer_impl(bid, mode, sr);
+	buffer_manager::access_info buffer_manager::access_host_buffer(buffer_id bid, access_mode mode, const subrange<3>& sr, const numa_node_id numa_node) {
+		auto& state = m_buffer_states.get(bid);
+		std::lock_guard lock(state.mutex);
+		return access_host_buffer_impl(bid, mode, sr, numa_node);
 	}
 
-	buffer_manager::access_info buffer_manager::access_host_buffer_impl(const buffer_id bid, const access_mode mode, const subrange<3>& sr) {
-		assert(all_true(range_cast<3>(sr.offset + sr.range) <= m_buffer_infos.at(bid).range));
+	numa_node_id buffer_manager::get_host_buffer_numa_node(const buffer_id bid) const {
+		const auto* const state = m_buffer_states.find(bid);
+		if(state == nullptr) return no_numa_node;
+		std::lock_guard lock(state->mutex);
+		return state->buffers.host_buf.is_allocated() ? state->host_numa_node : no_numa_node;
+	}
+
+	buffer_manager::access_info buffer_manager::access_host_buffer_impl(
+	    const buffer_id bid, const access_mode mode, const subrange<3>& sr, const numa_node_id numa_node) {
+		auto& state = m_buffer_states.get(bid);
+		assert(all_true(range_cast<3>(sr.offset + sr.range) <= state.info.range));
 
-		auto& existing_buf = m_buffers[bid].host_buf;
+		auto& existing_buf = state.buffers.host_buf;
 		backing_buffer replacement_buf;
 
+		const auto target_numa_node = numa_node != no_numa_node ? numa_node : state.host_numa_node;
 		if(!existing_buf.is_allocated()) {
-			replacement_buf = backing_buffer{m_buffer_infos.at(bid).construct_host(sr.range), sr.offset};
+			replacement_buf = backing_buffer{state.info.construct_host(sr.range, target_numa_node), sr.offset};
 		} else {
 			const auto info = is_resize_required(existing_buf, sr.range, sr.offset);
-			if(info.resize_required) { replacement_buf = backing_buffer{m_buffer_infos.at(bid).construct_host(info.new_range), info.new_offset}; }
+			if(info.resize_required) { replacement_buf = backing_buffer{state.info.construct_host(info.new_range, target_numa_node), info.new_offset}; }
 		}
+		if(replacement_buf.is_allocated()) { state.host_numa_node = target_numa_node; }
 
 		audit_buffer_access(bid, replacement_buf.is_allocated(), mode);
 
@@ -191,41 +322,98 @@ namespace detail {
 		}
 
 		existing_buf = make_buffer_subrange_coherent(bid, mode, std::move(existing_buf), {sr.offset, sr.range}, std::move(replacement_buf));
+		resolve_pending_host_init(state, mode, sr);
 
 		return {existing_buf.storage->get_pointer(), existing_buf.storage->get_range(), existing_buf.offset};
 	}
 
+	void buffer_manager::load_pending_host_init(const buffer_id bid, const subrange<3>& sr) {
+		auto& state = m_buffer_states.get(bid);
+		if(state.pending_host_init_region.empty()) return;
+
+		// These host accesses are part of the access that follows (whose pointer is not affected by them), so they are exempt from auditing.
+		const auto lock_info = std::exchange(state.lock_info, buffer_lock_info{});
+		for(const auto& pending_box : region_intersection(state.pending_host_init_region, box(sr)).get_boxes()) {
+			access_host_buffer_impl(bid, access_mode::read, pending_box.get_subrange());
+		}
+		state.lock_info = lock_info;
+	}
+
+	void buffer_manager::resolve_pending_host_init(buffer_state& state, const access_mode mode, const subrange<3>& sr) {
+		if(state.pending_host_init_region.empty()) return;
+		const auto resolved = region_intersection(state.pending_host_init_region, box(sr));
+		if(resolved.empty()) return;
+
+		if(access::mode_traits::is_consumer(mode)) {
+			// Nothing has been written to these parts since registration, so make_buffer_subrange_coherent did not copy anything into them.
+			const auto& host_buf = state.buffers.host_buf;
+			assert(host_buf.is_allocated());
+			for(const auto& resolved_box : resolved.get_boxes()) {
+				memcpy_strided_host(state.host_init_ptr, host_buf.storage->get_pointer(), state.info.element_size, state.info.range, resolved_box.get_offset(),
+				    host_buf.storage->get_range(), host_buf.get_local_offset(resolved_box.get_offset()), resolved_box.get_range());
+			}
+			state.newest_data_location.update_region(resolved, data_location::host);
+		}
+
+		state.pending_host_init_region = region_difference(state.pending_host_init_region, resolved);
+		if(state.pending_host_init_region.empty()) { state.host_init_ptr = nullptr; }
+	}
+
+	void buffer_manager::prefetch_host_buffer(const buffer_id bid, const subrange<3>& sr) const {
+		const auto* const state = m_buffer_states.find(bid);
+		if(state == nullptr) return;
+		std::lock_guard lock(state->mutex);
+		if(!state->buffers.host_buf.is_allocated()) return;
+
+		const auto& host_buf = state->buffers.host_buf;
+		const auto covered = box_intersection(box(sr), box(subrange<3>(host_buf.offset, host_buf.storage->get_range())));
+		if(covered.empty()) return;
+		host_buf.storage->prefetch({host_buf.get_local_offset(covered.get_offset()), covered.get_range()});
+	}
+
 	bool buffer_manager::try_lock(const buffer_lock_id id, const std::unordered_set<buffer_id>& buffers) {
+		std::lock_guard lock(m_buffer_locks_mutex);
 		assert(m_buffer_locks_by_id.count(id) == 0);
 		for(auto bid : buffers) {
-			if(m_buffer_lock_infos[bid].is_locked) return false;
+			if(m_locked_buffers.count(bid) != 0) return false;
 		}
-		m_buffer_locks_by_id[id].reserve(buffers.size());
+		auto& locked = m_buffer_locks_by_id[id];
+		locked.reserve(buffers.size());
 		for(auto bid : buffers) {
-			m_buffer_lock_infos[bid] = {true, std::nullopt};
-			m_buffer_locks_by_id[id].push_back(bid);
+			m_locked_buffers.insert(bid);
+			locked.push_back(bid);
+			set_lock_info(bid, {true, std::nullopt});
 		}
 		return true;
 	}
 
 	void buffer_manager::unlock(buffer_lock_id id) {
+		std::lock_guard lock(m_buffer_locks_mutex);
 		assert(m_buffer_locks_by_id.count(id) != 0);
 		for(auto bid : m_buffer_locks_by_id[id]) {
-			m_buffer_lock_infos[bid] = {};
+			m_locked_buffers.erase(bid);
+			set_lock_info(bid, {});
 		}
 		m_buffer_locks_by_id.erase(id);
 	}
 
 	bool buffer_manager::is_locked(buffer_id bid) const {
-		if(m_buffer_lock_infos.count(bid) == 0) return false;
-		return m_buffer_lock_infos.at(bid).is_locked;
+		std::lock_guard lock(m_buffer_locks_mutex);
+		return m_locked_buffers.count(bid) != 0;
+	}
+
+	void buffer_manager::set_lock_info(const buffer_id bid, const buffer_lock_info& lock_info) {
+		auto& state = m_buffer_states.get(bid);
+		std::lock_guard lock(state.mutex);
+		state.lock_info = lock_info;
 	}
 
 	// TODO: Something we could look into is to dispatch all memory copies concurrently and wait for them in the end.
 	buffer_manager::backing_buffer buffer_manager::make_buffer_subrange_coherent(
 	    buffer_id bid, cl::sycl::access::mode mode, backing_buffer existing_buffer, const subrange<3>& coherent_sr, backing_buffer replacement_buffer) {
 		backing_buffer target_buffer, previous_buffer;
-		if(replacement_buffer.is_allocated()) {
+		const bool replacement_buffer_allocated = replacement_buffer.is_allocated();
+		if(replacement_buffer_allocated) {
 			assert(!existing_buffer.is_allocated() || replacement_buffer.storage->get_type() == existing_buffer.storage->get_type());
 			target_buffer = std::move(replacement_buffer);
 			previous_buffer = std::move(existing_buffer);
@@ -235,7 +423,33 @@ namespace detail {
 			previous_buffer = {};
 		}
 
-		if(coherent_sr.range.size() == 0) { return target_buffer; }
+		auto& state = m_buffer_states.get(bid);
+		const auto target_type = target_buffer.storage->get_type();
+		auto& memory_stats = state.memory;
+		auto& target_memory = get_memory_usage(state, target_type);
+		if(replacement_buffer_allocated) {
+			// The previous buffer is only released once its contents have been retained, so both count towards the peak.
+			target_memory.allocate(target_buffer.storage->get_size());
+			if(previous_buffer.is_allocated()) { target_memory.num_resizes++; }
+		}
+		const auto release_previous_buffer = [&] {
+			if(previous_buffer.is_allocated()) { target_memory.free(previous_buffer.storage->get_size()); }
+		};
+
+		// Copies between host and device go through a temporary host allocation (see buffer_storage::copy)
+		const auto copy_into_target = [&](const backing_buffer& source, const subrange<3>& box_sr) {
+			const auto bytes = box_sr.range.size() * state.info.element_size;
+			const bool needs_staging = source.storage->get_type() != target_type;
+			if(needs_staging) { memory_stats.staging.allocate(bytes); }
+			target_buffer.storage->copy(*source.storage, source.get_local_offset(box_sr.offset), target_buffer.get_local_offset(box_sr.offset), box_sr.range);
+			if(needs_staging) { memory_stats.staging.free(bytes); }
+			if(&source == &previous_buffer) { target_memory.resize_copy_bytes += bytes; }
+		};
+
+		if(coherent_sr.range.size() == 0) {
+			release_previous_buffer();
+			return target_buffer;
+		}
 
 		const auto target_buffer_location = target_buffer.storage->get_type() == buffer_type::host_buffer ? data_location::host : data_location::device;
 
@@ -267,7 +481,7 @@ namespace detail {
 		{
 			box_vector<3> updated_region_boxes;
 			std::vector<transfer> remaining_transfers;
-			auto& scheduled_buffer_transfers = m_scheduled_transfers[bid];
+			auto& scheduled_buffer_transfers = state.scheduled_transfers;
 			remaining_transfers.reserve(scheduled_buffer_transfers.size() / 2);
 			for(auto& t : scheduled_buffer_transfers) {
 				auto t_box = box(t.sr);
@@ -287,12 +501,15 @@ namespace detail {
 						assert(detail::access::mode_traits::is_consumer(mode));
 						auto intersection = box_intersection(t_box, coherent_box);
 						remaining_region_after_transfers = region_difference(remaining_region_after_transfers, intersection);
-						const auto element_size = m_buffer_infos.at(bid).element_size;
+						const auto element_size = state.info.element_size;
 						auto sr = intersection.get_subrange();
 						// TODO can this temp buffer be avoided?
-						auto tmp = make_uninitialized_payload<std::byte>(sr.range.size() * element_size);
+						const auto tmp_bytes = sr.range.size() * element_size;
+						memory_stats.staging.allocate(tmp_bytes);
+						auto tmp = make_uninitialized_payload<std::byte>(tmp_bytes);
 						linearize_subrange(t.linearized.get_pointer(), tmp.get_pointer(), element_size, t.sr.range, {sr.offset - t.sr.offset, sr.range});
 						target_buffer.storage->set_data({target_buffer.get_local_offset(sr.offset), sr.range}, tmp.get_pointer());
+						memory_stats.staging.free(tmp_bytes);
 						updated_region_boxes.push_back(intersection);
 					}
 					// Transfer only applies partially, or not at all - which means we have to keep it around.
@@ -305,9 +522,10 @@ namespace detail {
 				remaining_region_after_transfers = region_difference(remaining_region_after_transfers, t_box);
 				target_buffer.storage->set_data({target_buffer.get_local_offset(t.sr.offset), t.sr.range}, t.linearized.get_pointer());
 				updated_region_boxes.push_back(t_box);
+				memory_stats.scheduled_transfers.free(t.sr.range.size() * state.info.element_size);
 			}
 			// The target buffer now has the newest data in this region.
-			m_newest_data_location.at(bid).update_region(region(std::move(updated_region_boxes)), target_buffer_location);
+			state.newest_data_location.update_region(region(std::move(updated_region_boxes)), target_buffer_location);
 			scheduled_buffer_transfers = std::move(remaining_transfers);
 		}
 
@@ -315,23 +533,19 @@ namespace detail {
 			const auto maybe_retain_box = [&](const box<3>& box) {
 				if(detail::access::mode_traits::is_consumer(mode)) {
 					// If we are accessing the buffer using a consumer mode, we have to retain the full previous contents, otherwise...
-					const auto box_sr = box.get_subrange();
-					target_buffer.storage->copy(
-					    *previous_buffer.storage, previous_buffer.get_local_offset(box_sr.offset), target_buffer.get_local_offset(box_sr.offset), box_sr.range);
+					copy_into_target(previous_buffer, box.get_subrange());
 				} else {
 					// ...check if there are parts of the previous buffer that we are not going to overwrite (and thus have to retain).
 					// If so, copy only those parts.
 					const auto remaining_region = region_difference(box, coherent_box);
 					for(const auto& small_box : remaining_region.get_boxes()) {
-						const auto small_box_sr = small_box.get_subrange();
-						target_buffer.storage->copy(*previous_buffer.storage, previous_buffer.get_local_offset(small_box_sr.offset),
-						    target_buffer.get_local_offset(small_box_sr.offset), small_box_sr.range);
+						copy_into_target(previous_buffer, small_box.get_subrange());
 					}
 				}
 			};
 
 			box_vector<3> replicated_boxes;
-			auto& buffer_data_locations = m_newest_data_location.at(bid);
+			auto& buffer_data_locations = state.newest_data_location;
 			const auto data_locations = buffer_data_locations.get_region_values(remaining_region_after_transfers);
 			for(auto& dl : data_locations) {
 				// Note that this assertion can fail in legitimate cases, e.g.
@@ -345,21 +559,15 @@ namespace detail {
 					}
 					// Copy from host, unless we are using a pure producer mode
 					else if(dl.second == data_location::host && detail::access::mode_traits::is_consumer(mode)) {
-						assert(m_buffers[bid].host_buf.is_allocated());
-						const auto box_sr = dl.first.get_subrange();
-						const auto& host_buf = m_buffers[bid].host_buf;
-						target_buffer.storage->copy(
-						    *host_buf.storage, host_buf.get_local_offset(box_sr.offset), target_buffer.get_local_offset(box_sr.offset), box_sr.range);
+						assert(state.buffers.host_buf.is_allocated());
+						copy_into_target(state.buffers.host_buf, dl.first.get_subrange());
 						replicated_boxes.push_back(dl.first);
 					}
 				} else if(target_buffer.storage->get_type() == buffer_type::host_buffer) {
 					// Copy from device, unless we are using a pure producer mode
 					if(dl.second == data_location::device && detail::access::mode_traits::is_consumer(mode)) {
-						assert(m_buffers[bid].device_buf.is_allocated());
-						const auto box_sr = dl.first.get_subrange();
-						const auto& device_buf = m_buffers[bid].device_buf;
-						target_buffer.storage->copy(
-						    *device_buf.storage, device_buf.get_local_offset(box_sr.offset), target_buffer.get_local_offset(box_sr.offset), box_sr.range);
+						assert(state.buffers.device_buf.is_allocated());
+						copy_into_target(state.buffers.device_buf, dl.first.get_subrange());
 						replicated_boxes.push_back(dl.first);
 					}
 					// Copy from host in case we are resizing an existing buffer
@@ -373,13 +581,14 @@ namespace detail {
 			buffer_data_locations.update_region(region(std::move(replicated_boxes)), data_location::host_and_device);
 		}
 
-		if(detail::access::mode_traits::is_producer(mode)) { m_newest_data_location.at(bid).update_region(coherent_box, target_buffer_location); }
+		if(detail::access::mode_traits::is_producer(mode)) { state.newest_data_location.update_region(coherent_box, target_buffer_location); }
 
+		release_previous_buffer();
 		return target_buffer;
 	}
 
 	void buffer_manager::audit_buffer_access(buffer_id bid, bool requires_allocation, cl::sycl::access::mode mode) {
-		auto& lock_info = m_buffer_lock_infos[bid];
+		auto& lock_info = m_buffer_states.get(bid).lock_info;
 
 		// Buffer locking is currently opt-in, so if this buffer isn't locked, we won't check anything else.
 		if(!lock_info.is_locked) return;
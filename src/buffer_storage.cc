@@ -1,5 +1,21 @@
 #include "buffer_storage.h"
 
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <ctpl_stl.h>
+
+#include "named_threads.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CELERITY_DETAIL_HAS_STREAMING_STORES 1
+#else
+#define CELERITY_DETAIL_HAS_STREAMING_STORES 0
+#endif
+
 namespace celerity {
 namespace detail {
 
@@ -8,40 +24,186 @@ namespace detail {
 		std::memcpy(target_base_ptr, source_base_ptr, elem_size);
 	}
 
+	namespace {
+
+		// Copies smaller than this are not worth bypassing the cache for, since the target is likely to be read again soon.
+		constexpr size_t streaming_min_copy_bytes = size_t{8} << 20;
+		// Contiguous chunks smaller than this are copied with plain memcpy even if streaming is enabled.
+		constexpr size_t streaming_min_chunk_bytes = 256;
+		// Copies smaller than this are not split across helper threads.
+		constexpr size_t parallel_min_copy_bytes = size_t{32} << 20;
+		// Minimum amount of data each thread copies when splitting.
+		constexpr size_t parallel_min_bytes_per_thread = size_t{8} << 20;
+		constexpr size_t max_copy_threads = 8;
+
+		/**
+		 * A strided copy of up to three dimensions, normalized into a contiguous chunk copied for each of count[0] * count[1] "rows".
+		 *
+		 * Dimensions that are copied in their entirety on both sides are collapsed into the chunk, so that e.g. copying entire planes of a 3D
+		 * buffer results in a single memcpy.
+		 */
+		struct strided_copy_layout {
+			size_t chunk_bytes = 0;
+			size_t count[2] = {1, 1};
+			size_t source_stride[2] = {0, 0};
+			size_t target_stride[2] = {0, 0};
+
+			size_t num_rows() const { return count[0] * count[1]; }
+			size_t total_bytes() const { return num_rows() * chunk_bytes; }
+		};
+
+		strided_copy_layout make_strided_copy_layout(
+		    const size_t elem_size, const range<3>& source_range, const range<3>& target_range, const range<3>& copy_range) {
+			strided_copy_layout layout;
+
+			// Collapse contiguous dimensions, starting from the fastest-moving one
+			int dim = 2;
+			layout.chunk_bytes = elem_size * copy_range[dim];
+			while(dim > 0 && copy_range[dim] == source_range[dim] && copy_range[dim] == target_range[dim]) {
+				--dim;
+				layout.chunk_bytes *= copy_range[dim];
+			}
+
+			// The remaining dimensions (at most two) become loops
+			size_t source_stride = elem_size;
+			size_t target_stride = elem_size;
+			for(int d = 2; d >= dim; --d) {
+				source_stride *= source_range[d];
+				target_stride *= target_range[d];
+			}
+			for(int d = dim - 1, level = 1; d >= 0; --d, --level) {
+				layout.count[level] = copy_range[d];
+				layout.source_stride[level] = source_stride;
+				layout.target_stride[level] = target_stride;
+				source_stride *= source_range[d];
+				target_stride *= target_range[d];
+			}
+
+			// Two loops with matching strides on both sides can be merged into one
+			if(layout.source_stride[0] == layout.count[1] * layout.source_stride[1] && layout.target_stride[0] == layout.count[1] * layout.target_stride[1]) {
+				layout.count[1] *= layout.count[0];
+				layout.count[0] = 1;
+			}
+
+			return layout;
+		}
+
+		void copy_chunk(const std::byte* const source, std::byte* const target, const size_t bytes, const bool streaming) {
+#if CELERITY_DETAIL_HAS_STREAMING_STORES
+			if(streaming && bytes >= streaming_min_chunk_bytes) {
+				// Non-temporal stores require 16-byte aligned targets, so copy the unaligned head and tail separately
+				const size_t head = (16 - reinterpret_cast<uintptr_t>(target) % 16) % 16;
+				std::memcpy(target, source, head);
+				size_t i = head;
+				for(; i + 64 <= bytes; i += 64) {
+					const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+					const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 16));
+					const auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 32));
+					const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 48));
+					_mm_stream_si128(reinterpret_cast<__m128i*>(target + i), a);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(target + i + 16), b);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(target + i + 32), c);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(target + i + 48), d);
+				}
+				std::memcpy(target + i, source + i, bytes - i);
+				return;
+			}
+#else
+			(void)streaming;
+#endif
+			std::memcpy(target, source, bytes);
+		}
+
+		// Copies the byte range [first_byte, last_byte) of the linearized copy, which must not partially cover any rows unless there is only a single row.
+		void copy_strided_range(const strided_copy_layout& layout, const std::byte* const source, std::byte* const target, const size_t first_byte,
+		    const size_t last_byte, const bool streaming) {
+			if(layout.num_rows() == 1) {
+				copy_chunk(source + first_byte, target + first_byte, last_byte - first_byte, streaming);
+			} else {
+				assert(first_byte % layout.chunk_bytes == 0 && last_byte % layout.chunk_bytes == 0);
+				for(size_t row = first_byte / layout.chunk_bytes; row < last_byte / layout.chunk_bytes; ++row) {
+					const size_t i = row / layout.count[1];
+					const size_t j = row % layout.count[1];
+					copy_chunk(source + i * layout.source_stride[0] + j * layout.source_stride[1],
+					    target + i * layout.target_stride[0] + j * layout.target_stride[1], layout.chunk_bytes, streaming);
+				}
+			}
+#if CELERITY_DETAIL_HAS_STREAMING_STORES
+			// Non-temporal stores are weakly ordered, make them visible before signalling completion
+			if(streaming) { _mm_sfence(); }
+#endif
+		}
+
+		size_t get_num_copy_threads() {
+			static const size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency() / 2, max_copy_threads);
+			return num_threads;
+		}
+
+		// Helper threads for large host copies. Created on first use, as most applications never copy enough data to need them.
+		ctpl::thread_pool& get_copy_thread_pool() {
+			static ctpl::thread_pool pool(static_cast<int>(get_num_copy_threads()));
+			static const bool threads_named = [] {
+				for(int i = 0; i < pool.size(); ++i) {
+					set_thread_name(pool.get_thread(i).native_handle(), fmt::format("cy-copy-{}", i));
+				}
+				return true;
+			}(); // IIFE
+			(void)threads_named;
+			return pool;
+		}
+
+		void memcpy_strided_host_impl(const void* const source_base_ptr, void* const target_base_ptr, const size_t elem_size, const range<3>& source_range,
+		    const id<3>& source_offset, const range<3>& target_range, const id<3>& target_offset, const range<3>& copy_range) {
+			if(copy_range.size() == 0) return;
+
+			const auto layout = make_strided_copy_layout(elem_size, source_range, target_range, copy_range);
+			const auto* const source = static_cast<const std::byte*>(source_base_ptr) + elem_size * get_linear_index(source_range, source_offset);
+			auto* const target = static_cast<std::byte*>(target_base_ptr) + elem_size * get_linear_index(target_range, target_offset);
+
+			const size_t total_bytes = layout.total_bytes();
+			const bool streaming = total_bytes >= streaming_min_copy_bytes;
+
+			// Split the copy into parts of whole rows (or arbitrary parts of a single row), the calling thread copies the last one
+			const size_t split_granularity = layout.num_rows() == 1 ? size_t{64} : layout.chunk_bytes;
+			const size_t num_parts = total_bytes >= parallel_min_copy_bytes
+			                             ? std::min({get_num_copy_threads() + 1, total_bytes / parallel_min_bytes_per_thread, total_bytes / split_granularity})
+			                             : 1;
+			if(num_parts <= 1) {
+				copy_strided_range(layout, source, target, 0, total_bytes, streaming);
+				return;
+			}
+
+			const size_t units = total_bytes / split_granularity;
+			const auto part_begin = [&](const size_t part) { return part == num_parts ? total_bytes : units * part / num_parts * split_granularity; };
+			auto& pool = get_copy_thread_pool();
+			std::vector<std::future<void>> pending;
+			pending.reserve(num_parts - 1);
+			for(size_t part = 0; part < num_parts - 1; ++part) {
+				pending.push_back(pool.push([&, part](int /* thread_id */) { copy_strided_range(layout, source, target, part_begin(part), part_begin(part + 1), streaming); }));
+			}
+			copy_strided_range(layout, source, target, part_begin(num_parts - 1), total_bytes, streaming);
+			for(auto& f : pending) {
+				f.get();
+			}
+		}
+
+	} // namespace
+
 	void memcpy_strided_host(const void* source_base_ptr, void* target_base_ptr, size_t elem_size, const range<1>& source_range, const id<1>& source_offset,
 	    const range<1>& target_range, const id<1>& target_offset, const range<1>& copy_range) {
-		const size_t line_size = elem_size * copy_range[0];
-		std::memcpy(static_cast<std::byte*>(target_base_ptr) + elem_size * get_linear_index(target_range, target_offset),
-		    static_cast<const std::byte*>(source_base_ptr) + elem_size * get_linear_index(source_range, source_offset), line_size);
+		memcpy_strided_host_impl(source_base_ptr, target_base_ptr, elem_size, range_cast<3>(source_range), id_cast<3>(source_offset), range_cast<3>(target_range),
+		    id_cast<3>(target_offset), range_cast<3>(copy_range));
 	}
 
-	// TODO Optimize for contiguous copies?
 	void memcpy_strided_host(const void* source_base_ptr, void* target_base_ptr, size_t elem_size, const range<2>& source_range, const id<2>& source_offset,
 	    const range<2>& target_range, const id<2>& target_offset, const range<2>& copy_range) {
-		const size_t line_size = elem_size * copy_range[1];
-		const auto source_base_offset = get_linear_index(source_range, source_offset);
-		const auto target_base_offset = get_linear_index(target_range, target_offset);
-		for(size_t i = 0; i < copy_range[0]; ++i) {
-			std::memcpy(static_cast<std::byte*>(target_base_ptr) + elem_size * (target_base_offset + i * target_range[1]),
-			    static_cast<const std::byte*>(source_base_ptr) + elem_size * (source_base_offset + i * source_range[1]), line_size);
-		}
+		memcpy_strided_host_impl(source_base_ptr, target_base_ptr, elem_size, range_cast<3>(source_range), id_cast<3>(source_offset), range_cast<3>(target_range),
+		    id_cast<3>(target_offset), range_cast<3>(copy_range));
 	}
 
-	// TODO Optimize for contiguous copies?
 	void memcpy_strided_host(const void* source_base_ptr, void* target_base_ptr, size_t elem_size, const range<3>& source_range, const id<3>& source_offset,
 	    const range<3>& target_range, const id<3>& target_offset, const range<3>& copy_range) {
-		// We simply decompose this into a bunch of 2D copies. Subtract offset on the copy plane, as it will be added again during the 2D copy.
-		const auto source_base_offset =
-		    get_linear_index(source_range, source_offset) - get_linear_index(range<2>{source_range[1], source_range[2]}, {source_offset[1], source_offset[2]});
-		const auto target_base_offset =
-		    get_linear_index(target_range, target_offset) - get_linear_index(range<2>{target_range[1], target_range[2]}, {target_offset[1], target_offset[2]});
-		for(size_t i = 0; i < copy_range[0]; ++i) {
-			const auto* const source_ptr =
-			    static_cast<const std::byte*>(source_base_ptr) + elem_size * (source_base_offset + i * (source_range[1] * source_range[2]));
-			auto* const target_ptr = static_cast<std::byte*>(target_base_ptr) + elem_size * (target_base_offset + i * (target_range[1] * target_range[2]));
-			memcpy_strided_host(source_ptr, target_ptr, elem_size, range<2>{source_range[1], source_range[2]}, {source_offset[1], source_offset[2]},
-			    {target_range[1], target_range[2]}, {target_offset[1], target_offset[2]}, {copy_range[1], copy_range[2]});
-		}
+		memcpy_strided_host_impl(source_base_ptr, target_base_ptr, elem_size, source_range, source_offset, target_range, target_offset, copy_range);
 	}
 
 	void linearize_subrange(const void* source_base_ptr, void* target_ptr, size_t elem_size, const range<3>& source_range, const subrange<3>& copy_sr) {
@@ -159,6 +159,14 @@ namespace detail {
 		constexpr int horizon_max = 1024 * 64;
 		const auto env_horizon_step = pref.register_range<int>("HORIZON_STEP", 1, horizon_max);
 		const auto env_horizon_max_para = pref.register_range<int>("HORIZON_MAX_PARALLELISM", 1, horizon_max);
+		const auto env_task_queue_soft_cap = pref.register_range<size_t>("TASK_QUEUE_SOFT_CAP", 128, size_t(1) << 30);
+		const auto env_numa_placement = pref.register_variable<bool>("NUMA_PLACEMENT");
+		const auto env_async_submission = pref.register_variable<bool>("ASYNC_SUBMISSION");
+		const auto env_oversubscription = pref.register_range<size_t>("OVERSUBSCRIPTION", 1, 64);
+		const auto env_locality_aware_assignment = pref.register_variable<bool>("LOCALITY_AWARE_ASSIGNMENT");
+		const auto env_broadcast_trees = pref.register_variable<bool>("BROADCAST_TREES");
+		const auto env_load_balancing = pref.register_variable<bool>("LOAD_BALANCING");
+		const auto env_load_balancing_slowdown = pref.register_range<size_t>("LOAD_BALANCING_SLOWDOWN", 1, 100);
 		[[maybe_unused]] const auto env_gpmv = pref.register_variable<size_t>("GRAPH_PRINT_MAX_VERTS", parse_validate_graph_print_max_verts);
 		[[maybe_unused]] const auto env_force_wg =
 		    pref.register_variable<bool>("FORCE_WG", [](const std::string_view str) { return parse_validate_force_wg(str); });
@@ -204,6 +212,14 @@ namespace detail {
 			m_recording = parsed_and_validated_envs.get_or(env_recording, false);
 			m_horizon_step = parsed_and_validated_envs.get(env_horizon_step);
 			m_horizon_max_parallelism = parsed_and_validated_envs.get(env_horizon_max_para);
+			m_task_queue_soft_cap = parsed_and_validated_envs.get(env_task_queue_soft_cap);
+			m_numa_placement = parsed_and_validated_envs.get_or(env_numa_placement, true);
+			m_async_submission = parsed_and_validated_envs.get_or(env_async_submission, false);
+			m_oversubscription = parsed_and_validated_envs.get(env_oversubscription);
+			m_locality_aware_assignment = parsed_and_validated_envs.get_or(env_locality_aware_assignment, false);
+			m_broadcast_trees = parsed_and_validated_envs.get_or(env_broadcast_trees, false);
+			m_load_balancing = parsed_and_validated_envs.get_or(env_load_balancing, false);
+			m_load_balancing_slowdown = parsed_and_validated_envs.get_or(env_load_balancing_slowdown, size_t{1});
 
 		} else {
 			for(const auto& warn : parsed_and_validated_envs.warnings()) {
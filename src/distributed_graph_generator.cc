@@ -1,8 +1,12 @@
 #include "distributed_graph_generator.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "access_modes.h"
 #include "command.h"
 #include "command_graph.h"
+#include "load_balancer.h"
 #include "recorders.h"
 #include "task.h"
 #include "task_manager.h"
@@ -12,10 +16,6 @@ namespace celerity::detail {
 distributed_graph_generator::distributed_graph_generator(
     const size_t num_nodes, const node_id local_nid, command_graph& cdag, const task_manager& tm, detail::command_recorder* recorder)
     : m_num_nodes(num_nodes), m_local_nid(local_nid), m_cdag(cdag), m_task_mngr(tm), m_recorder(recorder) {
-	if(m_num_nodes > max_num_nodes) {
-		throw std::runtime_error(fmt::format("Number of nodes requested ({}) exceeds compile-time maximum of {}", m_num_nodes, max_num_nodes));
-	}
-
 	// Build initial epoch command (this is required to properly handle anti-dependencies on host-initialized buffers).
 	// We manually generate the first command, this will be replaced by applied horizons or explicit epochs down the line (see
 	// set_epoch_for_new_commands).
@@ -25,66 +25,168 @@ distributed_graph_generator::distributed_graph_generator(
 	m_epoch_for_new_commands = epoch_cmd->get_cid();
 }
 
-void distributed_graph_generator::add_buffer(const buffer_id bid, const int dims, const range<3>& range) {
-	m_buffer_states.emplace(
-	    std::piecewise_construct, std::tuple{bid}, std::tuple{region_map<write_command_state>{range, dims}, region_map<node_bitset>{range, dims}});
+void distributed_graph_generator::add_buffer(const buffer_id bid, const int dims, const range<3>& range, const size_t elem_size) {
+	// Host-initialized and uninitialized buffers are resident on all nodes
+	m_buffer_states.emplace(std::piecewise_construct, std::tuple{bid},
+	    std::tuple{region_map<write_command_state>{range, dims}, region_map<node_set>{range, dims},
+	        region_map<node_set>{range, dims, node_set::all(m_num_nodes)}, elem_size});
+	// Every task queries the last writers with the requirements of each of its chunks, which iterative applications repeat from one task to the next.
+	// The replicated regions change shape with every push, so they would hardly ever hit a cache.
+	m_buffer_states.at(bid).local_last_writer.enable_query_cache(4 * m_num_nodes);
 	// Mark contents as available locally (= don't generate await push commands) and fully replicated (= don't generate push commands).
 	// This is required when tasks access host-initialized or uninitialized buffers.
-	m_buffer_states.at(bid).local_last_writer.update_region(subrange<3>({}, range), m_epoch_for_new_commands);
-	m_buffer_states.at(bid).replicated_regions.update_region(subrange<3>({}, range), node_bitset{}.set());
+	m_buffer_states.at(bid).local_last_writer.update_region(subrange<3>({}, range), write_command_state(m_epoch_for_new_commands, true /* is_replicated */));
+	m_buffer_states.at(bid).replicated_regions.update_region(subrange<3>({}, range), node_set::all(m_num_nodes));
+}
+
+// Splits [offset, offset + range) into num_parts pieces whose sizes are multiples of the granularity and differ by at most one granularity step.
+static std::vector<std::pair<size_t, size_t>> split_dimension(const size_t offset, const size_t range, const size_t granularity, const size_t num_parts) {
+	assert(num_parts > 0 && num_parts <= range / granularity);
+	assert(range % granularity == 0);
+
+	// If range is not divisible by (num_parts * granularity), assign ceil(quotient) to the first few parts and floor(quotient) to the remaining
+	const auto small_part_size = range / (num_parts * granularity) * granularity;
+	const auto large_part_size = small_part_size + granularity;
+	const auto num_large_parts = (range - small_part_size * num_parts) / granularity;
+	assert(num_large_parts * large_part_size + (num_parts - num_large_parts) * small_part_size == range);
+
+	std::vector<std::pair<size_t, size_t>> parts(num_parts);
+	for(size_t i = 0; i < num_large_parts; ++i) {
+		parts[i] = {offset + i * large_part_size, large_part_size};
+	}
+	for(size_t i = num_large_parts; i < num_parts; ++i) {
+		parts[i] = {offset + num_large_parts * large_part_size + (i - num_large_parts) * small_part_size, small_part_size};
+	}
+	return parts;
 }
 
-// We simply split in the first dimension for now
-static std::vector<chunk<3>> split_equal(const chunk<3>& full_chunk, const range<3>& granularity, const size_t num_chunks, const int dims) {
+// Creates the chunks of a grid with num_parts[d] parts along each dimension d, in row-major order
+static std::vector<chunk<3>> split_grid(const chunk<3>& full_chunk, const range<3>& granularity, const std::array<size_t, 3>& num_parts) {
+	std::array<std::vector<std::pair<size_t, size_t>>, 3> parts;
+	for(int d = 0; d < 3; ++d) {
+		parts[d] = split_dimension(full_chunk.offset[d], full_chunk.range[d], granularity[d], num_parts[d]);
+	}
+
+	std::vector<chunk<3>> result;
+	result.reserve(num_parts[0] * num_parts[1] * num_parts[2]);
+	for(const auto& [offset0, range0] : parts[0]) {
+		for(const auto& [offset1, range1] : parts[1]) {
+			for(const auto& [offset2, range2] : parts[2]) {
+				result.push_back({{offset0, offset1, offset2}, {range0, range1, range2}, full_chunk.global_size});
+			}
+		}
+	}
+
 #ifndef NDEBUG
-	assert(num_chunks > 0);
+	size_t total_area = 0;
+	for(const auto& ck : result) {
+		total_area += ck.range.size();
+	}
+	assert(total_area == full_chunk.range.size());
+#endif
+
+	return result;
+}
+
+static std::array<size_t, 3> get_max_num_parts(const chunk<3>& full_chunk, const range<3>& granularity, const int dims) {
+	std::array<size_t, 3> max_parts{1, 1, 1};
 	for(int d = 0; d < dims; ++d) {
 		assert(granularity[d] > 0);
 		assert(full_chunk.range[d] % granularity[d] == 0);
+		max_parts[d] = full_chunk.range[d] / granularity[d];
 	}
-#endif
+	return max_parts;
+}
 
-	// Due to split granularity requirements or if num_workers > global_size[0],
-	// we may not be able to create the requested number of chunks.
-	const auto actual_num_chunks = std::min(num_chunks, full_chunk.range[0] / granularity[0]);
+// Splits along the first dimension only
+static std::vector<chunk<3>> split_slabs(const chunk<3>& full_chunk, const range<3>& granularity, const size_t num_chunks, const int dims) {
+	assert(num_chunks > 0);
+	// Due to split granularity requirements or if num_workers > global_size[0], we may not be able to create the requested number of chunks.
+	const auto max_parts = get_max_num_parts(full_chunk, granularity, dims);
+	return split_grid(full_chunk, granularity, {std::min(num_chunks, max_parts[0]), 1, 1});
+}
 
-	// If global range is not divisible by (actual_num_chunks * granularity),
-	// assign ceil(quotient) to the first few chunks and floor(quotient) to the remaining
-	const auto small_chunk_size_dim0 = full_chunk.range[0] / (actual_num_chunks * granularity[0]) * granularity[0];
-	const auto large_chunk_size_dim0 = small_chunk_size_dim0 + granularity[0];
-	const auto num_large_chunks = (full_chunk.range[0] - small_chunk_size_dim0 * actual_num_chunks) / granularity[0];
-	assert(num_large_chunks * large_chunk_size_dim0 + (actual_num_chunks - num_large_chunks) * small_chunk_size_dim0 == full_chunk.range[0]);
+// Splits along all dimensions into a grid of up to num_chunks blocks. Among all grid shapes with the largest feasible number of blocks, we pick the one
+// with the smallest total area of the faces between blocks, as that is roughly proportional to the amount of data exchanged by stencil-like tasks.
+static std::vector<chunk<3>> split_blocks(const chunk<3>& full_chunk, const range<3>& granularity, const size_t num_chunks, const int dims) {
+	assert(num_chunks > 0);
+	const auto max_parts = get_max_num_parts(full_chunk, granularity, dims);
 
-	std::vector<chunk<3>> result(actual_num_chunks, {full_chunk.offset, full_chunk.range, full_chunk.global_size});
-	for(auto i = 0u; i < num_large_chunks; ++i) {
-		result[i].range[0] = large_chunk_size_dim0;
-		result[i].offset[0] += i * large_chunk_size_dim0;
-	}
-	for(auto i = num_large_chunks; i < actual_num_chunks; ++i) {
-		result[i].range[0] = small_chunk_size_dim0;
-		result[i].offset[0] += num_large_chunks * large_chunk_size_dim0 + (i - num_large_chunks) * small_chunk_size_dim0;
+	// Cutting along dimension d once creates a face with the area of the chunk's cross-section orthogonal to d
+	std::array<size_t, 3> face_area;
+	for(int d = 0; d < 3; ++d) {
+		face_area[d] = full_chunk.range.size() / full_chunk.range[d];
 	}
 
-#ifndef NDEBUG
-	size_t total_range_dim0 = 0;
-	for(size_t i = 0; i < result.size(); ++i) {
-		total_range_dim0 += result[i].range[0];
-		if(i == 0) {
-			assert(result[i].offset[0] == full_chunk.offset[0]);
-		} else {
-			assert(result[i].offset[0] == result[i - 1].offset[0] + result[i - 1].range[0]);
+	for(size_t n = std::min(num_chunks, max_parts[0] * max_parts[1] * max_parts[2]); n > 0; --n) {
+		std::optional<std::array<size_t, 3>> best_grid;
+		size_t best_surface = 0;
+		for(size_t p0 = std::min(n, max_parts[0]); p0 > 0; --p0) {
+			if(n % p0 != 0) continue;
+			for(size_t p1 = std::min(n / p0, max_parts[1]); p1 > 0; --p1) {
+				if((n / p0) % p1 != 0) continue;
+				const size_t p2 = n / p0 / p1;
+				if(p2 > max_parts[2]) continue;
+				const size_t surface = (p0 - 1) * face_area[0] + (p1 - 1) * face_area[1] + (p2 - 1) * face_area[2];
+				if(!best_grid.has_value() || surface < best_surface) {
+					best_grid = {p0, p1, p2};
+					best_surface = surface;
+				}
+			}
 		}
+		if(best_grid.has_value()) return split_grid(full_chunk, granularity, *best_grid);
 	}
-	assert(total_range_dim0 == full_chunk.range[0]);
-#endif
+	return {full_chunk};
+}
 
-	return result;
+// We assign chunks next to each other to the same node (if there are more chunks than nodes), as this is likely to produce less transfers between tasks
+// than a round-robin assignment (for typical stencil codes). This also holds if the number of chunks is not a multiple of the number of nodes, in which
+// case the number of chunks per node differs by at most one.
+static node_id assign_chunk_to_node(const size_t chunk_index, const size_t num_chunks, const size_t num_nodes) {
+	assert(chunk_index < num_chunks);
+	if(num_chunks <= num_nodes) return chunk_index;
+	return chunk_index * num_nodes / num_chunks;
 }
 
-using buffer_requirements_map = std::unordered_map<buffer_id, std::unordered_map<access_mode, region<3>>>;
+// Splits along the first dimension like split_slabs, but sizes the chunks of each node proportionally to its weight
+static std::vector<chunk<3>> split_weighted_slabs(
+    const chunk<3>& full_chunk, const range<3>& granularity, const size_t num_chunks, const int dims, const std::vector<double>& node_weights) {
+	assert(num_chunks > 0);
+	const auto max_parts = get_max_num_parts(full_chunk, granularity, dims);
+	const size_t num_parts = std::min(num_chunks, max_parts[0]);
 
-static buffer_requirements_map get_buffer_requirements_for_mapped_access(const task& tsk, subrange<3> sr, const range<3> global_size) {
-	buffer_requirements_map result;
+	// Nodes with multiple chunks divide their weight evenly among them
+	std::vector<size_t> num_parts_per_node(node_weights.size(), 0);
+	for(size_t i = 0; i < num_parts; ++i) {
+		++num_parts_per_node[assign_chunk_to_node(i, num_parts, node_weights.size())];
+	}
+	std::vector<double> cumulative_weights(num_parts + 1, 0.0);
+	for(size_t i = 0; i < num_parts; ++i) {
+		const auto nid = assign_chunk_to_node(i, num_parts, node_weights.size());
+		cumulative_weights[i + 1] = cumulative_weights[i] + node_weights[nid] / static_cast<double>(num_parts_per_node[nid]);
+	}
+	assert(cumulative_weights.back() > 0);
+
+	// Chunk boundaries are placed in multiples of the granularity, leaving at least one granularity step for every chunk
+	const size_t num_steps = max_parts[0];
+	std::vector<chunk<3>> result;
+	result.reserve(num_parts);
+	size_t begin = 0;
+	for(size_t i = 0; i < num_parts; ++i) {
+		const auto ideal_end = static_cast<size_t>(std::llround(cumulative_weights[i + 1] / cumulative_weights.back() * static_cast<double>(num_steps)));
+		const size_t end = i + 1 == num_parts ? num_steps : std::clamp(ideal_end, begin + 1, num_steps - (num_parts - i - 1));
+		chunk<3> ck = full_chunk;
+		ck.offset[0] = full_chunk.offset[0] + begin * granularity[0];
+		ck.range[0] = (end - begin) * granularity[0];
+		result.push_back(ck);
+		begin = end;
+	}
+	return result;
+}
+
+static void get_buffer_requirements_for_mapped_access(
+    const task& tsk, subrange<3> sr, const range<3> global_size, std::unordered_map<buffer_id, std::unordered_map<access_mode, region<3>>>& result) {
+	result.clear();
 	const auto& access_map = tsk.get_buffer_access_map();
 	const auto buffers = access_map.get_accessed_buffers();
 	for(const buffer_id bid : buffers) {
@@ -93,7 +195,296 @@ static buffer_requirements_map get_buffer_requirements_for_mapped_access(const t
 			result[bid][m] = access_map.get_mode_requirements(bid, m, tsk.get_dimensions(), sr, global_size);
 		}
 	}
-	return result;
+}
+
+static bool has_same_geometry(const task_geometry& lhs, const task_geometry& rhs) {
+	return lhs.dimensions == rhs.dimensions && lhs.global_size == rhs.global_size && lhs.global_offset == rhs.global_offset
+	       && lhs.granularity == rhs.granularity;
+}
+
+static bool has_same_range_mappers(const std::vector<std::optional<range_mapper_signature>>& signatures, const buffer_access_map& access_map) {
+	if(signatures.size() != access_map.get_num_accesses()) return false;
+	for(size_t i = 0; i < signatures.size(); ++i) {
+		if(!signatures[i].has_value() || signatures[i] != access_map.get_nth_access_signature(i)) return false;
+	}
+	return true;
+}
+
+distributed_graph_generator::mapped_requirements& distributed_graph_generator::get_mapped_requirements(
+    const task& tsk, const std::vector<chunk<3>>& chunks) {
+	const auto& access_map = tsk.get_buffer_access_map();
+
+	auto* reqs = &m_uncaptured_requirements;
+	if(const auto slot = tsk.get_capture_slot(); slot.has_value()) {
+		reqs = &m_captured_requirements[*slot];
+		// A replayed command group is not guaranteed to produce the same task, e.g. if it captures its global range by reference
+		// The chunks can differ even if the geometry does not, e.g. when the split weights were updated
+		bool matches = has_same_geometry(reqs->geometry, tsk.get_geometry()) && reqs->accesses.size() == access_map.get_num_accesses()
+		               && reqs->chunks == chunks && has_same_range_mappers(reqs->signatures, access_map);
+		for(size_t i = 0; matches && i < reqs->accesses.size(); ++i) {
+			matches = reqs->accesses[i] == access_map.get_nth_access(i);
+		}
+		if(matches) return *reqs;
+	}
+
+	reqs->geometry = tsk.get_geometry();
+	reqs->accesses.clear();
+	for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+		reqs->accesses.push_back(access_map.get_nth_access(i));
+	}
+	reqs->chunks = chunks;
+	reqs->chunk_requirements.resize(chunks.size());
+	reqs->is_chunk_evaluated.assign(chunks.size(), false);
+	const subrange<3> full_sr(tsk.get_global_offset(), tsk.get_global_size());
+	get_buffer_requirements_for_mapped_access(tsk, full_sr, tsk.get_global_size(), reqs->global_requirements);
+	reqs->signatures.clear();
+	if(tsk.get_capture_slot().has_value()) {
+		for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+			reqs->signatures.push_back(access_map.get_nth_access_signature(i));
+		}
+	}
+	return *reqs;
+}
+
+const distributed_graph_generator::buffer_requirements_map& distributed_graph_generator::get_chunk_requirements(
+    mapped_requirements& mapped, const task& tsk, const chunk<3>& chnk, const size_t chunk_index) {
+	if(!mapped.is_chunk_evaluated[chunk_index]) {
+		get_buffer_requirements_for_mapped_access(tsk, chnk, tsk.get_global_size(), mapped.chunk_requirements[chunk_index]);
+		mapped.is_chunk_evaluated[chunk_index] = true;
+	}
+	return mapped.chunk_requirements[chunk_index];
+}
+
+std::optional<box_vector<3>> distributed_graph_generator::get_push_candidate_bounds(const task& tsk) {
+	// Reductions push partial results to every other node, regardless of the data distribution
+	if(!tsk.has_variable_split() || !tsk.get_reductions().empty()) return std::nullopt;
+
+	const box<3> kernel_box(subrange<3>(tsk.get_global_offset(), tsk.get_global_size()));
+	const auto& access_map = tsk.get_buffer_access_map();
+	box_vector<3> candidate_bounds;
+	for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+		const auto [bid, mode] = access_map.get_nth_access(i);
+		if(!access::mode_traits::is_consumer(mode)) continue;
+
+		const auto& buffer_state = m_buffer_states.at(bid);
+		if(buffer_state.pending_reduction.has_value()) return std::nullopt;
+
+		// We only ever push fresh data that this node has produced itself
+		box<3> owned_bounds;
+		for(const auto& [box, wcs] : buffer_state.local_last_writer.get_region_values(tsk.get_consumed_region(bid))) {
+			if(wcs.is_fresh() && !wcs.is_replicated()) { owned_bounds = bounding_box(owned_bounds, box); }
+		}
+		if(owned_bounds.empty()) continue;
+
+		const auto preimage = access_map.get_nth_access_preimage_bounds(i, owned_bounds, kernel_box);
+		if(!preimage.has_value()) return std::nullopt;
+		if(!preimage->empty()) { candidate_bounds.push_back(*preimage); }
+	}
+	return candidate_bounds;
+}
+
+const std::vector<double>* distributed_graph_generator::get_split_weights(const task& tsk) const {
+	if(!tsk.has_variable_split() || tsk.get_split_strategy() != experimental::split_strategy::slab) return nullptr;
+	if(!is_load_balanced_kernel(tsk.get_debug_name())) return nullptr;
+	const auto it = m_split_weights.find(tsk.get_debug_name());
+	return it != m_split_weights.end() ? &it->second : nullptr;
+}
+
+std::vector<node_id> distributed_graph_generator::assign_chunks_to_nodes(const task& tsk, const std::vector<chunk<3>>& chunks, mapped_requirements& mapped) {
+	std::vector<node_id> contiguous_assignment(chunks.size());
+	for(size_t i = 0; i < chunks.size(); ++i) {
+		contiguous_assignment[i] = assign_chunk_to_node(i, chunks.size(), m_num_nodes);
+	}
+	// Collective host tasks and fences have one fixed chunk per node, and master node tasks must run on node 0. Weighted chunks are sized for the node
+	// they are assigned to. Reductions that include the current buffer value read it on node 0, which therefore must execute a chunk.
+	if(!m_locality_aware_assignment || !tsk.has_variable_split() || chunks.size() < 2 || get_split_weights(tsk) != nullptr
+	    || !tsk.get_reductions().empty()) {
+		return contiguous_assignment;
+	}
+
+	// For every chunk and node, determine how many of the bytes read by the chunk are already resident on that node
+	std::vector<size_t> consumed_bytes(chunks.size(), 0);
+	std::vector<size_t> resident_bytes(chunks.size() * m_num_nodes, 0);
+	for(size_t i = 0; i < chunks.size(); ++i) {
+		for(const auto& [bid, reqs_by_mode] : get_chunk_requirements(mapped, tsk, chunks[i], i)) {
+			region<3> consumed;
+			for(const auto& [mode, req] : reqs_by_mode) {
+				if(access::mode_traits::is_consumer(mode)) { consumed = region_union(consumed, req); }
+			}
+			const auto& buffer_state = m_buffer_states.at(bid);
+			for(const auto& [box, nodes] : buffer_state.resident_nodes.get_region_values(consumed)) {
+				const size_t bytes = box.get_area() * buffer_state.elem_size;
+				consumed_bytes[i] += bytes;
+				for(node_id nid = 0; nid < m_num_nodes; ++nid) {
+					if(nodes.test(nid)) { resident_bytes[i * m_num_nodes + nid] += bytes; }
+				}
+			}
+		}
+	}
+
+	// Every node receives the same number of chunks as with the contiguous assignment, i.e. either floor or ceil of chunks per node
+	const size_t min_chunks_per_node = chunks.size() / m_num_nodes;
+	size_t num_extra_chunks = chunks.size() % m_num_nodes;
+	std::vector<size_t> num_chunks_per_node(m_num_nodes, 0);
+	std::vector<node_id> locality_assignment(chunks.size());
+	std::vector<bool> is_assigned(chunks.size(), false);
+	const auto try_assign = [&](const size_t chunk_index, const node_id nid) {
+		if(is_assigned[chunk_index] || num_chunks_per_node[nid] > min_chunks_per_node) return false;
+		if(num_chunks_per_node[nid] == min_chunks_per_node) {
+			if(num_extra_chunks == 0) return false;
+			--num_extra_chunks;
+		}
+		locality_assignment[chunk_index] = nid;
+		is_assigned[chunk_index] = true;
+		++num_chunks_per_node[nid];
+		return true;
+	};
+
+	// Greedily match chunks with the nodes holding most of their inputs. Ties are broken by chunk index and node id, so that all nodes arrive at the same
+	// assignment.
+	struct candidate {
+		size_t resident_bytes;
+		size_t chunk_index;
+		node_id nid;
+	};
+	std::vector<candidate> candidates;
+	for(size_t i = 0; i < chunks.size(); ++i) {
+		for(node_id nid = 0; nid < m_num_nodes; ++nid) {
+			if(resident_bytes[i * m_num_nodes + nid] > 0) { candidates.push_back({resident_bytes[i * m_num_nodes + nid], i, nid}); }
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const candidate& lhs, const candidate& rhs) {
+		if(lhs.resident_bytes != rhs.resident_bytes) return lhs.resident_bytes > rhs.resident_bytes;
+		return std::pair{lhs.chunk_index, lhs.nid} < std::pair{rhs.chunk_index, rhs.nid};
+	});
+	for(const auto& c : candidates) {
+		try_assign(c.chunk_index, c.nid);
+	}
+	// Chunks without any resident inputs preferably go where the contiguous assignment would put them
+	for(size_t i = 0; i < chunks.size(); ++i) {
+		if(try_assign(i, contiguous_assignment[i])) continue;
+		for(node_id nid = 0; nid < m_num_nodes && !is_assigned[i]; ++nid) {
+			try_assign(i, nid);
+		}
+		assert(is_assigned[i]);
+	}
+
+	const auto get_bytes_moved = [&](const std::vector<node_id>& assignment) {
+		size_t bytes_moved = 0;
+		for(size_t i = 0; i < chunks.size(); ++i) {
+			bytes_moved += consumed_bytes[i] - resident_bytes[i * m_num_nodes + assignment[i]];
+		}
+		return bytes_moved;
+	};
+	return get_bytes_moved(locality_assignment) < get_bytes_moved(contiguous_assignment) ? locality_assignment : contiguous_assignment;
+}
+
+void distributed_graph_generator::update_resident_nodes(
+    const task& tsk, const std::vector<chunk<3>>& chunks, const std::vector<node_id>& chunk_nodes, mapped_requirements& mapped) {
+	// A node reading a region receives its newest version (or already holds it). Writes then invalidate all other copies.
+	for(const bool is_write_pass : {false, true}) {
+		for(size_t i = 0; i < chunks.size(); ++i) {
+			for(const auto& [bid, reqs_by_mode] : get_chunk_requirements(mapped, tsk, chunks[i], i)) {
+				auto& resident_nodes = m_buffer_states.at(bid).resident_nodes;
+				for(const auto& [mode, req] : reqs_by_mode) {
+					if(is_write_pass && access::mode_traits::is_producer(mode)) {
+						resident_nodes.update_region(req, node_set{}.set(chunk_nodes[i]));
+					} else if(!is_write_pass && access::mode_traits::is_consumer(mode)) {
+						for(const auto& [box, nodes] : resident_nodes.get_region_values(req)) {
+							resident_nodes.update_box(box, node_set{nodes}.set(chunk_nodes[i]));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+std::vector<distributed_graph_generator::broadcast_tree> distributed_graph_generator::plan_broadcast_trees(
+    const task& tsk, const std::vector<chunk<3>>& chunks, const std::vector<node_id>& chunk_nodes, mapped_requirements& mapped) {
+	std::vector<broadcast_tree> trees;
+	// Reductions push their partial results to every other node anyway
+	if(!m_broadcast_trees || !tsk.get_reductions().empty() || chunks.size() <= min_broadcast_tree_receivers) return trees;
+
+	const auto get_consumed_region = [&](const size_t chunk_index, const buffer_id bid) {
+		region<3> consumed;
+		const auto& reqs = get_chunk_requirements(mapped, tsk, chunks[chunk_index], chunk_index);
+		if(const auto it = reqs.find(bid); it != reqs.end()) {
+			for(const auto& [mode, req] : it->second) {
+				if(access::mode_traits::is_consumer(mode)) { consumed = region_union(consumed, req); }
+			}
+		}
+		return consumed;
+	};
+
+	std::vector<bool> is_reader(m_num_nodes, false);
+	for(const auto nid : chunk_nodes) {
+		is_reader[nid] = true;
+	}
+
+	for(const auto& [bid, _] : get_chunk_requirements(mapped, tsk, chunks[0], 0)) {
+		auto& buffer_state = m_buffer_states.at(bid);
+		if(buffer_state.pending_reduction.has_value()) continue;
+
+		region<3> common_reads = get_consumed_region(0, bid);
+		for(size_t i = 1; i < chunks.size() && !common_reads.empty(); ++i) {
+			common_reads = region_intersection(common_reads, get_consumed_region(i, bid));
+		}
+		if(common_reads.empty()) continue;
+
+		for(const auto& [box, holders] : buffer_state.resident_nodes.get_region_values(common_reads)) {
+			if(holders.none()) continue;
+			// The tree is rooted at the lowest node holding the data, receivers follow in the order of their distance from the root
+			node_id root = 0;
+			while(!holders.test(root)) {
+				++root;
+			}
+			broadcast_tree tree{bid, box, {root}};
+			for(size_t offset = 1; offset < m_num_nodes; ++offset) {
+				const node_id nid = (root + offset) % m_num_nodes;
+				if(is_reader[nid] && !holders.test(nid)) { tree.nodes.push_back(nid); }
+			}
+			if(tree.nodes.size() - 1 < min_broadcast_tree_receivers) continue;
+
+			const node_set receivers(std::vector<node_id>(tree.nodes.begin() + 1, tree.nodes.end()));
+			for(const auto& [replicated_box, nodes] : buffer_state.replicated_regions.get_region_values(box)) {
+				buffer_state.replicated_regions.update_box(replicated_box, nodes | receivers);
+			}
+			trees.push_back(std::move(tree));
+		}
+	}
+	return trees;
+}
+
+void distributed_graph_generator::generate_broadcast_pushes(
+    const task& tsk, const broadcast_tree& tree, const std::vector<node_id>& chunk_nodes, std::vector<push_command*>& generated_pushes) {
+	const auto local_it = std::find(tree.nodes.begin(), tree.nodes.end(), m_local_nid);
+	if(local_it == tree.nodes.end()) return;
+	const size_t position = local_it - tree.nodes.begin();
+
+	auto& buffer_state = m_buffer_states.at(tree.bid);
+	const auto sources = buffer_state.local_last_writer.get_region_values(tree.transferred_box);
+
+	// In a binomial tree, the node at position p receives from p minus its highest set bit and forwards to all positions p + 2^k with 2^k > p
+	for(size_t step = 1; position + step < tree.nodes.size(); step *= 2) {
+		if(step <= position) continue;
+		const node_id target_nid = tree.nodes[position + step];
+		// The target receives the data into the await push of its first chunk, since all of its chunks read it
+		const size_t target_chunk = std::find(chunk_nodes.begin(), chunk_nodes.end(), target_nid) - chunk_nodes.begin();
+		assert(target_chunk < chunk_nodes.size());
+		const transfer_id trid = static_cast<transfer_id>((tsk.get_id() << 32) | target_chunk);
+
+		for(const auto& [box, wcs] : sources) {
+			assert(wcs.is_fresh());
+			auto* const push_cmd = create_command<push_command>(tree.bid, 0, target_nid, trid, box.get_subrange());
+			// On intermediate nodes, the last writer is the await push of this task. Forwarding starts as soon as it has completed.
+			m_cdag.add_dependency(push_cmd, m_cdag.get(wcs), dependency_kind::true_dep, dependency_origin::dataflow);
+			generated_pushes.push_back(push_cmd);
+
+			// Store the read access for determining anti-dependencies later on
+			m_command_buffer_reads[push_cmd->get_cid()][tree.bid] = region<3>(box);
+		}
+	}
 }
 
 std::unordered_set<abstract_command*> distributed_graph_generator::build_task(const task& tsk) {
@@ -147,7 +538,9 @@ std::unordered_set<abstract_command*> distributed_graph_generator::build_task(co
 
 void distributed_graph_generator::generate_distributed_commands(const task& tsk) {
 	chunk<3> full_chunk{tsk.get_global_offset(), tsk.get_global_size(), tsk.get_global_size()};
-	const size_t num_chunks = m_num_nodes * 1; // TODO Make configurable
+	// Multiple chunks per node would produce multiple partial results per node, which we cannot handle for reductions (see assertion in build_task)
+	const size_t oversubscription_factor = tsk.get_reductions().empty() ? tsk.get_oversubscription_factor().value_or(m_oversubscription_factor) : 1;
+	const size_t num_chunks = m_num_nodes * oversubscription_factor;
 	const auto chunks = ([&] {
 		if(tsk.get_type() == task_type::collective || tsk.get_type() == task_type::fence) {
 			std::vector<chunk<3>> chunks;
@@ -156,17 +549,20 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 			}
 			return chunks;
 		}
-		if(tsk.has_variable_split()) { return split_equal(full_chunk, tsk.get_granularity(), num_chunks, tsk.get_dimensions()); }
+		if(tsk.has_variable_split()) {
+			if(tsk.get_split_strategy() == experimental::split_strategy::block) {
+				return split_blocks(full_chunk, tsk.get_granularity(), num_chunks, tsk.get_dimensions());
+			}
+			if(const auto* const weights = get_split_weights(tsk)) {
+				return split_weighted_slabs(full_chunk, tsk.get_granularity(), num_chunks, tsk.get_dimensions(), *weights);
+			}
+			return split_slabs(full_chunk, tsk.get_granularity(), num_chunks, tsk.get_dimensions());
+		}
 		return std::vector<chunk<3>>{full_chunk};
 	})();
 	assert(chunks.size() <= num_chunks); // We may have created less than requested
 	assert(!chunks.empty());
 
-	// Assign each chunk to a node
-	// We assign chunks next to each other to the same worker (if there is more chunks than workers), as this is likely to produce less
-	// transfers between tasks than a round-robin assignment (for typical stencil codes).
-	// FIXME: This only works if the number of chunks is an integer multiple of the number of workers, e.g. 3 chunks for 2 workers degrades to RR.
-	const auto chunks_per_node = std::max<size_t>(1, chunks.size() / m_num_nodes);
 
 	// Union of all per-buffer writes on this node, used to determine which parts of a buffer are fresh/stale later on.
 	std::unordered_map<buffer_id, region<3>> per_buffer_local_writes;
@@ -187,6 +583,15 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 	const box<3> empty_reduction_box({0, 0, 0}, {0, 0, 0});
 	const box<3> scalar_reduction_box({0, 0, 0}, {1, 1, 1});
 
+	auto& mapped = get_mapped_requirements(tsk, chunks);
+	const auto chunk_nodes = assign_chunks_to_nodes(tsk, chunks, mapped);
+	// Must be planned before iterating over the chunks, since it marks the broadcast data as replicated
+	const auto broadcast_trees = plan_broadcast_trees(tsk, chunks, chunk_nodes, mapped);
+	// With many nodes, most remote chunks do not read anything from this node. Their range mappers do not need to be evaluated.
+	const auto push_candidate_bounds = get_push_candidate_bounds(tsk);
+	// Reductions add requirements on top of the range mapper results, which we must not modify in place because they might be re-used later.
+	buffer_requirements_map requirements_with_reductions;
+
 	// Iterate over all chunks, distinguish between local / remote chunks and normal / reduction access.
 	//
 	// Normal buffer access:
@@ -202,21 +607,32 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 	// - For remote chunks, always create a push command, regardless of whether we have relevant data or not.
 	//   This is required because the remote node does not know how many partial reduction results there are.
 	for(size_t i = 0; i < chunks.size(); ++i) {
-		const node_id nid = (i / chunks_per_node) % m_num_nodes;
+		const node_id nid = chunk_nodes[i];
 		const bool is_local_chunk = nid == m_local_nid;
 
-		auto requirements = get_buffer_requirements_for_mapped_access(tsk, chunks[i], tsk.get_global_size());
+		if(!is_local_chunk && push_candidate_bounds.has_value()) {
+			const box<3> chunk_box(subrange<3>(chunks[i].offset, chunks[i].range));
+			const auto is_candidate = [&](const box<3>& bounds) { return !box_intersection(chunk_box, bounds).empty(); };
+			if(std::none_of(push_candidate_bounds->begin(), push_candidate_bounds->end(), is_candidate)) continue;
+		}
+
+		const auto* requirements = &get_chunk_requirements(mapped, tsk, chunks[i], i);
 
 		// Add requirements for reductions
-		for(const auto& reduction : tsk.get_reductions()) {
-			auto rmode = access_mode::discard_write;
-			if(nid == reduction_initializer_nid && reduction.init_from_buffer) { rmode = access_mode::read_write; }
+		if(!tsk.get_reductions().empty()) {
+			requirements_with_reductions = *requirements;
+			for(const auto& reduction : tsk.get_reductions()) {
+				auto rmode = access_mode::discard_write;
+				if(nid == reduction_initializer_nid && reduction.init_from_buffer) { rmode = access_mode::read_write; }
 #ifndef NDEBUG
-			for(auto pmode : access::producer_modes) {
-				assert(requirements[reduction.bid].count(pmode) == 0); // task_manager verifies that there are no reduction <-> write-access conflicts
-			}
+				for(auto pmode : access::producer_modes) {
+					// task_manager verifies that there are no reduction <-> write-access conflicts
+					assert(requirements_with_reductions[reduction.bid].count(pmode) == 0);
+				}
 #endif
-			requirements[reduction.bid][rmode] = scalar_reduction_box;
+				requirements_with_reductions[reduction.bid][rmode] = scalar_reduction_box;
+			}
+			requirements = &requirements_with_reductions;
 		}
 
 		abstract_command* cmd = nullptr;
@@ -253,7 +669,7 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 
 		// We use the task id, together with the "chunk id" and the buffer id (stored separately) to match pushes against their corresponding await pushes
 		const transfer_id trid = static_cast<transfer_id>((tsk.get_id() << 32) | i);
-		for(auto& [bid, reqs_by_mode] : requirements) {
+		for(const auto& [bid, reqs_by_mode] : *requirements) {
 			auto& buffer_state = m_buffer_states.at(bid);
 			std::vector<access_mode> required_modes;
 			for(const auto mode : detail::access::all_modes) {
@@ -275,8 +691,10 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 				write_command_state wcs{m_epoch_for_new_commands};
 				wcs.mark_as_stale();
 				// We just treat this buffer as 1-dimensional, regardless of its actual dimensionality (as it must be unit-sized anyway)
+				// Only the nodes reading the reduction result will hold it, which is recorded when updating the resident nodes at the end of the task.
 				post_reduction_buffer_states.emplace(std::piecewise_construct, std::tuple{bid},
-				    std::tuple{region_map<write_command_state>{ones, 1, wcs}, region_map<node_bitset>{ones, 1, node_bitset{}}});
+				    std::tuple{region_map<write_command_state>{ones, 1, wcs}, region_map<node_set>{ones, 1, node_set{}},
+				        region_map<node_set>{ones, 1, node_set{}}, buffer_state.elem_size});
 			}
 
 			if(is_pending_reduction && !generate_reduction) {
@@ -288,7 +706,8 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 				if(detail::access::mode_traits::is_consumer(mode)) {
 					if(is_local_chunk) {
 						// Store the read access for determining anti-dependencies later on
-						m_command_buffer_reads[cmd->get_cid()][bid] = region_union(m_command_buffer_reads[cmd->get_cid()][bid], req);
+						auto& reads = m_command_buffer_reads[cmd->get_cid()][bid];
+						reads = region_union(reads.get(), req);
 					}
 
 					if(is_local_chunk && !is_pending_reduction) {
@@ -333,10 +752,10 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 								generated_pushes.push_back(push_cmd);
 
 								// Store the read access for determining anti-dependencies later on
-								m_command_buffer_reads[push_cmd->get_cid()][bid] = replicated_box;
+								m_command_buffer_reads[push_cmd->get_cid()][bid] = region<3>(replicated_box);
 
 								// Remember that we've replicated this region
-								buffer_state.replicated_regions.update_box(replicated_box, node_bitset{nodes}.set(nid));
+								buffer_state.replicated_regions.update_box(replicated_box, node_set{nodes}.set(nid));
 							}
 						}
 					}
@@ -367,7 +786,7 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 						m_cdag.add_dependency(reduce_cmd, m_cdag.get(local_last_writer[0].second), dependency_kind::true_dep, dependency_origin::dataflow);
 					}
 
-					auto* const ap_cmd = create_command<await_push_command>(bid, reduction.rid, trid, scalar_reduction_box.get_subrange());
+					auto* const ap_cmd = create_command<await_push_command>(bid, reduction.rid, trid, region<3>(scalar_reduction_box));
 					m_cdag.add_dependency(reduce_cmd, ap_cmd, dependency_kind::true_dep, dependency_origin::dataflow);
 					generate_epoch_dependencies(ap_cmd);
 
@@ -386,7 +805,8 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 					if(notification_only) {
 						generate_epoch_dependencies(push_cmd);
 					} else {
-						m_command_buffer_reads[push_cmd->get_cid()][bid] = region_union(m_command_buffer_reads[push_cmd->get_cid()][bid], scalar_reduction_box);
+						auto& reads = m_command_buffer_reads[push_cmd->get_cid()][bid];
+						reads = region_union(reads.get(), scalar_reduction_box);
 						m_cdag.add_dependency(push_cmd, m_cdag.get(local_last_writer[0].second), dependency_kind::true_dep, dependency_origin::dataflow);
 					}
 
@@ -395,13 +815,18 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 					const auto replicated_box = post_reduction_buffer_states.at(bid).replicated_regions.get_region_values(scalar_reduction_box);
 					assert(replicated_box.size() == 1);
 					for(const auto& [_, nodes] : replicated_box) {
-						post_reduction_buffer_states.at(bid).replicated_regions.update_box(scalar_reduction_box, node_bitset{nodes}.set(nid));
+						post_reduction_buffer_states.at(bid).replicated_regions.update_box(scalar_reduction_box, node_set{nodes}.set(nid));
 					}
 				}
 			}
 		}
 	}
 
+	// Pushes within broadcast trees depend on the await pushes generated above, and must be generated before last writers are updated.
+	for(const auto& tree : broadcast_trees) {
+		generate_broadcast_pushes(tsk, tree, chunk_nodes, generated_pushes);
+	}
+
 	// For buffers that were in a pending reduction state and a reduction was generated
 	// (i.e., the result was not discarded), set their new state.
 	for(auto& [bid, new_state] : post_reduction_buffer_states) {
@@ -414,7 +839,7 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 		auto& buffer_state = m_buffer_states.at(bid);
 		for(auto& [req, cid] : updates) {
 			buffer_state.local_last_writer.update_region(req, cid);
-			buffer_state.replicated_regions.update_region(req, node_bitset{});
+			buffer_state.replicated_regions.update_region(req, node_set{});
 		}
 		// In case this buffer was in a pending reduction state but the result was discarded, remove the pending reduction.
 		buffer_state.pending_reduction = std::nullopt;
@@ -483,13 +908,17 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 	}
 
 	// Determine which local data is fresh/stale based on task-level writes.
-	auto requirements = get_buffer_requirements_for_mapped_access(tsk, subrange<3>(tsk.get_global_offset(), tsk.get_global_size()), tsk.get_global_size());
+	const auto* global_requirements = &mapped.global_requirements;
 	// Add requirements for reductions
-	for(const auto& reduction : tsk.get_reductions()) {
-		// the actual mode is irrelevant as long as it's a producer - TODO have a better query API for task buffer requirements
-		requirements[reduction.bid][access_mode::write] = scalar_reduction_box;
+	if(!tsk.get_reductions().empty()) {
+		requirements_with_reductions = *global_requirements;
+		for(const auto& reduction : tsk.get_reductions()) {
+			// the actual mode is irrelevant as long as it's a producer - TODO have a better query API for task buffer requirements
+			requirements_with_reductions[reduction.bid][access_mode::write] = scalar_reduction_box;
+		}
+		global_requirements = &requirements_with_reductions;
 	}
-	for(auto& [bid, reqs_by_mode] : requirements) {
+	for(const auto& [bid, reqs_by_mode] : *global_requirements) {
 		box_vector<3> global_write_boxes;
 		for(const auto mode : access::producer_modes) {
 			if(reqs_by_mode.count(mode) == 0) continue;
@@ -512,6 +941,8 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 		}
 	}
 
+	if(is_tracking_resident_nodes()) { update_resident_nodes(tsk, chunks, chunk_nodes, mapped); }
+
 	process_task_side_effect_requirements(tsk);
 }
 
@@ -538,7 +969,7 @@ void distributed_graph_generator::generate_anti_dependencies(
 				const auto& command_reads = command_reads_it->second;
 				// The task might be a dependent because of another buffer
 				if(const auto buffer_reads_it = command_reads.find(bid); buffer_reads_it != command_reads.end()) {
-					if(!region_intersection(write_req, buffer_reads_it->second).empty()) {
+					if(!region_intersection(write_req, buffer_reads_it->second.get()).empty()) {
 						has_successors = true;
 						m_cdag.add_dependency(write_cmd, cmd, dependency_kind::anti_dep, dependency_origin::dataflow);
 					}
@@ -149,9 +149,9 @@ namespace detail {
 		case command_type::reduction: create_job<reduction_job>(pkg, m_reduction_mngr); break;
 		case command_type::execution:
 			if(m_task_mngr.get_task(pkg.get_tid().value())->get_execution_target() == execution_target::host) {
-				create_job<host_execute_job>(pkg, m_h_queue, m_task_mngr, m_buffer_mngr);
+				create_job<host_execute_job>(pkg, m_h_queue, m_task_mngr, m_buffer_mngr, m_load_balancer);
 			} else {
-				create_job<device_execute_job>(pkg, m_d_queue, m_task_mngr, m_buffer_mngr, m_reduction_mngr, m_local_nid);
+				create_job<device_execute_job>(pkg, m_d_queue, m_task_mngr, m_buffer_mngr, m_reduction_mngr, m_local_nid, m_load_balancer);
 			}
 			break;
 		case command_type::fence: create_job<fence_job>(pkg, m_task_mngr); break;
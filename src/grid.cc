@@ -1,5 +1,26 @@
 #include "grid.h"
 
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <ctpl_stl.h>
+
+#include "named_threads.h"
+#include "utils.h"
+
+// The vector paths of box_soa are compiled for their target instruction set regardless of the compiler flags and selected at runtime, so that default
+// (baseline x86-64) builds use them on CPUs that support them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS 1
+#else
+#define CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS 0
+#endif
+
 namespace celerity::detail::grid_detail {
 
 // Regions have a storage dimensionality (the `Dims` template parameter of `class region`) and an effective dimensionality that is smaller iff all contained
@@ -291,6 +312,224 @@ template void normalize(box_vector<1>& boxes);
 template void normalize(box_vector<2>& boxes);
 template void normalize(box_vector<3>& boxes);
 
+template <int Dims>
+box_soa<Dims>::box_soa(const box_vector<Dims>& boxes) : m_size(boxes.size()) {
+	for(int d = 0; d < Dims; ++d) {
+		m_min[d].resize(m_size);
+		m_max[d].resize(m_size);
+		for(size_t i = 0; i < m_size; ++i) {
+			m_min[d][i] = static_cast<int64_t>(boxes[i].get_min()[d]);
+			m_max[d][i] = static_cast<int64_t>(boxes[i].get_max()[d]);
+		}
+	}
+}
+
+int get_box_soa_vector_width() {
+	static const int width = [] {
+#if CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2")) return 4;
+		if(__builtin_cpu_supports("sse4.2")) return 2;
+#endif
+		return 1;
+	}();
+	return width;
+}
+
+#if CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS
+
+// The vector kernels process boxes in groups of four (AVX2) or two (SSE4.2) and return the number of boxes they have processed. The caller handles the
+// remainder. Boxes intersect iff they overlap in every dimension, i.e. min < query_max && query_min < max. Vector lanes evaluate all dimensions without
+// early exit.
+
+template <int EffectiveDims>
+[[gnu::target("avx2")]] size_t find_intersecting_avx2(const int64_t* const* const min, const int64_t* const* const max, const size_t size,
+    const int64_t* const query_min, const int64_t* const query_max, std::vector<uint32_t>& out_indices) {
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4) {
+		__m256i hit = _mm256_set1_epi64x(-1);
+		for(int d = 0; d < EffectiveDims; ++d) {
+			const auto box_min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(min[d] + i));
+			const auto box_max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(max[d] + i));
+			hit = _mm256_and_si256(hit, _mm256_cmpgt_epi64(_mm256_set1_epi64x(query_max[d]), box_min));
+			hit = _mm256_and_si256(hit, _mm256_cmpgt_epi64(box_max, _mm256_set1_epi64x(query_min[d])));
+		}
+		for(int mask = _mm256_movemask_pd(_mm256_castsi256_pd(hit)), lane = 0; mask != 0; mask >>= 1, ++lane) {
+			if(mask & 1) { out_indices.push_back(static_cast<uint32_t>(i + lane)); }
+		}
+	}
+	return i;
+}
+
+template <int EffectiveDims>
+[[gnu::target("sse4.2")]] size_t find_intersecting_sse42(const int64_t* const* const min, const int64_t* const* const max, const size_t size,
+    const int64_t* const query_min, const int64_t* const query_max, std::vector<uint32_t>& out_indices) {
+	size_t i = 0;
+	for(; i + 2 <= size; i += 2) {
+		__m128i hit = _mm_set1_epi64x(-1);
+		for(int d = 0; d < EffectiveDims; ++d) {
+			const auto box_min = _mm_loadu_si128(reinterpret_cast<const __m128i*>(min[d] + i));
+			const auto box_max = _mm_loadu_si128(reinterpret_cast<const __m128i*>(max[d] + i));
+			hit = _mm_and_si128(hit, _mm_cmpgt_epi64(_mm_set1_epi64x(query_max[d]), box_min));
+			hit = _mm_and_si128(hit, _mm_cmpgt_epi64(box_max, _mm_set1_epi64x(query_min[d])));
+		}
+		const int mask = _mm_movemask_pd(_mm_castsi128_pd(hit));
+		if(mask & 1) { out_indices.push_back(static_cast<uint32_t>(i)); }
+		if(mask & 2) { out_indices.push_back(static_cast<uint32_t>(i + 1)); }
+	}
+	return i;
+}
+
+// A box covers the query unless it starts after or ends before the query in any dimension. Sets `found` and stops early if one does.
+
+template <int EffectiveDims>
+[[gnu::target("avx2")]] size_t any_covers_avx2(const int64_t* const* const min, const int64_t* const* const max, const size_t size,
+    const int64_t* const query_min, const int64_t* const query_max, bool& found) {
+	size_t i = 0;
+	for(; i + 4 <= size; i += 4) {
+		__m256i miss = _mm256_setzero_si256();
+		for(int d = 0; d < EffectiveDims; ++d) {
+			const auto box_min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(min[d] + i));
+			const auto box_max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(max[d] + i));
+			miss = _mm256_or_si256(miss, _mm256_cmpgt_epi64(box_min, _mm256_set1_epi64x(query_min[d])));
+			miss = _mm256_or_si256(miss, _mm256_cmpgt_epi64(_mm256_set1_epi64x(query_max[d]), box_max));
+		}
+		if(_mm256_movemask_pd(_mm256_castsi256_pd(miss)) != 0b1111) {
+			found = true;
+			break;
+		}
+	}
+	return i;
+}
+
+template <int EffectiveDims>
+[[gnu::target("sse4.2")]] size_t any_covers_sse42(const int64_t* const* const min, const int64_t* const* const max, const size_t size,
+    const int64_t* const query_min, const int64_t* const query_max, bool& found) {
+	size_t i = 0;
+	for(; i + 2 <= size; i += 2) {
+		__m128i miss = _mm_setzero_si128();
+		for(int d = 0; d < EffectiveDims; ++d) {
+			const auto box_min = _mm_loadu_si128(reinterpret_cast<const __m128i*>(min[d] + i));
+			const auto box_max = _mm_loadu_si128(reinterpret_cast<const __m128i*>(max[d] + i));
+			miss = _mm_or_si128(miss, _mm_cmpgt_epi64(box_min, _mm_set1_epi64x(query_min[d])));
+			miss = _mm_or_si128(miss, _mm_cmpgt_epi64(_mm_set1_epi64x(query_max[d]), box_max));
+		}
+		if(_mm_movemask_pd(_mm_castsi128_pd(miss)) != 0b11) {
+			found = true;
+			break;
+		}
+	}
+	return i;
+}
+
+#endif // CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS
+
+template <int Dims>
+template <int EffectiveDims>
+void box_soa<Dims>::find_intersecting(const box<Dims>& query, std::vector<uint32_t>& out_indices) const {
+	static_assert(EffectiveDims <= Dims);
+
+	int64_t query_min[EffectiveDims + 1];
+	int64_t query_max[EffectiveDims + 1];
+	const int64_t* min[EffectiveDims + 1];
+	const int64_t* max[EffectiveDims + 1];
+	for(int d = 0; d < EffectiveDims; ++d) {
+		query_min[d] = static_cast<int64_t>(query.get_min()[d]);
+		query_max[d] = static_cast<int64_t>(query.get_max()[d]);
+		min[d] = m_min[d].data();
+		max[d] = m_max[d].data();
+	}
+
+	size_t i = 0;
+#if CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS
+	switch(get_box_soa_vector_width()) {
+	case 4: i = find_intersecting_avx2<EffectiveDims>(min, max, m_size, query_min, query_max, out_indices); break;
+	case 2: i = find_intersecting_sse42<EffectiveDims>(min, max, m_size, query_min, query_max, out_indices); break;
+	default: break;
+	}
+#endif
+	for(; i < m_size; ++i) {
+		int d = 0;
+		while(d < EffectiveDims && min[d][i] < query_max[d] && query_min[d] < max[d][i]) {
+			++d;
+		}
+		if(d == EffectiveDims) { out_indices.push_back(static_cast<uint32_t>(i)); }
+	}
+}
+
+template <int Dims>
+template <int EffectiveDims>
+bool box_soa<Dims>::any_covers(const box<Dims>& query) const {
+	static_assert(EffectiveDims <= Dims);
+
+	// empty boxes are normalized and thus may not intersect in coordinates
+	if(query.empty()) return m_size > 0;
+
+	int64_t query_min[EffectiveDims + 1];
+	int64_t query_max[EffectiveDims + 1];
+	const int64_t* min[EffectiveDims + 1];
+	const int64_t* max[EffectiveDims + 1];
+	for(int d = 0; d < EffectiveDims; ++d) {
+		query_min[d] = static_cast<int64_t>(query.get_min()[d]);
+		query_max[d] = static_cast<int64_t>(query.get_max()[d]);
+		min[d] = m_min[d].data();
+		max[d] = m_max[d].data();
+	}
+
+	size_t i = 0;
+#if CELERITY_DETAIL_HAS_BOX_SOA_VECTOR_PATHS
+	bool found = false;
+	switch(get_box_soa_vector_width()) {
+	case 4: i = any_covers_avx2<EffectiveDims>(min, max, m_size, query_min, query_max, found); break;
+	case 2: i = any_covers_sse42<EffectiveDims>(min, max, m_size, query_min, query_max, found); break;
+	default: break;
+	}
+	if(found) return true;
+#endif
+	for(; i < m_size; ++i) {
+		int d = 0;
+		while(d < EffectiveDims && min[d][i] <= query_min[d] && query_max[d] <= max[d][i]) {
+			++d;
+		}
+		if(d == EffectiveDims) return true;
+	}
+	return false;
+}
+
+template class box_soa<0>;
+template class box_soa<1>;
+template class box_soa<2>;
+template class box_soa<3>;
+
+template void box_soa<0>::find_intersecting<0>(const box<0>&, std::vector<uint32_t>&) const;
+template void box_soa<1>::find_intersecting<0>(const box<1>&, std::vector<uint32_t>&) const;
+template void box_soa<1>::find_intersecting<1>(const box<1>&, std::vector<uint32_t>&) const;
+template void box_soa<2>::find_intersecting<0>(const box<2>&, std::vector<uint32_t>&) const;
+template void box_soa<2>::find_intersecting<1>(const box<2>&, std::vector<uint32_t>&) const;
+template void box_soa<2>::find_intersecting<2>(const box<2>&, std::vector<uint32_t>&) const;
+template void box_soa<3>::find_intersecting<0>(const box<3>&, std::vector<uint32_t>&) const;
+template void box_soa<3>::find_intersecting<1>(const box<3>&, std::vector<uint32_t>&) const;
+template void box_soa<3>::find_intersecting<2>(const box<3>&, std::vector<uint32_t>&) const;
+template void box_soa<3>::find_intersecting<3>(const box<3>&, std::vector<uint32_t>&) const;
+
+template bool box_soa<0>::any_covers<0>(const box<0>&) const;
+template bool box_soa<1>::any_covers<0>(const box<1>&) const;
+template bool box_soa<1>::any_covers<1>(const box<1>&) const;
+template bool box_soa<2>::any_covers<0>(const box<2>&) const;
+template bool box_soa<2>::any_covers<1>(const box<2>&) const;
+template bool box_soa<2>::any_covers<2>(const box<2>&) const;
+template bool box_soa<3>::any_covers<0>(const box<3>&) const;
+template bool box_soa<3>::any_covers<1>(const box<3>&) const;
+template bool box_soa<3>::any_covers<2>(const box<3>&) const;
+template bool box_soa<3>::any_covers<3>(const box<3>&) const;
+
+// Below this many boxes on the right-hand side, the O(N * M) region algorithms compare boxes directly instead of building a box_soa first. Without vector
+// compares, the early exits of box-by-box tests always beat the structure-of-arrays layout.
+static bool use_box_soa(const size_t num_boxes) {
+	constexpr size_t min_boxes_for_soa = 16;
+	return num_boxes >= min_boxes_for_soa && get_box_soa_vector_width() > 1;
+}
+
 template <int EffectiveDims, int StorageDims>
 region<StorageDims> region_intersection_impl(const region<StorageDims>& lhs, const region<StorageDims>& rhs) {
 	static_assert(EffectiveDims <= StorageDims);
@@ -301,9 +540,21 @@ region<StorageDims> region_intersection_impl(const region<StorageDims>& lhs, con
 	// sorting both by box_coordinate_order and finding common boxes through std::set_intersection. Practically this turned out to be slower, sometimes
 	// by several orders of magnitude, as the number of dissected boxes can grow to O((N * M) ^ EffectiveDims).
 	box_vector<StorageDims> intersection;
-	for(const auto& left : lhs.get_boxes()) {
-		for(const auto& right : rhs.get_boxes()) {
-			if(const auto box = grid_detail::box_intersection<EffectiveDims>(left, right); !box.empty()) { intersection.push_back(box); }
+	if(!use_box_soa(rhs.get_boxes().size())) {
+		for(const auto& left : lhs.get_boxes()) {
+			for(const auto& right : rhs.get_boxes()) {
+				if(const auto box = grid_detail::box_intersection<EffectiveDims>(left, right); !box.empty()) { intersection.push_back(box); }
+			}
+		}
+	} else {
+		const box_soa<StorageDims> right_soa(rhs.get_boxes());
+		std::vector<uint32_t> intersecting;
+		for(const auto& left : lhs.get_boxes()) {
+			intersecting.clear();
+			right_soa.template find_intersecting<EffectiveDims>(left, intersecting);
+			for(const auto i : intersecting) {
+				intersection.push_back(grid_detail::box_intersection<EffectiveDims>(left, rhs.get_boxes()[i]));
+			}
 		}
 	}
 
@@ -332,14 +583,19 @@ void apply_region_difference(box_vector<StorageDims>& dissected_left, const regi
 	// For further optimization potential see the comments on region_intersection_impl.
 	const auto left_begin = dissected_left.begin();
 	auto left_end = dissected_left.end();
-	for(const auto& right : rhs.get_boxes()) {
-		for(auto left_it = left_begin; left_it != left_end;) {
-			if(grid_detail::box_covers<EffectiveDims>(right, *left_it)) {
-				*left_it = *--left_end;
-			} else {
-				++left_it;
+	if(!use_box_soa(rhs.get_boxes().size())) {
+		for(const auto& right : rhs.get_boxes()) {
+			for(auto left_it = left_begin; left_it != left_end;) {
+				if(grid_detail::box_covers<EffectiveDims>(right, *left_it)) {
+					*left_it = *--left_end;
+				} else {
+					++left_it;
+				}
 			}
 		}
+	} else {
+		const box_soa<StorageDims> right_soa(rhs.get_boxes());
+		left_end = std::remove_if(left_begin, left_end, [&](const box<StorageDims>& left) { return right_soa.template any_covers<EffectiveDims>(left); });
 	}
 
 	// merge the now non-overlapping boxes
@@ -347,6 +603,347 @@ void apply_region_difference(box_vector<StorageDims>& dissected_left, const regi
 	dissected_left.erase(left_end, dissected_left.end());
 }
 
+// In effective dimensionality 1, a normalized region is a sequence of disjoint, non-touching intervals along dimension 0 sorted by their start. Set
+// operations then reduce to a single linear sweep over both operands instead of comparing every pair of boxes. All boxes span [0, 1) in the remaining
+// dimensions, so results can be created from any box by replacing its dimension-0 coordinates.
+template <int StorageDims>
+box<StorageDims> with_interval(const box<StorageDims>& like, const size_t min, const size_t max) {
+	auto box_min = like.get_min();
+	auto box_max = like.get_max();
+	box_min[0] = min;
+	box_max[0] = max;
+	return box<StorageDims>(box_min, box_max);
+}
+
+template <int StorageDims>
+region<StorageDims> interval_union(const region<StorageDims>& lhs, const region<StorageDims>& rhs) {
+	const auto& left = lhs.get_boxes();
+	const auto& right = rhs.get_boxes();
+	box_vector<StorageDims> box_union;
+	box_union.reserve(left.size() + right.size());
+	for(size_t l = 0, r = 0; l < left.size() || r < right.size();) {
+		const auto& next = r == right.size() || (l < left.size() && left[l].get_min()[0] <= right[r].get_min()[0]) ? left[l++] : right[r++];
+		if(!box_union.empty() && next.get_min()[0] <= box_union.back().get_max()[0]) {
+			const auto& last = box_union.back();
+			if(next.get_max()[0] > last.get_max()[0]) { box_union.back() = with_interval(last, last.get_min()[0], next.get_max()[0]); }
+		} else {
+			box_union.push_back(next);
+		}
+	}
+	return make_region<StorageDims>(normalized, std::move(box_union));
+}
+
+template <int StorageDims>
+region<StorageDims> interval_intersection(const region<StorageDims>& lhs, const region<StorageDims>& rhs) {
+	const auto& left = lhs.get_boxes();
+	const auto& right = rhs.get_boxes();
+	box_vector<StorageDims> intersection;
+	for(size_t l = 0, r = 0; l < left.size() && r < right.size();) {
+		const auto min = std::max(left[l].get_min()[0], right[r].get_min()[0]);
+		const auto max = std::min(left[l].get_max()[0], right[r].get_max()[0]);
+		if(min < max) { intersection.push_back(with_interval(left[l], min, max)); }
+		if(left[l].get_max()[0] < right[r].get_max()[0]) {
+			++l;
+		} else {
+			++r;
+		}
+	}
+	return make_region<StorageDims>(normalized, std::move(intersection));
+}
+
+template <int StorageDims>
+region<StorageDims> interval_difference(const region<StorageDims>& lhs, const region<StorageDims>& rhs) {
+	const auto& right = rhs.get_boxes();
+	box_vector<StorageDims> difference;
+	size_t first_right = 0;
+	for(const auto& left : lhs.get_boxes()) {
+		const auto left_max = left.get_max()[0];
+		auto uncovered_min = left.get_min()[0];
+		while(first_right < right.size() && right[first_right].get_max()[0] <= uncovered_min) {
+			++first_right;
+		}
+		// right boxes can extend into the next left box, so the sweep over right restarts at first_right for each of them
+		for(size_t r = first_right; r < right.size() && right[r].get_min()[0] < left_max; ++r) {
+			if(right[r].get_min()[0] > uncovered_min) { difference.push_back(with_interval(left, uncovered_min, right[r].get_min()[0])); }
+			uncovered_min = std::max(uncovered_min, right[r].get_max()[0]);
+		}
+		if(uncovered_min < left_max) { difference.push_back(with_interval(left, uncovered_min, left_max)); }
+	}
+	return make_region<StorageDims>(normalized, std::move(difference));
+}
+
+// The pairwise algorithms above are O(N * M) in the number of boxes (and normalizing a union must dissect every box along the edges of all others), which
+// dominates for operands with thousands of boxes, such as unions of many await-push regions or irregular gathers. For those we sweep a plane along
+// dimension 0 instead: between two consecutive box boundaries in dimension 0 (a "slab"), the cross-section of both operands is constant, so the result
+// within a slab is the operation applied to the (lower-dimensional) cross-sections of the boxes intersecting it. Since normalized boxes are sorted by
+// their minimum in dimension 0, the set of boxes intersecting each slab is maintained incrementally. Merging the per-slab results along dimension 0
+// yields the normalized result, as normalization merges along dimension 0 last.
+
+// Below this many boxes in both operands combined, the pairwise algorithms are faster. Intersection only compares boxes (with vector instructions, see
+// box_soa), while union and difference need to dissect boxes, so the latter benefit from a sweep much earlier.
+constexpr size_t sweep_min_boxes = 128;
+constexpr size_t sweep_min_boxes_for_intersection = 1024;
+// Sweeps over at least this many boxes process independent ranges of slabs on helper threads.
+constexpr size_t parallel_sweep_min_boxes = 8192;
+constexpr size_t max_sweep_threads = 8;
+
+// Nested sweeps (on cross-sections) must not wait on the helper threads they are running on
+thread_local bool is_sweep_thread = false;
+
+size_t get_num_sweep_threads() {
+	static const size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency() / 2, max_sweep_threads);
+	return num_threads;
+}
+
+// Helper threads for large sweeps. Created on first use, as most applications never operate on regions large enough to need them.
+ctpl::thread_pool& get_sweep_thread_pool() {
+	static ctpl::thread_pool pool(static_cast<int>(get_num_sweep_threads()));
+	static const bool threads_named = [] {
+		for(int i = 0; i < pool.size(); ++i) {
+			set_thread_name(pool.get_thread(i).native_handle(), "cy-region-" + std::to_string(i));
+		}
+		return true;
+	}(); // IIFE
+	(void)threads_named;
+	return pool;
+}
+
+// Moves dimensions [1, StorageDims) of a box down by one, so that the cross-section of a region has a lower effective dimensionality than the region itself
+template <int StorageDims>
+box<StorageDims> get_cross_section(const box<StorageDims>& box) {
+	id<StorageDims> min;
+	id<StorageDims> max;
+	for(int d = 0; d + 1 < StorageDims; ++d) {
+		min[d] = box.get_min()[d + 1];
+		max[d] = box.get_max()[d + 1];
+	}
+	min[StorageDims - 1] = 0;
+	max[StorageDims - 1] = 1;
+	return make_box<StorageDims>(non_empty, min, max);
+}
+
+// Inverse of get_cross_section, extruding the cross-section along [min, max) in dimension 0
+template <int StorageDims>
+box<StorageDims> extrude_cross_section(const box<StorageDims>& cross_section, const size_t min, const size_t max) {
+	id<StorageDims> box_min;
+	id<StorageDims> box_max;
+	box_min[0] = min;
+	box_max[0] = max;
+	for(int d = 1; d < StorageDims; ++d) {
+		box_min[d] = cross_section.get_min()[d - 1];
+		box_max[d] = cross_section.get_max()[d - 1];
+	}
+	return make_box<StorageDims>(non_empty, box_min, box_max);
+}
+
+// The boxes of one operand that intersect the current slab, as their cross-sections and their end in dimension 0
+template <int StorageDims>
+class sweep_front {
+  public:
+	explicit sweep_front(const box_vector<StorageDims>& boxes) : m_boxes(boxes) {}
+
+	void advance_to(const size_t slab_min) {
+		m_active.erase(std::remove_if(m_active.begin(), m_active.end(), [&](const auto& active) { return active.first <= slab_min; }), m_active.end());
+		for(; m_next < m_boxes.size() && m_boxes[m_next].get_min()[0] <= slab_min; ++m_next) {
+			if(m_boxes[m_next].get_max()[0] > slab_min) { m_active.emplace_back(m_boxes[m_next].get_max()[0], get_cross_section(m_boxes[m_next])); }
+		}
+	}
+
+	bool empty() const { return m_active.empty(); }
+
+	void collect(box_vector<StorageDims>& out_cross_sections) const {
+		for(const auto& active : m_active) {
+			out_cross_sections.push_back(active.second);
+		}
+	}
+
+	// Cross-sections of disjoint boxes are disjoint, but not necessarily normalized
+	region<StorageDims> get_cross_section_region() const {
+		box_vector<StorageDims> cross_sections;
+		collect(cross_sections);
+		return region<StorageDims>(std::move(cross_sections));
+	}
+
+  private:
+	const box_vector<StorageDims>& m_boxes;
+	size_t m_next = 0;
+	std::vector<std::pair<size_t, box<StorageDims>>> m_active;
+};
+
+// Boxes of the result whose cross-sections were part of the previous slab's result, and which are extended as long as the following slabs contain
+// them as well. This merges along dimension 0 without ever materializing the (much larger) per-slab results.
+template <int StorageDims>
+class sweep_result_builder {
+  public:
+	explicit sweep_result_builder(box_vector<StorageDims>& out) : m_out(out) {}
+
+	// `cross_section` must be normalized, i.e. sorted in box_coordinate_order
+	void add_slab(const size_t slab_min, const size_t slab_max, const box_vector<StorageDims>& cross_section) {
+		if(slab_min != m_open_max) { close_all(); }
+
+		m_next_open.clear();
+		m_next_open_min.clear();
+		size_t o = 0;
+		for(const auto& box : cross_section) {
+			for(; o < m_open.size() && box_coordinate_order()(m_open[o], box); ++o) {
+				close(o);
+			}
+			if(o < m_open.size() && m_open[o] == box) {
+				m_next_open_min.push_back(m_open_min[o++]);
+			} else {
+				m_next_open_min.push_back(slab_min);
+			}
+			m_next_open.push_back(box);
+		}
+		for(; o < m_open.size(); ++o) {
+			close(o);
+		}
+		std::swap(m_open, m_next_open);
+		std::swap(m_open_min, m_next_open_min);
+		m_open_max = slab_max;
+	}
+
+	void close_all() {
+		for(size_t o = 0; o < m_open.size(); ++o) {
+			close(o);
+		}
+		m_open.clear();
+		m_open_min.clear();
+	}
+
+  private:
+	box_vector<StorageDims>& m_out;
+	box_vector<StorageDims> m_open;
+	std::vector<size_t> m_open_min;
+	size_t m_open_max = 0;
+	box_vector<StorageDims> m_next_open;
+	std::vector<size_t> m_next_open_min;
+
+	void close(const size_t o) { m_out.push_back(extrude_cross_section(m_open[o], m_open_min[o], m_open_max)); }
+};
+
+// Applies the operation to all slabs in [first_slab, last_slab), appending result boxes to `out`. These are merged along dimension 0 except across the
+// boundaries of the slab range.
+template <int StorageDims>
+void sweep_slabs(const region<StorageDims>& lhs, const region<StorageDims>& rhs, const region_operation op, const std::vector<size_t>& slab_bounds,
+    const size_t first_slab, const size_t last_slab, box_vector<StorageDims>& out) {
+	sweep_front<StorageDims> left(lhs.get_boxes());
+	sweep_front<StorageDims> right(rhs.get_boxes());
+	sweep_result_builder<StorageDims> builder(out);
+	for(size_t slab = first_slab; slab < last_slab; ++slab) {
+		const auto slab_min = slab_bounds[slab];
+		const auto slab_max = slab_bounds[slab + 1];
+		left.advance_to(slab_min);
+		right.advance_to(slab_min);
+
+		region<StorageDims> cross_section;
+		switch(op) {
+		case region_operation::unite:
+			if(!left.empty() || !right.empty()) {
+				box_vector<StorageDims> cross_sections;
+				left.collect(cross_sections);
+				right.collect(cross_sections);
+				cross_section = region<StorageDims>(std::move(cross_sections));
+			}
+			break;
+		case region_operation::intersect:
+			if(!left.empty() && !right.empty()) { cross_section = region_intersection(left.get_cross_section_region(), right.get_cross_section_region()); }
+			break;
+		case region_operation::subtract:
+			if(!left.empty()) {
+				cross_section = left.get_cross_section_region();
+				if(!right.empty()) { cross_section = region_difference(cross_section, right.get_cross_section_region()); }
+			}
+			break;
+		}
+		builder.add_slab(slab_min, slab_max, cross_section.get_boxes());
+	}
+	builder.close_all();
+}
+
+template <int EffectiveDims, int StorageDims>
+region<StorageDims> sweep_region_operation_impl(const region<StorageDims>& lhs, const region<StorageDims>& rhs, const region_operation op) {
+	static_assert(EffectiveDims >= 2 && EffectiveDims <= StorageDims);
+
+	std::vector<size_t> slab_bounds;
+	slab_bounds.reserve(2 * (lhs.get_boxes().size() + rhs.get_boxes().size()));
+	for(const auto* const operand : {&lhs, &rhs}) {
+		for(const auto& box : operand->get_boxes()) {
+			slab_bounds.push_back(box.get_min()[0]);
+			slab_bounds.push_back(box.get_max()[0]);
+		}
+	}
+	std::sort(slab_bounds.begin(), slab_bounds.end());
+	slab_bounds.erase(std::unique(slab_bounds.begin(), slab_bounds.end()), slab_bounds.end());
+	const size_t num_slabs = slab_bounds.size() - 1;
+
+	box_vector<StorageDims> result;
+	const size_t num_parts = lhs.get_boxes().size() + rhs.get_boxes().size() >= parallel_sweep_min_boxes && !is_sweep_thread
+	                             ? std::min(get_num_sweep_threads() + 1, num_slabs)
+	                             : 1;
+	if(num_parts <= 1) {
+		sweep_slabs(lhs, rhs, op, slab_bounds, 0, num_slabs, result);
+	} else {
+		// Every part sweeps a contiguous range of slabs, the calling thread sweeps the last one
+		const auto part_begin = [&](const size_t part) { return num_slabs * part / num_parts; };
+		std::vector<box_vector<StorageDims>> part_results(num_parts);
+		auto& pool = get_sweep_thread_pool();
+		std::vector<std::future<void>> pending;
+		pending.reserve(num_parts - 1);
+		for(size_t part = 0; part < num_parts - 1; ++part) {
+			pending.push_back(pool.push([&, part](int /* thread_id */) {
+				is_sweep_thread = true;
+				sweep_slabs(lhs, rhs, op, slab_bounds, part_begin(part), part_begin(part + 1), part_results[part]);
+			}));
+		}
+		sweep_slabs(lhs, rhs, op, slab_bounds, part_begin(num_parts - 1), num_slabs, part_results[num_parts - 1]);
+		for(size_t part = 0; part < num_parts; ++part) {
+			if(part < num_parts - 1) { pending[part].get(); }
+			result.insert(result.end(), part_results[part].begin(), part_results[part].end());
+		}
+	}
+
+	// Parts are merged along dimension 0 internally, which leaves merges across the boundaries between parts
+	if(num_parts > 1) { result.erase(merge_connected_boxes_along_dim<0, EffectiveDims>(result.begin(), result.end()), result.end()); }
+	std::sort(result.begin(), result.end(), box_coordinate_order());
+	return make_region<StorageDims>(normalized, std::move(result));
+}
+
+template <int Dims>
+region<Dims> sweep_region_operation(const region<Dims>& lhs, const region<Dims>& rhs, const region_operation op) {
+	const auto effective_dims = std::max(lhs.get_effective_dims(), rhs.get_effective_dims());
+	if constexpr(Dims >= 2) {
+		if(effective_dims >= 2 && !lhs.empty() && !rhs.empty()) {
+			return dispatch_effective_dims<Dims>(effective_dims, [&](const auto effective_dims) -> region<Dims> {
+				if constexpr(effective_dims.value >= 2) {
+					return sweep_region_operation_impl<effective_dims.value>(lhs, rhs, op);
+				} else {
+					abort(); // unreachable
+				}
+			});
+		}
+	}
+	// lower-dimensional and trivial operations don't benefit from a sweep
+	switch(op) {
+	case region_operation::unite: return region_union(lhs, rhs);
+	case region_operation::intersect: return region_intersection(lhs, rhs);
+	case region_operation::subtract: return region_difference(lhs, rhs);
+	default: abort(); // unreachable
+	}
+}
+
+// explicit instantiations for tests
+template region<0> sweep_region_operation(const region<0>& lhs, const region<0>& rhs, region_operation op);
+template region<1> sweep_region_operation(const region<1>& lhs, const region<1>& rhs, region_operation op);
+template region<2> sweep_region_operation(const region<2>& lhs, const region<2>& rhs, region_operation op);
+template region<3> sweep_region_operation(const region<3>& lhs, const region<3>& rhs, region_operation op);
+
+template <int Dims>
+bool should_sweep(const region<Dims>& lhs, const region<Dims>& rhs, const int effective_dims, const region_operation op) {
+	const auto min_boxes = op == region_operation::intersect ? sweep_min_boxes_for_intersection : sweep_min_boxes;
+	return effective_dims >= 2 && lhs.get_boxes().size() + rhs.get_boxes().size() >= min_boxes;
+}
+
 } // namespace celerity::detail::grid_detail
 
 namespace celerity::detail {
@@ -374,6 +971,16 @@ region<Dims> region_union(const region<Dims>& lhs, const region<Dims>& rhs) {
 	if(lhs.empty()) return rhs;
 	if(rhs.empty()) return lhs;
 
+	const auto effective_dims = std::max(lhs.get_effective_dims(), rhs.get_effective_dims());
+	if constexpr(Dims > 0) {
+		if(effective_dims == 1) { return grid_detail::interval_union(lhs, rhs); }
+	}
+	if constexpr(Dims > 1) {
+		if(grid_detail::should_sweep(lhs, rhs, effective_dims, grid_detail::region_operation::unite)) {
+			return grid_detail::sweep_region_operation(lhs, rhs, grid_detail::region_operation::unite);
+		}
+	}
+
 	box_vector<Dims> box_union;
 	box_union.reserve(lhs.get_boxes().size() + rhs.get_boxes().size());
 	box_union.insert(box_union.end(), lhs.get_boxes().begin(), lhs.get_boxes().end());
@@ -392,6 +999,14 @@ region<Dims> region_intersection(const region<Dims>& lhs, const region<Dims>& rh
 	if(lhs.empty() || rhs.empty()) return {};
 
 	const auto effective_dims = std::max(lhs.get_effective_dims(), rhs.get_effective_dims());
+	if constexpr(Dims > 0) {
+		if(effective_dims == 1) { return grid_detail::interval_intersection(lhs, rhs); }
+	}
+	if constexpr(Dims > 1) {
+		if(grid_detail::should_sweep(lhs, rhs, effective_dims, grid_detail::region_operation::intersect)) {
+			return grid_detail::sweep_region_operation(lhs, rhs, grid_detail::region_operation::intersect);
+		}
+	}
 	return grid_detail::dispatch_effective_dims<Dims>(effective_dims, [&](const auto effective_dims) { //
 		return grid_detail::region_intersection_impl<effective_dims.value>(lhs, rhs);
 	});
@@ -412,6 +1027,14 @@ region<Dims> region_difference(const region<Dims>& lhs, const region<Dims>& rhs)
 	// to correctly identify overlapping boxes
 	const auto effective_dims = std::max(lhs.get_effective_dims(), rhs.get_effective_dims());
 	assert(effective_dims <= Dims);
+	if constexpr(Dims > 0) {
+		if(effective_dims == 1) { return grid_detail::interval_difference(lhs, rhs); }
+	}
+	if constexpr(Dims > 1) {
+		if(grid_detail::should_sweep(lhs, rhs, effective_dims, grid_detail::region_operation::subtract)) {
+			return grid_detail::sweep_region_operation(lhs, rhs, grid_detail::region_operation::subtract);
+		}
+	}
 
 	// 1. collect dissection lines (in *all* dimensions) from rhs
 	std::vector<std::vector<size_t>> cuts(effective_dims);
@@ -437,3 +1060,92 @@ template region<2> region_difference(const region<2>& lhs, const region<2>& rhs)
 template region<3> region_difference(const region<3>& lhs, const region<3>& rhs);
 
 } // namespace celerity::detail
+
+namespace celerity::detail::grid_detail {
+
+struct shared_region_counters {
+	std::atomic<size_t> num_constructions{0};
+	std::atomic<size_t> num_allocations{0};
+	std::atomic<size_t> num_allocated_boxes{0};
+};
+
+shared_region_counters& get_shared_region_counters() {
+	static shared_region_counters counters;
+	return counters;
+}
+
+// The table only holds weak references, so a region is freed as soon as the last shared_region referring to it is destroyed. Expired entries are purged
+// whenever the table has doubled in size since the last purge, which keeps the amortized cost of interning constant.
+template <int Dims>
+struct shared_region_table {
+	std::mutex mutex;
+	std::unordered_multimap<size_t, std::weak_ptr<const shared_region_node<Dims>>> nodes;
+	size_t purge_threshold = 64;
+};
+
+template <int Dims>
+shared_region_table<Dims>& get_shared_region_table() {
+	static shared_region_table<Dims> table;
+	return table;
+}
+
+template <int Dims>
+size_t hash_region(const region<Dims>& region) {
+	size_t seed = region.get_boxes().size();
+	for(const auto& box : region.get_boxes()) {
+		for(int d = 0; d < Dims; ++d) {
+			utils::hash_combine(seed, box.get_min()[d]);
+			utils::hash_combine(seed, box.get_max()[d]);
+		}
+	}
+	return seed;
+}
+
+template <int Dims>
+std::shared_ptr<const shared_region_node<Dims>> intern_region(region<Dims>&& region) {
+	auto& counters = get_shared_region_counters();
+	counters.num_constructions.fetch_add(1, std::memory_order_relaxed);
+	if(region.empty()) return nullptr;
+
+	const auto hash = hash_region(region);
+	auto& table = get_shared_region_table<Dims>();
+	std::lock_guard lock(table.mutex);
+
+	const auto [first, last] = table.nodes.equal_range(hash);
+	for(auto it = first; it != last; ++it) {
+		if(auto node = it->second.lock(); node != nullptr && node->value == region) return node;
+	}
+
+	if(table.nodes.size() >= table.purge_threshold) {
+		for(auto it = table.nodes.begin(); it != table.nodes.end();) {
+			it = it->second.expired() ? table.nodes.erase(it) : std::next(it);
+		}
+		table.purge_threshold = std::max(size_t{64}, 2 * table.nodes.size());
+	}
+
+	counters.num_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.num_allocated_boxes.fetch_add(region.get_boxes().size(), std::memory_order_relaxed);
+	auto node = std::make_shared<const shared_region_node<Dims>>(shared_region_node<Dims>{std::move(region), hash});
+	table.nodes.emplace(hash, node);
+	return node;
+}
+
+} // namespace celerity::detail::grid_detail
+
+namespace celerity::detail {
+
+template <int Dims>
+shared_region<Dims>::shared_region(region<Dims>&& other) : m_node(grid_detail::intern_region(std::move(other))) {}
+
+template class shared_region<0>;
+template class shared_region<1>;
+template class shared_region<2>;
+template class shared_region<3>;
+
+shared_region_statistics get_shared_region_statistics() {
+	const auto& counters = grid_detail::get_shared_region_counters();
+	return {counters.num_constructions.load(std::memory_order_relaxed), counters.num_allocations.load(std::memory_order_relaxed),
+	    counters.num_allocated_boxes.load(std::memory_order_relaxed)};
+}
+
+} // namespace celerity::detail
@@ -0,0 +1,106 @@
+#include "load_balancer.h"
+
+#include "handler.h"
+
+namespace celerity::detail {
+
+bool is_load_balanced_kernel(const std::string& kernel_name) {
+	static const auto unnamed_kernel_name = kernel_debug_name<unnamed_kernel>();
+	return !kernel_name.empty() && kernel_name != unnamed_kernel_name;
+}
+
+std::unordered_map<std::string, std::vector<double>> compute_split_weights(const std::vector<kernel_throughput_map>& throughput_per_node) {
+	std::unordered_map<std::string, std::vector<double>> weights;
+	if(throughput_per_node.empty()) return weights;
+
+	for(const auto& [kernel_name, _] : throughput_per_node.front()) {
+		std::vector<double> node_weights;
+		double total_throughput = 0;
+		for(const auto& node_throughput : throughput_per_node) {
+			const auto it = node_throughput.find(kernel_name);
+			if(it == node_throughput.end() || it->second.work_items == 0 || it->second.duration.count() <= 0) break;
+			const auto throughput = static_cast<double>(it->second.work_items) / static_cast<double>(it->second.duration.count());
+			node_weights.push_back(throughput);
+			total_throughput += throughput;
+		}
+		if(node_weights.size() < throughput_per_node.size()) continue;
+
+		for(auto& w : node_weights) {
+			w /= total_throughput;
+		}
+		weights.emplace(kernel_name, std::move(node_weights));
+	}
+	return weights;
+}
+
+load_balancer::~load_balancer() {
+	// All nodes start the same number of exchanges, so the last one completes even if its results are no longer needed
+	if(m_pending_exchange.has_value()) { MPI_Wait(&*m_pending_exchange, MPI_STATUS_IGNORE); }
+	if(m_comm.has_value()) { MPI_Comm_free(&*m_comm); }
+}
+
+void load_balancer::record_execution(const std::string& kernel_name, const size_t work_items, const std::chrono::nanoseconds duration) {
+	if(!is_load_balanced_kernel(kernel_name)) return;
+	std::lock_guard lock(m_mutex);
+	auto& throughput = m_local_throughput[kernel_name];
+	throughput.work_items += work_items;
+	throughput.duration += duration;
+}
+
+void load_balancer::register_kernel(const std::string& kernel_name) {
+	if(!is_load_balanced_kernel(kernel_name)) return;
+	if(m_registered_kernels.insert(kernel_name).second) { m_kernel_names.push_back(kernel_name); }
+}
+
+std::unordered_map<std::string, std::vector<double>> load_balancer::exchange() {
+	if(!m_comm.has_value()) {
+		MPI_Comm comm;
+		MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+		m_comm = comm;
+	}
+
+	int num_nodes = 0;
+	MPI_Comm_size(*m_comm, &num_nodes);
+
+	// The previous exchange was started one horizon ago, so it has usually completed by now
+	std::vector<kernel_throughput_map> throughput_per_node;
+	if(m_pending_exchange.has_value()) {
+		MPI_Wait(&*m_pending_exchange, MPI_STATUS_IGNORE);
+		m_pending_exchange.reset();
+		throughput_per_node.resize(num_nodes);
+		for(int i = 0; i < num_nodes; ++i) {
+			for(size_t k = 0; k < m_num_exchanged_kernels; ++k) {
+				const auto& exchanged = m_recv_buf[i * m_num_exchanged_kernels + k];
+				if(exchanged.work_items == 0) continue;
+				throughput_per_node[i][m_kernel_names[k]] = {exchanged.work_items, std::chrono::nanoseconds(exchanged.duration_ns)};
+			}
+		}
+	}
+
+	kernel_throughput_map local_throughput;
+	{
+		std::lock_guard lock(m_mutex);
+		std::swap(local_throughput, m_local_throughput);
+	}
+
+	m_num_exchanged_kernels = m_kernel_names.size();
+	m_send_buf.assign(m_num_exchanged_kernels, exchanged_throughput{});
+	for(size_t k = 0; k < m_num_exchanged_kernels; ++k) {
+		if(const auto it = local_throughput.find(m_kernel_names[k]); it != local_throughput.end()) {
+			m_send_buf[k] = {static_cast<uint64_t>(it->second.work_items), static_cast<int64_t>(it->second.duration.count())};
+		}
+	}
+
+	// Every node registered the same kernels up to this point, so all contributions have the same size
+	if(m_num_exchanged_kernels > 0) {
+		m_recv_buf.resize(num_nodes * m_num_exchanged_kernels);
+		const int send_size = static_cast<int>(m_num_exchanged_kernels * sizeof(exchanged_throughput));
+		MPI_Request request;
+		MPI_Iallgather(m_send_buf.data(), send_size, MPI_BYTE, m_recv_buf.data(), send_size, MPI_BYTE, *m_comm, &request);
+		m_pending_exchange = request;
+	}
+
+	return compute_split_weights(throughput_per_node);
+}
+
+} // namespace celerity::detail
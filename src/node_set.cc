@@ -0,0 +1,216 @@
+#include "node_set.h"
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <unordered_map>
+
+#include "utils.h"
+
+namespace celerity::detail::node_set_detail {
+
+// The last word is never zero, and at least one node at or above node_set::inline_capacity is contained
+struct shared_words {
+	std::atomic<size_t> ref_count;
+	size_t hash;
+	std::vector<uint64_t> words;
+};
+static_assert(alignof(shared_words) >= 2, "node_set uses the lowest pointer bit to tag inline sets");
+
+struct shared_words_counters {
+	std::atomic<size_t> num_allocations{0};
+	std::atomic<size_t> num_live_sets{0};
+	std::atomic<size_t> num_live_bytes{0};
+};
+
+shared_words_counters& get_shared_words_counters() {
+	static shared_words_counters counters;
+	return counters;
+}
+
+// Unlike the shared_region table, this holds strong references whose count is maintained by node_set itself. A bit vector is removed from the table
+// by whoever drops its last reference, which happens under the table lock so that it cannot be revived by a concurrent lookup in the meantime.
+struct shared_words_table {
+	std::mutex mutex;
+	std::unordered_multimap<size_t, shared_words*> entries;
+};
+
+shared_words_table& get_shared_words_table() {
+	static shared_words_table table;
+	return table;
+}
+
+size_t hash_words(const std::vector<uint64_t>& words) {
+	size_t seed = words.size();
+	for(const auto w : words) {
+		utils::hash_combine(seed, static_cast<size_t>(w));
+	}
+	return seed;
+}
+
+const shared_words* intern_words(std::vector<uint64_t>&& words) {
+	const auto hash = hash_words(words);
+	auto& table = get_shared_words_table();
+	std::lock_guard lock(table.mutex);
+
+	const auto [first, last] = table.entries.equal_range(hash);
+	for(auto it = first; it != last; ++it) {
+		if(it->second->words == words) {
+			it->second->ref_count.fetch_add(1, std::memory_order_relaxed);
+			return it->second;
+		}
+	}
+
+	auto& counters = get_shared_words_counters();
+	counters.num_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.num_live_sets.fetch_add(1, std::memory_order_relaxed);
+	counters.num_live_bytes.fetch_add(sizeof(shared_words) + words.size() * sizeof(uint64_t), std::memory_order_relaxed);
+	auto* const shared = new shared_words{{1}, hash, std::move(words)};
+	table.entries.emplace(hash, shared);
+	return shared;
+}
+
+void acquire(const shared_words* shared) { const_cast<shared_words*>(shared)->ref_count.fetch_add(1, std::memory_order_relaxed); }
+
+void release(const shared_words* const_shared) {
+	auto* const shared = const_cast<shared_words*>(const_shared);
+	// As long as other references remain, the count can be decremented without taking the lock
+	auto count = shared->ref_count.load(std::memory_order_relaxed);
+	while(count > 1) {
+		if(shared->ref_count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+	}
+
+	auto& table = get_shared_words_table();
+	{
+		std::lock_guard lock(table.mutex);
+		if(shared->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) return; // revived by intern_words
+		const auto [first, last] = table.entries.equal_range(shared->hash);
+		for(auto it = first; it != last; ++it) {
+			if(it->second == shared) {
+				table.entries.erase(it);
+				break;
+			}
+		}
+	}
+
+	auto& counters = get_shared_words_counters();
+	counters.num_live_sets.fetch_sub(1, std::memory_order_relaxed);
+	counters.num_live_bytes.fetch_sub(sizeof(shared_words) + shared->words.size() * sizeof(uint64_t), std::memory_order_relaxed);
+	delete shared;
+}
+
+} // namespace celerity::detail::node_set_detail
+
+namespace celerity::detail {
+
+node_set::node_set(const std::vector<node_id>& nodes) {
+	std::vector<uint64_t> words;
+	for(const auto nid : nodes) {
+		const size_t word = nid / 64;
+		if(word >= words.size()) { words.resize(word + 1, 0); }
+		words[word] |= uint64_t{1} << (nid % 64);
+	}
+	*this = from_words(std::move(words));
+}
+
+node_set::node_set(const node_set& other) : m_repr(other.m_repr) {
+	if(!is_inline()) { node_set_detail::acquire(&get_shared()); }
+}
+
+node_set& node_set::operator=(const node_set& other) {
+	if(this == &other) return *this;
+	if(!other.is_inline()) { node_set_detail::acquire(&other.get_shared()); }
+	if(!is_inline()) { node_set_detail::release(&get_shared()); }
+	m_repr = other.m_repr;
+	return *this;
+}
+
+node_set& node_set::operator=(node_set&& other) noexcept {
+	if(this == &other) return *this;
+	if(!is_inline()) { node_set_detail::release(&get_shared()); }
+	m_repr = other.m_repr;
+	other.m_repr = inline_tag;
+	return *this;
+}
+
+node_set::~node_set() {
+	if(!is_inline()) { node_set_detail::release(&get_shared()); }
+}
+
+node_set node_set::all(const size_t num_nodes) {
+	std::vector<uint64_t> words(num_nodes / 64, ~uint64_t{0});
+	if(num_nodes % 64 != 0) { words.push_back((uint64_t{1} << (num_nodes % 64)) - 1); }
+	return from_words(std::move(words));
+}
+
+bool node_set::test(const node_id nid) const {
+	if(is_inline()) return nid < inline_capacity && ((m_repr >> (nid + 1)) & 1) != 0;
+	const auto& words = get_shared().words;
+	return nid / 64 < words.size() && ((words[nid / 64] >> (nid % 64)) & 1) != 0;
+}
+
+size_t node_set::count() const {
+	if(is_inline()) return utils::popcount(static_cast<uint64_t>(m_repr >> 1));
+	size_t count = 0;
+	for(const auto w : get_shared().words) {
+		count += utils::popcount(w);
+	}
+	return count;
+}
+
+node_set& node_set::set(const node_id nid) {
+	if(is_inline() && nid < inline_capacity) {
+		m_repr |= uintptr_t{1} << (nid + 1);
+		return *this;
+	}
+	auto words = get_words();
+	if(nid / 64 >= words.size()) { words.resize(nid / 64 + 1, 0); }
+	words[nid / 64] |= uint64_t{1} << (nid % 64);
+	return *this = from_words(std::move(words));
+}
+
+node_set operator|(const node_set& lhs, const node_set& rhs) {
+	if(lhs.is_inline() && rhs.is_inline()) {
+		node_set result;
+		result.m_repr = lhs.m_repr | rhs.m_repr;
+		return result;
+	}
+	if(lhs == rhs) return lhs;
+	auto words = lhs.get_words();
+	const auto rhs_words = rhs.get_words();
+	if(rhs_words.size() > words.size()) { words.resize(rhs_words.size(), 0); }
+	for(size_t i = 0; i < rhs_words.size(); ++i) {
+		words[i] |= rhs_words[i];
+	}
+	return node_set::from_words(std::move(words));
+}
+
+std::vector<uint64_t> node_set::get_words() const {
+	if(!is_inline()) return get_shared().words;
+	const auto bits = static_cast<uint64_t>(m_repr >> 1);
+	if(bits == 0) return {};
+	return {bits};
+}
+
+node_set node_set::from_words(std::vector<uint64_t>&& words) {
+	while(!words.empty() && words.back() == 0) {
+		words.pop_back();
+	}
+	node_set result;
+	if(words.empty()) return result;
+	if(words.size() == 1 && (words[0] >> inline_capacity) == 0) {
+		result.m_repr = static_cast<uintptr_t>(words[0] << 1) | inline_tag;
+		return result;
+	}
+	result.m_repr = reinterpret_cast<uintptr_t>(node_set_detail::intern_words(std::move(words)));
+	assert(!result.is_inline());
+	return result;
+}
+
+node_set_statistics get_node_set_statistics() {
+	const auto& counters = node_set_detail::get_shared_words_counters();
+	return {counters.num_allocations.load(std::memory_order_relaxed), counters.num_live_sets.load(std::memory_order_relaxed),
+	    counters.num_live_bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace celerity::detail
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "mapped_memory.h"
+
+namespace celerity {
+namespace detail {
+
+	scratch_file_mapping::scratch_file_mapping(const std::string& directory, const size_t size_bytes) {
+		if(size_bytes == 0) return;
+
+		const auto dir = directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+		auto path_template = (dir / "celerity-scratch-XXXXXX").string();
+		std::vector<char> path(path_template.begin(), path_template.end());
+		path.push_back('\0');
+
+		const int fd = mkstemp(path.data());
+		if(fd == -1) { throw std::runtime_error(fmt::format("Unable to create scratch file in {}: {}", dir.string(), std::strerror(errno))); }
+
+		// Unlink right away so the file is reclaimed as soon as the mapping goes away, no matter how the process exits.
+		unlink(path.data());
+
+		if(ftruncate(fd, static_cast<off_t>(size_bytes)) != 0) {
+			const int err = errno;
+			close(fd);
+			throw std::runtime_error(fmt::format("Unable to grow scratch file in {} to {} bytes: {}", dir.string(), size_bytes, std::strerror(err)));
+		}
+
+		void* const ptr = mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		const int err = errno;
+		close(fd); // the mapping keeps the file alive
+		if(ptr == MAP_FAILED) { throw std::runtime_error(fmt::format("Unable to map {} bytes of scratch file: {}", size_bytes, std::strerror(err))); }
+
+		m_ptr = ptr;
+		m_size_bytes = size_bytes;
+	}
+
+	void scratch_file_mapping::advise(const size_t offset, const size_t size_bytes, const mapped_access_advice advice) const {
+		assert(offset + size_bytes <= m_size_bytes);
+		if(size_bytes == 0) return;
+
+		// madvise requires a page-aligned start address
+		const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t aligned_offset = offset / page_size * page_size;
+		const size_t aligned_size = std::min(m_size_bytes, offset + size_bytes) - aligned_offset;
+
+		int native_advice = MADV_NORMAL;
+		switch(advice) {
+		case mapped_access_advice::normal: native_advice = MADV_NORMAL; break;
+		case mapped_access_advice::sequential: native_advice = MADV_SEQUENTIAL; break;
+		case mapped_access_advice::will_need: native_advice = MADV_WILLNEED; break;
+		case mapped_access_advice::dont_need: native_advice = MADV_DONTNEED; break;
+		default: assert(!"Unhandled mapped_access_advice");
+		}
+		// Advice is a hint, failure is not an error
+		(void)madvise(static_cast<std::byte*>(m_ptr) + aligned_offset, aligned_size, native_advice);
+	}
+
+	void scratch_file_mapping::release() noexcept {
+		if(m_ptr == nullptr) return;
+		[[maybe_unused]] const auto ret = munmap(m_ptr, m_size_bytes);
+		assert(ret == 0 && "Error unmapping scratch file.");
+		m_ptr = nullptr;
+		m_size_bytes = 0;
+	}
+
+} // namespace detail
+} // namespace celerity
@@ -0,0 +1,67 @@
+#include <cassert>
+#include <filesystem>
+#include <stdexcept>
+
+#include <Windows.h>
+
+#include <fmt/format.h>
+
+#include "mapped_memory.h"
+
+namespace celerity {
+namespace detail {
+
+	scratch_file_mapping::scratch_file_mapping(const std::string& directory, const size_t size_bytes) {
+		if(size_bytes == 0) return;
+
+		const auto dir = directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+		char path[MAX_PATH];
+		if(GetTempFileNameA(dir.string().c_str(), "cly", 0, path) == 0) {
+			throw std::runtime_error(fmt::format("Unable to create scratch file in {} (error {})", dir.string(), GetLastError()));
+		}
+
+		// The file is deleted once the last handle to it (including the one held by the mapping) is closed.
+		const HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		    FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+		if(file == INVALID_HANDLE_VALUE) {
+			DeleteFileA(path);
+			throw std::runtime_error(fmt::format("Unable to open scratch file {} (error {})", path, GetLastError()));
+		}
+
+		LARGE_INTEGER size;
+		size.QuadPart = static_cast<LONGLONG>(size_bytes);
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+		const auto mapping_error = GetLastError();
+		CloseHandle(file);
+		if(mapping == nullptr) { throw std::runtime_error(fmt::format("Unable to map {} bytes of scratch file (error {})", size_bytes, mapping_error)); }
+
+		void* const ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size_bytes);
+		const auto view_error = GetLastError();
+		CloseHandle(mapping); // the view keeps the mapping alive
+		if(ptr == nullptr) { throw std::runtime_error(fmt::format("Unable to map {} bytes of scratch file (error {})", size_bytes, view_error)); }
+
+		m_ptr = ptr;
+		m_size_bytes = size_bytes;
+	}
+
+	void scratch_file_mapping::advise(const size_t offset, const size_t size_bytes, const mapped_access_advice advice) const {
+		assert(offset + size_bytes <= m_size_bytes);
+		if(size_bytes == 0) return;
+
+		// Windows only offers an explicit prefetch, all other advice is ignored
+		if(advice == mapped_access_advice::will_need) {
+			WIN32_MEMORY_RANGE_ENTRY entry{static_cast<std::byte*>(m_ptr) + offset, size_bytes};
+			(void)PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+		}
+	}
+
+	void scratch_file_mapping::release() noexcept {
+		if(m_ptr == nullptr) return;
+		[[maybe_unused]] const auto ret = UnmapViewOfFile(m_ptr);
+		assert(ret != FALSE && "Error unmapping scratch file.");
+		m_ptr = nullptr;
+		m_size_bytes = 0;
+	}
+
+} // namespace detail
+} // namespace celerity
@@ -0,0 +1,142 @@
+#include "numa.h"
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "log.h"
+
+namespace celerity {
+namespace detail {
+
+#if defined(__linux__)
+
+	// From <numaif.h>, which is part of libnuma and not generally available
+	constexpr int mpol_preferred = 1;
+
+	// Parses a kernel cpu list such as "0-3,8-11"
+	static std::vector<uint32_t> parse_cpu_list(const std::string& list) {
+		std::vector<uint32_t> cpus;
+		size_t pos = 0;
+		while(pos < list.size()) {
+			const auto end = std::min(list.find(',', pos), list.size());
+			const auto item = list.substr(pos, end - pos);
+			if(!item.empty()) {
+				const auto dash = item.find('-');
+				const auto first = static_cast<uint32_t>(std::stoul(item.substr(0, dash)));
+				const auto last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(item.substr(dash + 1)));
+				for(uint32_t cpu = first; cpu <= last; ++cpu) {
+					cpus.push_back(cpu);
+				}
+			}
+			pos = end + 1;
+		}
+		return cpus;
+	}
+
+	static std::vector<numa_node> read_sysfs_numa_nodes(const cpu_set_t& available_cores) {
+		std::vector<numa_node> nodes;
+		std::error_code ec;
+		for(const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+			const auto name = entry.path().filename().string();
+			if(name.rfind("node", 0) != 0 || name.size() == 4 || !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+				continue;
+			}
+
+			std::ifstream cpulist(entry.path() / "cpulist");
+			std::string list;
+			if(!std::getline(cpulist, list)) continue;
+
+			numa_node node{static_cast<uint32_t>(std::stoul(name.substr(4))), {}};
+			for(const auto cpu : parse_cpu_list(list)) {
+				if(cpu < CPU_SETSIZE && CPU_ISSET(cpu, &available_cores)) { node.cores.push_back(cpu); }
+			}
+			if(!node.cores.empty()) { nodes.push_back(std::move(node)); }
+		}
+		std::sort(nodes.begin(), nodes.end(), [](const numa_node& lhs, const numa_node& rhs) { return lhs.os_index < rhs.os_index; });
+		return nodes;
+	}
+
+#endif
+
+	numa_topology discover_numa_topology() {
+#if defined(__linux__)
+		cpu_set_t available_cores;
+		CPU_ZERO(&available_cores);
+		if(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &available_cores) != 0) {
+			CELERITY_WARN("Unable to retrieve process affinity mask, assuming a single NUMA node");
+			return numa_topology{{numa_node{0, {}}}};
+		}
+
+		numa_topology topology;
+		try {
+			topology.nodes = read_sysfs_numa_nodes(available_cores);
+		} catch(const std::exception& e) { CELERITY_WARN("Unable to determine NUMA topology: {}", e.what()); }
+		if(!topology.nodes.empty()) return topology;
+
+		// Not a NUMA system (or unable to tell): a single node with all available cores
+		numa_node node{0, {}};
+		for(uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+			if(CPU_ISSET(cpu, &available_cores)) { node.cores.push_back(cpu); }
+		}
+		return numa_topology{{std::move(node)}};
+#else
+		// Other UNIX systems (e.g. macOS) expose neither the NUMA topology nor process affinity masks: a single node with all cores
+		numa_node node{0, {}};
+		for(uint32_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+			node.cores.push_back(cpu);
+		}
+		return numa_topology{{std::move(node)}};
+#endif
+	}
+
+	void pin_thread_to_numa_node(
+	    [[maybe_unused]] const std::thread::native_handle_type thread_handle, const numa_topology& topology, [[maybe_unused]] const numa_node_id node) {
+		assert(node < topology.get_num_nodes());
+#if defined(__linux__)
+		cpu_set_t cores;
+		CPU_ZERO(&cores);
+		for(const auto core : topology.nodes[node].cores) {
+			CPU_SET(core, &cores);
+		}
+		if(const auto ret = pthread_setaffinity_np(thread_handle, sizeof(cpu_set_t), &cores); ret != 0) {
+			CELERITY_WARN("Unable to pin thread to NUMA node {} (error {})", topology.nodes[node].os_index, ret);
+		}
+#endif
+	}
+
+	void bind_memory_to_numa_node(
+	    [[maybe_unused]] void* const ptr, [[maybe_unused]] const size_t size_bytes, const numa_topology& topology, [[maybe_unused]] const numa_node_id node) {
+		assert(node < topology.get_num_nodes());
+#if defined(__linux__)
+		// mbind requires a page-aligned start address, so partial pages at either end keep the default (first-touch) policy
+		const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+		const auto begin = (reinterpret_cast<uintptr_t>(ptr) + page_size - 1) / page_size * page_size;
+		const auto end = (reinterpret_cast<uintptr_t>(ptr) + size_bytes) / page_size * page_size;
+		if(begin >= end) return;
+
+		constexpr size_t max_nodes = 1024;
+		unsigned long node_mask[max_nodes / (8 * sizeof(unsigned long))] = {};
+		const auto os_index = topology.nodes[node].os_index;
+		if(os_index >= max_nodes) return;
+		node_mask[os_index / (8 * sizeof(unsigned long))] |= 1ul << (os_index % (8 * sizeof(unsigned long)));
+
+		// A preferred (rather than strict) policy falls back to other nodes instead of failing allocations when the node is out of memory
+		if(syscall(SYS_mbind, begin, end - begin, mpol_preferred, node_mask, max_nodes, 0) != 0) {
+			CELERITY_DEBUG("Unable to bind {} bytes of memory to NUMA node {}", end - begin, os_index);
+		}
+#endif
+	}
+
+} // namespace detail
+} // namespace celerity
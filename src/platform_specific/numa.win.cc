@@ -0,0 +1,59 @@
+#include "numa.h"
+
+#include <cassert>
+
+#include <Windows.h>
+
+#include "log.h"
+
+namespace celerity {
+namespace detail {
+
+	numa_topology discover_numa_topology() {
+		DWORD_PTR available_cores = 0;
+		DWORD_PTR sys_affinity_mask = 0;
+		[[maybe_unused]] const auto ret = GetProcessAffinityMask(GetCurrentProcess(), &available_cores, &sys_affinity_mask);
+		assert(ret != FALSE && "Error retrieving affinity mask.");
+
+		numa_topology topology;
+		ULONG highest_node = 0;
+		if(GetNumaHighestNodeNumber(&highest_node) != FALSE) {
+			for(ULONG n = 0; n <= highest_node; ++n) {
+				ULONGLONG node_mask = 0;
+				if(GetNumaNodeProcessorMask(static_cast<UCHAR>(n), &node_mask) == FALSE) continue;
+				numa_node node{static_cast<uint32_t>(n), {}};
+				for(uint32_t core = 0; core < 8 * sizeof(DWORD_PTR); ++core) {
+					if((node_mask & available_cores & (DWORD_PTR{1} << core)) != 0) { node.cores.push_back(core); }
+				}
+				if(!node.cores.empty()) { topology.nodes.push_back(std::move(node)); }
+			}
+		}
+		if(!topology.nodes.empty()) return topology;
+
+		numa_node node{0, {}};
+		for(uint32_t core = 0; core < 8 * sizeof(DWORD_PTR); ++core) {
+			if((available_cores & (DWORD_PTR{1} << core)) != 0) { node.cores.push_back(core); }
+		}
+		return numa_topology{{std::move(node)}};
+	}
+
+	void pin_thread_to_numa_node(const std::thread::native_handle_type thread_handle, const numa_topology& topology, const numa_node_id node) {
+		assert(node < topology.get_num_nodes());
+		DWORD_PTR mask = 0;
+		for(const auto core : topology.nodes[node].cores) {
+			mask |= DWORD_PTR{1} << core;
+		}
+		if(SetThreadAffinityMask(thread_handle, mask) == 0) {
+			CELERITY_WARN("Unable to pin thread to NUMA node {} (error {})", topology.nodes[node].os_index, GetLastError());
+		}
+	}
+
+	void bind_memory_to_numa_node(
+	    void* /* ptr */, size_t /* size_bytes */, [[maybe_unused]] const numa_topology& topology, [[maybe_unused]] const numa_node_id node) {
+		// Windows only supports choosing a node at allocation time (VirtualAllocExNuma). Since worker threads are pinned, first-touch placement
+		// by the consuming thread still applies.
+		assert(node < topology.get_num_nodes());
+	}
+
+} // namespace detail
+} // namespace celerity
@@ -20,8 +20,8 @@ access_list build_access_list(const task& tsk, const buffer_manager* buff_man, c
 	const auto& bam = tsk.get_buffer_access_map();
 	for(const auto bid : bam.get_accessed_buffers()) {
 		for(const auto mode : bam.get_access_modes(bid)) {
-			const auto req = bam.get_mode_requirements(bid, mode, tsk.get_dimensions(), exec_range, tsk.get_global_size());
-			ret.push_back({bid, get_buffer_name(bid, buff_man), mode, req});
+			auto req = bam.get_mode_requirements(bid, mode, tsk.get_dimensions(), exec_range, tsk.get_global_size());
+			ret.push_back({bid, get_buffer_name(bid, buff_man), mode, std::move(req)});
 		}
 	}
 	return ret;
@@ -100,7 +100,7 @@ std::optional<node_id> get_target(const abstract_command& cmd) {
 	return {};
 }
 
-std::optional<region<3>> get_await_region(const abstract_command& cmd) {
+std::optional<shared_region<3>> get_await_region(const abstract_command& cmd) {
 	if(const auto* await_push_cmd = dynamic_cast<const await_push_command*>(&cmd)) return await_push_cmd->get_region();
 	return {};
 }
@@ -25,9 +25,11 @@
 #include "distributed_graph_generator.h"
 #include "executor.h"
 #include "host_object.h"
+#include "load_balancer.h"
 #include "log.h"
 #include "mpi_support.h"
 #include "named_threads.h"
+#include "numa.h"
 #include "print_graph.h"
 #include "scheduler.h"
 #include "task_manager.h"
@@ -134,7 +136,11 @@ namespace detail {
 
 		cgf_diagnostics::make_available();
 
-		m_h_queue = std::make_unique<host_queue>();
+		m_h_queue = std::make_unique<host_queue>(m_cfg->get_numa_placement());
+		if(const auto& topology = get_numa_topology(); topology.get_num_nodes() > 1) {
+			CELERITY_DEBUG("Process spans {} NUMA nodes, NUMA-aware host task placement is {}", topology.get_num_nodes(),
+			    m_h_queue->get_num_numa_nodes() > 0 ? "enabled" : "disabled");
+		}
 		m_d_queue = std::make_unique<device_queue>();
 
 		// Initialize worker classes (but don't start them up yet)
@@ -152,12 +158,23 @@ namespace detail {
 		m_task_mngr = std::make_unique<task_manager>(m_num_nodes, m_h_queue.get(), m_task_recorder.get());
 		if(m_cfg->get_horizon_step()) m_task_mngr->set_horizon_step(m_cfg->get_horizon_step().value());
 		if(m_cfg->get_horizon_max_parallelism()) m_task_mngr->set_horizon_max_parallelism(m_cfg->get_horizon_max_parallelism().value());
+		if(m_cfg->get_task_queue_soft_cap()) m_task_mngr->set_task_queue_soft_cap(m_cfg->get_task_queue_soft_cap().value());
 		m_exec = std::make_unique<executor>(m_num_nodes, m_local_nid, *m_h_queue, *m_d_queue, *m_task_mngr, *m_buffer_mngr, *m_reduction_mngr);
 		m_cdag = std::make_unique<command_graph>();
 		if(m_cfg->is_recording()) m_command_recorder = std::make_unique<command_recorder>(m_task_mngr.get(), m_buffer_mngr.get());
 		auto dggen = std::make_unique<distributed_graph_generator>(m_num_nodes, m_local_nid, *m_cdag, *m_task_mngr, m_command_recorder.get());
+		if(m_cfg->get_oversubscription()) dggen->set_oversubscription_factor(m_cfg->get_oversubscription().value());
+		dggen->set_locality_aware_assignment(m_cfg->get_locality_aware_assignment());
+		dggen->set_broadcast_trees(m_cfg->get_broadcast_trees());
 		m_schdlr = std::make_unique<scheduler>(is_dry_run(), std::move(dggen), *m_exec);
+		// The slowdown may be configured on individual nodes, whereas load balancing must be enabled on all of them
+		if((m_cfg->get_load_balancing() && m_num_nodes > 1 && !is_dry_run()) || m_cfg->get_load_balancing_slowdown() > 1) {
+			m_load_balancer = std::make_unique<load_balancer>(static_cast<double>(m_cfg->get_load_balancing_slowdown()));
+			m_exec->set_load_balancer(m_load_balancer.get());
+			if(m_cfg->get_load_balancing() && m_num_nodes > 1 && !is_dry_run()) { m_schdlr->set_load_balancer(m_load_balancer.get()); }
+		}
 		m_task_mngr->register_task_callback([this](const task* tsk) { m_schdlr->notify_task_created(tsk); });
+		if(m_cfg->get_async_submission()) m_task_mngr->enable_async_dependency_analysis();
 
 		CELERITY_INFO("Celerity runtime version {} running on {}. PID = {}, build type = {}, {}", get_version_string(), get_sycl_version(), get_pid(),
 		    get_build_type(), get_mimalloc_string());
@@ -168,11 +185,13 @@ namespace detail {
 		m_schdlr.reset();
 		m_cdag.reset();
 		m_exec.reset();
+		m_load_balancer.reset();
 		m_task_mngr.reset();
 		m_reduction_mngr.reset();
 		m_host_object_mngr.reset();
 		// All buffers should have unregistered themselves by now.
 		assert(!m_buffer_mngr->has_active_buffers());
+		if(spdlog::should_log(log_level::debug)) { CELERITY_DEBUG("{}", m_buffer_mngr->print_memory_report()); }
 		m_buffer_mngr.reset();
 		m_d_queue.reset();
 		m_h_queue.reset();
@@ -274,7 +293,7 @@ namespace detail {
 	void runtime::handle_buffer_registered(buffer_id bid) {
 		const auto& info = m_buffer_mngr->get_buffer_info(bid);
 		m_task_mngr->add_buffer(bid, info.dimensions, info.range, info.is_host_initialized);
-		m_schdlr->notify_buffer_registered(bid, info.dimensions, info.range);
+		m_schdlr->notify_buffer_registered(bid, info.dimensions, info.range, info.element_size);
 	}
 
 	void runtime::handle_buffer_unregistered(buffer_id bid) { maybe_destroy_runtime(); }
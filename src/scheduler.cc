@@ -4,7 +4,9 @@
 #include "executor.h"
 #include "frame.h"
 #include "graph_serializer.h"
+#include "load_balancer.h"
 #include "named_threads.h"
+#include "task.h"
 #include "utils.h"
 
 namespace celerity {
@@ -49,11 +51,21 @@ namespace detail {
 				    event,
 				    [&](const event_task_available& e) {
 					    assert(e.tsk != nullptr);
+					    // All nodes build the same horizons, so the weights received from the exchange started at the previous horizon take effect at
+					    // the same task everywhere
+					    if(m_load_balancer != nullptr) {
+						    m_load_balancer->register_kernel(e.tsk->get_debug_name());
+						    if(e.tsk->get_type() == task_type::horizon) {
+							    for(auto& [kernel_name, weights] : m_load_balancer->exchange()) {
+								    m_dggen->set_split_weights(kernel_name, std::move(weights));
+							    }
+						    }
+					    }
 					    const auto cmds = m_dggen->build_task(*e.tsk);
 					    serializer.flush(cmds);
 				    },
 				    [&](const event_buffer_registered& e) { //
-					    m_dggen->add_buffer(e.bid, e.dims, e.range);
+					    m_dggen->add_buffer(e.bid, e.dims, e.range, e.elem_size);
 				    },
 				    [&](const event_shutdown&) {
 					    assert(in_flight_events.empty());
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "access_modes.h"
+
 namespace celerity {
 namespace detail {
 
@@ -58,6 +60,41 @@ namespace detail {
 		return req;
 	}
 
+	const region<3>& task::get_consumed_region(const buffer_id bid) const {
+		static const region<3> empty_region;
+		const auto reqs = find_buffer_requirements(bid);
+		return reqs != nullptr ? reqs->consumed : empty_region;
+	}
+
+	const region<3>& task::get_produced_region(const buffer_id bid) const {
+		static const region<3> empty_region;
+		const auto reqs = find_buffer_requirements(bid);
+		return reqs != nullptr ? reqs->produced : empty_region;
+	}
+
+	void task::compute_buffer_requirements() {
+		const subrange<3> full_range{get_global_offset(), get_global_size()};
+		// Tasks typically access only a handful of buffers, so we avoid a map here
+		std::vector<std::tuple<buffer_id, box_vector<3>, box_vector<3>>> boxes;
+		for(size_t i = 0; i < m_access_map.get_num_accesses(); ++i) {
+			const auto [bid, mode] = m_access_map.get_nth_access(i);
+			auto it = std::find_if(boxes.begin(), boxes.end(), [bid = bid](const auto& b) { return std::get<0>(b) == bid; });
+			if(it == boxes.end()) { it = boxes.emplace(boxes.end(), bid, box_vector<3>(), box_vector<3>()); }
+			const auto req = m_access_map.get_requirements_for_nth_access(i, get_dimensions(), full_range, get_global_size());
+			if(access::mode_traits::is_consumer(mode)) { std::get<1>(*it).push_back(req); }
+			if(access::mode_traits::is_producer(mode)) { std::get<2>(*it).push_back(req); }
+		}
+		m_buffer_requirements.reserve(boxes.size());
+		for(auto& [bid, consumed, produced] : boxes) {
+			m_buffer_requirements.push_back({bid, region(std::move(consumed)), region(std::move(produced))});
+		}
+	}
+
+	const task::buffer_requirements* task::find_buffer_requirements(const buffer_id bid) const {
+		const auto it = std::find_if(m_buffer_requirements.begin(), m_buffer_requirements.end(), [=](const buffer_requirements& r) { return r.bid == bid; });
+		return it != m_buffer_requirements.end() ? &*it : nullptr;
+	}
+
 	void side_effect_map::add_side_effect(const host_object_id hoid, const experimental::side_effect_order order) {
 		// TODO for multiple side effects on the same hoid, find the weakest order satisfying all of them
 		emplace(hoid, order);
@@ -1,7 +1,9 @@
 #include "task_manager.h"
 
 #include "access_modes.h"
+#include "named_threads.h"
 #include "recorders.h"
+#include "utils.h"
 
 namespace celerity {
 namespace detail {
@@ -15,8 +17,140 @@ namespace detail {
 		m_task_buffer.put(std::move(reserve), std::move(initial_epoch));
 	}
 
+	task_manager::~task_manager() { stop_async_analysis(); }
+
+	void task_manager::begin_capture() {
+		if(m_capture.has_value()) { throw std::runtime_error("A capture is already in progress"); }
+		m_capture.emplace();
+	}
+
+	void task_manager::end_capture() {
+		if(!m_capture.has_value()) { throw std::runtime_error("No capture in progress"); }
+		m_captured_command_groups = std::move(*m_capture);
+		m_capture.reset();
+	}
+
+	void task_manager::replay_capture(const size_t num_iterations) {
+		if(m_capture.has_value()) { throw std::runtime_error("Cannot replay while a capture is in progress"); }
+		for(size_t i = 0; i < num_iterations; ++i) {
+			for(auto& captured : m_captured_command_groups) {
+				submit_command_group_internal(captured.cgf, captured.slot);
+			}
+		}
+	}
+
+	void task_manager::enable_async_dependency_analysis() {
+		if(m_async_analysis) return;
+		m_async_analysis = true;
+		m_analysis_thread = std::thread(&task_manager::analysis_thread_main, this);
+		set_thread_name(m_analysis_thread.native_handle(), "cy-task-mngr");
+	}
+
+	void task_manager::await_async_analysis() {
+		if(!m_async_analysis) return;
+		drain_async_analysis();
+
+		// The analysis thread is idle now, so we can create a pending horizon ourselves. Callers are epochs, fences and other points in the submission
+		// sequence, so this does not make horizon placement depend on timing. This must not wait for free task slots, because the ring buffer might be
+		// full of tasks that can only be freed through this horizon. The ring buffer leaves room for exceeding the soft cap by a few tasks.
+		if(m_horizon_requested_after.exchange(no_horizon_request, std::memory_order_relaxed) != no_horizon_request) {
+			generate_horizon_task(m_task_buffer.reserve_task_entry([](task_id) {}));
+		}
+	}
+
+	void task_manager::drain_async_analysis() {
+		assert(m_async_analysis);
+
+		std::promise<void> done;
+		auto analyzed = done.get_future();
+		m_analysis_queue.push(analysis_job_barrier{&done});
+		analyzed.wait();
+
+		if(m_analysis_failed.exchange(false, std::memory_order_acquire)) {
+			std::exception_ptr error;
+			{
+				std::lock_guard lock(m_analysis_error_mutex);
+				std::swap(error, m_analysis_error);
+			}
+			std::rethrow_exception(error);
+		}
+	}
+
+	void task_manager::shutdown() {
+		await_async_analysis();
+		stop_async_analysis();
+		m_task_buffer.clear();
+	}
+
+	void task_manager::prepare_async_submission() {
+		if(m_analysis_failed.load(std::memory_order_relaxed)) { drain_async_analysis(); }
+		if(m_num_async_submissions <= async_horizon_delay) return;
+
+		// A horizon requested after analyzing this submission is due now. We have to wait for the decision, otherwise the horizon's task id would depend on
+		// how far the analysis thread lags behind, and task ids would differ between nodes.
+		const size_t decided_submission = m_num_async_submissions - async_horizon_delay - 1;
+		await_analyzed_submissions(decided_submission + 1);
+		if(m_horizon_requested_after.load(std::memory_order_relaxed) <= decided_submission) {
+			m_horizon_requested_after.store(no_horizon_request, std::memory_order_relaxed);
+			m_analysis_queue.push(analysis_job_horizon{m_task_buffer.reserve_task_entry(await_free_task_slot_callback())});
+		}
+	}
+
+	void task_manager::await_analyzed_submissions(const size_t num_submissions) {
+		if(m_num_analyzed_submissions.load(std::memory_order_acquire) >= num_submissions) return;
+		std::unique_lock lock(m_analysis_progress_mutex);
+		m_analysis_progress.wait(lock, [&] { return m_num_analyzed_submissions.load(std::memory_order_relaxed) >= num_submissions; });
+	}
+
+	void task_manager::analysis_thread_main() {
+		for(;;) {
+			auto job = m_analysis_queue.pop();
+			if(std::holds_alternative<analysis_job_shutdown>(job)) return;
+			try {
+				utils::match(
+				    job, //
+				    [&](analysis_job_task& j) { process_task(std::move(j.reserve), std::move(j.tsk)); },
+				    [&](analysis_job_horizon& j) { generate_horizon_task(std::move(j.reserve)); },
+				    [&](analysis_job_add_buffer& j) { add_buffer_internal(j.bid, j.dims, j.buffer_range, j.host_initialized); },
+				    [&](analysis_job_barrier& j) { j.done->set_value(); },
+				    [&](analysis_job_shutdown&) {});
+			} catch(...) {
+				// Like in the synchronous case, the task remains registered even though its dependencies might be incomplete
+				std::lock_guard lock(m_analysis_error_mutex);
+				if(m_analysis_error == nullptr) { m_analysis_error = std::current_exception(); }
+				m_analysis_failed.store(true, std::memory_order_release);
+			}
+
+			// Also count failed submissions, the application thread might be waiting for them
+			if(std::holds_alternative<analysis_job_task>(job)) {
+				{
+					std::lock_guard lock(m_analysis_progress_mutex);
+					m_num_analyzed_submissions.fetch_add(1, std::memory_order_release);
+				}
+				m_analysis_progress.notify_one();
+			}
+		}
+	}
+
+	void task_manager::stop_async_analysis() {
+		if(!m_analysis_thread.joinable()) return;
+		m_analysis_queue.push(analysis_job_shutdown{});
+		m_analysis_thread.join();
+		m_async_analysis = false;
+	}
+
 	void task_manager::add_buffer(buffer_id bid, const int dims, const range<3>& range, bool host_initialized) {
+		if(m_async_analysis) {
+			m_analysis_queue.push(analysis_job_add_buffer{bid, dims, range, host_initialized});
+		} else {
+			add_buffer_internal(bid, dims, range, host_initialized);
+		}
+	}
+
+	void task_manager::add_buffer_internal(buffer_id bid, const int dims, const range<3>& range, bool host_initialized) {
 		m_buffers_last_writers.emplace(std::piecewise_construct, std::tuple{bid}, std::tuple{range, dims});
+		// Iterative applications query the last writers with the same requirements over and over
+		m_buffers_last_writers.at(bid).enable_query_cache(8);
 		if(host_initialized) { m_buffers_last_writers.at(bid).update_region(subrange<3>({}, range), m_epoch_for_new_tasks); }
 	}
 
@@ -53,17 +187,6 @@ namespace detail {
 
 	void task_manager::await_epoch(task_id epoch) { m_latest_epoch_reached.await(epoch); }
 
-	region<3> get_requirements(const task& tsk, buffer_id bid, const std::vector<cl::sycl::access::mode>& modes) {
-		const auto& access_map = tsk.get_buffer_access_map();
-		const subrange<3> full_range{tsk.get_global_offset(), tsk.get_global_size()};
-		box_vector<3> boxes;
-		for(auto m : modes) {
-			const auto req = access_map.get_mode_requirements(bid, m, tsk.get_dimensions(), full_range, tsk.get_global_size());
-			boxes.insert(boxes.end(), req.get_boxes().begin(), req.get_boxes().end());
-		}
-		return region(std::move(boxes));
-	}
-
 	void task_manager::compute_dependencies(task& tsk) {
 		using namespace cl::sycl::access;
 
@@ -94,7 +217,7 @@ namespace detail {
 
 			// Determine reader dependencies
 			if(std::any_of(modes.cbegin(), modes.cend(), detail::access::mode_traits::is_consumer) || (reduction.has_value() && reduction->init_from_buffer)) {
-				auto read_requirements = get_requirements(tsk, bid, {detail::access::consumer_modes.cbegin(), detail::access::consumer_modes.cend()});
+				auto read_requirements = tsk.get_consumed_region(bid);
 				if(reduction.has_value()) { read_requirements = region_union(read_requirements, scalar_box); }
 				const auto last_writers = m_buffers_last_writers.at(bid).get_region_values(read_requirements);
 
@@ -109,7 +232,7 @@ namespace detail {
 
 			// Update last writers and determine anti-dependencies
 			if(std::any_of(modes.cbegin(), modes.cend(), detail::access::mode_traits::is_producer) || reduction.has_value()) {
-				auto write_requirements = get_requirements(tsk, bid, {detail::access::producer_modes.cbegin(), detail::access::producer_modes.cend()});
+				auto write_requirements = tsk.get_produced_region(bid);
 				if(reduction.has_value()) { write_requirements = region_union(write_requirements, scalar_box); }
 				if(write_requirements.empty()) continue;
 
@@ -128,10 +251,8 @@ namespace detail {
 							// - if the task itself also needs read access to that buffer (R/W access)
 							continue;
 						}
-						const auto dependent_read_requirements =
-						    get_requirements(*dependent.node, bid, {detail::access::consumer_modes.cbegin(), detail::access::consumer_modes.cend()});
 						// Only add an anti-dependency if we are really writing over the region read by this task
-						if(!region_intersection(write_requirements, dependent_read_requirements).empty()) {
+						if(!region_intersection(write_requirements, dependent.node->get_consumed_region(bid)).empty()) {
 							add_dependency(tsk, *dependent.node, dependency_kind::anti_dep, dependency_origin::dataflow);
 							has_anti_dependents = true;
 						}
@@ -174,6 +295,28 @@ namespace detail {
 		}
 	}
 
+	void task_manager::process_task(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task) {
+		auto& tsk = register_task_internal(std::move(reserve), std::move(task));
+		compute_dependencies(tsk);
+
+		// the following deletion is intentionally redundant with the one happening when waiting for free task slots
+		// we want to free tasks earlier than just when running out of slots,
+		// so that we can potentially reclaim additional resources such as buffers earlier
+		m_task_buffer.delete_up_to(m_latest_epoch_reached.get());
+
+		invoke_callbacks(&tsk);
+
+		if(!m_horizon_request_pending && need_new_horizon()) {
+			if(m_async_analysis) {
+				// This is the analysis thread, and the task being processed has not been counted yet
+				m_horizon_request_pending = true;
+				m_horizon_requested_after.store(m_num_analyzed_submissions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			} else {
+				generate_horizon_task(m_task_buffer.reserve_task_entry(await_free_task_slot_callback()));
+			}
+		}
+	}
+
 	task& task_manager::register_task_internal(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task) {
 		auto& task_ref = *task;
 		assert(task != nullptr);
@@ -233,9 +376,9 @@ namespace detail {
 		m_epoch_for_new_tasks = epoch;
 	}
 
-	task_id task_manager::generate_horizon_task() {
-		auto reserve = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
+	task_id task_manager::generate_horizon_task(task_ring_buffer::reservation&& reserve) {
 		const auto tid = reserve.get_tid();
+		m_horizon_request_pending = false;
 
 		m_current_horizon_critical_path_length = m_max_pseudo_critical_path_length;
 		const auto previous_horizon = m_current_horizon;
@@ -249,6 +392,7 @@ namespace detail {
 	}
 
 	task_id task_manager::generate_epoch_task(epoch_action action) {
+		await_async_analysis();
 		auto reserve = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
 		const auto tid = reserve.get_tid();
 
@@ -264,6 +408,7 @@ namespace detail {
 	}
 
 	task_id task_manager::generate_fence_task(buffer_access_map access_map, side_effect_map side_effects, std::unique_ptr<fence_promise> fence_promise) {
+		await_async_analysis();
 		auto reserve = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
 		const auto tid = reserve.get_tid();
 		task& tsk = register_task_internal(std::move(reserve), task::make_fence(tid, std::move(access_map), std::move(side_effects), std::move(fence_promise)));
@@ -291,6 +436,9 @@ namespace detail {
 
 	task_ring_buffer::wait_callback task_manager::await_free_task_slot_callback() {
 		return [&](task_id previous_free_tid) {
+			// tasks are only registered and deleted on the analysis thread, and we need an up-to-date view of the in-flight horizons. Pending horizons
+			// are not inserted here, since running out of task slots depends on timing (see m_horizon_requested_after).
+			if(m_async_analysis) { drain_async_analysis(); }
 			if(get_first_in_flight_epoch() == m_latest_epoch_reached.get()) {
 				// verify that the epoch didn't get reached between the invocation of the callback and the in flight check
 				if(m_latest_epoch_reached.get() < previous_free_tid + 1) {
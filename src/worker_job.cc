@@ -6,6 +6,7 @@
 #include "closure_hydrator.h"
 #include "device_queue.h"
 #include "handler.h"
+#include "load_balancer.h"
 #include "reduction_manager.h"
 #include "runtime.h"
 #include "task_manager.h"
@@ -48,6 +49,17 @@ namespace detail {
 		m_start_time = std::chrono::steady_clock::now();
 	}
 
+	// Reports the execution time of a finished chunk to the load balancer, if any. Returns the point in time at which the job may complete, which lies
+	// in the future if the load balancer simulates a slower node.
+	static std::chrono::steady_clock::time_point record_execution(load_balancer* const lb, const task_manager& tm, const command_pkg& pkg,
+	    const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end) {
+		if(lb == nullptr) return end;
+		const auto data = std::get<execution_data>(pkg.data);
+		const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>((end - start) * lb->get_slowdown());
+		lb->record_execution(tm.get_task(data.tid)->get_debug_name(), data.sr.range.size(), duration);
+		return start + duration;
+	}
+
 	// --------------------------------------------------------------------------------------------------------------------
 	// --------------------------------------------------- HORIZON --------------------------------------------------------
 	// --------------------------------------------------------------------------------------------------------------------
@@ -83,7 +95,7 @@ namespace detail {
 	// --------------------------------------------------------------------------------------------------------------------
 
 	std::string await_push_job::get_description(const command_pkg& pkg) {
-		const auto data = std::get<await_push_data>(pkg.data);
+		const auto& data = std::get<await_push_data>(pkg.data);
 		return fmt::format("await push of buffer {} transfer {}", static_cast<size_t>(data.bid), static_cast<size_t>(data.trid));
 	}
 
@@ -141,7 +153,51 @@ namespace detail {
 		return fmt::format("HOST_EXECUTE {}", data.sr);
 	}
 
+	void host_execute_job::map_accesses(const command_pkg& pkg) {
+		const auto data = std::get<execution_data>(pkg.data);
+		const auto tsk = m_task_mngr.get_task(data.tid);
+		const auto& access_map = tsk->get_buffer_access_map();
+		m_access_subranges.reserve(access_map.get_num_accesses());
+		for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+			m_access_subranges.push_back(access_map.get_requirements_for_nth_access(i, tsk->get_dimensions(), data.sr, tsk->get_global_size()).get_subrange());
+		}
+	}
+
+	void host_execute_job::prefetch_buffers(const command_pkg& pkg) {
+		const auto data = std::get<execution_data>(pkg.data);
+		const auto& access_map = m_task_mngr.get_task(data.tid)->get_buffer_access_map();
+		for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+			const auto [bid, mode] = access_map.get_nth_access(i);
+			// There is nothing to page in for data that will be overwritten
+			if(!detail::access::mode_traits::is_consumer(mode)) continue;
+			m_buffer_mngr.prefetch_host_buffer(bid, m_access_subranges[i]);
+		}
+	}
+
+	numa_node_id host_execute_job::select_numa_node(const task& tsk) const {
+		const auto num_nodes = m_queue.get_num_numa_nodes();
+		if(num_nodes <= 1) return no_numa_node;
+
+		// Run close to the largest part of the input data that already resides in host memory
+		std::vector<size_t> consumed_bytes(num_nodes, 0);
+		const auto& access_map = tsk.get_buffer_access_map();
+		for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
+			const auto [bid, mode] = access_map.get_nth_access(i);
+			if(!detail::access::mode_traits::is_consumer(mode)) continue;
+			const auto node = m_buffer_mngr.get_host_buffer_numa_node(bid);
+			if(node == no_numa_node) continue;
+			consumed_bytes[node] += m_access_subranges[i].range.size() * m_buffer_mngr.get_element_size(bid);
+		}
+		const auto max = std::max_element(consumed_bytes.begin(), consumed_bytes.end());
+		if(*max > 0) return static_cast<numa_node_id>(max - consumed_bytes.begin());
+
+		// No data to be close to, newly allocated host buffers will follow wherever the task is placed
+		return m_queue.get_next_numa_node();
+	}
+
 	bool host_execute_job::execute(const command_pkg& pkg) {
+		if(m_release_time.has_value()) return std::chrono::steady_clock::now() >= *m_release_time;
+
 		if(!m_submitted) {
 			const auto data = std::get<execution_data>(pkg.data);
 
@@ -152,14 +208,15 @@ namespace detail {
 			if(!m_buffer_mngr.try_lock(pkg.cid, tsk->get_buffer_access_map().get_accessed_buffers())) { return false; }
 
 			CELERITY_TRACE("Scheduling host task in thread pool");
+			const auto numa_node = select_numa_node(*tsk);
 
 			const auto& access_map = tsk->get_buffer_access_map();
 			std::vector<closure_hydrator::accessor_info> access_infos;
 			access_infos.reserve(access_map.get_num_accesses());
 			for(size_t i = 0; i < access_map.get_num_accesses(); ++i) {
 				const auto [bid, mode] = access_map.get_nth_access(i);
-				const auto sr = access_map.get_requirements_for_nth_access(i, tsk->get_dimensions(), data.sr, tsk->get_global_size()).get_subrange();
-				const auto info = m_buffer_mngr.access_host_buffer(bid, mode, sr);
+				const auto& sr = m_access_subranges[i];
+				const auto info = m_buffer_mngr.access_host_buffer(bid, mode, sr, numa_node);
 
 #if CELERITY_ACCESSOR_BOUNDARY_CHECK
 				// oob_indices[0] contains the lower bound oob indices
@@ -178,7 +235,7 @@ namespace detail {
 			}
 
 			closure_hydrator::get_instance().arm(target::host_task, std::move(access_infos));
-			m_future = tsk->launch(m_queue, data.sr);
+			m_future = tsk->launch(m_queue, data.sr, numa_node);
 
 			assert(m_future.valid());
 			m_submitted = true;
@@ -199,7 +256,7 @@ namespace detail {
 
 				if(oob_max != id<3>{0, 0, 0}) {
 					const auto& access_map = tsk->get_buffer_access_map();
-					const auto acc_sr = access_map.get_requirements_for_nth_access(i, tsk->get_dimensions(), data.sr, tsk->get_global_size()).get_subrange();
+					const auto& acc_sr = m_access_subranges[i];
 					const auto oob_sr = subrange<3>(oob_min, range_cast<3>(oob_max - oob_min));
 					const auto buffer_id = access_map.get_nth_access(i).first;
 					CELERITY_ERROR("Out-of-bounds access in host task detected: Accessor {} for buffer {} attempted to access indices between {} which are "
@@ -213,7 +270,8 @@ namespace detail {
 			CELERITY_TRACE("Delta time submit -> start: {}us, start -> end: {}us",
 			    std::chrono::duration_cast<std::chrono::microseconds>(info.start_time - info.submit_time).count(),
 			    std::chrono::duration_cast<std::chrono::microseconds>(info.end_time - info.start_time).count());
-			return true;
+			m_release_time = record_execution(m_load_balancer, m_task_mngr, pkg, info.start_time, info.end_time);
+			return std::chrono::steady_clock::now() >= *m_release_time;
 		}
 		return false;
 	}
@@ -228,6 +286,8 @@ namespace detail {
 	}
 
 	bool device_execute_job::execute(const command_pkg& pkg) {
+		if(m_release_time.has_value()) return std::chrono::steady_clock::now() >= *m_release_time;
+
 		if(!m_submitted) {
 			const auto data = std::get<execution_data>(pkg.data);
 			auto tsk = m_task_mngr.get_task(data.tid);
@@ -281,6 +341,7 @@ namespace detail {
 			m_event = tsk->launch(m_queue, data.sr, reduction_ptrs, data.initialize_reductions);
 
 			m_submitted = true;
+			m_submit_time = std::chrono::steady_clock::now();
 			CELERITY_TRACE("Kernel submitted to SYCL");
 		}
 
@@ -324,7 +385,10 @@ namespace detail {
 				    std::chrono::duration_cast<std::chrono::microseconds>(start - submit).count(),
 				    std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 			}
-			return true;
+
+			// Device profiling timestamps are not comparable with the host clock, so we measure the wall time since submission instead
+			m_release_time = record_execution(m_load_balancer, m_task_mngr, pkg, m_submit_time, std::chrono::steady_clock::now());
+			return std::chrono::steady_clock::now() >= *m_release_time;
 		}
 		return false;
 	}
@@ -6,6 +6,10 @@
 #include <catch2/matchers/catch_matchers_exception.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include <atomic>
+#include <numeric>
+#include <thread>
+
 #include <celerity.h>
 
 #include "ranges.h"
@@ -718,8 +722,56 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "buffer_manager only copies accessed parts of buffers initialized by reference", "[buffer_manager]") {
+		auto& bm = get_buffer_manager();
+
+		constexpr size_t size = 64;
+		std::vector<size_t> host_buf(size * size);
+		std::iota(host_buf.begin(), host_buf.end(), size_t{0});
+
+		auto bid = bm.register_buffer<size_t, 2>(range<3>(size, size, 1), host_buf.data(), {}, host_init_policy::reference);
+		CHECK(bm.get_memory_statistics(bid).host.peak_bytes == 0);
+		const auto is_init_data = [](id<2> idx, bool current, size_t value) { return current && value == idx[0] * size + idx[1]; };
+
+		SECTION("when accessed on host") {
+			// Unlike with copy_on_register, the host buffer is only as large as required.
+			REQUIRE(get_backing_buffer_range<size_t, 2>(bid, access_target::host, {7, 5}, {8, 16}) == range<2>{7, 5});
+			REQUIRE(buffer_reduce<size_t, 2, class UKN(check)>(bid, access_target::host, {7, 5}, {8, 16}, true, is_init_data));
+			CHECK(bm.get_memory_statistics(bid).host.peak_bytes == 7 * 5 * sizeof(size_t));
+		}
+
+		SECTION("when accessed on device") {
+			REQUIRE(buffer_reduce<size_t, 2, class UKN(check)>(bid, access_target::device, {7, 5}, {8, 16}, true, is_init_data));
+			CHECK(bm.get_memory_statistics(bid).host.peak_bytes == 7 * 5 * sizeof(size_t));
+		}
+
+		SECTION("when parts are overwritten before being read") {
+			buffer_for_each<size_t, 2, access_mode::discard_write, class UKN(overwrite)>(
+			    bid, access_target::device, {8, 8}, {0, 0}, [](id<2>, size_t& value) { value = 0; });
+			// The user data must no longer be consulted for the overwritten part
+			std::fill(host_buf.begin(), host_buf.begin() + 8, size_t{42});
+
+			const bool valid = buffer_reduce<size_t, 2, class UKN(check_overwritten)>(bid, access_target::host, {16, 16}, {0, 0}, true,
+			    [](id<2> idx, bool current, size_t value) { return current && value == (idx[0] < 8 && idx[1] < 8 ? 0 : idx[0] * size + idx[1]); });
+			REQUIRE(valid);
+		}
+
+		SECTION("when data is requested for an outgoing transfer") {
+			std::vector<size_t> data(4 * 4);
+			bm.get_buffer_data(bid, {{32, 32, 0}, {4, 4, 1}}, data.data());
+			for(size_t i = 0; i < 4; ++i) {
+				for(size_t j = 0; j < 4; ++j) {
+					REQUIRE_LOOP(data[i * 4 + j] == (32 + i) * size + 32 + j);
+				}
+			}
+		}
+	}
+
 	TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "buffer_manager correctly handles locking", "[buffer_manager]") {
 		auto& bm = get_buffer_manager();
+		for(buffer_id bid = 0; bid < 7; ++bid) {
+			REQUIRE(bm.register_buffer<size_t, 1>(range<3>(1, 1, 1)) == bid);
+		}
 
 		// Check that basic functionality works.
 		REQUIRE(bm.try_lock(0, {}));
@@ -1078,6 +1130,127 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "buffer_manager keeps track of per-buffer memory usage", "[buffer_manager]") {
+		auto& bm = get_buffer_manager();
+		const auto bid = bm.register_buffer<size_t, 1>(range<3>(128, 1, 1));
+
+		CHECK(bm.get_memory_statistics(bid).device.peak_bytes == 0);
+		CHECK(bm.get_memory_statistics(bid).host.peak_bytes == 0);
+
+		bm.access_device_buffer<size_t, 1>(bid, access_mode::discard_write, {{0}, {32}});
+		bm.access_device_buffer<size_t, 1>(bid, access_mode::read_write, {{0}, {64}});
+		{
+			const auto stats = bm.get_memory_statistics(bid);
+			CHECK(stats.device.current_bytes == 64 * sizeof(size_t));
+			// The previous backing buffer is released only after its contents have been retained
+			CHECK(stats.device.peak_bytes == 96 * sizeof(size_t));
+			CHECK(stats.device.num_resizes == 1);
+			CHECK(stats.device.resize_copy_bytes == 32 * sizeof(size_t));
+			CHECK(stats.staging.peak_bytes == 0);
+		}
+
+		auto data = make_uninitialized_payload<size_t>(16);
+		bm.set_buffer_data(bid, {{64, 0, 0}, {16, 1, 1}}, std::move(data));
+		CHECK(bm.get_memory_statistics(bid).scheduled_transfers.current_bytes == 16 * sizeof(size_t));
+
+		// Reading on the host ingests the transfer and copies the device data through a staging buffer
+		bm.access_host_buffer<size_t, 1>(bid, access_mode::read, {{0}, {80}});
+		{
+			const auto stats = bm.get_memory_statistics(bid);
+			CHECK(stats.scheduled_transfers.current_bytes == 0);
+			CHECK(stats.scheduled_transfers.peak_bytes == 16 * sizeof(size_t));
+			CHECK(stats.host.current_bytes == 80 * sizeof(size_t));
+			CHECK(stats.host.num_resizes == 0);
+			CHECK(stats.staging.current_bytes == 0);
+			CHECK(stats.staging.peak_bytes == 64 * sizeof(size_t));
+		}
+
+		bm.unregister_buffer(bid);
+		const auto stats = bm.get_memory_statistics(bid);
+		CHECK(stats.device.current_bytes == 0);
+		CHECK(stats.host.current_bytes == 0);
+		CHECK(stats.device.peak_bytes == 96 * sizeof(size_t));
+	}
+
+	struct buffer_manager_testspy {
+		static constexpr size_t state_table_capacity = buffer_manager::buffer_state_table::capacity;
+
+		static void skip_buffer_ids(buffer_manager& bm, const size_t count) { bm.m_buffer_count += count; }
+
+		static size_t get_num_buffer_states(const buffer_manager& bm) {
+			size_t num_states = 0;
+			bm.m_buffer_states.for_each([&](const auto& /* state */) { ++num_states; });
+			return num_states;
+		}
+	};
+
+	TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "buffer_manager releases the state of unregistered buffers", "[buffer_manager]") {
+		auto& bm = get_buffer_manager();
+
+		const auto first_bid = bm.register_buffer<size_t, 1>(range<3>(32, 1, 1));
+		bm.access_host_buffer<size_t, 1>(first_bid, access_mode::discard_write, {{0}, {32}});
+		bm.set_debug_name(first_bid, "first");
+		bm.unregister_buffer(first_bid);
+		CHECK(buffer_manager_testspy::get_num_buffer_states(bm) == 0);
+		CHECK_FALSE(bm.has_buffer(first_bid));
+		CHECK(bm.get_memory_statistics(first_bid).host.peak_bytes == 32 * sizeof(size_t));
+		CHECK_THAT(bm.print_memory_report(), Catch::Matchers::ContainsSubstring("B0 \"first\":"));
+
+		SECTION("and reuses their slot for buffer ids that map to it") {
+			buffer_manager_testspy::skip_buffer_ids(bm, buffer_manager_testspy::state_table_capacity - 1);
+			const auto second_bid = bm.register_buffer<size_t, 1>(range<3>(16, 1, 1));
+			REQUIRE(second_bid == first_bid + buffer_manager_testspy::state_table_capacity);
+			CHECK(bm.has_buffer(second_bid));
+			CHECK_FALSE(bm.has_buffer(first_bid));
+			CHECK(bm.get_buffer_info(second_bid).range == range<3>(16, 1, 1));
+			CHECK(buffer_manager_testspy::get_num_buffer_states(bm) == 1);
+
+			// The slot is occupied as long as the buffer is registered
+			buffer_manager_testspy::skip_buffer_ids(bm, buffer_manager_testspy::state_table_capacity - 1);
+			CHECK_THROWS_WITH((bm.register_buffer<size_t, 1>(range<3>(16, 1, 1))),
+			    fmt::format("Exceeded the maximum of {} simultaneously registered buffers", buffer_manager_testspy::state_table_capacity));
+			bm.unregister_buffer(second_bid);
+		}
+
+		SECTION("while only summarizing the statistics of long-unregistered buffers") {
+			for(int i = 0; i < 2000; ++i) {
+				bm.unregister_buffer(bm.register_buffer<size_t, 1>(range<3>(1, 1, 1)));
+			}
+			CHECK(buffer_manager_testspy::get_num_buffer_states(bm) == 0);
+			const auto report = bm.print_memory_report();
+			CHECK_THAT(report, Catch::Matchers::ContainsSubstring("earlier unregistered buffers"));
+			CHECK_THAT(report, !Catch::Matchers::ContainsSubstring("B0 \"first\":"));
+			CHECK_THAT(report, Catch::Matchers::ContainsSubstring("B2000:"));
+		}
+	}
+
+	TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "buffer_manager statistics can be queried while buffers are being unregistered", "[buffer_manager]") {
+		auto& bm = get_buffer_manager();
+
+		constexpr size_t num_buffers = 200;
+		std::atomic<size_t> num_registered = 0;
+		std::thread lifecycle_thread([&] {
+			for(size_t i = 0; i < num_buffers; ++i) {
+				const auto bid = bm.register_buffer<size_t, 1>(range<3>(64, 1, 1));
+				num_registered.store(i + 1);
+				bm.access_host_buffer<size_t, 1>(bid, access_mode::discard_write, {{0}, {64}});
+				bm.unregister_buffer(bid);
+			}
+		});
+
+		size_t num_queried = 0;
+		while(num_queried < num_buffers) {
+			num_queried = num_registered.load();
+			for(buffer_id bid = 0; bid < num_queried; ++bid) {
+				bm.has_buffer(bid);
+				CHECK(bm.get_memory_statistics(bid).host.peak_bytes <= 64 * sizeof(size_t));
+			}
+			CHECK_THAT(bm.print_memory_report(), Catch::Matchers::StartsWith("Buffer memory usage"));
+		}
+		lifecycle_thread.join();
+		CHECK_FALSE(bm.has_active_buffers());
+	}
+
 	TEST_CASE_METHOD(test_utils::device_queue_fixture, "device_queue allows to allocate device memory and query usage", "[device_queue]") {
 		auto& dq = get_device_queue();
 		const size_t ten_mib = 1024ul * 1024ul * 10ul;
@@ -1,3 +1,5 @@
+#include <bitset>
+
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -5,8 +7,10 @@
 
 #include "command_graph.h"
 #include "distributed_graph_generator.h"
+#include "distributed_graph_generator_test_utils.h"
 #include "executor.h"
 #include "intrusive_graph.h"
+#include "node_set.h"
 #include "task_manager.h"
 #include "test_utils.h"
 
@@ -77,12 +81,12 @@ TEST_CASE("benchmark task handling", "[benchmark][group:task-graph]") {
 		tm->set_horizon_step(0);
 	};
 
-	auto task_creation_lambda = [&](bool with_sync = false) {
+	auto task_creation_lambda = [&](const int interval, bool with_sync = false) {
 		for(int i = 0; i < N; ++i) {
 			// create simplest possible host task
 			highest_tid = tm->submit_command_group([](handler& cgh) { cgh.host_task(on_master_node, [] {}); });
 			// start notifying once we've built some tasks
-			if(i % report_interval == 0 && i / report_interval > 1) {
+			if(i % interval == 0 && i / interval > 1) {
 				while(with_sync && highest_tid_to_delete.load() < highest_tid.load())
 					; // need to potentially wait for task lookup thread to catch up
 				// every other generated task is always a horizon (step size 0)
@@ -95,7 +99,17 @@ TEST_CASE("benchmark task handling", "[benchmark][group:task-graph]") {
 		highest_tid_to_delete = N * 2; // set sufficiently high to just run through
 		BENCHMARK("generating and deleting tasks") {
 			initialization_lambda();
-			task_creation_lambda();
+			task_creation_lambda(report_interval);
+		};
+	}
+
+	SECTION("with deep queue") {
+		// only report horizons every few thousand tasks, so that the application thread runs far ahead of task deletion
+		const int deep_report_interval = GENERATE(values({1000, 4000}));
+		highest_tid_to_delete = N * 2;
+		BENCHMARK(fmt::format("generating and deleting tasks, reaching horizons every {} tasks", deep_report_interval)) {
+			initialization_lambda();
+			task_creation_lambda(deep_report_interval);
 		};
 	}
 
@@ -123,7 +137,7 @@ TEST_CASE("benchmark task handling", "[benchmark][group:task-graph]") {
 			initialization_lambda();
 			highest_tid_to_delete = 0;
 			run_lookups = true;
-			task_creation_lambda(true);
+			task_creation_lambda(report_interval, true);
 			run_lookups = false;
 			while(highest_tid_to_delete.load() != 0)
 				; // wait for task lookup thread to finish
@@ -174,10 +188,15 @@ struct graph_generator_benchmark_context {
 
 	template <int KernelDims, typename CGF>
 	void create_task(range<KernelDims> global_range, CGF cgf) {
+		create_task(global_range, id<KernelDims>{}, cgf);
+	}
+
+	template <int KernelDims, typename CGF>
+	void create_task(range<KernelDims> global_range, id<KernelDims> global_offset, CGF cgf) {
 		// note: This ignores communication overhead with the scheduler thread
 		tm.submit_command_group([=](handler& cgh) {
 			cgf(cgh);
-			cgh.host_task(global_range, [](partition<KernelDims>) {});
+			cgh.host_task(global_range, global_offset, [](partition<KernelDims>) {});
 		});
 	}
 };
@@ -423,6 +442,23 @@ template <typename BenchmarkContext>
 	return std::forward<BenchmarkContext>(ctx);
 }
 
+// Artificial: Every write to a buffer is followed by many tasks each reading a part of it, so the next write has to check all of them for anti-dependencies
+template <typename BenchmarkContext>
+[[gnu::noinline]] BenchmarkContext&& generate_fan_out_graph(BenchmarkContext&& ctx, const size_t num_readers, const size_t num_steps) {
+	const range<2> global_range{num_readers, 256};
+	test_utils::mock_buffer<2> buf = ctx.mbf.create_buffer(global_range);
+	for(size_t s = 0; s < num_steps; ++s) {
+		ctx.create_task(global_range, [&](handler& cgh) { buf.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{}); });
+		for(size_t r = 0; r < num_readers; ++r) {
+			ctx.create_task(range<1>{global_range[1]}, [&](handler& cgh) {
+				buf.get_access<access_mode::read>(cgh, [=](chunk<1> ck) { return subrange<2>{{r, ck.offset[0]}, {1, ck.range[0]}}; });
+			});
+		}
+	}
+
+	return std::forward<BenchmarkContext>(ctx);
+}
+
 template <typename BenchmarkContextFactory>
 void run_benchmarks(BenchmarkContextFactory&& make_ctx) {
 	BENCHMARK("soup topology") { generate_soup_graph(make_ctx(), 100); };
@@ -437,10 +473,224 @@ TEST_CASE("generating large task graphs", "[benchmark][group:task-graph]") {
 	run_benchmarks([] { return task_manager_benchmark_context{}; });
 }
 
+TEST_CASE("generating task graphs with many readers per buffer", "[benchmark][group:task-graph]") {
+	const size_t num_readers = GENERATE(values<size_t>({16, 256}));
+	BENCHMARK(fmt::format("{} readers per write", num_readers)) { generate_fan_out_graph(task_manager_benchmark_context{}, num_readers, 10); };
+}
+
 TEMPLATE_TEST_CASE_SIG("generating large command graphs for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 1, 4, 16) {
 	run_benchmarks([] { return graph_generator_benchmark_context{NumNodes}; });
 }
 
+// Each node should only inspect the few remote chunks that read data it owns, so generation time per node should scale sub-linearly with the cluster size
+TEMPLATE_TEST_CASE_SIG(
+    "generating stencil command graphs for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 4, 16, 64, 256, 1024) {
+	BENCHMARK("wave_sim topology") { generate_wave_sim_graph(graph_generator_benchmark_context{NumNodes}, 50); };
+}
+
+// 2D five-point stencil ping-ponging between two buffers, split according to the given strategy
+template <typename BenchmarkContext>
+[[gnu::noinline]] BenchmarkContext&& generate_split_stencil_graph(BenchmarkContext&& ctx, const experimental::split_strategy strategy, const int steps) {
+	constexpr int N = 1024;
+	test_utils::mock_buffer<2> u = ctx.mbf.create_buffer(range<2>{N, N}, true /* host initialized */);
+	test_utils::mock_buffer<2> v = ctx.mbf.create_buffer(range<2>{N, N});
+	for(int k = 0; k < steps; ++k) {
+		ctx.create_task(range<2>{N, N}, [&](handler& cgh) {
+			experimental::set_split_strategy(cgh, strategy);
+			u.get_access<access_mode::read>(cgh, celerity::access::neighborhood{1, 1});
+			v.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+		});
+		std::swap(u, v);
+	}
+	return std::forward<BenchmarkContext>(ctx);
+}
+
+// Block splitting should transfer fewer elements than slab splitting for stencils once there are enough nodes to split more than one dimension
+TEMPLATE_TEST_CASE_SIG("generating stencil command graphs with different split strategies for N nodes", "[benchmark][group:command-graph]",
+    ((size_t NumNodes), NumNodes), 4, 16, 64) {
+	const auto count_pushed_elements = [](const experimental::split_strategy strategy) {
+		test_utils::dist_cdag_test_context dctx(NumNodes);
+		constexpr int N = 1024;
+		auto u = dctx.create_buffer(range<2>{N, N}, true /* host initialized */);
+		auto v = dctx.create_buffer(range<2>{N, N});
+		for(int k = 0; k < 4; ++k) {
+			dctx.device_compute<class UKN(stencil)>(range<2>{N, N})
+			    .read(u, celerity::access::neighborhood{1, 1})
+			    .discard_write(v, celerity::access::one_to_one{})
+			    .set_split_strategy(strategy)
+			    .submit();
+			std::swap(u, v);
+		}
+		size_t num_elements = 0;
+		for(const auto* cmd : dctx.query(command_type::push).get_raw()) {
+			num_elements += utils::as<push_command>(cmd)->get_range().range.size();
+		}
+		return num_elements;
+	};
+
+	const auto slab_elements = count_pushed_elements(experimental::split_strategy::slab);
+	const auto block_elements = count_pushed_elements(experimental::split_strategy::block);
+	INFO(fmt::format("elements pushed across {} nodes: {} with slab splitting, {} with block splitting", NumNodes, slab_elements, block_elements));
+	CHECK(block_elements <= slab_elements);
+
+	BENCHMARK("slab split") { generate_split_stencil_graph(graph_generator_benchmark_context{NumNodes}, experimental::split_strategy::slab, 10); };
+	BENCHMARK("block split") { generate_split_stencil_graph(graph_generator_benchmark_context{NumNodes}, experimental::split_strategy::block, 10); };
+}
+
+// Ping-pong chain in which every other task is shifted against its predecessors, as in staggered grids or pipelines operating on sub-buffers
+template <typename BenchmarkContext>
+[[gnu::noinline]] BenchmarkContext&& generate_shifted_chain_graph(BenchmarkContext&& ctx, const bool locality_aware, const int steps) {
+	constexpr int N = 1 << 20;
+	ctx.dggen.set_locality_aware_assignment(locality_aware);
+	test_utils::mock_buffer<1> u = ctx.mbf.create_buffer(range<1>{N}, true /* host initialized */);
+	test_utils::mock_buffer<1> v = ctx.mbf.create_buffer(range<1>{N}, true /* host initialized */);
+	for(int k = 0; k < steps; ++k) {
+		const size_t offset = k % 2 == 0 ? 0 : N / 4;
+		ctx.create_task(range<1>{N - offset}, id<1>{offset}, [&](handler& cgh) {
+			u.get_access<access_mode::read>(cgh, celerity::access::one_to_one{});
+			v.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+		});
+		std::swap(u, v);
+	}
+	return std::forward<BenchmarkContext>(ctx);
+}
+
+// Locality-aware assignment should never move more bytes than assigning chunks in index order
+TEMPLATE_TEST_CASE_SIG("generating shifted command graphs with locality-aware chunk assignment for N nodes", "[benchmark][group:command-graph]",
+    ((size_t NumNodes), NumNodes), 4, 16, 64) {
+	const auto count_pushed_bytes = [](const bool locality_aware) {
+		test_utils::dist_cdag_test_context dctx(NumNodes);
+		for(node_id nid = 0; nid < NumNodes; ++nid) {
+			dctx.get_graph_generator(nid).set_locality_aware_assignment(locality_aware);
+		}
+		constexpr int N = 1 << 20;
+		auto u = dctx.create_buffer(range<1>{N}, true /* host initialized */);
+		auto v = dctx.create_buffer(range<1>{N}, true /* host initialized */);
+		for(int k = 0; k < 8; ++k) {
+			const size_t offset = k % 2 == 0 ? 0 : N / 4;
+			dctx.device_compute<class UKN(shifted)>(range<1>{N - offset}, id<1>{offset})
+			    .read(u, celerity::access::one_to_one{})
+			    .discard_write(v, celerity::access::one_to_one{})
+			    .submit();
+			std::swap(u, v);
+		}
+		size_t num_bytes = 0;
+		for(const auto* cmd : dctx.query(command_type::push).get_raw()) {
+			num_bytes += utils::as<push_command>(cmd)->get_range().range.size() * sizeof(float);
+		}
+		return num_bytes;
+	};
+
+	const auto contiguous_bytes = count_pushed_bytes(false);
+	const auto locality_bytes = count_pushed_bytes(true);
+	INFO(fmt::format("bytes moved across {} nodes: {} with contiguous assignment, {} with locality-aware assignment", NumNodes, contiguous_bytes,
+	    locality_bytes));
+	CHECK(locality_bytes <= contiguous_bytes);
+
+	BENCHMARK("contiguous assignment") { generate_shifted_chain_graph(graph_generator_benchmark_context{NumNodes}, false, 10); };
+	BENCHMARK("locality-aware assignment") { generate_shifted_chain_graph(graph_generator_benchmark_context{NumNodes}, true, 10); };
+}
+
+// Every node writes a slab of a buffer, which all nodes then read in its entirety. The replicated regions of the local slab track up to every node.
+template <typename BenchmarkContext>
+[[gnu::noinline]] BenchmarkContext&& generate_all_gather_graph(BenchmarkContext&& ctx, const int steps) {
+	const size_t n = ctx.num_nodes * 16;
+	test_utils::mock_buffer<1> buf = ctx.mbf.create_buffer(range<1>{n});
+	for(int k = 0; k < steps; ++k) {
+		ctx.create_task(range<1>{n}, [&](handler& cgh) { buf.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{}); });
+		ctx.create_task(range<1>{n}, [&](handler& cgh) { buf.get_access<access_mode::read>(cgh, celerity::access::all{}); });
+	}
+	return std::forward<BenchmarkContext>(ctx);
+}
+
+// Mirrors how the replicated regions of a node evolve while it pushes parts of a buffer to every other node, one update per push
+template <typename NodeSet>
+[[gnu::noinline]] NodeSet replicate_to_all_nodes(const size_t num_nodes) {
+	constexpr size_t num_boxes = 16;
+	region_map<NodeSet> replicated_regions(range<3>{num_boxes, 1, 1}, 1, NodeSet{});
+	for(size_t nid = 0; nid < num_nodes; ++nid) {
+		for(size_t i = 0; i < num_boxes; ++i) {
+			const box<3> pushed_box(subrange<3>({(i + nid) % num_boxes, 0, 0}, {1, 1, 1}));
+			const auto nodes = replicated_regions.get_region_values(pushed_box).front().second;
+			replicated_regions.update_box(pushed_box, NodeSet{nodes}.set(nid));
+		}
+	}
+	return replicated_regions.get_region_values(box<3>(subrange<3>({}, {num_boxes, 1, 1}))).front().second;
+}
+
+// Simulates the local node of a dry run with N nodes. A fixed-size std::bitset would need to be sized for the largest supported cluster.
+TEMPLATE_TEST_CASE_SIG("generating all-gather command graphs for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 4, 256, 4096) {
+	{
+		const auto before = get_node_set_statistics();
+		graph_generator_benchmark_context ctx{NumNodes};
+		generate_all_gather_graph(ctx, 2);
+		const auto during = get_node_set_statistics();
+		INFO(fmt::format("{} byte node sets with {} bytes of shared storage in {} allocations, compared to {} byte bitsets", sizeof(node_set),
+		    during.num_live_bytes - before.num_live_bytes, during.num_allocations - before.num_allocations, sizeof(std::bitset<NumNodes>)));
+		CHECK(sizeof(node_set) <= sizeof(std::bitset<NumNodes>));
+	}
+
+	BENCHMARK("all-gather topology") { generate_all_gather_graph(graph_generator_benchmark_context{NumNodes}, 5); };
+	BENCHMARK("replicated regions with node_set") { return replicate_to_all_nodes<node_set>(NumNodes); };
+	BENCHMARK("replicated regions with std::bitset") { return replicate_to_all_nodes<std::bitset<NumNodes>>(NumNodes); };
+}
+
+// Counts how many regions the command graph stores (in await-push commands, anti-dependency tracking and command records) and how many of them are
+// distinct, i.e. had to be allocated because identical regions are shared between commands
+TEST_CASE("regions stored while generating command graphs", "[benchmark][group:command-graph]") {
+	const auto report_region_storage = [](const char* const label, auto&& generate) {
+		const auto before = get_shared_region_statistics();
+		generate(graph_generator_benchmark_context{4});
+		const auto after = get_shared_region_statistics();
+		const auto num_constructions = after.num_constructions - before.num_constructions;
+		const auto num_allocations = after.num_allocations - before.num_allocations;
+		INFO(fmt::format("{}: {} regions stored, {} allocated with {} boxes in total", label, num_constructions, num_allocations,
+		    after.num_allocated_boxes - before.num_allocated_boxes));
+		CHECK(num_allocations <= num_constructions);
+	};
+
+	report_region_storage("chain topology", [](auto&& ctx) { generate_chain_graph(std::move(ctx), 30); });
+	report_region_storage("wave_sim topology", [](auto&& ctx) { generate_wave_sim_graph(std::move(ctx), 50); });
+	report_region_storage("jacobi topology", [](auto&& ctx) { generate_jacobi_graph(std::move(ctx), 50); });
+}
+
+// Ping-pong stencil over two buffers, either submitted anew in every iteration or captured once and replayed
+template <typename BenchmarkContext>
+[[gnu::noinline]] BenchmarkContext&& generate_stencil_graph(BenchmarkContext&& ctx, const int steps, const bool replay) {
+	constexpr int N = 1024;
+	test_utils::mock_buffer<2> u = ctx.mbf.create_buffer(range<2>{N, N}, true /* host initialized */);
+	test_utils::mock_buffer<2> v = ctx.mbf.create_buffer(range<2>{N, N});
+
+	const auto submit_iteration = [&] {
+		ctx.create_task(range<2>{N, N}, [&](handler& cgh) {
+			u.get_access<access_mode::read>(cgh, celerity::access::neighborhood{1, 1});
+			v.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+		});
+		ctx.create_task(range<2>{N, N}, [&](handler& cgh) {
+			v.get_access<access_mode::read>(cgh, celerity::access::neighborhood{1, 1});
+			u.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+		});
+	};
+
+	if(replay) {
+		ctx.tm.begin_capture();
+		submit_iteration();
+		ctx.tm.end_capture();
+		ctx.tm.replay_capture(steps - 1);
+	} else {
+		for(int k = 0; k < steps; ++k) {
+			submit_iteration();
+		}
+	}
+
+	return std::forward<BenchmarkContext>(ctx);
+}
+
+TEMPLATE_TEST_CASE_SIG("replaying captured iterations for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 4, 16) {
+	BENCHMARK("reference: submitting every iteration") { generate_stencil_graph(graph_generator_benchmark_context{NumNodes}, 50, false); };
+	BENCHMARK("replaying a captured iteration") { generate_stencil_graph(graph_generator_benchmark_context{NumNodes}, 50, true); };
+}
+
 TEMPLATE_TEST_CASE_SIG(
     "building command graphs in a dedicated scheduler thread for N nodes", "[benchmark][group:scheduler]", ((size_t NumNodes), NumNodes), 1, 4) {
 	SECTION("reference: single-threaded immediate graph generation") {
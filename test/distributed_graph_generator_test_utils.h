@@ -81,6 +81,14 @@ class task_builder {
 			return chain<step>([constraint](handler& cgh) { experimental::constrain_split(cgh, constraint); });
 		}
 
+		step oversubscribe(const size_t factor) {
+			return chain<step>([factor](handler& cgh) { experimental::oversubscribe(cgh, factor); });
+		}
+
+		step set_split_strategy(const experimental::split_strategy strategy) {
+			return chain<step>([strategy](handler& cgh) { experimental::set_split_strategy(cgh, strategy); });
+		}
+
 	  private:
 		dist_cdag_test_context& m_dctx;
 		std::deque<action> m_actions;
@@ -494,7 +502,7 @@ class dist_cdag_test_context {
 		const auto buf = test_utils::mock_buffer<Dims>(bid, size);
 		m_tm.add_buffer(bid, Dims, range_cast<3>(size), mark_as_host_initialized);
 		for(auto& dggen : m_dggens) {
-			dggen->add_buffer(bid, Dims, range_cast<3>(size));
+			dggen->add_buffer(bid, Dims, range_cast<3>(size), 1);
 		}
 		return buf;
 	}
@@ -543,6 +551,28 @@ class dist_cdag_test_context {
 		return fence(buf, {{}, buf.get_range()});
 	}
 
+	// Unlike the task_builder, this does not consume the command group, so it can be captured and replayed
+	template <typename CGF>
+	task_id submit(CGF cgf) {
+		const auto tid = m_tm.submit_command_group(cgf);
+		build_task(tid);
+		maybe_build_horizon();
+		return tid;
+	}
+
+	void begin_capture() { m_tm.begin_capture(); }
+
+	void end_capture() { m_tm.end_capture(); }
+
+	void replay(const size_t num_iterations) {
+		const task_id first_tid = m_tm.get_total_task_count();
+		m_tm.replay_capture(num_iterations);
+		for(task_id tid = first_tid; tid < m_tm.get_total_task_count(); ++tid) {
+			build_task(tid);
+		}
+		m_most_recently_built_horizon = task_manager_testspy::get_current_horizon(m_tm);
+	}
+
 	task_id epoch(epoch_action action) {
 		const auto tid = m_tm.generate_epoch_task(action);
 		build_task(tid);
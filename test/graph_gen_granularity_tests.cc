@@ -74,6 +74,206 @@ TEST_CASE("distributed_graph_generator respects split constraints", "[distribute
 	CHECK(dynamic_cast<const execution_command*>(dctx.query(tid_b).get_raw(1)[0])->get_execution_range().range == range<3>{96, 1, 1});
 }
 
+TEST_CASE("distributed_graph_generator assigns contiguous chunks to each node when oversubscribing", "[distributed_graph_generator]") {
+	const size_t num_nodes = 3;
+	dist_cdag_test_context dctx(num_nodes);
+
+	const auto check_assignment = [&](const task_id tid, const std::vector<std::vector<subrange<3>>>& expected_per_node) {
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			std::vector<subrange<3>> execution_ranges;
+			for(const auto* cmd : dctx.query(tid).get_raw(nid)) {
+				execution_ranges.push_back(dynamic_cast<const execution_command*>(cmd)->get_execution_range());
+			}
+			const auto by_offset = [](const subrange<3>& lhs, const subrange<3>& rhs) { return lhs.offset[0] < rhs.offset[0]; };
+			std::sort(execution_ranges.begin(), execution_ranges.end(), by_offset);
+			CHECK(execution_ranges == expected_per_node[nid]);
+		}
+	};
+
+	SECTION("with a chunk count that is a multiple of the number of nodes") {
+		const auto tid = dctx.device_compute<class UKN(task)>(range<1>{120}).oversubscribe(2).submit();
+		check_assignment(tid, {
+		                          {subrange<3>{{0, 0, 0}, {20, 1, 1}}, subrange<3>{{20, 0, 0}, {20, 1, 1}}},
+		                          {subrange<3>{{40, 0, 0}, {20, 1, 1}}, subrange<3>{{60, 0, 0}, {20, 1, 1}}},
+		                          {subrange<3>{{80, 0, 0}, {20, 1, 1}}, subrange<3>{{100, 0, 0}, {20, 1, 1}}},
+		                      });
+	}
+
+	SECTION("with a chunk count that is not a multiple of the number of nodes") {
+		// The split constraint limits the task to 4 chunks instead of the requested 6
+		const auto tid = dctx.device_compute<class UKN(task)>(range<1>{120}).constrain_split(range<1>{30}).oversubscribe(2).submit();
+		check_assignment(tid, {
+		                          {subrange<3>{{0, 0, 0}, {30, 1, 1}}, subrange<3>{{30, 0, 0}, {30, 1, 1}}},
+		                          {subrange<3>{{60, 0, 0}, {30, 1, 1}}},
+		                          {subrange<3>{{90, 0, 0}, {30, 1, 1}}},
+		                      });
+	}
+
+	SECTION("with a default factor set on the graph generator") {
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			dctx.get_graph_generator(nid).set_oversubscription_factor(2);
+		}
+		const auto tid_default = dctx.device_compute<class UKN(task)>(range<1>{120}).submit();
+		CHECK(dctx.query(tid_default).count() == 6);
+		const auto tid_override = dctx.device_compute<class UKN(task)>(range<1>{120}).oversubscribe(1).submit();
+		CHECK(dctx.query(tid_override).count() == 3);
+	}
+}
+
+TEST_CASE("distributed_graph_generator assigns chunks to the nodes holding their inputs with locality-aware assignment", "[distributed_graph_generator]") {
+	const size_t num_nodes = 4;
+	dist_cdag_test_context dctx(num_nodes);
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		dctx.get_graph_generator(nid).set_locality_aware_assignment(true);
+	}
+
+	const auto get_execution_offsets = [&](const task_id tid, const node_id nid) {
+		std::vector<size_t> offsets;
+		for(const auto* cmd : dctx.query(tid, command_type::execution).get_raw(nid)) {
+			offsets.push_back(dynamic_cast<const execution_command*>(cmd)->get_execution_range().offset[0]);
+		}
+		return offsets;
+	};
+	const auto count_pushed_elements = [&](const task_id tid) {
+		size_t num_elements = 0;
+		for(const auto* cmd : dctx.query(tid, command_type::push).get_raw()) {
+			num_elements += dynamic_cast<const push_command*>(cmd)->get_range().range.size();
+		}
+		return num_elements;
+	};
+
+	auto buf = dctx.create_buffer(range<1>{256});
+	const auto tid_init = dctx.device_compute<class UKN(init)>(range<1>{256}).discard_write(buf, acc::one_to_one{}).submit();
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		CHECK(get_execution_offsets(tid_init, nid) == std::vector<size_t>{nid * 64});
+	}
+
+	SECTION("when the task is shifted against its predecessor") {
+		// Chunks of 48 elements starting at 64: in index order, every node would have to receive most of its input
+		const auto tid = dctx.device_compute<class UKN(shifted)>(range<1>{192}, id<1>{64}).read(buf, acc::one_to_one{}).submit();
+		CHECK(get_execution_offsets(tid, 0) == std::vector<size_t>{160});
+		CHECK(get_execution_offsets(tid, 1) == std::vector<size_t>{64});
+		CHECK(get_execution_offsets(tid, 2) == std::vector<size_t>{112});
+		CHECK(get_execution_offsets(tid, 3) == std::vector<size_t>{208});
+		CHECK(count_pushed_elements(tid) == 64); // instead of 96
+	}
+
+	SECTION("but keeps the contiguous assignment if the data is already distributed accordingly") {
+		const auto tid = dctx.device_compute<class UKN(aligned)>(range<1>{256}).read(buf, acc::one_to_one{}).submit();
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			CHECK(get_execution_offsets(tid, nid) == std::vector<size_t>{nid * 64});
+		}
+		CHECK(count_pushed_elements(tid) == 0);
+	}
+
+	SECTION("except for tasks with reductions, which are initialized on node 0") {
+		// Both chunks read data resident on nodes 2 and 3, but node 0 must execute one to include the current value of the reduction buffer
+		auto reduction_buf = dctx.create_buffer(range<1>{1});
+		const auto tid = dctx.device_compute<class UKN(reduce)>(range<1>{128}, id<1>{128})
+		                     .constrain_split(range<1>{64})
+		                     .read(buf, acc::one_to_one{})
+		                     .reduce(reduction_buf, true /* include_current_buffer_value */)
+		                     .submit();
+		CHECK(get_execution_offsets(tid, 0) == std::vector<size_t>{128});
+		CHECK(get_execution_offsets(tid, 1) == std::vector<size_t>{192});
+		CHECK(get_execution_offsets(tid, 2).empty());
+		CHECK(get_execution_offsets(tid, 3).empty());
+	}
+}
+
+class weighted_kernel;
+
+TEST_CASE("distributed_graph_generator sizes chunks proportionally to per-node split weights", "[distributed_graph_generator]") {
+	const size_t num_nodes = 4;
+	dist_cdag_test_context dctx(num_nodes);
+
+	const auto get_execution_range = [&](const task_id tid, const node_id nid) {
+		const auto cmds = dctx.query(tid, command_type::execution).get_raw(nid);
+		REQUIRE(cmds.size() == 1);
+		return dynamic_cast<const execution_command*>(cmds[0])->get_execution_range();
+	};
+
+	const auto tid_unweighted = dctx.device_compute<weighted_kernel>(range<1>{100}).submit();
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		CHECK(get_execution_range(tid_unweighted, nid).range == range<3>{25, 1, 1});
+	}
+
+	const auto kernel_name = dctx.get_task_manager().get_task(tid_unweighted)->get_debug_name();
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		dctx.get_graph_generator(nid).set_split_weights(kernel_name, {0.1, 0.2, 0.3, 0.4});
+	}
+
+	SECTION("for subsequent instances of the same kernel") {
+		const auto tid = dctx.device_compute<weighted_kernel>(range<1>{100}).submit();
+		CHECK(get_execution_range(tid, 0) == subrange<3>{{0, 0, 0}, {10, 1, 1}});
+		CHECK(get_execution_range(tid, 1) == subrange<3>{{10, 0, 0}, {20, 1, 1}});
+		CHECK(get_execution_range(tid, 2) == subrange<3>{{30, 0, 0}, {30, 1, 1}});
+		CHECK(get_execution_range(tid, 3) == subrange<3>{{60, 0, 0}, {40, 1, 1}});
+	}
+
+	SECTION("while respecting the task granularity") {
+		const auto tid = dctx.device_compute<weighted_kernel>(nd_range<1>{{128}, {32}}).submit();
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			CHECK(get_execution_range(tid, nid).range == range<3>{32, 1, 1});
+		}
+	}
+
+	SECTION("but not for other kernels") {
+		const auto tid = dctx.device_compute<class UKN(other)>(range<1>{100}).submit();
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			CHECK(get_execution_range(tid, nid).range == range<3>{25, 1, 1});
+		}
+	}
+
+	SECTION("nor for host tasks without a name, which cannot be told apart") {
+		const auto tid_a = dctx.host_task(range<1>{100}).submit();
+		const auto tid_b = dctx.host_task(range<1>{100}).submit();
+		const auto unnamed = dctx.get_task_manager().get_task(tid_a)->get_debug_name();
+		REQUIRE(dctx.get_task_manager().get_task(tid_b)->get_debug_name() == unnamed);
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			dctx.get_graph_generator(nid).set_split_weights(unnamed, {0.1, 0.2, 0.3, 0.4});
+		}
+		const auto tid_c = dctx.host_task(range<1>{100}).submit();
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			CHECK(get_execution_range(tid_c, nid).range == range<3>{25, 1, 1});
+		}
+	}
+}
+
+TEST_CASE("distributed_graph_generator splits along all dimensions with the block split strategy", "[distributed_graph_generator]") {
+	const size_t num_nodes = 4;
+	dist_cdag_test_context dctx(num_nodes);
+	const auto block = experimental::split_strategy::block;
+
+	const auto get_execution_ranges = [&](const task_id tid) {
+		std::vector<subrange<3>> execution_ranges;
+		for(const auto* cmd : dctx.query(tid).get_raw()) {
+			execution_ranges.push_back(dynamic_cast<const execution_command*>(cmd)->get_execution_range());
+		}
+		return execution_ranges;
+	};
+
+	SECTION("into a grid with minimal surface") {
+		const auto tid = dctx.device_compute<class UKN(task)>(range<2>{128, 128}).set_split_strategy(block).submit();
+		for(const auto& sr : get_execution_ranges(tid)) {
+			CHECK(sr.range == range<3>{64, 64, 1});
+		}
+		CHECK(dynamic_cast<const execution_command*>(dctx.query(tid).get_raw(1)[0])->get_execution_range().offset == id<3>{0, 64, 0});
+	}
+
+	SECTION("while respecting the task granularity") {
+		const auto tid = dctx.device_compute<class UKN(task)>(nd_range<2>{{128, 128}, {128, 32}}).set_split_strategy(block).submit();
+		for(const auto& sr : get_execution_ranges(tid)) {
+			CHECK(sr.range == range<3>{128, 32, 1});
+		}
+	}
+
+	SECTION("and falls back to fewer chunks if the global range does not admit enough blocks") {
+		const auto tid = dctx.device_compute<class UKN(task)>(range<3>{3, 1, 1}).set_split_strategy(block).submit();
+		CHECK(get_execution_ranges(tid).size() == 3);
+	}
+}
+
 template <int Dims>
 class simple_task;
 
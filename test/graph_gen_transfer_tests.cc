@@ -54,8 +54,13 @@ TEST_CASE("distributed_graph_generator doesn't generate data transfer commands f
 	}
 
 	SECTION("when used in the same task by different chunks on the same worker node") {
-		// FIXME: Bring this back once we support oversubscription
-		SKIP("Oversubscription NYI");
+		dctx.device_compute<class UKN(task_a)>(test_range).discard_write(buf0, acc::one_to_one{}).submit();
+		// Each node executes two chunks, both of which read the other node's half
+		dctx.device_compute<class UKN(task_b)>(test_range).read(buf0, acc::all{}).oversubscribe(2).submit();
+		CHECK(dctx.query(command_type::push, node_id(0)).count() == 1);
+		CHECK(dctx.query(command_type::push, node_id(1)).count() == 1);
+		CHECK(dctx.query(command_type::await_push, node_id(0)).count() == 1);
+		CHECK(dctx.query(command_type::await_push, node_id(1)).count() == 1);
 	}
 
 	SECTION("when used in consecutive tasks") {
@@ -240,3 +245,86 @@ TEST_CASE("distributed_graph_generator generates anti-dependencies with subrange
 		CHECK_FALSE(dctx.query(node_id(0), tid_b).have_successors(await_push, dependency_kind::anti_dep));
 	}
 }
+
+TEST_CASE("distributed_graph_generator generates pushes only to nodes whose chunks read local data", "[distributed_graph_generator][command-graph]") {
+	const size_t num_nodes = 16;
+	dist_cdag_test_context dctx(num_nodes);
+
+	const range<1> test_range = {256};
+	auto buf = dctx.create_buffer(test_range);
+	dctx.device_compute<class UKN(task_a)>(test_range).discard_write(buf, acc::one_to_one{}).submit();
+
+	SECTION("for range mappers with a known preimage") {
+		dctx.device_compute<class UKN(task_b)>(test_range).read(buf, acc::neighborhood<1>(1)).submit();
+		// Every node exchanges halos with its direct neighbors only
+		CHECK(dctx.query(command_type::push).count() == 2 * (num_nodes - 1));
+		CHECK(dctx.query(command_type::push, node_id(0)).count() == 1);
+		CHECK(dctx.query(command_type::push, node_id(7)).count() == 2);
+		CHECK(dctx.query(command_type::push, node_id(num_nodes - 1)).count() == 1);
+		CHECK(dctx.query(command_type::await_push).count() == 2 * (num_nodes - 1));
+	}
+
+	SECTION("for arbitrary range mappers") {
+		const auto reverse = [=](chunk<1> chnk) { return subrange<1>{test_range[0] - chnk.offset[0] - chnk.range[0], chnk.range[0]}; };
+		dctx.device_compute<class UKN(task_b)>(test_range).read(buf, reverse).submit();
+		CHECK(dctx.query(command_type::push).count() == num_nodes);
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			CHECK(dctx.query(command_type::push, nid).count() == 1);
+		}
+	}
+}
+
+TEST_CASE("distributed_graph_generator forwards data read by all nodes along a broadcast tree", "[distributed_graph_generator][command-graph]") {
+	const size_t num_nodes = 8;
+	dist_cdag_test_context dctx(num_nodes);
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		dctx.get_graph_generator(nid).set_broadcast_trees(true);
+	}
+
+	const range<1> test_range = {256};
+	auto buf = dctx.create_buffer(test_range);
+	dctx.master_node_host_task().discard_write(buf, acc::all{}).submit();
+
+	const auto get_push_targets = [&](const node_id nid) {
+		std::vector<node_id> targets;
+		for(const auto* cmd : dctx.query(command_type::push, nid).get_raw(nid)) {
+			targets.push_back(utils::as<push_command>(cmd)->get_target());
+		}
+		std::sort(targets.begin(), targets.end());
+		return targets;
+	};
+
+	SECTION("when every node reads the entire buffer") {
+		dctx.device_compute<class UKN(task_b)>(test_range).read(buf, acc::all{}).submit();
+
+		// Node 0 pushes to nodes 1, 2 and 4, which forward the data to the rest of the binomial tree
+		CHECK(get_push_targets(0) == std::vector<node_id>{1, 2, 4});
+		CHECK(get_push_targets(1) == std::vector<node_id>{3, 5});
+		CHECK(get_push_targets(2) == std::vector<node_id>{6});
+		CHECK(get_push_targets(3) == std::vector<node_id>{7});
+		for(node_id nid = 4; nid < num_nodes; ++nid) {
+			CHECK(get_push_targets(nid).empty());
+		}
+		CHECK(dctx.query(command_type::await_push).count() == num_nodes - 1);
+
+		// Intermediate nodes forward the data once they have received it
+		for(node_id nid = 1; nid <= 3; ++nid) {
+			CHECK(dctx.query(command_type::await_push, nid).have_successors(dctx.query(command_type::push, nid), dependency_kind::true_dep));
+		}
+	}
+
+	SECTION("when the data has already been replicated to some nodes") {
+		dctx.device_compute<class UKN(task_b)>(range<1>{4}).read(buf, acc::all{}).submit();
+		// Nodes 0 through 3 now hold the data, so the next tree only contains the remaining four nodes as receivers
+		dctx.device_compute<class UKN(task_c)>(test_range).read(buf, acc::all{}).submit();
+		CHECK(dctx.query(command_type::push).count() == 3 + 4);
+		CHECK(dctx.query(command_type::await_push).count() == 3 + 4);
+	}
+
+	SECTION("when fewer nodes read the data than are worth forming a tree") {
+		dctx.device_compute<class UKN(task_b)>(range<1>{3}).read(buf, acc::all{}).submit();
+		// Only nodes 1 and 2 need the data, which node 0 pushes to them directly
+		CHECK(get_push_targets(0) == std::vector<node_id>{1, 2});
+		CHECK(dctx.query(command_type::push).count() == 2);
+	}
+}
@@ -499,3 +499,173 @@ TEST_CASE("fences introduce dependencies on buffers", "[distributed_graph_genera
 		CHECK(dctx.query(tid_fence, nid).have_successors(dctx.query(tid_b, nid)));
 	}
 }
+
+TEST_CASE("replaying a captured iteration generates the same commands as submitting it again", "[distributed_graph_generator][command-graph][capture]") {
+	constexpr size_t num_nodes = 4;
+	cgf_diagnostics::teardown(); // see test_utils::add_compute_task
+
+	const auto generate = [](dist_cdag_test_context& dctx, const bool replay) {
+		dctx.set_horizon_step(2);
+		auto buf_a = dctx.create_buffer(range<1>(128));
+		auto buf_b = dctx.create_buffer(range<1>(128));
+		size_t global_size = 128;
+
+		const auto stencil_a_to_b = [&](handler& cgh) {
+			buf_a.get_access<access_mode::read>(cgh, acc::neighborhood<1>(1));
+			buf_b.get_access<access_mode::discard_write>(cgh, acc::one_to_one{});
+			cgh.parallel_for<class UKN(a_to_b)>(range<1>(global_size), [](id<1>) {});
+		};
+		const auto stencil_b_to_a = [&](handler& cgh) {
+			buf_b.get_access<access_mode::read>(cgh, acc::neighborhood<1>(1));
+			buf_a.get_access<access_mode::discard_write>(cgh, acc::one_to_one{});
+			cgh.parallel_for<class UKN(b_to_a)>(range<1>(global_size), [](id<1>) {});
+		};
+		const auto submit_iteration = [&] {
+			dctx.submit(stencil_a_to_b);
+			dctx.submit(stencil_b_to_a);
+		};
+
+		if(replay) dctx.begin_capture();
+		submit_iteration();
+		if(replay) {
+			dctx.end_capture();
+			dctx.replay(3);
+		} else {
+			for(int i = 0; i < 3; ++i) {
+				submit_iteration();
+			}
+		}
+
+		// A replayed command group that no longer produces the same task must not re-use results from earlier iterations
+		global_size = 64;
+		if(replay) {
+			dctx.replay(1);
+		} else {
+			submit_iteration();
+		}
+		dctx.epoch(epoch_action::none);
+	};
+
+	dist_cdag_test_context submitted_dctx(num_nodes);
+	generate(submitted_dctx, false);
+	dist_cdag_test_context replayed_dctx(num_nodes);
+	generate(replayed_dctx, true);
+
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		CHECK(replayed_dctx.print_command_graph(nid) == submitted_dctx.print_command_graph(nid));
+	}
+	CHECK(replayed_dctx.print_task_graph() == submitted_dctx.print_task_graph());
+}
+
+TEST_CASE("replaying a captured iteration re-evaluates range mappers whose parameters have changed", "[distributed_graph_generator][command-graph][capture]") {
+	constexpr size_t num_nodes = 4;
+	cgf_diagnostics::teardown(); // see test_utils::add_compute_task
+
+	const auto generate = [](dist_cdag_test_context& dctx, const bool replay) {
+		auto buf_a = dctx.create_buffer(range<1>(128));
+		auto buf_b = dctx.create_buffer(range<1>(128));
+		auto buf_c = dctx.create_buffer(range<1>(128));
+		dctx.device_compute<class UKN(init)>(range<1>(128)).discard_write(buf_a, acc::one_to_one{}).discard_write(buf_b, acc::one_to_one{}).submit();
+
+		// Both parameters are captured by reference, so replayed command groups observe changes to them
+		size_t radius = 1;
+		size_t offset = 0;
+		const auto iteration = [&](handler& cgh) {
+			buf_a.get_access<access_mode::read>(cgh, acc::neighborhood<1>(radius));
+			buf_b.get_access<access_mode::read>(cgh, acc::fixed<1>({offset, 64}));
+			buf_c.get_access<access_mode::discard_write>(cgh, acc::one_to_one{});
+			cgh.parallel_for<class UKN(iteration)>(range<1>(128), [](id<1>) {});
+		};
+		const auto run = [&](const size_t num_iterations) {
+			if(replay) {
+				dctx.replay(num_iterations);
+			} else {
+				for(size_t i = 0; i < num_iterations; ++i) {
+					dctx.submit(iteration);
+				}
+			}
+		};
+
+		if(replay) {
+			dctx.begin_capture();
+			dctx.submit(iteration);
+			dctx.end_capture();
+		} else {
+			dctx.submit(iteration);
+		}
+		run(2);
+
+		// Reads one more element on each side, which only changes the regions of individual chunks, since the task as a whole reads the entire buffer
+		radius = 2;
+		run(2);
+
+		// Moves the region read by every chunk
+		offset = 32;
+		run(2);
+		dctx.epoch(epoch_action::none);
+	};
+
+	dist_cdag_test_context submitted_dctx(num_nodes);
+	generate(submitted_dctx, false);
+	dist_cdag_test_context replayed_dctx(num_nodes);
+	generate(replayed_dctx, true);
+
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		CHECK(replayed_dctx.print_command_graph(nid) == submitted_dctx.print_command_graph(nid));
+	}
+	CHECK(replayed_dctx.print_task_graph() == submitted_dctx.print_task_graph());
+}
+
+TEST_CASE("replaying a captured iteration always re-evaluates custom range mappers", "[distributed_graph_generator][command-graph][capture]") {
+	constexpr size_t num_nodes = 4;
+	cgf_diagnostics::teardown(); // see test_utils::add_compute_task
+
+	const auto generate = [](dist_cdag_test_context& dctx, const bool replay) {
+		auto buf_a = dctx.create_buffer(range<1>(128));
+		auto buf_b = dctx.create_buffer(range<1>(128));
+		dctx.device_compute<class UKN(init)>(range<1>(128)).discard_write(buf_a, acc::one_to_one{}).submit();
+
+		// Once mirrored, all but the first chunk read a different region, while the region read by the first chunk and by the entire task stay the same
+		bool mirrored = false;
+		const auto iteration = [&](handler& cgh) {
+			const auto mirror = [&mirrored](const chunk<1>& ck) {
+				if(!mirrored || ck.offset[0] == 0) return subrange<1>(ck.offset, ck.range);
+				return subrange<1>(ck.global_size[0] - ck.offset[0] - ck.range[0], ck.range);
+			};
+			buf_a.get_access<access_mode::read>(cgh, mirror);
+			buf_b.get_access<access_mode::discard_write>(cgh, acc::one_to_one{});
+			cgh.parallel_for<class UKN(iteration)>(range<1>(128), [](id<1>) {});
+		};
+
+		if(replay) {
+			dctx.begin_capture();
+			dctx.submit(iteration);
+			dctx.end_capture();
+			dctx.replay(2);
+		} else {
+			for(int i = 0; i < 3; ++i) {
+				dctx.submit(iteration);
+			}
+		}
+
+		mirrored = true;
+		if(replay) {
+			dctx.replay(2);
+		} else {
+			for(int i = 0; i < 2; ++i) {
+				dctx.submit(iteration);
+			}
+		}
+		dctx.epoch(epoch_action::none);
+	};
+
+	dist_cdag_test_context submitted_dctx(num_nodes);
+	generate(submitted_dctx, false);
+	dist_cdag_test_context replayed_dctx(num_nodes);
+	generate(replayed_dctx, true);
+
+	for(node_id nid = 0; nid < num_nodes; ++nid) {
+		CHECK(replayed_dctx.print_command_graph(nid) == submitted_dctx.print_command_graph(nid));
+	}
+	CHECK(replayed_dctx.print_task_graph() == submitted_dctx.print_task_graph());
+}
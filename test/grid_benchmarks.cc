@@ -111,11 +111,44 @@ TEMPLATE_TEST_CASE_SIG("normalizing a fully mergeable tiling of boxes", "[benchm
 	}
 }
 
+TEST_CASE("performing set operations between randomized regions - 1d", "[benchmark][group:grid]") {
+	const auto [label, grid_size, max_box_size, num_boxes] = GENERATE(values<std::tuple<const char*, size_t, size_t, size_t>>({
+	    {"small", 100, 5, 4},
+	    {"medium", 1000, 10, 100},
+	    {"large", 100000, 50, 1000},
+	}));
+
+	// Extruding the intervals along dimension 1 keeps the structure of the regions, but forces the general box-by-box algorithms
+	const auto extrude = [](const region<1>& r) {
+		box_vector<2> boxes;
+		for(const auto& b : r.get_boxes()) {
+			boxes.emplace_back(id<2>(b.get_min()[0], 0), id<2>(b.get_max()[0], 2));
+		}
+		return region<2>(std::move(boxes));
+	};
+
+	const std::vector inputs_1d{
+	    region(create_random_boxes<1>(grid_size, max_box_size, num_boxes, 13)), region(create_random_boxes<1>(grid_size, max_box_size, num_boxes, 37))};
+	const std::vector inputs_2d{extrude(inputs_1d[0]), extrude(inputs_1d[1])};
+
+	BENCHMARK(fmt::format("union, {}, native", label)) { return region_union(inputs_1d[0], inputs_1d[1]); };
+	BENCHMARK(fmt::format("union, {}, extruded to 2d", label)) { return region_union(inputs_2d[0], inputs_2d[1]); };
+	BENCHMARK(fmt::format("intersection, {}, native", label)) { return region_intersection(inputs_1d[0], inputs_1d[1]); };
+	BENCHMARK(fmt::format("intersection, {}, extruded to 2d", label)) { return region_intersection(inputs_2d[0], inputs_2d[1]); };
+	BENCHMARK(fmt::format("difference, {}, native", label)) { return region_difference(inputs_1d[0], inputs_1d[1]); };
+	BENCHMARK(fmt::format("difference, {}, extruded to 2d", label)) { return region_difference(inputs_2d[0], inputs_2d[1]); };
+
+	CHECK(extrude(region_union(inputs_1d[0], inputs_1d[1])) == region_union(inputs_2d[0], inputs_2d[1]));
+	CHECK(extrude(region_intersection(inputs_1d[0], inputs_1d[1])) == region_intersection(inputs_2d[0], inputs_2d[1]));
+	CHECK(extrude(region_difference(inputs_1d[0], inputs_1d[1])) == region_difference(inputs_2d[0], inputs_2d[1]));
+}
+
 TEST_CASE("performing set operations between randomized regions - 2d", "[benchmark][group:grid]") {
 	const auto [label, grid_size, max_box_size, num_boxes] = GENERATE(values<std::tuple<const char*, size_t, size_t, size_t>>({
 	    {"small", 10, 5, 4},
 	    {"medium", 50, 1, 50},
 	    {"large", 200, 20, 100},
+	    {"10k boxes", 1000, 20, 10000},
 	}));
 
 	const std::vector inputs_2d{
@@ -153,6 +186,7 @@ TEST_CASE("performing set operations between randomized regions - 3d", "[benchma
 	    {"small", 10, 5, 4},
 	    {"medium", 50, 1, 50},
 	    {"large", 200, 20, 100},
+	    {"10k boxes", 500, 10, 10000},
 	}));
 
 	const std::vector inputs_3d{
@@ -168,6 +202,51 @@ TEST_CASE("performing set operations between randomized regions - 3d", "[benchma
 	test_utils::black_hole(region_difference(inputs_3d[0], inputs_3d[1]));
 }
 
+TEMPLATE_TEST_CASE_SIG("testing a box against a set of randomized boxes", "[benchmark][group:grid]", ((int Dims), Dims), 2, 3) {
+	const auto [label, num_boxes] = GENERATE(values<std::tuple<const char*, size_t>>({
+	    {"small", 16},
+	    {"medium", 128},
+	    {"large", 1024},
+	}));
+
+	const auto boxes = create_random_boxes<Dims>(200, 20, num_boxes, 42);
+	const auto queries = create_random_boxes<Dims>(200, 20, 64, 7);
+	const grid_detail::box_soa<Dims> packed(boxes);
+
+	const auto count_intersecting_box_by_box = [&] {
+		size_t num_intersecting = 0;
+		for(const auto& query : queries) {
+			for(const auto& b : boxes) {
+				num_intersecting += !box_intersection(query, b).empty();
+			}
+		}
+		return num_intersecting;
+	};
+	const auto count_intersecting_packed = [&] {
+		std::vector<uint32_t> intersecting;
+		for(const auto& query : queries) {
+			packed.template find_intersecting<Dims>(query, intersecting);
+		}
+		return intersecting.size();
+	};
+	const auto count_covered_box_by_box = [&] {
+		return std::count_if(queries.begin(), queries.end(), [&](const box<Dims>& query) {
+			return std::any_of(boxes.begin(), boxes.end(), [&](const box<Dims>& b) { return b.covers(query); });
+		});
+	};
+	const auto count_covered_packed = [&] {
+		return std::count_if(queries.begin(), queries.end(), [&](const box<Dims>& query) { return packed.template any_covers<Dims>(query); });
+	};
+
+	CHECK(count_intersecting_packed() == count_intersecting_box_by_box());
+	CHECK(count_covered_packed() == count_covered_box_by_box());
+
+	BENCHMARK(fmt::format("intersection, {}, box by box", label)) { return count_intersecting_box_by_box(); };
+	BENCHMARK(fmt::format("intersection, {}, packed", label)) { return count_intersecting_packed(); };
+	BENCHMARK(fmt::format("containment, {}, box by box", label)) { return count_covered_box_by_box(); };
+	BENCHMARK(fmt::format("containment, {}, packed", label)) { return count_covered_packed(); };
+}
+
 box_vector<2> create_interlocking_boxes(const size_t num_boxes_per_side) {
 	box_vector<2> boxes;
 	for(size_t i = 0; i < num_boxes_per_side; ++i) {
@@ -353,6 +353,136 @@ TEST_CASE("region difference - 2d", "[grid]") {
 	test_utils::render_boxes(result.get_boxes(), "result");
 }
 
+TEST_CASE("region operations on intervals agree with the general algorithms - 1d", "[grid]") {
+	// Extruding intervals along dimension 1 preserves the structure of the regions, but routes them through the algorithms for 2d regions
+	const auto extrude = [](const region<1>& r) {
+		box_vector<2> boxes;
+		for(const auto& b : r.get_boxes()) {
+			boxes.emplace_back(id<2>(b.get_min()[0], 0), id<2>(b.get_max()[0], 2));
+		}
+		return region<2>(std::move(boxes));
+	};
+
+	std::minstd_rand rng(42);
+	const auto random_region = [&] {
+		box_vector<1> boxes;
+		const size_t num_boxes = rng() % 16;
+		for(size_t i = 0; i < num_boxes; ++i) {
+			const size_t min = rng() % 100;
+			boxes.emplace_back(id<1>(min), id<1>(min + 1 + rng() % 10));
+		}
+		return region<1>(std::move(boxes));
+	};
+
+	for(size_t i = 0; i < 100; ++i) {
+		const auto ra = random_region();
+		const auto rb = random_region();
+		REQUIRE_LOOP(extrude(region_union(ra, rb)) == region_union(extrude(ra), extrude(rb)));
+		REQUIRE_LOOP(extrude(region_intersection(ra, rb)) == region_intersection(extrude(ra), extrude(rb)));
+		REQUIRE_LOOP(extrude(region_difference(ra, rb)) == region_difference(extrude(ra), extrude(rb)));
+	}
+}
+
+TEMPLATE_TEST_CASE_SIG("sweep-line region operations agree with the pairwise algorithms", "[grid]", ((int Dims), Dims), 2, 3) {
+	std::minstd_rand rng(42);
+	const auto random_region = [&](const size_t grid_size, const size_t num_boxes) {
+		box_vector<Dims> boxes;
+		for(size_t i = 0; i < num_boxes; ++i) {
+			id<Dims> min;
+			id<Dims> max;
+			for(int d = 0; d < Dims; ++d) {
+				min[d] = rng() % grid_size;
+				max[d] = min[d] + 1 + rng() % 6;
+			}
+			boxes.emplace_back(min, max);
+		}
+		return region<Dims>(std::move(boxes));
+	};
+	// The pairwise algorithms only merge, but don't re-normalize their result, which can leave it in a different (but equivalent) tiling
+	const auto renormalize = [](const region<Dims>& r) { return region<Dims>(test_utils::copy(r.get_boxes())); };
+
+	for(size_t i = 0; i < 50; ++i) {
+		// below the box counts at which region_union etc. switch to the sweep themselves
+		const auto ra = random_region(20, rng() % 30);
+		const auto rb = random_region(20, rng() % 30);
+		using grid_detail::region_operation;
+		REQUIRE_LOOP(grid_detail::sweep_region_operation(ra, rb, region_operation::unite) == renormalize(region_union(ra, rb)));
+		REQUIRE_LOOP(grid_detail::sweep_region_operation(ra, rb, region_operation::intersect) == renormalize(region_intersection(ra, rb)));
+		REQUIRE_LOOP(grid_detail::sweep_region_operation(ra, rb, region_operation::subtract) == renormalize(region_difference(ra, rb)));
+	}
+
+	// region_union sweeps for large operands, and normalizing all boxes at once gives the same result
+	const auto ra = random_region(100, 400);
+	const auto rb = random_region(100, 400);
+	box_vector<Dims> all_boxes = ra.get_boxes();
+	all_boxes.insert(all_boxes.end(), rb.get_boxes().begin(), rb.get_boxes().end());
+	CHECK(region_union(ra, rb) == region<Dims>(std::move(all_boxes)));
+	CHECK(region_difference(region_union(ra, rb), rb) == region_difference(ra, rb));
+	CHECK(region_intersection(region_difference(ra, rb), rb).empty());
+}
+
+TEMPLATE_TEST_CASE_SIG("box_soa finds the same boxes as box-by-box tests", "[grid]", ((int Dims), Dims), 1, 2, 3) {
+	// Exercises whichever vector path the CPU supports, including box counts that are not a multiple of the vector width
+	INFO("vector width: " << grid_detail::get_box_soa_vector_width());
+
+	std::minstd_rand rng(42);
+	const auto random_box = [&] {
+		id<Dims> min;
+		id<Dims> max;
+		for(int d = 0; d < Dims; ++d) {
+			const size_t a = rng() % 20;
+			const size_t b = rng() % 20;
+			min[d] = std::min(a, b);
+			max[d] = std::max(a, b) + 1;
+		}
+		return box<Dims>(min, max);
+	};
+
+	for(size_t num_boxes = 0; num_boxes < 40; ++num_boxes) {
+		box_vector<Dims> boxes;
+		for(size_t i = 0; i < num_boxes; ++i) {
+			boxes.push_back(random_box());
+		}
+		const grid_detail::box_soa<Dims> soa(boxes);
+		REQUIRE(soa.size() == num_boxes);
+
+		for(size_t q = 0; q < 20; ++q) {
+			const auto query = random_box();
+			std::vector<uint32_t> expected_intersecting;
+			bool expected_covered = false;
+			for(size_t i = 0; i < boxes.size(); ++i) {
+				if(!box_intersection(query, boxes[i]).empty()) { expected_intersecting.push_back(static_cast<uint32_t>(i)); }
+				expected_covered |= boxes[i].covers(query);
+			}
+
+			std::vector<uint32_t> intersecting;
+			soa.template find_intersecting<Dims>(query, intersecting);
+			REQUIRE_LOOP(intersecting == expected_intersecting);
+			REQUIRE_LOOP(soa.template any_covers<Dims>(query) == expected_covered);
+		}
+	}
+
+	// Region algorithms switch to box_soa for large right-hand sides
+	box_vector<Dims> many_boxes;
+	for(size_t i = 0; i < 64; ++i) {
+		many_boxes.push_back(random_box());
+	}
+	const region<Dims> large(std::move(many_boxes));
+	const region<Dims> small(box_vector<Dims>{random_box(), random_box()});
+	region<Dims> expected_intersection;
+	for(const auto& l : small.get_boxes()) {
+		for(const auto& r : large.get_boxes()) {
+			expected_intersection = region_union(expected_intersection, box_intersection(l, r));
+		}
+	}
+	// normalized 3D regions are not unique, so compare coverage instead of box lists
+	const auto same_coverage = [](const region<Dims>& lhs, const region<Dims>& rhs) {
+		return region_difference(lhs, rhs).empty() && region_difference(rhs, lhs).empty();
+	};
+	CHECK(same_coverage(region_intersection(small, large), expected_intersection));
+	CHECK(same_coverage(region_difference(small, large), region_difference(small, expected_intersection)));
+}
+
 TEST_CASE("region normalization - 0d", "[grid]") {
 	box_vector<0> r;
 	auto n = r;
@@ -395,3 +525,32 @@ TEST_CASE("region difference - 0d", "[grid]") {
 	CHECK(!region_difference(unit, empty).empty());
 	CHECK(region_difference(unit, unit).empty());
 }
+
+TEST_CASE("shared_region stores identical regions only once", "[grid]") {
+	const region<2> r1(box_vector<2>{{{0, 0}, {4, 4}}, {{8, 0}, {9, 9}}});
+	const region<2> r2(box_vector<2>{{{8, 0}, {9, 9}}, {{0, 0}, {4, 4}}}); // same region, boxes in different order
+
+	const auto stats_before = get_shared_region_statistics();
+	const shared_region<2> s1(r1);
+	const shared_region<2> s2(r2);
+	const auto stats_after = get_shared_region_statistics();
+
+	CHECK(s1 == s2);
+	CHECK(&s1.get() == &s2.get());
+	CHECK(s1.get_hash() == s2.get_hash());
+	CHECK(s1 == r1);
+	CHECK(r2 == s2);
+	CHECK(stats_after.num_constructions - stats_before.num_constructions == 2);
+	CHECK(stats_after.num_allocations - stats_before.num_allocations == 1);
+	CHECK(stats_after.num_allocated_boxes - stats_before.num_allocated_boxes == 2);
+
+	const shared_region<2> s3(region_union(r1, box<2>({4, 0}, {8, 1})));
+	CHECK(s3 != s1);
+	CHECK(s3 != r1);
+
+	const shared_region<2> empty;
+	CHECK(empty.empty());
+	CHECK(empty == shared_region<2>(region<2>()));
+	CHECK(empty.get().empty());
+	CHECK(empty != s1);
+}
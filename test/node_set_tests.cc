@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "node_set.h"
+#include "region_map.h"
+
+using namespace celerity;
+using namespace celerity::detail;
+
+TEST_CASE("node_set tests and sets nodes beyond its inline capacity", "[node_set]") {
+	const size_t num_nodes = GENERATE(values<size_t>({4, node_set::inline_capacity, node_set::inline_capacity + 1, 4096}));
+	CAPTURE(num_nodes);
+
+	node_set nodes;
+	CHECK(nodes.none());
+	CHECK(nodes.count() == 0);
+
+	for(size_t nid = 0; nid < num_nodes; nid += 3) {
+		nodes.set(nid);
+	}
+	nodes.set(num_nodes - 1);
+	for(size_t nid = 0; nid < num_nodes + 64; ++nid) {
+		CHECK(nodes.test(nid) == (nid < num_nodes && (nid % 3 == 0 || nid == num_nodes - 1)));
+	}
+	CHECK(nodes.count() == (num_nodes + 2) / 3 + ((num_nodes - 1) % 3 != 0 ? 1 : 0));
+
+	const auto all = node_set::all(num_nodes);
+	CHECK(all.count() == num_nodes);
+	CHECK((nodes | all) == all);
+	CHECK((nodes | node_set{}) == nodes);
+	CHECK(nodes != all);
+}
+
+TEST_CASE("node_set compares equal regardless of how a set was constructed", "[node_set]") {
+	const size_t num_nodes = GENERATE(values<size_t>({16, 1000}));
+	CAPTURE(num_nodes);
+
+	node_set incremental;
+	std::vector<node_id> ids;
+	for(size_t nid = num_nodes; nid-- > 0;) {
+		incremental.set(nid);
+		ids.push_back(nid);
+	}
+	CHECK(incremental == node_set::all(num_nodes));
+	CHECK(node_set(ids) == node_set::all(num_nodes));
+
+	node_set lower;
+	node_set upper;
+	for(size_t nid = 0; nid < num_nodes; ++nid) {
+		(nid < num_nodes / 2 ? lower : upper).set(nid);
+	}
+	CHECK(lower != upper);
+	CHECK((lower | upper) == node_set::all(num_nodes));
+	CHECK((upper | lower) == node_set::all(num_nodes));
+}
+
+TEST_CASE("node_set shares the storage of identical large sets", "[node_set]") {
+	const auto before = get_node_set_statistics();
+	{
+		const auto a = node_set::all(2048);
+		const auto b = node_set::all(2048);
+		const auto c = node_set{a}.set(4000);
+		auto d = c;
+		d = b;
+		const auto during = get_node_set_statistics();
+		CHECK(during.num_live_sets - before.num_live_sets == 2);
+		CHECK(during.num_allocations - before.num_allocations == 2);
+		CHECK(a == d);
+	}
+	const auto after = get_node_set_statistics();
+	CHECK(after.num_live_sets == before.num_live_sets);
+	CHECK(after.num_live_bytes == before.num_live_bytes);
+
+	// Sets within the inline capacity are never allocated
+	CHECK(sizeof(node_set) == sizeof(void*));
+	const auto small = node_set::all(node_set::inline_capacity);
+	CHECK(get_node_set_statistics().num_allocations == after.num_allocations);
+	CHECK(small.count() == node_set::inline_capacity);
+}
+
+TEST_CASE("node_set can be used as a region_map value for thousands of nodes", "[node_set][region_map]") {
+	constexpr size_t num_nodes = 4096;
+	constexpr size_t buffer_size = 256;
+	const box<3> full_box(subrange<3>({}, {buffer_size, 1, 1}));
+	region_map<node_set> rm(range<3>{buffer_size, 1, 1}, 1, node_set{});
+
+	// The last nodes each write one element, then all nodes read the entire buffer
+	for(size_t i = 0; i < buffer_size; ++i) {
+		rm.update_box(box<3>(subrange<3>({i, 0, 0}, {1, 1, 1})), node_set{}.set(num_nodes - 1 - i));
+	}
+	const auto written = rm.get_region_values(full_box);
+	REQUIRE(written.size() == buffer_size);
+	for(const auto& [box, nodes] : written) {
+		CHECK(nodes.count() == 1);
+		CHECK(nodes.test(num_nodes - 1 - box.get_min()[0]));
+	}
+
+	for(const auto& [box, nodes] : written) {
+		rm.update_box(box, nodes | node_set::all(num_nodes));
+	}
+	// Adjacent boxes with equal values are merged again
+	const auto read = rm.get_region_values(full_box);
+	REQUIRE(read.size() == 1);
+	CHECK(read[0].second == node_set::all(num_nodes));
+}
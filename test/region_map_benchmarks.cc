@@ -0,0 +1,411 @@
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "region_map.h"
+#include "test_utils.h"
+
+using namespace celerity;
+using namespace celerity::detail;
+
+struct linear_split_policy : region_map_default_policy {
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::linear;
+};
+
+struct rstar_policy : region_map_default_policy {
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::rstar;
+	static constexpr size_t forced_reinsert_count = 3;
+	static constexpr bool break_insertion_ties_by_area = true;
+};
+
+struct narrow_policy : region_map_default_policy {
+	static constexpr size_t max_children = 4;
+};
+
+struct wide_policy : region_map_default_policy {
+	static constexpr size_t max_children = 16;
+	static constexpr size_t min_children = 4;
+};
+
+struct wide_rstar_policy : rstar_policy {
+	static constexpr size_t max_children = 16;
+	static constexpr size_t min_children = 4;
+	static constexpr size_t forced_reinsert_count = 5;
+};
+
+struct rtree_1d_policy : region_map_default_policy {
+	static constexpr bool use_interval_map_for_1d = false;
+};
+
+// Access trace of one of the region maps the runtime maintains per buffer, for common application patterns.
+struct region_map_trace {
+	range<3> extent{1, 1, 1};
+	int dims;
+	std::vector<std::pair<box<3>, std::optional<uint64_t>>> ops; // update if value present, query otherwise
+};
+
+// A map that records every access for later replay
+class traced_region_map {
+  public:
+	traced_region_map(const range<3>& extent, const int dims, const uint64_t default_value) : m_map(extent, dims, default_value) {
+		m_trace.extent = extent;
+		m_trace.dims = dims;
+	}
+
+	void update_box(const box<3>& box, const uint64_t value) {
+		m_trace.ops.emplace_back(box, value);
+		m_map.update_box(box, value);
+	}
+
+	std::vector<std::pair<box<3>, uint64_t>> get_region_values(const box<3>& request) {
+		m_trace.ops.emplace_back(request, std::nullopt);
+		return m_map.get_region_values(request);
+	}
+
+	const region_map_trace& get_trace() const { return m_trace; }
+
+  private:
+	region_map<uint64_t> m_map;
+	region_map_trace m_trace;
+};
+
+// Models how distributed_graph_generator and buffer_manager track a single buffer that is read and written by chunks of a task on different nodes.
+class buffer_tracker {
+  public:
+	buffer_tracker(const range<3>& extent, const int dims)
+	    : m_last_writers(extent, dims, 0), m_replicated_regions(extent, dims, 0), m_newest_data_location(extent, dims, host_location) {}
+
+	void read(const box<3>& box, const size_t node) {
+		const uint64_t node_bit = uint64_t{1} << node;
+		m_last_writers.get_region_values(box);
+		for(const auto& [b, nodes] : m_replicated_regions.get_region_values(box)) {
+			if((nodes & node_bit) == 0) m_replicated_regions.update_box(b, nodes | node_bit);
+		}
+		if(node == 0) {
+			for(const auto& [b, location] : m_newest_data_location.get_region_values(box)) {
+				if((location & device_location) == 0) m_newest_data_location.update_box(b, location | device_location);
+			}
+		}
+	}
+
+	void write(const box<3>& box, const size_t node, const uint64_t command) {
+		m_last_writers.update_box(box, command);
+		m_replicated_regions.update_box(box, uint64_t{1} << node);
+		if(node == 0) m_newest_data_location.update_box(box, device_location);
+	}
+
+	void read_on_host(const box<3>& box) {
+		for(const auto& [b, location] : m_newest_data_location.get_region_values(box)) {
+			if((location & host_location) == 0) m_newest_data_location.update_box(b, location | host_location);
+		}
+	}
+
+	const region_map_trace& get_last_writers_trace() const { return m_last_writers.get_trace(); }
+	const region_map_trace& get_replicated_regions_trace() const { return m_replicated_regions.get_trace(); }
+	const region_map_trace& get_newest_data_location_trace() const { return m_newest_data_location.get_trace(); }
+
+  private:
+	static constexpr uint64_t host_location = 1;
+	static constexpr uint64_t device_location = 2;
+
+	traced_region_map m_last_writers;
+	traced_region_map m_replicated_regions;
+	traced_region_map m_newest_data_location;
+};
+
+// Splits [0, extent) into num_chunks parts along dimension 0
+std::vector<box<3>> split_rows(const range<3>& extent, const size_t num_chunks) {
+	std::vector<box<3>> chunks;
+	for(size_t i = 0; i < num_chunks; ++i) {
+		chunks.emplace_back(id<3>(extent[0] * i / num_chunks, 0, 0), id<3>(extent[0] * (i + 1) / num_chunks, extent[1], extent[2]));
+	}
+	return chunks;
+}
+
+box<3> grow_clamped(const box<3>& box, const range<3>& halo, const range<3>& extent) {
+	id<3> min = box.get_min();
+	id<3> max = box.get_max();
+	for(int d = 0; d < 3; ++d) {
+		min[d] = min[d] >= halo[d] ? min[d] - halo[d] : 0;
+		max[d] = std::min(max[d] + halo[d], extent[d]);
+	}
+	return {min, max};
+}
+
+// wave_sim: Each time step reads u and um with a one-row halo and writes the next time step into um, which is then swapped with u.
+buffer_tracker trace_wave_sim(const size_t num_nodes, const size_t num_steps) {
+	const range<3> extent(512, 512, 1);
+	buffer_tracker tracker(extent, 2);
+	const auto chunks = split_rows(extent, num_nodes);
+	uint64_t command = 1;
+	for(size_t step = 0; step < num_steps; ++step) {
+		for(size_t n = 0; n < num_nodes; ++n) {
+			tracker.read(grow_clamped(chunks[n], {1, 1, 0}, extent), n);
+			tracker.write(chunks[n], n, command++);
+		}
+		if(step % 10 == 9) tracker.read_on_host(box<3>(subrange<3>({}, extent)));
+	}
+	return tracker;
+}
+
+// jacobi: A 5-point stencil on a 2D grid of chunks, so halos are exchanged along both dimensions.
+buffer_tracker trace_jacobi(const size_t num_nodes_per_side, const size_t num_steps) {
+	const range<3> extent(512, 512, 1);
+	buffer_tracker tracker(extent, 2);
+	std::vector<box<3>> chunks;
+	for(size_t i = 0; i < num_nodes_per_side; ++i) {
+		for(size_t j = 0; j < num_nodes_per_side; ++j) {
+			chunks.emplace_back(id<3>(extent[0] * i / num_nodes_per_side, extent[1] * j / num_nodes_per_side, 0),
+			    id<3>(extent[0] * (i + 1) / num_nodes_per_side, extent[1] * (j + 1) / num_nodes_per_side, 1));
+		}
+	}
+	uint64_t command = 1;
+	for(size_t step = 0; step < num_steps; ++step) {
+		for(size_t n = 0; n < chunks.size(); ++n) {
+			tracker.read(grow_clamped(chunks[n], {1, 0, 0}, extent), n);
+			tracker.read(grow_clamped(chunks[n], {0, 1, 0}, extent), n);
+			tracker.write(chunks[n], n, command++);
+		}
+	}
+	return tracker;
+}
+
+// matmul: C = A * B with row-split chunks, iterated by feeding C back as the next A. We trace the buffer in the role of A, B and C in turn.
+buffer_tracker trace_matmul(const size_t num_nodes, const size_t num_iterations) {
+	const range<3> extent(256, 256, 1);
+	buffer_tracker tracker(extent, 2);
+	const auto chunks = split_rows(extent, num_nodes);
+	uint64_t command = 1;
+	for(size_t iteration = 0; iteration < num_iterations; ++iteration) {
+		for(size_t n = 0; n < num_nodes; ++n) {
+			tracker.read(chunks[n], n); // as A
+		}
+		for(size_t n = 0; n < num_nodes; ++n) {
+			tracker.read(box<3>(subrange<3>({}, extent)), n); // as B
+		}
+		for(size_t n = 0; n < num_nodes; ++n) {
+			tracker.write(chunks[n], n, command++); // as C
+		}
+	}
+	tracker.read_on_host(box<3>(subrange<3>({}, extent)));
+	return tracker;
+}
+
+// stencil_1d: A 3-point stencil on a 1D array, where nodes additionally read a few scattered elements owned by other nodes (e.g. a gather).
+buffer_tracker trace_stencil_1d(const size_t num_nodes, const size_t num_steps) {
+	const range<3> extent(1 << 20, 1, 1);
+	buffer_tracker tracker(extent, 1);
+	const auto chunks = split_rows(extent, num_nodes);
+	std::minstd_rand rng(42);
+	uint64_t command = 1;
+	for(size_t step = 0; step < num_steps; ++step) {
+		for(size_t n = 0; n < num_nodes; ++n) {
+			tracker.read(grow_clamped(chunks[n], {1, 0, 0}, extent), n);
+			const size_t gather_min = rng() % (extent[0] - 64);
+			tracker.read(box<3>(id<3>(gather_min, 0, 0), id<3>(gather_min + 64, 1, 1)), n);
+			tracker.write(chunks[n], n, command++);
+		}
+	}
+	return tracker;
+}
+
+template <typename Policy>
+size_t replay(const region_map_trace& trace, const size_t query_cache_capacity = 0, region_map_query_cache_statistics* const query_cache_stats = nullptr) {
+	region_map<uint64_t, Policy> map(trace.extent, trace.dims, 0);
+	if(query_cache_capacity > 0) { map.enable_query_cache(query_cache_capacity); }
+	size_t num_results = 0;
+	for(const auto& [box, value] : trace.ops) {
+		if(value.has_value()) {
+			map.update_box(box, *value);
+		} else {
+			num_results += map.get_region_values(box).size();
+		}
+	}
+	if(query_cache_stats != nullptr) { *query_cache_stats = map.get_query_cache_statistics(); }
+	return num_results;
+}
+
+template <typename Policy>
+region_map_allocation_statistics get_allocation_statistics_after_replay(const region_map_trace& trace) {
+	region_map<uint64_t, Policy> map(trace.extent, trace.dims, 0);
+	for(const auto& [box, value] : trace.ops) {
+		if(value.has_value()) {
+			map.update_box(box, *value);
+		} else {
+			test_utils::black_hole(map.get_region_values(box));
+		}
+	}
+	return map.get_allocation_statistics();
+}
+
+// Traces are recorded once with the default policy and then replayed, so every policy sees the exact same sequence of updates and queries.
+template <typename Policy>
+void benchmark_replays(const buffer_tracker& tracker) {
+	BENCHMARK("last writers") { return replay<Policy>(tracker.get_last_writers_trace()); };
+	BENCHMARK("replicated regions") { return replay<Policy>(tracker.get_replicated_regions_trace()); };
+	BENCHMARK("newest data location") { return replay<Policy>(tracker.get_newest_data_location_trace()); };
+}
+
+TEMPLATE_TEST_CASE("replaying region map accesses of wave_sim", "[benchmark][group:region-map]", region_map_default_policy, linear_split_policy,
+    rstar_policy, narrow_policy, wide_policy, wide_rstar_policy) {
+	benchmark_replays<TestType>(trace_wave_sim(16, 50));
+}
+
+TEMPLATE_TEST_CASE("replaying region map accesses of jacobi", "[benchmark][group:region-map]", region_map_default_policy, linear_split_policy,
+    rstar_policy, narrow_policy, wide_policy, wide_rstar_policy) {
+	benchmark_replays<TestType>(trace_jacobi(4, 50));
+}
+
+TEMPLATE_TEST_CASE("replaying region map accesses of matmul", "[benchmark][group:region-map]", region_map_default_policy, linear_split_policy,
+    rstar_policy, narrow_policy, wide_policy, wide_rstar_policy) {
+	benchmark_replays<TestType>(trace_matmul(16, 10));
+}
+
+TEMPLATE_TEST_CASE("replaying region map accesses of a 1d stencil", "[benchmark][group:region-map]", region_map_default_policy, rtree_1d_policy) {
+	benchmark_replays<TestType>(trace_stencil_1d(16, 50));
+}
+
+TEST_CASE("replaying region map accesses of wave_sim with a query cache", "[benchmark][group:region-map]") {
+	const size_t num_nodes = 16;
+	const auto tracker = trace_wave_sim(num_nodes, 50);
+	const auto& trace = tracker.get_last_writers_trace();
+
+	// Each node reads its chunk plus halo once per time step, so a cache of one entry per node sees every request again
+	BENCHMARK("last writers, uncached") { return replay<region_map_default_policy>(trace); };
+	BENCHMARK("last writers, cached") { return replay<region_map_default_policy>(trace, num_nodes); };
+
+	// Writes replace entire entries with new last writers, which leaves the tree structure untouched after the first two time steps
+	region_map_query_cache_statistics stats;
+	CHECK(replay<region_map_default_policy>(trace, num_nodes, &stats) == replay<region_map_default_policy>(trace));
+	INFO(fmt::format("{} hits, {} revalidations, {} misses", stats.num_hits, stats.num_revalidations, stats.num_misses));
+	CHECK(stats.num_misses <= 2 * num_nodes);
+}
+
+TEST_CASE("region map node allocations when replaying accesses", "[benchmark][group:region-map]") {
+	const auto check_slab_reuse = [](const char* const label, const region_map_trace& trace) {
+		const auto stats = get_allocation_statistics_after_replay<region_map_default_policy>(trace);
+		INFO(fmt::format("{}: {} operations, {} nodes created, at most {} alive at once, {} slab allocations", label, trace.ops.size(),
+		    stats.num_node_allocations, stats.peak_live_nodes, stats.num_slab_allocations));
+		// Slabs are only allocated once all previously freed nodes have been reused
+		constexpr auto nodes_per_slab = region_map_detail::nodes_per_arena_slab;
+		CHECK(stats.num_slab_allocations == (stats.peak_live_nodes + nodes_per_slab - 1) / nodes_per_slab);
+		CHECK(stats.num_node_allocations >= stats.peak_live_nodes);
+	};
+
+	SECTION("wave_sim") {
+		const auto tracker = trace_wave_sim(16, 50);
+		check_slab_reuse("last writers", tracker.get_last_writers_trace());
+		check_slab_reuse("replicated regions", tracker.get_replicated_regions_trace());
+		check_slab_reuse("newest data location", tracker.get_newest_data_location_trace());
+	}
+
+	SECTION("jacobi") {
+		const auto tracker = trace_jacobi(4, 50);
+		check_slab_reuse("last writers", tracker.get_last_writers_trace());
+		check_slab_reuse("replicated regions", tracker.get_replicated_regions_trace());
+		check_slab_reuse("newest data location", tracker.get_newest_data_location_trace());
+	}
+
+	SECTION("matmul") {
+		const auto tracker = trace_matmul(16, 10);
+		check_slab_reuse("last writers", tracker.get_last_writers_trace());
+		check_slab_reuse("replicated regions", tracker.get_replicated_regions_trace());
+		check_slab_reuse("newest data location", tracker.get_newest_data_location_trace());
+	}
+}
+
+// Short row segments scattered over a 2D extent, like the halo of an irregular domain decomposition or a set of gathered rows.
+region<3> make_scattered_row_segments(const range<3>& extent, const size_t num_segments) {
+	std::minstd_rand rng(42);
+	box_vector<3> boxes;
+	for(size_t i = 0; i < num_segments; ++i) {
+		const size_t row = rng() % extent[0];
+		const size_t column = rng() % (extent[1] - 24);
+		boxes.emplace_back(id<3>(row, column, 0), id<3>(row + 1, column + 1 + rng() % 24, 1));
+	}
+	return region<3>(std::move(boxes));
+}
+
+// Chunks of a checkerboard, i.e. many boxes that all touch, but cannot be merged.
+region<3> make_checkerboard(const size_t side_length, const size_t tile_size) {
+	box_vector<3> boxes;
+	for(size_t i = 0; i < side_length / tile_size; ++i) {
+		for(size_t j = i % 2; j < side_length / tile_size; j += 2) {
+			boxes.emplace_back(id<3>(i * tile_size, j * tile_size, 0), id<3>((i + 1) * tile_size, (j + 1) * tile_size, 1));
+		}
+	}
+	return region<3>(std::move(boxes));
+}
+
+TEST_CASE("updating and querying region maps with regions of many boxes", "[benchmark][group:region-map]") {
+	const range<3> extent(1024, 1024, 1);
+	const auto generated = GENERATE(values<std::pair<const char*, region<3>>>({
+	    {"128 row segments", make_scattered_row_segments(extent, 128)},
+	    {"512 row segments", make_scattered_row_segments(extent, 512)},
+	    {"512 checkerboard tiles", make_checkerboard(256, 8)},
+	    {"2048 checkerboard tiles", make_checkerboard(256, 4)},
+	}));
+	const auto label = generated.first;
+	const auto& request = generated.second;
+
+	// One entry per row stripe, as left behind by a 1D split of the buffer
+	const auto make_striped_map = [&] {
+		region_map<uint64_t> map(extent, 2, 0);
+		for(size_t i = 0; i < 64; ++i) {
+			map.update_box(box<3>(id<3>(i * 16, 0, 0), id<3>((i + 1) * 16, extent[1], 1)), i);
+		}
+		return map;
+	};
+
+	BENCHMARK(fmt::format("{}: update_box for each box", label)) {
+		auto map = make_striped_map();
+		for(const auto& box : request.get_boxes()) {
+			map.update_box(box, 100);
+		}
+		return map;
+	};
+	BENCHMARK(fmt::format("{}: update_region", label)) {
+		auto map = make_striped_map();
+		map.update_region(request, 100);
+		return map;
+	};
+
+	auto map = make_striped_map();
+	map.update_region(request, 100);
+	BENCHMARK(fmt::format("{}: get_region_values for each box", label)) {
+		size_t num_results = 0;
+		for(const auto& box : request.get_boxes()) {
+			num_results += map.get_region_values(box).size();
+		}
+		return num_results;
+	};
+	BENCHMARK(fmt::format("{}: get_region_values for region", label)) { return map.get_region_values(request).size(); };
+}
+
+TEST_CASE("building region maps from a partition", "[benchmark][group:region-map]") {
+	const range<3> extent(1024, 1024, 1);
+	const auto tiles_per_side = GENERATE(values<size_t>({16, 64}));
+
+	std::vector<std::pair<box<3>, uint64_t>> partition;
+	const size_t tile_size = extent[0] / tiles_per_side;
+	for(size_t i = 0; i < tiles_per_side; ++i) {
+		for(size_t j = 0; j < tiles_per_side; ++j) {
+			partition.emplace_back(box<3>(id<3>(i * tile_size, j * tile_size, 0), id<3>((i + 1) * tile_size, (j + 1) * tile_size, 1)), (i * 7 + j * 3) % 11);
+		}
+	}
+
+	BENCHMARK(fmt::format("{} tiles, update_box for each tile", partition.size())) {
+		region_map<uint64_t> map(extent, 2, 0);
+		for(const auto& [box, value] : partition) {
+			map.update_box(box, value);
+		}
+		return map;
+	};
+	BENCHMARK(fmt::format("{} tiles, bulk-loaded", partition.size())) { return region_map<uint64_t>(extent, 2, partition); };
+}
@@ -103,7 +103,7 @@ struct region_map_testspy {
 
 	template <typename ValueType, int Dims>
 	static void try_merge(region_map_impl<ValueType, Dims>& rm, std::vector<typename region_map_impl<ValueType, Dims>::types::entry> candidates) {
-		rm.try_merge(std::move(candidates));
+		rm.try_merge(candidates);
 	}
 };
 } // namespace celerity::detail
@@ -802,3 +802,339 @@ TEST_CASE("inserting consecutive boxes results in zero overlap", "[region_map][p
 	CHECK(region_map_testspy::compute_overlap(rm) == 0);
 	draw(rm);
 }
+
+struct linear_split_policy : region_map_default_policy {
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::linear;
+};
+
+struct rstar_policy : region_map_default_policy {
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::rstar;
+	static constexpr size_t forced_reinsert_count = 3;
+	static constexpr bool break_insertion_ties_by_area = true;
+};
+
+struct wide_no_merge_policy : region_map_default_policy {
+	static constexpr size_t max_children = 16;
+	static constexpr size_t min_children = 4;
+	static constexpr bool merge_on_update = false;
+};
+
+TEMPLATE_TEST_CASE("region_map policies only change tree layout, not query results", "[region_map]", linear_split_policy, rstar_policy,
+    wide_no_merge_policy) {
+	const size_t height = 48;
+	const size_t width = 64;
+	region_map_detail::region_map_impl<size_t, 2> reference{{height, width}, 0};
+	region_map_detail::region_map_impl<size_t, 2, TestType> rm{{height, width}, 0};
+
+	const auto get_value_regions = [](const auto& results) {
+		std::vector<region<2>> regions(4);
+		for(const auto& [box, value] : results) {
+			regions[value] = region_union(regions[value], box);
+		}
+		return regions;
+	};
+
+	std::minstd_rand rng(42);
+	for(size_t i = 0; i < 500; ++i) {
+		const id<2> min{rng() % height, rng() % width};
+		const id<2> max{std::min(height, min[0] + 1 + rng() % 12), std::min(width, min[1] + 1 + rng() % 16)};
+		const size_t value = rng() % 4;
+		reference.update_box({min, max}, value);
+		rm.update_box({min, max}, value);
+
+		if(i % 25 == 0) {
+			const id<2> query_min{rng() % height, rng() % width};
+			const id<2> query_max{std::min(height, query_min[0] + 1 + rng() % 32), std::min(width, query_min[1] + 1 + rng() % 32)};
+			CHECK(get_value_regions(rm.get_region_values({query_min, query_max}))
+			      == get_value_regions(reference.get_region_values({query_min, query_max})));
+		}
+	}
+	CHECK(get_value_regions(rm.get_region_values({{0, 0}, {height, width}})) == get_value_regions(reference.get_region_values({{0, 0}, {height, width}})));
+}
+
+struct small_fanout_policy : region_map_default_policy {
+	static constexpr size_t max_children = 4;
+	static constexpr size_t min_children = 2;
+};
+
+struct small_fanout_rstar_policy : small_fanout_policy {
+	static constexpr region_map_split_algorithm split_algorithm = region_map_split_algorithm::rstar;
+	static constexpr size_t forced_reinsert_count = 1;
+};
+
+TEMPLATE_TEST_CASE("region_map with a small fan-out stays consistent over many erases and merges", "[region_map]", small_fanout_policy,
+    small_fanout_rstar_policy) {
+	// With few children per node, erases frequently dissolve nodes on several levels at once, and reinserting their orphans changes the tree height
+	const range<3> extent{6, 9, 11};
+	region_map_detail::region_map_impl<size_t, 3, TestType> rm{extent, 0};
+	std::vector<size_t> reference(extent.size(), 0);
+	const auto linear_index = [&](const size_t i, const size_t j, const size_t k) { return (i * extent[1] + j) * extent[2] + k; };
+
+	std::minstd_rand rng(7);
+	const auto random_box = [&] {
+		id<3> min;
+		id<3> max;
+		for(int d = 0; d < 3; ++d) {
+			const size_t a = rng() % extent[d];
+			const size_t b = rng() % extent[d];
+			min[d] = std::min(a, b);
+			max[d] = std::max(a, b) + 1;
+		}
+		return box<3>(min, max);
+	};
+
+	for(size_t step = 0; step < 2000; ++step) {
+		const auto op = rng() % 16;
+		if(op < 12) {
+			// Few distinct values, so that updates are merged with their neighbors all the time
+			const auto box = random_box();
+			const size_t value = rng() % 3;
+			rm.update_box(box, value);
+			for(size_t i = box.get_min()[0]; i < box.get_max()[0]; ++i) {
+				for(size_t j = box.get_min()[1]; j < box.get_max()[1]; ++j) {
+					for(size_t k = box.get_min()[2]; k < box.get_max()[2]; ++k) {
+						reference[linear_index(i, j, k)] = value;
+					}
+				}
+			}
+		} else if(op < 15) {
+			const auto query = random_box();
+			size_t area = 0;
+			for(const auto& [box, value] : rm.get_region_values(query)) {
+				for(size_t i = box.get_min()[0]; i < box.get_max()[0]; ++i) {
+					for(size_t j = box.get_min()[1]; j < box.get_max()[1]; ++j) {
+						for(size_t k = box.get_min()[2]; k < box.get_max()[2]; ++k) {
+							REQUIRE_LOOP(reference[linear_index(i, j, k)] == value);
+						}
+					}
+				}
+				area += box.get_area();
+			}
+			REQUIRE_LOOP(area == query.get_area());
+		} else {
+			const auto rotate = [](const size_t value) { return (value + 1) % 3; };
+			rm.apply_to_values(rotate);
+			std::transform(reference.begin(), reference.end(), reference.begin(), rotate);
+		}
+	}
+}
+
+TEST_CASE("region_map::update_region and get_region_values on regions behave like their per-box counterparts", "[region_map]") {
+	const size_t height = 48;
+	const size_t width = 64;
+	region_map_impl<size_t, 2> reference{{height, width}, 0};
+	region_map_impl<size_t, 2> rm{{height, width}, 0};
+
+	const auto get_value_regions = [](const auto& results) {
+		std::vector<region<2>> regions(4);
+		for(const auto& [box, value] : results) {
+			regions[value] = region_union(regions[value], box);
+		}
+		return regions;
+	};
+
+	std::minstd_rand rng(42);
+	const auto random_region = [&](const size_t num_boxes, const size_t max_size) {
+		box_vector<2> boxes;
+		for(size_t i = 0; i < num_boxes; ++i) {
+			const id<2> min{rng() % height, rng() % width};
+			const id<2> max{std::min(height, min[0] + 1 + rng() % max_size), std::min(width, min[1] + 1 + rng() % max_size)};
+			boxes.emplace_back(min, max);
+		}
+		return region<2>(std::move(boxes));
+	};
+
+	for(size_t i = 0; i < 200; ++i) {
+		const auto update = random_region(1 + rng() % 16, 8);
+		const size_t value = rng() % 4;
+		rm.update_region(update, value);
+		for(const auto& box : update.get_boxes()) {
+			reference.update_box(box, value);
+		}
+
+		if(i % 10 == 0) {
+			const auto query = random_region(1 + rng() % 16, 16);
+			const auto results = rm.get_region_values(query);
+			size_t area = 0;
+			for(const auto& [box, value] : results) {
+				REQUIRE_LOOP(region_intersection(query, box).get_area() == box.get_area());
+				area += box.get_area();
+			}
+			CHECK(area == query.get_area());
+
+			std::vector<std::pair<box<2>, size_t>> reference_results;
+			for(const auto& box : query.get_boxes()) {
+				const auto box_results = reference.get_region_values(box);
+				reference_results.insert(reference_results.end(), box_results.begin(), box_results.end());
+			}
+			CHECK(results.size() <= reference_results.size());
+			CHECK(get_value_regions(results) == get_value_regions(reference_results));
+		}
+	}
+}
+
+TEST_CASE("region_map merges query results across the boxes of a region", "[region_map]") {
+	region_map_impl<int, 2> rm{{4, 4}, -1};
+	rm.update_box({{0, 0}, {4, 2}}, 1);
+	rm.update_box({{0, 2}, {4, 4}}, 2);
+
+	// The L-shaped region is normalized into two boxes {{0, 0}, {2, 4}} and {{2, 0}, {4, 2}}, both of which intersect the entry with value 1
+	const auto query = region_union(region<2>(box<2>{{0, 0}, {2, 4}}), region<2>(box<2>{{2, 0}, {4, 2}}));
+	REQUIRE(query.get_boxes().size() == 2);
+	const auto results = rm.get_region_values(query);
+	CHECK_RESULTS(results, {{{0, 0}, {4, 2}}, 1}, {{{0, 2}, {2, 4}}, 2});
+}
+
+TEST_CASE("region_map can be bulk-loaded from a partition", "[region_map]") {
+	constexpr size_t count_sqrt = 16;
+	constexpr size_t tile_size = 4;
+	region_map_impl<size_t, 2> rm{{count_sqrt * tile_size, count_sqrt * tile_size}, 0};
+
+	std::vector<std::pair<box<2>, size_t>> partition;
+	for(size_t i = 0; i < count_sqrt; ++i) {
+		for(size_t j = 0; j < count_sqrt; ++j) {
+			partition.emplace_back(box<2>{{i * tile_size, j * tile_size}, {(i + 1) * tile_size, (j + 1) * tile_size}}, i * count_sqrt + j);
+		}
+	}
+	rm.reset(partition);
+
+	// 256 entries fit into 32 fully packed leaf nodes, which need two more levels above them
+	CHECK(region_map_testspy::get_num_leaf_nodes(rm) == count_sqrt * count_sqrt);
+	CHECK(region_map_testspy::get_depth(rm) == 3);
+	for(const auto& [box, value] : partition) {
+		CHECK_RESULTS(rm.get_region_values(box), {box, value});
+	}
+
+	// Bulk-loaded trees can be updated like any other
+	const box<2> everything = {{0, 0}, {count_sqrt * tile_size, count_sqrt * tile_size}};
+	rm.update_box(everything, 7);
+	CHECK_RESULTS(rm.get_region_values(everything), {everything, 7});
+	draw(rm);
+}
+
+TEST_CASE("region_map query cache re-reads values updated in place and re-traverses after structural changes", "[region_map]") {
+	region_map_impl<int, 2> rm{{8, 8}, 0};
+	rm.update_box({{0, 0}, {4, 8}}, 1);
+	rm.update_box({{4, 0}, {8, 8}}, 2);
+	rm.enable_query_cache(4);
+	const auto& stats = rm.get_query_cache_statistics();
+
+	// CHECK_RESULTS evaluates its first argument repeatedly, so we query exactly once per step
+	const box<2> request = {{2, 2}, {6, 6}};
+	const auto first = rm.get_region_values(request);
+	const auto second = rm.get_region_values(request);
+	CHECK_RESULTS(first, {{{2, 2}, {4, 6}}, 1}, {{{4, 2}, {6, 6}}, 2});
+	CHECK(second == first);
+	CHECK(stats.num_misses == 1);
+	CHECK(stats.num_hits == 1);
+
+	// Overwriting an entire entry only changes its value
+	rm.update_box({{0, 0}, {4, 8}}, 3);
+	const auto revalidated = rm.get_region_values(request);
+	CHECK_RESULTS(revalidated, {{{2, 2}, {4, 6}}, 3}, {{{4, 2}, {6, 6}}, 2});
+	CHECK(stats.num_misses == 1);
+	CHECK(stats.num_revalidations == 1);
+
+	// ... unless the new value allows it to be merged with a neighbor
+	rm.update_box({{0, 0}, {4, 8}}, 2);
+	const auto merged = rm.get_region_values(request);
+	CHECK_RESULTS(merged, {{{2, 2}, {6, 6}}, 2});
+	CHECK(stats.num_misses == 2);
+
+	rm.update_box({{0, 0}, {8, 4}}, 5);
+	const auto split = rm.get_region_values(request);
+	CHECK_RESULTS(split, {{{2, 2}, {6, 4}}, 5}, {{{2, 4}, {6, 6}}, 2});
+	CHECK(stats.num_misses == 3);
+
+	// Regions are cached by their boxes
+	const region<2> halo(box_vector<2>{{{1, 1}, {7, 2}}, {{1, 6}, {7, 7}}});
+	const auto first_halo = rm.get_region_values(halo);
+	const auto second_halo = rm.get_region_values(halo);
+	CHECK_RESULTS(first_halo, {{{1, 1}, {7, 2}}, 5}, {{{1, 6}, {7, 7}}, 2});
+	CHECK(second_halo == first_halo);
+	CHECK(stats.num_misses == 4);
+	CHECK(stats.num_hits == 2);
+}
+
+TEST_CASE("region_map returns the same results with and without query cache", "[region_map]") {
+	const size_t height = 32;
+	const size_t width = 32;
+	region_map_impl<size_t, 2> reference{{height, width}, 0};
+	region_map_impl<size_t, 2> rm{{height, width}, 0};
+	rm.enable_query_cache(4);
+
+	// Drawing from a small pool of boxes makes repeated requests and in-place updates likely
+	std::minstd_rand rng(42);
+	std::vector<box<2>> pool;
+	for(size_t i = 0; i < 12; ++i) {
+		const id<2> min{rng() % height, rng() % width};
+		pool.emplace_back(min, id<2>{std::min(height, min[0] + 1 + rng() % 12), std::min(width, min[1] + 1 + rng() % 12)});
+	}
+
+	for(size_t i = 0; i < 500; ++i) {
+		const auto& box = pool[rng() % pool.size()];
+		if(rng() % 3 == 0) {
+			const size_t value = rng() % 4;
+			rm.update_box(box, value);
+			reference.update_box(box, value);
+		} else {
+			REQUIRE_LOOP(rm.get_region_values(box) == reference.get_region_values(box));
+		}
+	}
+
+	const auto& stats = rm.get_query_cache_statistics();
+	CHECK(stats.num_hits + stats.num_revalidations > 0);
+	CHECK(stats.num_misses > 0);
+}
+
+TEST_CASE("1d region_map stored as intervals behaves like the tree", "[region_map]") {
+	const size_t size = 200;
+	region_map_detail::interval_map<size_t, region_map_default_policy> rm{{size}, 0};
+	region_map_impl<size_t, 1> reference{{size}, 0};
+
+	// The tree returns results in no particular order, so we compare the region covered by each value instead
+	const auto get_value_regions = [](const auto& results) {
+		std::vector<region<1>> regions(4);
+		for(const auto& [box, value] : results) {
+			regions[value] = region_union(regions[value], region<1>(box));
+		}
+		return regions;
+	};
+
+	std::minstd_rand rng(42);
+	const auto random_box = [&] {
+		const size_t min = rng() % size;
+		return box<1>(min, std::min(size, min + 1 + rng() % 40));
+	};
+
+	for(size_t i = 0; i < 1000; ++i) {
+		const auto op = rng() % 8;
+		if(op < 4) {
+			const auto box = random_box();
+			const size_t value = rng() % 4;
+			rm.update_box(box, value);
+			reference.update_box(box, value);
+		} else if(op < 7) {
+			const auto box = random_box();
+			const auto results = rm.get_region_values(box);
+			const auto expected = reference.get_region_values(box);
+			REQUIRE_LOOP(results.size() == expected.size());
+			REQUIRE_LOOP(get_value_regions(results) == get_value_regions(expected));
+		} else {
+			const auto halve = [](const size_t value) { return value / 2; };
+			rm.apply_to_values(halve);
+			reference.apply_to_values(halve);
+		}
+	}
+
+	std::vector<std::pair<box<1>, size_t>> partition;
+	for(size_t min = 0; min < size; min += 10) {
+		partition.emplace_back(box<1>(min, min + 10), min / 10 % 3);
+	}
+	std::reverse(partition.begin(), partition.end());
+	rm.reset(partition);
+	reference.reset(partition);
+	const auto results = rm.get_region_values({0, size});
+	CHECK(results.size() == reference.get_region_values({0, size}).size());
+	CHECK(get_value_regions(results) == get_value_regions(partition));
+}
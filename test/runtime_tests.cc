@@ -1,5 +1,7 @@
 #include "sycl_wrappers.h"
 
+#include <algorithm>
+#include <numeric>
 #include <random>
 
 #ifdef _WIN32
@@ -21,7 +23,9 @@
 
 #include "affinity.h"
 #include "executor.h"
+#include "load_balancer.h"
 #include "named_threads.h"
+#include "numa.h"
 #include "ranges.h"
 
 #include "test_utils.h"
@@ -229,6 +233,57 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE("built-in range mappers bound the kernel indices requiring a buffer box", "[range-mapper]") {
+		const range<2> size{16, 16};
+		const box<3> kernel_box(subrange<3>({}, range_cast<3>(size)));
+		const box<3> buffer_box({4, 5, 0}, {7, 9, 1});
+
+		// For the built-in range mappers with an analytical preimage, the bounds are exact when evaluated item by item
+		const auto check_exact_preimage = [&](const range_mapper_base& rm) {
+			const auto bounds = rm.get_preimage_bounds(buffer_box, kernel_box);
+			REQUIRE(bounds.has_value());
+			for(size_t i = 0; i < size[0]; ++i) {
+				for(size_t j = 0; j < size[1]; ++j) {
+					const auto req = box<3>(subrange_cast<3>(rm.map_2(chunk<2>{{i, j}, {1, 1}, size})));
+					const auto item = box<3>({i, j, 0}, {i + 1, j + 1, 1});
+					CHECK(box_intersection(req, buffer_box).empty() == box_intersection(item, *bounds).empty());
+				}
+			}
+		};
+
+		check_exact_preimage(range_mapper{one_to_one{}, cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{neighborhood<2>(1, 2), cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{slice<2>(0), cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{slice<2>(1), cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{all{}, cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{fixed<2>({{0, 0}, {4, 4}}), cl::sycl::access::mode::read, size});
+		check_exact_preimage(range_mapper{fixed<2>({{6, 6}, {4, 4}}), cl::sycl::access::mode::read, size});
+
+		// Arbitrary functors cannot be inverted
+		const auto custom = [](const chunk<2>& ck) { return subrange<2>{{ck.offset[1], ck.offset[0]}, {ck.range[1], ck.range[0]}}; };
+		CHECK(range_mapper{custom, cl::sycl::access::mode::read, size}.get_preimage_bounds(buffer_box, kernel_box) == std::nullopt);
+	}
+
+	TEST_CASE("built-in range mappers are compared by their parameters", "[range-mapper]") {
+		const range<2> size{16, 16};
+		const auto signature = [&](auto rmfn) { return range_mapper{rmfn, cl::sycl::access::mode::read, size}.get_signature(); };
+
+		CHECK(signature(one_to_one{}).has_value());
+		CHECK(signature(one_to_one{}) == signature(one_to_one{}));
+		CHECK(signature(one_to_one{}) != signature(all{}));
+		CHECK(signature(neighborhood<2>(1, 2)) == signature(neighborhood<2>(1, 2)));
+		CHECK(signature(neighborhood<2>(1, 2)) != signature(neighborhood<2>(2, 1)));
+		CHECK(signature(slice<2>(0)) == signature(slice<2>(0)));
+		CHECK(signature(slice<2>(0)) != signature(slice<2>(1)));
+		CHECK(signature(fixed<2>({{0, 0}, {4, 4}})) == signature(fixed<2>({{0, 0}, {4, 4}})));
+		CHECK(signature(fixed<2>({{0, 0}, {4, 4}})) != signature(fixed<2>({{6, 6}, {4, 4}})));
+		CHECK(signature(fixed<2>({{0, 0}, {4, 4}})) != signature(fixed<2>({{0, 0}, {4, 2}})));
+
+		// Arbitrary functors can capture state by reference
+		const auto custom = [](const chunk<2>& ck) { return subrange<2>{{ck.offset[1], ck.offset[0]}, {ck.range[1], ck.range[0]}}; };
+		CHECK(signature(custom) == std::nullopt);
+	}
+
 	TEST_CASE("task_manager invokes callback upon task creation", "[task_manager]") {
 		task_manager tm{1, nullptr, nullptr};
 		size_t call_counter = 0;
@@ -390,6 +445,39 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE("memcpy_strided_host produces the same result for contiguous, partially contiguous and large copies") {
+		struct copy_shape {
+			range<3> source_range;
+			id<3> source_offset;
+			range<3> target_range;
+			id<3> target_offset;
+			range<3> copy_range;
+		};
+		// The last shape is large enough to be split across helper threads using streaming stores
+		const auto shape = GENERATE(values<copy_shape>({
+		    {{8, 16, 32}, {2, 0, 0}, {8, 16, 32}, {0, 0, 0}, {4, 16, 32}}, // whole planes, single copy
+		    {{8, 16, 32}, {1, 2, 0}, {4, 16, 32}, {0, 3, 0}, {3, 10, 32}}, // whole rows
+		    {{8, 16, 32}, {1, 0, 3}, {8, 16, 29}, {2, 0, 0}, {5, 16, 29}}, // partial rows, mergeable row loop
+		    {{8, 16, 32}, {1, 2, 3}, {7, 15, 31}, {0, 1, 2}, {6, 13, 27}}, // fully strided
+		    {{1, 1, size_t{12} << 20}, {0, 0, 5}, {1, 1, size_t{12} << 20}, {0, 0, 3}, {1, 1, (size_t{12} << 20) - 7}},
+		}));
+
+		std::vector<uint32_t> source(shape.source_range.size());
+		std::iota(source.begin(), source.end(), 0);
+		std::vector<uint32_t> target(shape.target_range.size());
+		memcpy_strided_host(source.data(), target.data(), sizeof(uint32_t), shape.source_range, shape.source_offset, shape.target_range, shape.target_offset,
+		    shape.copy_range);
+
+		for(size_t i = 0; i < shape.copy_range[0]; ++i) {
+			for(size_t j = 0; j < shape.copy_range[1]; ++j) {
+				for(size_t k = 0; k < shape.copy_range[2]; ++k) {
+					const auto value = target[get_linear_index(shape.target_range, shape.target_offset + id<3>{i, j, k})];
+					REQUIRE_LOOP(value == get_linear_index(shape.source_range, shape.source_offset + id<3>{i, j, k}));
+				}
+			}
+		}
+	}
+
 	TEST_CASE("linearize_subrange works as expected") {
 		const range<3> data1_range{3, 5, 7};
 		std::vector<size_t> data1(data1_range.size());
@@ -417,6 +505,65 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE("host_buffer_storage backed by a mapped file retains data across copies, resizes and prefetches", "[buffer_storage]") {
+		const range<2> small_range{8, 16};
+		const range<2> large_range{12, 20};
+		const host_storage_config mapped_config{host_memory_kind::mapped_file, {}};
+
+		std::vector<size_t> pattern(small_range.size());
+		std::iota(pattern.begin(), pattern.end(), size_t{1});
+		const auto expected_value = [&](const id<2>& idx) { return pattern[idx[0] * small_range[1] + idx[1]]; };
+
+		host_buffer_storage<size_t, 2> mapped(small_range, mapped_config);
+		REQUIRE(mapped.get_host_buffer().is_mapped());
+		CHECK(mapped.get_size() == small_range.size() * sizeof(size_t));
+
+		// Freshly mapped memory is zero-initialized just like heap memory
+		std::vector<size_t> readback(small_range.size(), 42);
+		mapped.get_data(subrange<3>({}, range_cast<3>(small_range)), readback.data());
+		CHECK(std::all_of(readback.begin(), readback.end(), [](const size_t v) { return v == 0; }));
+
+		mapped.set_data(subrange<3>({}, range_cast<3>(small_range)), pattern.data());
+		mapped.get_data(subrange<3>({}, range_cast<3>(small_range)), readback.data());
+		CHECK(readback == pattern);
+
+		SECTION("when copying between mapped and regular host storage") {
+			host_buffer_storage<size_t, 2> heap(small_range);
+			REQUIRE_FALSE(heap.get_host_buffer().is_mapped());
+			heap.copy(mapped, {}, {}, range_cast<3>(small_range));
+
+			host_buffer_storage<size_t, 2> mapped_copy(small_range, mapped_config);
+			const subrange<3> copy_sr{{2, 3, 0}, {5, 7, 1}};
+			mapped_copy.copy(heap, copy_sr.offset, copy_sr.offset, copy_sr.range);
+
+			const auto* const copied = static_cast<const size_t*>(mapped_copy.get_pointer());
+			for(size_t i = 0; i < small_range[0]; ++i) {
+				for(size_t j = 0; j < small_range[1]; ++j) {
+					const bool inside = i >= 2 && i < 7 && j >= 3 && j < 10;
+					REQUIRE_LOOP(copied[i * small_range[1] + j] == (inside ? expected_value({i, j}) : 0));
+				}
+			}
+		}
+
+		SECTION("when resizing into a larger mapped storage") {
+			// This is how buffer_manager retains the contents of a backing buffer it replaces with a larger one
+			host_buffer_storage<size_t, 2> resized(large_range, mapped_config);
+			const id<3> resize_offset{3, 2, 0};
+			resized.copy(mapped, {}, resize_offset, range_cast<3>(small_range));
+
+			const subrange<3> read_sr{{4, 5, 0}, {6, 10, 1}};
+			resized.prefetch(read_sr);
+			std::vector<size_t> partial(read_sr.range.size());
+			resized.get_data(read_sr, partial.data());
+			for(size_t i = 0; i < read_sr.range[0]; ++i) {
+				for(size_t j = 0; j < read_sr.range[1]; ++j) {
+					const id<2> source_idx{read_sr.offset[0] + i - resize_offset[0], read_sr.offset[1] + j - resize_offset[1]};
+					REQUIRE_LOOP(partial[i * read_sr.range[1] + j] == expected_value(source_idx));
+				}
+			}
+		}
+	}
+
 	TEST_CASE_METHOD(test_utils::runtime_fixture, "collective host_task produces one item per rank", "[task]") {
 		distr_queue{}.submit([=](handler& cgh) {
 			cgh.host_task(experimental::collective, [=](experimental::collective_partition part) {
@@ -1141,6 +1288,33 @@ namespace detail {
 		const auto cores = affinity_cores_available();
 		REQUIRE(cores == 1);
 	}
+
+	TEST_CASE_METHOD(restore_process_affinity_fixture, "discover_numa_topology only reports cores available to the process", "[affinity][numa]") {
+		const auto count_cores = [](const numa_topology& topology) {
+			size_t num_cores = 0;
+			for(const auto& node : topology.nodes) {
+				CHECK(!node.cores.empty());
+				num_cores += node.cores.size();
+			}
+			return num_cores;
+		};
+
+		CHECK(count_cores(discover_numa_topology()) == affinity_cores_available());
+
+#ifdef _WIN32
+		const auto ret = SetProcessAffinityMask(GetCurrentProcess(), 1);
+		REQUIRE(ret != FALSE);
+#else
+		cpu_set_t cpu_mask;
+		CPU_ZERO(&cpu_mask);
+		CPU_SET(0, &cpu_mask);
+		const auto ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_mask), &cpu_mask);
+		REQUIRE(ret == 0);
+#endif
+		const auto topology = discover_numa_topology();
+		REQUIRE(topology.get_num_nodes() == 1);
+		CHECK(topology.nodes[0].cores == std::vector<uint32_t>{0});
+	}
 #endif
 
 	TEST_CASE_METHOD(test_utils::runtime_fixture, "side_effect API works as expected on a single node", "[side-effect]") {
@@ -1358,6 +1532,66 @@ namespace detail {
 		}
 	}
 
+	TEST_CASE("split weights are proportional to the throughput of each node", "[load-balancing]") {
+		using namespace std::chrono_literals;
+		std::vector<kernel_throughput_map> throughput_per_node(3);
+		throughput_per_node[0]["stencil"] = {1000, 1ms};
+		throughput_per_node[1]["stencil"] = {500, 1ms};
+		throughput_per_node[2]["stencil"] = {2000, 4ms};
+		throughput_per_node[0]["init"] = {1000, 1ms};
+		throughput_per_node[2]["init"] = {1000, 1ms}; // node 1 did not execute "init", so we cannot weigh it
+
+		const auto weights = compute_split_weights(throughput_per_node);
+		REQUIRE(weights.size() == 1);
+		REQUIRE(weights.count("stencil") == 1);
+		CHECK_THAT(weights.at("stencil"), Catch::Matchers::Approx(std::vector<double>{0.5, 0.25, 0.25}));
+	}
+
+	TEST_CASE_METHOD(test_utils::mpi_fixture, "load balancer exchanges the throughput measured since the last exchange", "[load-balancing]") {
+		using namespace std::chrono_literals;
+		load_balancer lb;
+		lb.register_kernel("stencil");
+		lb.record_execution("stencil", 100, 1ms);
+		lb.record_execution("stencil", 100, 3ms);
+		// The measurements are only received by the next exchange
+		CHECK(lb.exchange().empty());
+		const auto weights = lb.exchange();
+		REQUIRE(weights.count("stencil") == 1);
+		CHECK(weights.at("stencil") == std::vector<double>{1.0}); // single rank
+		CHECK(lb.exchange().empty());
+	}
+
+	TEST_CASE_METHOD(test_utils::mpi_fixture, "load balancer does not measure kernels that cannot be told apart by name", "[load-balancing]") {
+		using namespace std::chrono_literals;
+		const auto unnamed_device_kernel = kernel_debug_name<unnamed_kernel>();
+		CHECK_FALSE(is_load_balanced_kernel(""));
+		CHECK_FALSE(is_load_balanced_kernel(unnamed_device_kernel));
+		CHECK(is_load_balanced_kernel("stencil"));
+
+		load_balancer lb;
+		for(const auto& kernel_name : {std::string(), unnamed_device_kernel, std::string("stencil")}) {
+			lb.register_kernel(kernel_name);
+		}
+		lb.record_execution("", 100, 1ms); // two unnamed host tasks
+		lb.record_execution("", 100, 9ms);
+		lb.record_execution(unnamed_device_kernel, 100, 1ms);
+		lb.record_execution("stencil", 100, 1ms);
+		lb.exchange();
+		const auto weights = lb.exchange();
+		CHECK(weights.size() == 1);
+		CHECK(weights.count("stencil") == 1);
+	}
+
+	TEST_CASE_METHOD(test_utils::runtime_fixture, "load balancing slowdown delays the completion of kernels", "[load-balancing]") {
+		env::scoped_test_environment ste(std::unordered_map<std::string, std::string>{{"CELERITY_LOAD_BALANCING_SLOWDOWN", "3"}});
+		distr_queue q;
+
+		const auto before = std::chrono::steady_clock::now();
+		q.submit([](handler& cgh) { cgh.host_task(range<1>{1}, [](partition<1>) { std::this_thread::sleep_for(std::chrono::milliseconds(50)); }); });
+		q.slow_full_sync();
+		CHECK(std::chrono::steady_clock::now() - before >= std::chrono::milliseconds(150));
+	}
+
 	TEST_CASE_METHOD(test_utils::runtime_fixture, "fences extract data from host objects", "[runtime][fence]") {
 		experimental::host_object<int> ho{1};
 		distr_queue q;
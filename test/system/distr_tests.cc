@@ -1,9 +1,12 @@
 #include "../test_utils.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 #include <libenvpp/env.hpp>
 
@@ -436,5 +439,56 @@ namespace detail {
 		}
 	}
 
+	// Run with 16 or more nodes to measure the time-to-broadcast at scale
+	TEST_CASE_METHOD(test_utils::runtime_fixture, "broadcast trees distribute data read by all nodes", "[command-graph][broadcast]") {
+		const bool broadcast_trees = GENERATE(false, true);
+		env::scoped_test_environment tenv(
+		    broadcast_trees ? std::unordered_map<std::string, std::string>{{"CELERITY_BROADCAST_TREES", "1"}} : std::unordered_map<std::string, std::string>{});
+
+		int global_size = 0;
+		int global_rank = 0;
+		MPI_Comm_size(MPI_COMM_WORLD, &global_size);
+		MPI_Comm_rank(MPI_COMM_WORLD, &global_rank);
+		if(global_size < 4) { SKIP("broadcast trees are only formed for at least three receiving nodes"); }
+
+		constexpr size_t num_elements = 1024 * 1024;
+		constexpr int num_broadcasts = 10;
+
+		distr_queue q;
+		buffer<float, 1> buf{range<1>(num_elements)};
+		std::atomic<size_t> num_mismatches = 0;
+		std::chrono::steady_clock::duration time_to_broadcast{};
+
+		for(int i = 0; i < num_broadcasts; ++i) {
+			q.submit([&](handler& cgh) {
+				accessor acc{buf, cgh, celerity::access::all{}, write_only_host_task, no_init};
+				cgh.host_task(on_master_node, [=] {
+					for(size_t j = 0; j < num_elements; ++j) {
+						acc[j] = static_cast<float>(i + j % 7);
+					}
+				});
+			});
+			q.slow_full_sync();
+
+			const auto start = std::chrono::steady_clock::now();
+			q.submit([&](handler& cgh) {
+				accessor acc{buf, cgh, celerity::access::all{}, read_only_host_task};
+				cgh.host_task(range<1>(global_size), [=, &num_mismatches](partition<1>) {
+					for(size_t j = 0; j < num_elements; j += 4099) {
+						if(acc[j] != static_cast<float>(i + j % 7)) { ++num_mismatches; }
+					}
+				});
+			});
+			q.slow_full_sync();
+			time_to_broadcast += std::chrono::steady_clock::now() - start;
+		}
+
+		CHECK(num_mismatches == 0);
+		if(global_rank == 0) {
+			CELERITY_INFO("Broadcasting {} bytes to {} nodes {} broadcast trees took {} us on average", num_elements * sizeof(float), global_size,
+			    broadcast_trees ? "with" : "without", std::chrono::duration_cast<std::chrono::microseconds>(time_to_broadcast).count() / num_broadcasts);
+		}
+	}
+
 } // namespace detail
 } // namespace celerity
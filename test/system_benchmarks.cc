@@ -5,6 +5,14 @@
 
 #include <celerity.h>
 
+#include <numeric>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "buffer_manager_test_utils.h"
 #include "test_utils.h"
 
 using namespace celerity;
@@ -137,3 +145,258 @@ TEMPLATE_TEST_CASE_METHOD_SIG(
 	});
 	CHECK(*queue.fence(success_buffer).get() == true);
 }
+
+// Wave propagation with three time-step buffers as in the wave_sim example, split into several chunks per node so that halo exchanges of one chunk can
+// overlap with the computation of the others
+TEST_CASE_METHOD(test_utils::runtime_fixture, "benchmark oversubscribed wave_sim pattern", "[benchmark][group:system][oversubscription]") {
+	constexpr size_t num_iterations = 50;
+	constexpr size_t side_length = 512;
+	const size_t factor = GENERATE(1, 2, 4);
+
+	celerity::distr_queue queue;
+
+	const auto size = celerity::range<2>(side_length, side_length);
+	celerity::buffer<float, 2> up(size);
+	celerity::buffer<float, 2> u(size);
+	celerity::buffer<float, 2> um(size);
+
+	for(auto* buf : {&up, &u, &um}) {
+		queue.submit([&](celerity::handler& cgh) {
+			celerity::accessor w{*buf, cgh, celerity::access::one_to_one{}, celerity::write_only, celerity::no_init};
+			cgh.parallel_for(size, [=](celerity::item<2> item) {
+				w[item] = item.get_id(0) == side_length / 2 && item.get_id(1) == side_length / 2 ? 1.f : 0.f; // point source
+			});
+		});
+	}
+	queue.slow_full_sync();
+
+	BENCHMARK(fmt::format("{} chunks per node", factor)) {
+		for(size_t i = 0; i < num_iterations; ++i) {
+			queue.submit([&](celerity::handler& cgh) {
+				celerity::experimental::oversubscribe(cgh, factor);
+				celerity::accessor rw_up{up, cgh, celerity::access::one_to_one{}, celerity::read_write};
+				celerity::accessor r_u{u, cgh, celerity::access::neighborhood{1, 1}, celerity::read_only};
+				celerity::accessor r_um{um, cgh, celerity::access::one_to_one{}, celerity::read_only};
+				cgh.parallel_for(size, [=](celerity::item<2> item) {
+					const auto y = item.get_id(0);
+					const auto x = item.get_id(1);
+					if(y == 0 || x == 0 || y == side_length - 1 || x == side_length - 1) return;
+					const float lap = r_u[{y - 1, x}] + r_u[{y + 1, x}] + r_u[{y, x - 1}] + r_u[{y, x + 1}] - 4.f * r_u[item];
+					rw_up[item] = 2.f * r_u[item] - r_um[item] + 0.25f * lap;
+				});
+			});
+			std::swap(um, u);
+			std::swap(u, up);
+		}
+		queue.slow_full_sync();
+	};
+}
+
+// Measures how long the application thread spends in submit(), which only runs the command group function when dependency analysis happens on a
+// separate thread. Execution of the tasks is not part of the measurement.
+TEST_CASE_METHOD(test_utils::runtime_fixture, "benchmark command group submission latency", "[benchmark][group:system][submission]") {
+	constexpr size_t num_tasks = 1000;
+	constexpr size_t num_buffers = 8;
+	const bool async_analysis = GENERATE(false, true);
+
+	celerity::distr_queue queue;
+	if(async_analysis) { celerity::detail::runtime::get_instance().get_task_manager().enable_async_dependency_analysis(); }
+
+	std::vector<celerity::buffer<float, 1>> buffers;
+	for(size_t i = 0; i < num_buffers; ++i) {
+		buffers.emplace_back(celerity::range<1>(1024));
+	}
+
+	BENCHMARK_ADVANCED(async_analysis ? "asynchronous dependency analysis" : "synchronous dependency analysis")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&] {
+			for(size_t i = 0; i < num_tasks; ++i) {
+				queue.submit([&](celerity::handler& cgh) {
+					celerity::accessor read{buffers[i % num_buffers], cgh, celerity::access::neighborhood(1), celerity::read_only};
+					celerity::accessor write{buffers[(i + 1) % num_buffers], cgh, celerity::access::one_to_one(), celerity::write_only, celerity::no_init};
+					cgh.parallel_for(celerity::range<1>(1024), [=](celerity::item<1> item) { write[item] = read[item]; });
+				});
+			}
+		});
+		queue.slow_full_sync();
+	};
+}
+
+// Streams a host buffer of a multiple of the node's physical memory through a fixed-size staging area, which is what coherence updates and data
+// transfers do. Hidden by default: at 2x RAM this writes that much data to the scratch directory on every iteration.
+TEST_CASE("benchmark out-of-core host buffers", "[.][benchmark][group:out-of-core]") {
+#if defined(_WIN32)
+	SKIP("Physical memory size detection is not implemented on Windows");
+#else
+	using namespace celerity::detail;
+
+	const size_t physical_memory_bytes = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	constexpr size_t staging_elements = size_t{16} << 20; // 64 MiB of floats
+	std::vector<float> staging(staging_elements, 1.f);
+
+	const auto stream_through = [&](buffer_storage& storage) {
+		const size_t num_elements = storage.get_range()[0];
+		float checksum = 0;
+		for(size_t offset = 0; offset < num_elements; offset += staging_elements) {
+			const subrange<3> sr{{offset, 0, 0}, {std::min(staging_elements, num_elements - offset), 1, 1}};
+			storage.set_data(sr, staging.data());
+		}
+		for(size_t offset = 0; offset < num_elements; offset += staging_elements) {
+			const subrange<3> sr{{offset, 0, 0}, {std::min(staging_elements, num_elements - offset), 1, 1}};
+			storage.prefetch(sr);
+			storage.get_data(sr, staging.data());
+			checksum += staging[0];
+		}
+		return checksum;
+	};
+
+	for(const double ram_factor : {0.5, 1.0, 2.0}) {
+		const size_t num_elements = static_cast<size_t>(ram_factor * static_cast<double>(physical_memory_bytes)) / sizeof(float);
+		const auto buffer_range = celerity::range<1>(num_elements);
+
+		// A heap allocation of 1x RAM or more would swap or get the process killed
+		if(ram_factor < 1.0) {
+			host_buffer_storage<float, 1> heap_storage(buffer_range);
+			BENCHMARK(fmt::format("heap, {}x RAM", ram_factor)) { return stream_through(heap_storage); };
+		}
+
+		host_buffer_storage<float, 1> mapped_storage(buffer_range, host_storage_config{host_memory_kind::mapped_file, {}});
+		BENCHMARK(fmt::format("mapped file, {}x RAM", ram_factor)) { return stream_through(mapped_storage); };
+	}
+#endif
+}
+
+// Streams through host buffers from host tasks, with the buffers placed either on the NUMA node of the reading thread or on a different node.
+// Only meaningful when the process spans multiple NUMA nodes, e.g. on dual-socket systems.
+TEST_CASE("benchmark NUMA-aware host task placement", "[benchmark][group:numa]") {
+	using namespace celerity::detail;
+
+	const auto& topology = get_numa_topology();
+	if(topology.get_num_nodes() < 2) { SKIP("Process does not span multiple NUMA nodes"); }
+	const auto num_nodes = static_cast<numa_node_id>(topology.get_num_nodes());
+
+	constexpr size_t num_elements = (size_t{256} << 20) / sizeof(float);
+	host_queue queue(true /* numa_placement */);
+	REQUIRE(queue.get_num_numa_nodes() == num_nodes);
+
+	std::vector<std::unique_ptr<host_buffer<float, 1>>> buffers;
+	for(numa_node_id node = 0; node < num_nodes; ++node) {
+		buffers.push_back(std::make_unique<host_buffer<float, 1>>(celerity::range<1>(num_elements), host_storage_config{host_memory_kind::heap, {}, node}));
+	}
+
+	// Reads each buffer from a host task on the node returned by get_reader_node, concurrently
+	const auto read_all = [&](const auto& get_reader_node) {
+		std::vector<float> sums(num_nodes);
+		std::vector<std::future<host_queue::execution_info>> futures;
+		for(numa_node_id node = 0; node < num_nodes; ++node) {
+			futures.push_back(queue.submit(0, get_reader_node(node), [&, node](MPI_Comm /* comm */) {
+				const auto* const data = buffers[node]->get_pointer();
+				sums[node] = std::accumulate(data, data + num_elements, 0.f);
+			}));
+		}
+		for(auto& f : futures) {
+			f.wait();
+		}
+		return std::accumulate(sums.begin(), sums.end(), 0.f);
+	};
+
+	const auto read_first = [&](const numa_node_id reader_node) {
+		float sum = 0;
+		const auto* const data = buffers[0]->get_pointer();
+		queue.submit(0, reader_node, [&](MPI_Comm /* comm */) { sum = std::accumulate(data, data + num_elements, 0.f); }).wait();
+		return sum;
+	};
+
+	BENCHMARK("single reader, local buffer") { return read_first(0); };
+	BENCHMARK("single reader, remote buffer") { return read_first(1); };
+	BENCHMARK("reader per node, local buffers") { return read_all([](const numa_node_id node) { return node; }); };
+	BENCHMARK("reader per node, remote buffers") { return read_all([&](const numa_node_id node) { return (node + 1) % num_nodes; }); };
+}
+
+// Host copies as they occur in coherence updates and transfer (de)linearization: halo exchanges of 2D / 3D stencils and buffer resizes along
+// different dimensions. The row-wise reference corresponds to issuing one memcpy per row of the copy.
+TEST_CASE("benchmark strided host copies", "[benchmark][group:memcpy]") {
+	using namespace celerity::detail;
+
+	struct copy_shape {
+		const char* name;
+		celerity::range<3> source_range;
+		celerity::id<3> source_offset;
+		celerity::range<3> target_range;
+		celerity::id<3> target_offset;
+		celerity::range<3> copy_range;
+	};
+	const copy_shape shapes[] = {
+	    {"2D halo row", {4096, 4096, 1}, {4094, 0, 0}, {2, 4096, 1}, {0, 0, 0}, {2, 4096, 1}},
+	    {"2D halo column", {4096, 4096, 1}, {0, 4094, 0}, {4096, 2, 1}, {0, 0, 0}, {4096, 2, 1}},
+	    {"3D halo x-plane", {256, 256, 256}, {254, 0, 0}, {2, 256, 256}, {0, 0, 0}, {2, 256, 256}},
+	    {"3D halo y-plane", {256, 256, 256}, {0, 254, 0}, {256, 2, 256}, {0, 0, 0}, {256, 2, 256}},
+	    {"3D halo z-plane", {256, 256, 256}, {0, 0, 254}, {256, 256, 2}, {0, 0, 0}, {256, 256, 2}},
+	    {"2D resize along rows", {4096, 4096, 1}, {0, 0, 0}, {8192, 4096, 1}, {0, 0, 0}, {4096, 4096, 1}},
+	    {"2D resize along columns", {4096, 4096, 1}, {0, 0, 0}, {4096, 8192, 1}, {0, 0, 0}, {4096, 4096, 1}},
+	    {"3D resize along z", {256, 256, 256}, {0, 0, 0}, {256, 256, 512}, {0, 0, 0}, {256, 256, 256}},
+	};
+
+	const auto copy_row_wise = [](const std::byte* source, std::byte* target, const copy_shape& shape) {
+		const size_t row_bytes = sizeof(float) * shape.copy_range[2];
+		for(size_t i = 0; i < shape.copy_range[0]; ++i) {
+			for(size_t j = 0; j < shape.copy_range[1]; ++j) {
+				const auto source_idx = get_linear_index(shape.source_range, shape.source_offset + celerity::id<3>(i, j, 0));
+				const auto target_idx = get_linear_index(shape.target_range, shape.target_offset + celerity::id<3>(i, j, 0));
+				std::memcpy(target + sizeof(float) * target_idx, source + sizeof(float) * source_idx, row_bytes);
+			}
+		}
+	};
+
+	for(const auto& shape : shapes) {
+		std::vector<float> source(shape.source_range.size(), 1.f);
+		std::vector<float> target(shape.target_range.size());
+
+		BENCHMARK(fmt::format("{}: memcpy_strided_host", shape.name)) {
+			memcpy_strided_host(source.data(), target.data(), sizeof(float), shape.source_range, shape.source_offset, shape.target_range, shape.target_offset,
+			    shape.copy_range);
+		};
+		BENCHMARK(fmt::format("{}: row-wise reference", shape.name)) {
+			copy_row_wise(reinterpret_cast<const std::byte*>(source.data()), reinterpret_cast<std::byte*>(target.data()), shape);
+		};
+	}
+}
+
+// Measures how well host accesses from concurrent threads (as issued by host tasks and data transfers) scale, both when every thread works on its
+// own buffer and when all threads contend for the same buffer.
+TEST_CASE_METHOD(test_utils::buffer_manager_fixture, "benchmark concurrent buffer_manager accesses", "[benchmark][group:buffer-manager]") {
+	using namespace celerity::detail;
+
+	constexpr size_t num_elements = 4096;
+	constexpr size_t accesses_per_thread = 10000;
+	auto& bm = get_buffer_manager();
+	const auto num_threads = GENERATE(values<size_t>({1, 4, 16}));
+
+	std::vector<buffer_id> bids;
+	for(size_t i = 0; i < num_threads; ++i) {
+		bids.push_back(bm.register_buffer<float, 1>(range_cast<3>(celerity::range<1>(num_elements))));
+	}
+
+	const auto run_threads = [&](const auto& get_bid) {
+		std::vector<std::thread> threads;
+		for(size_t t = 0; t < num_threads; ++t) {
+			threads.emplace_back([&, t] {
+				const auto bid = get_bid(t);
+				for(size_t i = 0; i < accesses_per_thread; ++i) {
+					// Alternate between two subranges so that coherence tracking has to do some work
+					const auto offset = i % 2 == 0 ? 0 : num_elements / 2;
+					(void)bm.access_host_buffer<float, 1>(bid, access_mode::read_write, subrange<1>(offset, num_elements / 2));
+				}
+			});
+		}
+		for(auto& thread : threads) {
+			thread.join();
+		}
+	};
+
+	BENCHMARK(fmt::format("{} threads, distinct buffers", num_threads)) { run_threads([&](const size_t t) { return bids[t]; }); };
+	BENCHMARK(fmt::format("{} threads, shared buffer", num_threads)) { run_threads([&](const size_t /* t */) { return bids[0]; }); };
+
+	for(const auto bid : bids) {
+		bm.unregister_buffer(bid);
+	}
+}
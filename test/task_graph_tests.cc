@@ -6,7 +6,11 @@
 #include <catch2/generators/catch_generators.hpp>
 
 #include <celerity.h>
+#include <algorithm>
+#include <chrono>
 #include <iterator>
+#include <random>
+#include <thread>
 
 #include "test_utils.h"
 
@@ -106,6 +110,33 @@ namespace detail {
 		REQUIRE_FALSE(has_dependency(tt.tm, tid_c, tid_a));
 	}
 
+	TEST_CASE("tasks store the regions they consume and produce per buffer", "[task_manager][task-graph]") {
+		using namespace cl::sycl::access;
+
+		auto tt = test_utils::task_test_context{};
+		auto buf_a = tt.mbf.create_buffer(range<1>(128));
+		auto buf_b = tt.mbf.create_buffer(range<1>(128));
+		auto buf_c = tt.mbf.create_buffer(range<1>(128));
+
+		const auto tid = test_utils::add_compute_task<class UKN(task_a)>(
+		    tt.tm,
+		    [&](handler& cgh) {
+			    buf_a.get_access<mode::read>(cgh, fixed<1>{{0, 32}});
+			    buf_a.get_access<mode::read>(cgh, fixed<1>{{64, 32}});
+			    buf_b.get_access<mode::read_write>(cgh, celerity::access::one_to_one{});
+			    buf_b.get_access<mode::discard_write>(cgh, fixed<1>{{100, 28}});
+		    },
+		    range<1>{64}, id<1>{16});
+		const auto tsk = tt.tm.get_task(tid);
+
+		CHECK(tsk->get_consumed_region(buf_a.get_id()) == region(box_vector<3>{box<3>({0, 0, 0}, {32, 1, 1}), box<3>({64, 0, 0}, {96, 1, 1})}));
+		CHECK(tsk->get_produced_region(buf_a.get_id()).empty());
+		CHECK(tsk->get_consumed_region(buf_b.get_id()) == box<3>({16, 0, 0}, {80, 1, 1}));
+		CHECK(tsk->get_produced_region(buf_b.get_id()) == region(box_vector<3>{box<3>({16, 0, 0}, {80, 1, 1}), box<3>({100, 0, 0}, {128, 1, 1})}));
+		CHECK(tsk->get_consumed_region(buf_c.get_id()).empty());
+		CHECK(tsk->get_produced_region(buf_c.get_id()).empty());
+	}
+
 	TEST_CASE("task_manager correctly generates anti-dependencies", "[task_manager][task-graph]") {
 		using namespace cl::sycl::access;
 
@@ -713,5 +744,169 @@ namespace detail {
 		CHECK(has_dependency(tt.tm, tid_b, tid_fence, dependency_kind::anti_dep));
 	}
 
+	TEST_CASE("asynchronous dependency analysis generates the same task graph as synchronous analysis", "[task_manager][task-graph][async]") {
+		const auto build_graph = [](test_utils::task_test_context& tt) {
+			// keep horizons out of the picture, asynchronous analysis inserts them async_horizon_delay submissions later
+			tt.tm.set_horizon_step(1000);
+			auto buf_a = tt.mbf.create_buffer(range<1>(128));
+			auto buf_b = tt.mbf.create_buffer(range<2>(64, 64), true /* host_initialized */);
+			auto ho = tt.mhof.create_host_object();
+
+			test_utils::add_compute_task<class UKN(producer)>(
+			    tt.tm, [&](handler& cgh) { buf_a.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{}); }, range<1>(128));
+			test_utils::add_compute_task<class UKN(stencil)>(
+			    tt.tm, [&](handler& cgh) { buf_a.get_access<access_mode::read>(cgh, celerity::access::neighborhood<1>(1)); }, range<1>(128));
+			test_utils::add_compute_task<class UKN(update)>(
+			    tt.tm, [&](handler& cgh) { buf_b.get_access<access_mode::read_write>(cgh, celerity::access::one_to_one{}); }, range<2>(64, 64));
+			test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) {
+				buf_b.get_access<access_mode::read>(cgh, all{});
+				ho.add_side_effect(cgh, experimental::side_effect_order::sequential);
+			});
+			test_utils::add_fence_task(tt.tm, buf_a);
+			test_utils::add_compute_task<class UKN(consumer)>(
+			    tt.tm, [&](handler& cgh) { buf_a.get_access<access_mode::discard_write>(cgh, fixed<1>({0, 64})); }, range<1>(64));
+			test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) { ho.add_side_effect(cgh, experimental::side_effect_order::sequential); });
+			tt.tm.await_async_analysis();
+
+			std::vector<std::set<std::pair<task_id, dependency_kind>>> dependencies;
+			for(task_id tid = 0; tid < tt.tm.get_total_task_count(); ++tid) {
+				auto& deps = dependencies.emplace_back();
+				for(const auto dep : tt.tm.get_task(tid)->get_dependencies()) {
+					deps.emplace(dep.node->get_id(), dep.kind);
+				}
+			}
+			return dependencies;
+		};
+
+		test_utils::task_test_context sync_tt;
+		const auto sync_dependencies = build_graph(sync_tt);
+
+		test_utils::task_test_context async_tt;
+		async_tt.tm.enable_async_dependency_analysis();
+		const auto async_dependencies = build_graph(async_tt);
+
+		CHECK(async_dependencies == sync_dependencies);
+	}
+
+	TEST_CASE("asynchronous dependency analysis still generates horizons", "[task_manager][task-graph][task-horizon][async]") {
+		auto tt = test_utils::task_test_context{};
+		tt.tm.set_horizon_step(2);
+		tt.tm.enable_async_dependency_analysis();
+		auto buf = tt.mbf.create_buffer(range<1>(128));
+
+		// each horizon is inserted async_horizon_delay submissions after it has been requested
+		for(size_t i = 0; i < 5 * (task_manager::async_horizon_delay + 2); ++i) {
+			test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) { buf.get_access<access_mode::read_write>(cgh, all{}); });
+		}
+		tt.tm.await_async_analysis();
+
+		const auto current_horizon = task_manager_testspy::get_current_horizon(tt.tm);
+		REQUIRE(current_horizon.has_value());
+		CHECK(task_manager_testspy::get_num_horizons(tt.tm) >= 5);
+		CHECK(tt.tm.get_task(*current_horizon)->get_type() == task_type::horizon);
+
+		// epochs still see the entire execution front, which is a single task in a chain
+		const auto epoch = tt.tm.generate_epoch_task(epoch_action::none);
+		CHECK(has_dependency(tt.tm, epoch, epoch - 1));
+	}
+
+	TEST_CASE("asynchronous dependency analysis places horizons independently of the analysis thread's progress",
+	    "[task_manager][task-graph][task-horizon][async]") {
+		// Task ids must match between nodes, no matter how far each node's application thread runs ahead of its analysis thread
+		const auto record_task_types = [](const bool delay_analysis) {
+			auto tt = test_utils::task_test_context{};
+			tt.tm.set_horizon_step(2);
+			tt.tm.set_horizon_max_parallelism(4);
+
+			std::minstd_rand rng(42);
+			std::vector<task_type> task_types;
+			tt.tm.register_task_callback([&](const task* tsk) {
+				if(delay_analysis && rng() % 4 == 0) { std::this_thread::sleep_for(std::chrono::microseconds(200)); }
+				if(task_types.size() <= tsk->get_id()) { task_types.resize(tsk->get_id() + 1); }
+				task_types[tsk->get_id()] = tsk->get_type();
+			});
+			tt.tm.enable_async_dependency_analysis();
+
+			auto buf = tt.mbf.create_buffer(range<1>(128));
+			for(int i = 0; i < 200; ++i) {
+				if(!delay_analysis && i % 4 == 0) { std::this_thread::sleep_for(std::chrono::microseconds(200)); }
+				if(i % 3 == 0) {
+					// independent tasks widen the execution front
+					test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) { (void)cgh; });
+				} else {
+					test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) { buf.get_access<access_mode::read_write>(cgh, all{}); });
+				}
+				if(i == 120) { test_utils::add_fence_task(tt.tm, buf); }
+			}
+			tt.tm.generate_epoch_task(epoch_action::none);
+			tt.tm.await_async_analysis();
+			return task_types;
+		};
+
+		const auto lagging_analysis = record_task_types(true /* delay_analysis */);
+		const auto lagging_application = record_task_types(false /* delay_analysis */);
+		CHECK(std::count(lagging_analysis.begin(), lagging_analysis.end(), task_type::horizon) >= 5);
+		CHECK(lagging_analysis == lagging_application);
+	}
+
+	TEST_CASE("errors during asynchronous dependency analysis are rethrown on the application thread", "[task_manager][task-graph][async]") {
+		auto tt = test_utils::task_test_context{};
+		tt.tm.enable_async_dependency_analysis();
+		auto buf = tt.mbf.create_buffer(range<1>(1));
+
+		CHECK_NOTHROW(test_utils::add_compute_task<class UKN(reduction_with_accessor)>(tt.tm, [&](handler& cgh) {
+			buf.get_access<access_mode::read>(cgh, all{});
+			test_utils::add_reduction(cgh, tt.mrf, buf, false);
+		}));
+		CHECK_THROWS_WITH(tt.tm.await_async_analysis(), "Buffer 0 is both required through an accessor and used as a reduction output in task 1");
+
+		// the error is only reported once
+		CHECK_NOTHROW(tt.tm.await_async_analysis());
+	}
+
+	TEST_CASE("task_manager replays captured command groups", "[task_manager][task-graph][capture]") {
+		cgf_diagnostics::teardown(); // see test_utils::add_compute_task
+		auto tt = test_utils::task_test_context{};
+		tt.tm.set_horizon_step(100);
+		auto buf_a = tt.mbf.create_buffer(range<1>(128));
+		auto buf_b = tt.mbf.create_buffer(range<1>(128));
+
+		const auto a_to_b = [&](handler& cgh) {
+			buf_a.get_access<access_mode::read>(cgh, celerity::access::neighborhood<1>(1));
+			buf_b.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+			cgh.parallel_for<class UKN(a_to_b)>(range<1>(128), [](id<1>) {});
+		};
+		const auto b_to_a = [&](handler& cgh) {
+			buf_b.get_access<access_mode::read>(cgh, celerity::access::neighborhood<1>(1));
+			buf_a.get_access<access_mode::discard_write>(cgh, celerity::access::one_to_one{});
+			cgh.parallel_for<class UKN(b_to_a)>(range<1>(128), [](id<1>) {});
+		};
+
+		CHECK_THROWS_WITH(tt.tm.end_capture(), "No capture in progress");
+
+		tt.tm.begin_capture();
+		CHECK_THROWS_WITH(tt.tm.begin_capture(), "A capture is already in progress");
+		const auto tid_a = tt.tm.submit_command_group(a_to_b);
+		const auto tid_b = tt.tm.submit_command_group(b_to_a);
+		CHECK_THROWS_WITH(tt.tm.replay_capture(1), "Cannot replay while a capture is in progress");
+		tt.tm.end_capture();
+
+		const auto slot_a = tt.tm.get_task(tid_a)->get_capture_slot();
+		const auto slot_b = tt.tm.get_task(tid_b)->get_capture_slot();
+		REQUIRE(slot_a.has_value());
+		REQUIRE(slot_b.has_value());
+		CHECK(*slot_a != *slot_b);
+
+		tt.tm.replay_capture(2);
+		REQUIRE(tt.tm.get_total_task_count() == tid_b + 5);
+		for(task_id tid = tid_b + 1; tid <= tid_b + 4; ++tid) {
+			CHECK(tt.tm.get_task(tid)->get_capture_slot() == ((tid - tid_a) % 2 == 0 ? slot_a : slot_b));
+			CHECK(has_dependency(tt.tm, tid, tid - 1));
+		}
+
+		const auto tid_uncaptured = tt.tm.submit_command_group(a_to_b);
+		CHECK_FALSE(tt.tm.get_task(tid_uncaptured)->get_capture_slot().has_value());
+	}
+
 } // namespace detail
 } // namespace celerity
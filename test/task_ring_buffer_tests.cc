@@ -1,6 +1,7 @@
 #include "task_ring_buffer.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
 #include <celerity.h>
@@ -13,17 +14,20 @@ TEST_CASE_METHOD(test_utils::runtime_fixture, "freeing task ring buffer capacity
 	using namespace std::chrono_literals;
 	celerity::distr_queue q;
 
+	constexpr size_t task_queue_soft_cap = 1024;
+	runtime::get_instance().get_task_manager().set_task_queue_soft_cap(task_queue_soft_cap);
+
 	std::atomic<bool> reached_ringbuffer_capacity = false;
 
 	auto observer = std::thread([&] {
-		while(runtime::get_instance().get_task_manager().get_total_task_count() < task_ringbuffer_size)
+		while(runtime::get_instance().get_task_manager().get_total_task_count() < task_queue_soft_cap)
 			;
 		reached_ringbuffer_capacity = true;
 	});
 
 	celerity::buffer<int, 1> dependency{1};
 
-	for(size_t i = 0; i < task_ringbuffer_size + 10; ++i) {
+	for(size_t i = 0; i < task_queue_soft_cap + 10; ++i) {
 		q.submit([&](celerity::handler& cgh) {
 			celerity::accessor acc{dependency, cgh, celerity::access::all{}, celerity::read_write_host_task};
 			cgh.host_task(celerity::on_master_node, [=, &reached_ringbuffer_capacity] {
@@ -41,12 +45,15 @@ TEST_CASE_METHOD(test_utils::runtime_fixture, "freeing task ring buffer capacity
 TEST_CASE_METHOD(test_utils::runtime_fixture, "deadlock in task ring buffer due to slot exhaustion is reported", "[task_ring_buffer]") {
 	celerity::distr_queue q;
 
+	constexpr size_t task_queue_soft_cap = 1024;
+	runtime::get_instance().get_task_manager().set_task_queue_soft_cap(task_queue_soft_cap);
+
 	// set a high maximum so that we can actually run out of slots
-	runtime::get_instance().get_task_manager().set_horizon_max_parallelism(task_ringbuffer_size * 16);
+	runtime::get_instance().get_task_manager().set_horizon_max_parallelism(task_queue_soft_cap * 16);
 
 	CHECK_THROWS_WITH(
 	    [&] {
-		    for(size_t i = 0; i < task_ringbuffer_size + 1; ++i) {
+		    for(size_t i = 0; i < task_queue_soft_cap + 1; ++i) {
 			    q.submit([=](celerity::handler& cgh) { cgh.host_task(celerity::on_master_node, [=] {}); });
 		    }
 	    }(),
@@ -56,4 +63,80 @@ TEST_CASE_METHOD(test_utils::runtime_fixture, "deadlock in task ring buffer due
 	task_manager_testspy::create_task_slot(runtime::get_instance().get_task_manager());
 }
 
+TEST_CASE("task ring buffer allocates and frees segments as the range of live tasks moves", "[task_ring_buffer]") {
+	task_ring_buffer trb(4 * task_ring_buffer_segment_size);
+	const auto no_wait = [](task_id) { FAIL("task ring buffer should not wait for free slots"); };
+
+	const task_id num_tasks = 3 * task_ring_buffer_segment_size + 10;
+	for(task_id tid = 0; tid < num_tasks; ++tid) {
+		auto reserve = trb.reserve_task_entry(no_wait);
+		CHECK(reserve.get_tid() == tid);
+		trb.put(std::move(reserve), task::make_epoch(tid, epoch_action::none));
+	}
+	CHECK(task_ring_buffer_testspy::get_num_segments(trb) == 4);
+	CHECK(trb.get_current_task_count() == num_tasks);
+	for(task_id tid = 0; tid < num_tasks; ++tid) {
+		REQUIRE(trb.has_task(tid));
+		CHECK(trb.get_task(tid)->get_id() == tid);
+	}
+	CHECK_FALSE(trb.has_task(num_tasks));
+	CHECK(trb.find_task(num_tasks) == nullptr);
+
+	const task_id first_live_tid = 2 * task_ring_buffer_segment_size + 1;
+	trb.delete_up_to(first_live_tid);
+	CHECK(task_ring_buffer_testspy::get_num_segments(trb) == 2);
+	CHECK(trb.get_current_task_count() == num_tasks - first_live_tid);
+	CHECK_FALSE(trb.has_task(first_live_tid - 1));
+	CHECK(trb.find_task(first_live_tid - 1) == nullptr);
+	for(task_id tid = first_live_tid; tid < num_tasks; ++tid) {
+		REQUIRE(trb.has_task(tid));
+		CHECK(trb.get_task(tid)->get_id() == tid);
+	}
+
+	trb.clear();
+	CHECK(task_ring_buffer_testspy::get_num_segments(trb) == 0);
+	CHECK(trb.get_current_task_count() == 0);
+}
+
+TEST_CASE("task ring buffer waits for free slots only once reaching its soft cap", "[task_ring_buffer]") {
+	const size_t soft_cap = GENERATE(values<size_t>({100, 2 * task_ring_buffer_segment_size + 1}));
+	CAPTURE(soft_cap);
+
+	task_ring_buffer trb(soft_cap);
+	size_t num_waits = 0;
+	task_id next_tid_to_delete = 0;
+	const auto wait = [&](const task_id previous_free_tid) {
+		CHECK(previous_free_tid == next_tid_to_delete);
+		++num_waits;
+		trb.delete_up_to(++next_tid_to_delete);
+	};
+
+	for(task_id tid = 0; tid < soft_cap; ++tid) {
+		trb.put(trb.reserve_task_entry(wait), task::make_epoch(tid, epoch_action::none));
+	}
+	CHECK(num_waits == 0);
+
+	for(task_id tid = soft_cap; tid < 3 * soft_cap; ++tid) {
+		trb.put(trb.reserve_task_entry(wait), task::make_epoch(tid, epoch_action::none));
+		CHECK(trb.get_current_task_count() == soft_cap);
+	}
+	CHECK(num_waits == 2 * soft_cap);
+	for(task_id tid = 2 * soft_cap; tid < 3 * soft_cap; ++tid) {
+		REQUIRE(trb.has_task(tid));
+		CHECK(trb.get_task(tid)->get_id() == tid);
+	}
+
+	// raising the cap at runtime lets the buffer grow without waiting
+	trb.set_soft_cap(4 * soft_cap);
+	for(task_id tid = 3 * soft_cap; tid < 6 * soft_cap; ++tid) {
+		trb.put(trb.reserve_task_entry(wait), task::make_epoch(tid, epoch_action::none));
+	}
+	CHECK(num_waits == 2 * soft_cap);
+	CHECK(trb.get_current_task_count() == 4 * soft_cap);
+	for(task_id tid = 2 * soft_cap; tid < 6 * soft_cap; ++tid) {
+		REQUIRE(trb.has_task(tid));
+		CHECK(trb.get_task(tid)->get_id() == tid);
+	}
+}
+
 } // namespace celerity::detail